@@ -0,0 +1,179 @@
+/**
+ * @file AssetPack.hpp
+ * @brief Offline-baked, memory-mapped asset pack (SPIR-V, decoded textures, mesh buffers)
+ */
+
+#pragma once
+
+#include "Mesh.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @namespace AssetPack
+ * @brief Single-file pack read through mmap: payloads are copied straight into staging memory
+ * @details Layout: Header, then the table of contents (Header::entryCount Entry records), then
+ *          every payload at a PACK_ALIGNMENT-aligned offset. Payloads are stored exactly as the
+ *          GPU consumes them (SPIR-V words, RGBA8 texels, PackedVertex and index bytes), so
+ *          startup does no parsing, decoding or intermediate heap copies.
+ */
+namespace AssetPack
+{
+    inline constexpr std::uint32_t PACK_MAGIC = 0x4B505356; ///< "VSPK" (little-endian)
+    inline constexpr std::uint32_t PACK_VERSION = 2;        ///< Bumped on any layout change
+
+    /// Payload alignment in the file (and so in the mapping): SPIR-V words, texel copies
+    inline constexpr std::uint64_t PACK_ALIGNMENT = 64;
+
+    /// Entry names of the baked scene mesh
+    constexpr std::string_view meshVerticesName = "mesh/vertices";
+    constexpr std::string_view meshIndicesName = "mesh/indices";
+    constexpr std::string_view meshPlacementName = "mesh/placement";
+
+    /**
+     * @enum AssetType
+     * @brief What an entry's payload holds and how its params are read
+     */
+    enum class AssetType : std::uint32_t
+    {
+        Shader,   ///< SPIR-V; no params
+        Texture,  ///< Tightly packed texels; width, height, VkFormat, mip level
+        Vertices, ///< Mesh::PackedVertex array; vertex count, bounding radius (float bits)
+        Indices,  ///< Index array; VkIndexType, index count
+        Placement ///< No payload; mesh centre xyz and scale (float bits, Mesh::MeshData)
+    };
+
+    /**
+     * @struct Header
+     * @brief First bytes of a pack file
+     */
+    struct Header
+    {
+        std::uint32_t magic = PACK_MAGIC;     ///< PACK_MAGIC
+        std::uint32_t version = PACK_VERSION; ///< PACK_VERSION
+        std::uint32_t entryCount = 0;         ///< Table of contents records
+        std::uint32_t reserved = 0;           ///< Zero
+        std::uint64_t tocOffset = 0;          ///< Byte offset of the table of contents
+        std::uint64_t fileSize = 0;           ///< Total size, catches truncated files
+    };
+
+    /**
+     * @struct Entry
+     * @brief Table of contents record
+     */
+    struct Entry
+    {
+        char name[56] = {};                 ///< NUL-terminated name (usually the source path)
+        AssetType type = AssetType::Shader; ///< Payload kind
+        std::uint32_t params[4] = {};       ///< Type-specific parameters (see AssetType)
+        std::uint32_t reserved = 0;         ///< Zero
+        std::uint64_t offset = 0;           ///< Payload offset (multiple of PACK_ALIGNMENT)
+        std::uint64_t size = 0;             ///< Payload size in bytes
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(Entry) == 96, "pack layout changed");
+
+    /**
+     * @struct Pack
+     * @brief An open, read-only mapping of a pack file
+     */
+    struct Pack
+    {
+        const std::byte *data = nullptr; ///< Start of the mapping
+        std::size_t size = 0;            ///< Mapping size
+        std::span<const Entry> entries;  ///< Table of contents (inside the mapping)
+
+#ifdef _WIN32
+        void *file = nullptr;    ///< File HANDLE
+        void *mapping = nullptr; ///< File mapping HANDLE
+#else
+        int fd = -1; ///< File descriptor
+#endif
+
+        Pack() = default;
+        Pack(const Pack&) = delete;
+        Pack& operator=(const Pack&) = delete;
+    };
+
+    /**
+     * @struct BakeEntry
+     * @brief One asset to write into a pack
+     */
+    struct BakeEntry
+    {
+        std::string name;                      ///< Entry name (at most 55 bytes)
+        AssetType type = AssetType::Shader;    ///< Payload kind
+        std::array<std::uint32_t, 4> params{}; ///< Type-specific parameters
+        std::vector<std::byte> bytes;          ///< Payload
+    };
+
+    /**
+     * @brief Map a pack file and validate its header and table of contents
+     * @param path Pack file
+     * @param pack Output pack
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid pack
+     */
+    void openPack(const std::filesystem::path &path, Pack &pack);
+
+    /**
+     * @brief Unmap a pack (no-op if it is not open)
+     * @param pack Pack to close; pointers into it become invalid
+     */
+    void closePack(Pack &pack);
+
+    /**
+     * @brief Check whether a pack is mapped
+     * @param pack Pack
+     * @return true between openPack and closePack
+     */
+    bool isOpen(const Pack &pack);
+
+    /**
+     * @brief Look up an entry by name
+     * @param pack Open pack (a closed pack has no entries)
+     * @param name Entry name
+     * @param type Expected payload kind
+     * @return Entry, or nullptr if the pack has no such entry
+     */
+    const Entry *find(const Pack &pack, std::string_view name, AssetType type);
+
+    /**
+     * @brief Bytes of an entry, inside the mapping
+     * @param pack Open pack
+     * @param entry Entry of that pack
+     * @return Payload view (valid until closePack)
+     */
+    std::span<const std::byte> payload(const Pack &pack, const Entry &entry);
+
+    /**
+     * @brief View the baked scene mesh
+     * @param pack Open pack
+     * @param mesh Output view into the mapping
+     * @return true if the pack holds a mesh
+     */
+    bool findMesh(const Pack &pack, Mesh::MeshView &mesh);
+
+    /**
+     * @brief Write a pack file
+     * @param path Output file (written to a temporary file, then renamed)
+     * @param entries Assets to store, in table of contents order
+     * @throws std::runtime_error if a name is too long or the file cannot be written
+     */
+    void writePack(const std::filesystem::path &path, const std::vector<BakeEntry> &entries);
+
+    /**
+     * @brief Bake everything the demo scene loads at startup into a pack
+     * @param path Output pack file
+     * @param meshPath Mesh to bake (empty = built-in quad)
+     * @details Stores the compiled shaders, the decoded texture and the optimised, packed mesh
+     *          under the names the application looks them up by
+     */
+    void bakeSceneAssets(const std::filesystem::path &path, const std::string &meshPath);
+} // namespace AssetPack
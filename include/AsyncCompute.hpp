@@ -0,0 +1,173 @@
+/**
+ * @file AsyncCompute.hpp
+ * @brief Compute submissions on a queue of their own, overlapping the graphics frame
+ */
+
+#pragma once
+
+#include "Submit.hpp"
+#include "Synchronisation.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace AsyncCompute
+ * @brief Schedules per-frame compute work (culling, simulation) on the async compute family
+ * @details Each frame in flight records one compute command buffer from a pool of its own,
+ *          reset once that frame's graphics timeline value has passed: the graphics submission
+ *          waits on the compute one, so its completion implies the compute work's. The queue
+ *          signals its own timeline semaphore, which graphics submissions wait on at the stages
+ *          that consume the results; a second queue signalling the graphics timeline could
+ *          bring values out of order.
+ *
+ *          Buffers crossing between the families change ownership with a release barrier on
+ *          the source queue and a matching acquire on the destination queue. Results handed to
+ *          graphics every frame are released and acquired each time; buffers the compute work
+ *          fully overwrites go back without a transfer, since their contents are discarded.
+ *          Copies keep to the Upload context and its dedicated transfer queue.
+ */
+namespace AsyncCompute
+{
+    /**
+     * @struct Context
+     * @brief Async compute queue, its per-frame command buffers and timeline
+     */
+    struct Context
+    {
+        VkDevice device = VK_NULL_HANDLE;        ///< Logical device
+        VkQueue queue = VK_NULL_HANDLE;          ///< Async compute queue (null = disabled)
+        Submit::Batcher *batcher = nullptr;      ///< Takes the compute and hand-over submissions
+        std::uint32_t family = 0;                ///< Async compute family index
+        std::uint32_t graphicsFamily = 0;        ///< Family consuming the results
+        std::vector<VkCommandPool> pools;        ///< One transient pool per frame in flight
+        std::vector<VkCommandBuffer> commands;   ///< One command buffer per frame in flight
+        Synchronization::Timeline timeline;      ///< Signalled by every compute submission
+        VkCommandPool graphicsPool = VK_NULL_HANDLE;       ///< Pool for the hand-over release
+        VkCommandBuffer handOver = VK_NULL_HANDLE;         ///< Graphics-side release (once)
+        std::vector<VkBufferMemoryBarrier> pendingAcquire; ///< Acquires of the next submission
+        std::uint64_t pendingWait = 0; ///< Graphics timeline value the hand-over signals
+
+        /// True when the device has an async compute queue and it was enabled
+        bool enabled() const
+        {
+            return queue != VK_NULL_HANDLE;
+        }
+
+        Context() = default;
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+        Context(Context&&) = default;
+        Context& operator=(Context&&) = default;
+    };
+
+    /**
+     * @brief Create the command pools, command buffers and timeline of the compute queue
+     * @param device Logical device
+     * @param physicalDevice Physical device for queue family lookup
+     * @param surface Surface used for queue family selection
+     * @param queue Async compute queue (Device::createLogicalDevice)
+     * @param batcher Batcher the submissions go through (outlives the context)
+     * @param frameCount Number of frames in flight
+     * @param context Output context
+     * @throws std::runtime_error if a pool, buffer or the timeline cannot be created
+     */
+    void createContext(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        VkQueue queue,
+        Submit::Batcher &batcher,
+        std::uint32_t frameCount,
+        Context &context
+    );
+
+    /**
+     * @brief Destroy the context (no submission may still use it)
+     * @param context Context to destroy
+     */
+    void destroyContext(Context &context);
+
+    /**
+     * @brief Move buffers the graphics family owns to the compute family, once
+     * @param context Async compute context
+     * @param graphicsQueue Graphics queue the release is submitted to
+     * @param graphicsTimeline Graphics timeline, signalled by the release submission
+     * @param buffers Buffers whose contents the compute work reads (e.g. source instances)
+     * @details The matching acquires are recorded at the start of the next compute command
+     *          buffer, whose submission waits on the release. Call on the thread that submits
+     *          to graphicsQueue.
+     * @throws std::runtime_error if the release cannot be recorded
+     */
+    void handOverBuffers(
+        Context &context,
+        VkQueue graphicsQueue,
+        Synchronization::Timeline &graphicsTimeline,
+        std::span<const VkBuffer> buffers
+    );
+
+    /**
+     * @brief Begin the compute command buffer of a frame
+     * @param context Async compute context
+     * @param frameIndex Frame slot, whose graphics timeline value has passed
+     * @return Command buffer, begun, with any pending hand-over acquires recorded
+     * @throws std::runtime_error if recording cannot begin
+     */
+    VkCommandBuffer begin(Context &context, std::uint32_t frameIndex);
+
+    /**
+     * @brief End the compute command buffer of a frame and enqueue it on the batcher
+     * @param context Async compute context
+     * @param frameIndex Frame slot passed to begin
+     * @param graphicsTimeline Graphics timeline semaphore waited on before the work starts
+     * @param graphicsValue Value that must be reached first: the last graphics submission
+     *                      that read what this work overwrites (0 = none)
+     * @return Compute timeline value the submission signals
+     * @throws std::runtime_error if recording fails
+     */
+    std::uint64_t submit(
+        Context &context,
+        std::uint32_t frameIndex,
+        VkSemaphore graphicsTimeline,
+        std::uint64_t graphicsValue
+    );
+
+    /**
+     * @brief Record the release of buffers to another queue family
+     * @param commandBuffer Command buffer of the source family
+     * @param buffers Buffers (whole ranges) to release
+     * @param srcFamily Releasing family
+     * @param dstFamily Acquiring family
+     * @param srcStages Stages of the last writes
+     * @param srcAccess Those writes
+     */
+    void releaseBuffers(
+        VkCommandBuffer commandBuffer,
+        std::span<const VkBuffer> buffers,
+        std::uint32_t srcFamily,
+        std::uint32_t dstFamily,
+        VkPipelineStageFlags srcStages,
+        VkAccessFlags srcAccess
+    );
+
+    /**
+     * @brief Record the acquire matching releaseBuffers
+     * @param commandBuffer Command buffer of the destination family, submitted after a
+     *                      semaphore wait on the release
+     * @param buffers Buffers released, in any order
+     * @param srcFamily Releasing family
+     * @param dstFamily Acquiring family
+     * @param dstStages Stages of the first reads
+     * @param dstAccess Those reads
+     */
+    void acquireBuffers(
+        VkCommandBuffer commandBuffer,
+        std::span<const VkBuffer> buffers,
+        std::uint32_t srcFamily,
+        std::uint32_t dstFamily,
+        VkPipelineStageFlags dstStages,
+        VkAccessFlags dstAccess
+    );
+} // namespace AsyncCompute
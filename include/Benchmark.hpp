@@ -0,0 +1,104 @@
+/**
+ * @file Benchmark.hpp
+ * @brief Headless benchmark settings, frame-time percentiles and the JSON report
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace Benchmark
+ * @brief Reproducible frame-time measurements without a display
+ * @details The benchmark renders into offscreen images with the regular render pass and
+ *          pipeline. Animation advances by SIMULATED_FRAME_SECONDS per frame instead of with the
+ *          wall clock, so every run draws the same frames whatever the frame rate. The first
+ *          WARMUP_FRAMES frames (pipeline compilation, first uploads, driver warm-up) are left
+ *          out of the statistics.
+ */
+namespace Benchmark
+{
+    inline constexpr std::uint32_t WIDTH = 1920;  ///< Offscreen target width in pixels
+    inline constexpr std::uint32_t HEIGHT = 1080; ///< Offscreen target height in pixels
+
+    /// Simulated time between two frames
+    inline constexpr float SIMULATED_FRAME_SECONDS = 1.0f / 60.0f;
+
+    /// Frames rendered before measurements start
+    inline constexpr std::uint32_t WARMUP_FRAMES = 30;
+
+    /// Measured frames when none are requested
+    inline constexpr std::uint32_t DEFAULT_FRAMES = 1000;
+
+    /**
+     * @struct Summary
+     * @brief Distribution of one frame time, in milliseconds
+     */
+    struct Summary
+    {
+        std::uint32_t samples = 0; ///< Frames measured
+        double min = 0.0;          ///< Fastest frame
+        double median = 0.0;       ///< 50th percentile
+        double p99 = 0.0;          ///< 99th percentile (nearest rank)
+        double max = 0.0;          ///< Slowest frame
+        double mean = 0.0;         ///< Average
+    };
+
+    /**
+     * @struct MemoryPeak
+     * @brief High-water mark of one memory category
+     */
+    struct MemoryPeak
+    {
+        std::string category;    ///< Memory::categoryName
+        std::uint64_t bytes = 0; ///< Most bytes the category held at once
+    };
+
+    /**
+     * @struct Report
+     * @brief What was drawn, on which device, and how long it took
+     */
+    struct Report
+    {
+        std::string deviceName;          ///< VkPhysicalDeviceProperties::deviceName
+        std::string deviceUuid;          ///< Device::formatUuid, usable as --device
+        std::uint32_t driverVersion = 0; ///< Vendor-encoded driver version
+        std::uint32_t width = WIDTH;     ///< Render target width
+        std::uint32_t height = HEIGHT;   ///< Render target height
+        std::uint32_t frames = 0;        ///< Measured frames
+        std::uint32_t instances = 0;     ///< Objects drawn per frame
+        std::uint32_t draws = 0;         ///< Draw records per frame
+        std::uint32_t textures = 0;      ///< Distinct textures sampled
+        std::string drawPath;            ///< "direct", "indirect" or "gpu-cull"
+        std::uint32_t blendedDraws = 0;  ///< Draw records drawn with the blended pipeline
+        bool depthPrepass = false;       ///< Opaque draws were preceded by a depth pre-pass
+        std::string renderPath;          ///< "dynamic-rendering" or "render-pass"
+        bool asyncCompute = false;       ///< Culling ran on the async compute queue
+        double submitsPerFrame = 0.0;    ///< Queue submit calls per frame (Submit::Batcher)
+        double submitMs = 0.0;           ///< CPU time inside those calls per frame
+        float renderScale = 1.0f;        ///< Render scale at the end of the run
+        std::uint32_t sprites = 0;       ///< Sprites drawn over the scene per frame
+        std::uint32_t spriteDraws = 0;   ///< Indexed draws the sprites took (last frame)
+        double startupMs = 0.0;          ///< Launch to first frame submission
+        std::vector<MemoryPeak> memory;  ///< Peak bytes of every Memory::Category
+        Summary cpu;                     ///< drawFrame time on the CPU
+        Summary gpu;                     ///< "gpu frame" zone (samples = 0 without timestamps)
+    };
+
+    /**
+     * @brief Sort samples and compute their distribution
+     * @param samples Frame times in milliseconds (reordered)
+     * @return Summary (all zero when there are no samples)
+     */
+    Summary summarize(std::vector<double> &samples);
+
+    /**
+     * @brief Write the report as JSON
+     * @param report Report to write
+     * @param path Output file (empty = standard output)
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void writeReport(const Report &report, const std::string &path);
+} // namespace Benchmark
@@ -0,0 +1,142 @@
+/**
+ * @file Bindless.hpp
+ * @brief One descriptor set holding every texture and material, indexed from push constants
+ */
+
+#pragma once
+
+#include "Memory.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Bindless
+ * @brief Descriptor-indexing table bound once per frame instead of a set per material
+ * @details Set 1 of the pipeline layout: binding 0 is a storage buffer of Material records,
+ *          binding 1 a large, partially bound combined-image-sampler array. Draws select a
+ *          material with GraphicsPipeline::DrawConstants; the material names its texture slot.
+ *          The array is update-after-bind and update-unused-while-pending, so textures are
+ *          added while frames using other slots are in flight. Each frame slot has its own
+ *          set and its own region of the material buffer, so a record can change while
+ *          earlier frames still read the old one. Requires Device::supportsBindless.
+ */
+namespace Bindless
+{
+    /// Texture slots requested (clamped to the device's update-after-bind limits)
+    inline constexpr std::uint32_t MAX_TEXTURES = 4096;
+
+    /// Entries of the material table
+    inline constexpr std::uint32_t MAX_MATERIALS = 1024;
+
+    /**
+     * @struct Material
+     * @brief One material table entry (std430 layout of shaders/bindless.frag)
+     */
+    struct Material
+    {
+        float baseColor[4] = {1.0f, 1.0f, 1.0f, 1.0f}; ///< RGBA multiplied with the texture
+        std::uint32_t textureIndex = 0;                ///< Slot in the texture array
+        std::uint32_t padding[3] = {};                 ///< Array stride of 32 bytes
+    };
+
+    /**
+     * @struct Table
+     * @brief The bindless descriptor set, its texture slots and the material buffer
+     */
+    struct Table
+    {
+        VkDevice device = VK_NULL_HANDLE;              ///< Logical device
+        Memory::Allocator *allocator = nullptr;        ///< Allocator of the material buffer
+        VkDescriptorSetLayout layout = VK_NULL_HANDLE; ///< Set 1 layout
+        VkDescriptorPool pool = VK_NULL_HANDLE;        ///< Update-after-bind pool of the sets
+        std::vector<VkDescriptorSet> sets;             ///< One set per frame slot
+
+        std::uint32_t textureCapacity = 0;       ///< Slots in the texture array
+        std::uint32_t textureCount = 0;          ///< Slots ever handed out
+        std::vector<std::uint32_t> freeTextures; ///< Removed slots, reused first
+
+        VkBuffer materialBuffer = VK_NULL_HANDLE; ///< Material records (storage buffer)
+        Memory::Allocation materialMemory;        ///< Host-visible, persistently mapped
+        VkDeviceSize regionSize = 0;              ///< Bytes of one frame slot's records
+        std::vector<Material> materials;          ///< Current records, copied out per slot
+        std::uint32_t materialCount = 0;          ///< Materials added
+
+        /// Per frame slot: records changed since the slot's region was last written
+        std::vector<std::vector<std::uint32_t>> staleMaterials;
+
+        Table() = default;
+        Table(const Table&) = delete;
+        Table& operator=(const Table&) = delete;
+    };
+
+    /**
+     * @brief Create the layout, the sets and the material buffer
+     * @param device Logical device (bindless features enabled)
+     * @param physicalDevice Physical device for descriptor limits
+     * @param allocator Allocator for the material buffer
+     * @param frameCount Frames in flight (one set and material region each)
+     * @param table Output table
+     * @throws std::runtime_error if any object cannot be created
+     */
+    void createTable(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        std::uint32_t frameCount,
+        Table &table
+    );
+
+    /**
+     * @brief Destroy the table
+     * @param table Table to destroy (no frame using it may be in flight)
+     */
+    void destroyTable(Table &table);
+
+    /**
+     * @brief Bring a frame slot's material region up to date
+     * @param table Table
+     * @param frameIndex Frame slot about to record (its previous frame has retired)
+     * @return The slot's set, to bind as set 1
+     */
+    VkDescriptorSet beginFrame(Table &table, std::uint32_t frameIndex);
+
+    /**
+     * @brief Write a texture into a free slot
+     * @param table Table
+     * @param view Image view (SHADER_READ_ONLY_OPTIMAL when sampled)
+     * @param sampler Sampler
+     * @return Slot index for Material::textureIndex
+     * @throws std::runtime_error if every slot is taken
+     */
+    std::uint32_t addTexture(Table &table, VkImageView view, VkSampler sampler);
+
+    /**
+     * @brief Return a slot for reuse
+     * @param table Table
+     * @param index Slot to free (no submitted frame may still sample it, so defer this past
+     *              the frames that did)
+     */
+    void removeTexture(Table &table, std::uint32_t index);
+
+    /**
+     * @brief Append a material
+     * @param table Table
+     * @param material Material record
+     * @return Index for GraphicsPipeline::DrawConstants::materialIndex
+     * @throws std::runtime_error if the table is full
+     */
+    std::uint32_t addMaterial(Table &table, const Material &material);
+
+    /**
+     * @brief Overwrite a material
+     * @param table Table
+     * @param index Material to change
+     * @param material New record
+     * @details Each frame slot picks the record up in Bindless::beginFrame. Frames in flight
+     *          keep reading the old one, so every texture slot it names must stay valid until
+     *          those frames retire.
+     */
+    void setMaterial(Table &table, std::uint32_t index, const Material &material);
+} // namespace Bindless
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include "Descriptors.hpp"
+#include "Memory.hpp"
+#include "Upload.hpp"
 #include "glm/ext/matrix_float4x4.hpp"
 #include <array>
 #define GLM_FORCE_RADIANS
@@ -31,14 +34,14 @@ namespace Buffer
 
         /**
          * @struct UniformBufferObject
-         * @brief Transformation matrices passed to vertex shader
-         * @details Matrices must be 16-byte aligned for std140 layout in GLSL
+         * @brief Camera matrices shared by every draw of a frame
+         * @details Matrices must be 16-byte aligned for std140 layout in GLSL. Model matrices
+         *          are per draw and travel as push constants (GraphicsPipeline::DrawConstants).
          */
         struct UniformBufferObject
         {
-            alignas(16) glm::mat4 model; ///< Model matrix (object to world transform)
-            alignas(16) glm::mat4 view;  ///< View matrix (world to camera transform)
-            alignas(16) glm::mat4 proj;  ///< Projection matrix (camera to clip space)
+            alignas(16) glm::mat4 view; ///< View matrix (world to camera transform)
+            alignas(16) glm::mat4 proj; ///< Projection matrix (camera to clip space)
         };
 
         /**
@@ -83,6 +86,50 @@ namespace Buffer
         }
     };
 
+    /**
+     * @struct Instance
+     * @brief Per-instance data read from vertex binding 1 (VK_VERTEX_INPUT_RATE_INSTANCE)
+     */
+    struct Instance
+    {
+        glm::vec4 offsetScale{0.0f, 0.0f, 0.0f, 1.0f}; ///< xyz translation, w uniform scale
+        glm::vec4 tint{1.0f, 1.0f, 1.0f, 1.0f};        ///< RGBA multiplied with the texture
+
+        /**
+         * @brief Get instance input binding description
+         * @return Binding description for the instance buffer (binding 1)
+         */
+        static VkVertexInputBindingDescription getBindingDescription()
+        {
+            VkVertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 1;
+            bindingDescription.stride = sizeof(Instance);
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+            return bindingDescription;
+        }
+
+        /**
+         * @brief Get instance attribute descriptions
+         * @return Array of 2 attribute descriptions (offsetScale, tint) at locations 3 and 4
+         */
+        static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+        {
+            std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+
+            attributeDescriptions[0].binding = 1;
+            attributeDescriptions[0].location = 3;
+            attributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[0].offset = offsetof(Instance, offsetScale);
+
+            attributeDescriptions[1].binding = 1;
+            attributeDescriptions[1].location = 4;
+            attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+            attributeDescriptions[1].offset = offsetof(Instance, tint);
+
+            return attributeDescriptions;
+        }
+    };
+
     /// Quad vertices (two triangles) with position, color, and texture coordinates
     const std::vector<Vertex> vertices =
         {{{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}}, ///< Bottom-left (red)
@@ -96,143 +143,207 @@ namespace Buffer
     /**
      * @brief Create vertex buffer on GPU with staging buffer transfer
      * @param device Logical device
-     * @param physicalDevice Physical device for memory properties
+     * @param allocator Device memory allocator
+     * @param vertexData Vertex bytes (Vertex or Mesh::PackedVertex elements)
+     * @param size Number of bytes
      * @param vertexBuffer Output vertex buffer handle
-     * @param vertexBufferMemory Output memory handle
-     * @param commandPool Command pool for transfer operations
-     * @param graphicsQueue Queue for executing transfer commands
-     * @details Uses staging buffer in host-visible memory, then transfers to device-local memory
+     * @param vertexAllocation Output memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @details Uses staging buffer in host-visible memory, then transfers to device-local memory.
+     *          The copy is recorded into the current upload batch
      */
     void createVertexBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const void *vertexData,
+        VkDeviceSize size,
         VkBuffer &vertexBuffer,
-        VkDeviceMemory &vertexBufferMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocation &vertexAllocation,
+        Upload::Context &uploads
     );
 
     /**
      * @brief Create index buffer on GPU with staging buffer transfer
      * @param device Logical device
-     * @param physicalDevice Physical device for memory properties
+     * @param allocator Device memory allocator
+     * @param indexData Index bytes (16- or 32-bit elements)
+     * @param size Number of bytes
      * @param indexBuffer Output index buffer handle
-     * @param indexBufferMemory Output memory handle
-     * @param commandPool Command pool for transfer operations
-     * @param graphicsQueue Queue for executing transfer commands
-     * @details Transfers index data from CPU to GPU using staging buffer
+     * @param indexAllocation Output memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @details Transfers index data from CPU to GPU using staging buffer.
+     *          The copy is recorded into the current upload batch
      */
     void createIndexBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const void *indexData,
+        VkDeviceSize size,
         VkBuffer &indexBuffer,
-        VkDeviceMemory &indexBufferMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocation &indexAllocation,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Lay out instances on a square grid centred on the origin
+     * @param count Number of instances
+     * @return Instances filling [-1, 1] in X and Y (a single instance is the identity)
+     */
+    std::vector<Instance> createInstanceGrid(std::uint32_t count);
+
+    /**
+     * @brief Create a device-local buffer and upload its initial contents
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param data Source bytes
+     * @param size Number of bytes
+     * @param usage Buffer usage (TRANSFER_DST is added)
+     * @param dstStage Stage that first consumes the buffer
+     * @param dstAccess Access of that first use
+     * @param buffer Output buffer handle
+     * @param allocation Output memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @param category Category the memory is counted against
+     */
+    void createDeviceBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *data,
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess,
+        VkBuffer &buffer,
+        Memory::Allocation &allocation,
+        Upload::Context &uploads,
+        Memory::Category category
+    );
+
+    /**
+     * @brief Create the per-instance vertex buffer (binding 1)
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param instances Instance data
+     * @param instanceBuffer Output instance buffer handle
+     * @param instanceAllocation Output memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @details Also a storage buffer, read by the GPU cull pass
+     */
+    void createInstanceBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const std::vector<Instance> &instances,
+        VkBuffer &instanceBuffer,
+        Memory::Allocation &instanceAllocation,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Create a buffer of VkDrawIndexedIndirectCommand records
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param commands Initial draw commands
+     * @param indirectBuffer Output indirect buffer handle
+     * @param indirectAllocation Output memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @details Also usable as a storage buffer so GPU passes can rewrite the commands
+     */
+    void createIndirectBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const std::vector<VkDrawIndexedIndirectCommand> &commands,
+        VkBuffer &indirectBuffer,
+        Memory::Allocation &indirectAllocation,
+        Upload::Context &uploads
     );
 
     /**
      * @brief Create a Vulkan buffer with specified usage and memory properties
      * @param device Logical device
-     * @param physicalDevice Physical device for querying memory types
+     * @param allocator Device memory allocator to sub-allocate from
      * @param size Size of buffer in bytes
      * @param usage Buffer usage flags (vertex, index, uniform, transfer, etc.)
      * @param properties Memory property flags (device local, host visible, etc.)
-     * @param vertexBuffer Output buffer handle
-     * @param vertexBufferMemory Output memory handle
+     * @param buffer Output buffer handle
+     * @param allocation Output memory sub-allocation (mapped if host visible)
+     * @param category Category the memory is counted against
      * @details Generic buffer creation utility used by all buffer types
      */
     void createBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
         VkDeviceSize size,
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
-        VkBuffer &vertexBuffer,
-        VkDeviceMemory &vertexBufferMemory
+        VkBuffer &buffer,
+        Memory::Allocation &allocation,
+        Memory::Category category
     );
 
     /**
-     * @brief Copy data from one buffer to another using command buffer
+     * @brief Destroy a buffer and return its memory to the allocator
      * @param device Logical device
+     * @param allocator Allocator the buffer memory came from
+     * @param buffer Buffer to destroy (reset to VK_NULL_HANDLE)
+     * @param allocation Memory sub-allocation to free
+     */
+    void destroyBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        VkBuffer &buffer,
+        Memory::Allocation &allocation
+    );
+
+    /**
+     * @brief Record a copy from one buffer to another
+     * @param commandBuffer Command buffer in recording state
      * @param srcBuffer Source buffer
      * @param dstBuffer Destination buffer
      * @param size Number of bytes to copy
-     * @param commandPool Command pool for allocation
-     * @param graphicsQueue Queue to submit copy command
-     * @details Uses single-time command buffer for transfer operation
      */
     void copyBuffer(
-        VkDevice &device,
-        VkBuffer srcBuffer,
-        VkBuffer dstBuffer,
-        VkDeviceSize size,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
     );
 
     /**
      * @brief Find suitable memory type index
-     * @param physicalDevice Physical device to query
+     * @param memProperties Cached physical device memory properties
      * @param typeFilter Bit field of suitable memory types
      * @param properties Required memory properties
      * @return Index of suitable memory type
      * @throws std::runtime_error if no suitable memory type found
      */
     std::uint32_t findMemoryType(
-        VkPhysicalDevice &physicalDevice, std::uint32_t typeFilter, VkMemoryPropertyFlags properties
+        const VkPhysicalDeviceMemoryProperties &memProperties,
+        std::uint32_t typeFilter,
+        VkMemoryPropertyFlags properties
     );
 
     /**
-     * @brief Create descriptor set layout
-     * @param device Logical device
+     * @brief Get the frame descriptor set layout from the layout cache
+     * @param layouts Layout cache (owns the layout)
      * @param descriptorLayout Output descriptor set layout
-     * @details Defines bindings for uniform buffer (MVP matrices) and combined image sampler (texture)
-     */
-    void createDescriptorSetLayout(VkDevice &device, VkDescriptorSetLayout &descriptorLayout);
-
-    /**
-     * @brief Create uniform buffers for each frame in flight
-     * @param device Logical device
-     * @param physicalDevice Physical device for memory queries
-     * @param uniformBuffers Output vector of uniform buffers
-     * @param uniformBuffersMemory Output vector of memory handles
-     * @param uniformBuffersMapped Output vector of mapped pointers for updates
-     * @details Creates persistently mapped host-visible buffers for efficient per-frame updates
+     * @details Defines bindings for a dynamic uniform buffer (camera matrices) and a combined
+     *          image sampler (texture)
      */
-    void createUniformBuffers(
-        VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
-        std::vector<VkBuffer> &uniformBuffers,
-        std::vector<VkDeviceMemory> &uniformBuffersMemory,
-        std::vector<void *> &uniformBuffersMapped
+    void createDescriptorSetLayout(
+        Descriptors::LayoutCache &layouts, VkDescriptorSetLayout &descriptorLayout
     );
 
     /**
-     * @brief Create descriptor pool for allocating descriptor sets
-     * @param device Logical device
-     * @param descriptorPool Output descriptor pool
-     * @details Sized for MAX_FRAMES_IN_FLIGHT descriptor sets with uniform buffer and sampler bindings
-     */
-    void createDescriptorPool(VkDevice &device, VkDescriptorPool &descriptorPool);
-
-    /**
-     * @brief Create and update descriptor sets
+     * @brief Point a descriptor set at the uniform ring and the texture
      * @param device Logical device
-     * @param descriptorPool Pool to allocate from
-     * @param descriptorSets Output vector of descriptor sets
-     * @param descriptorSetLayout Layout defining bindings
-     * @param uniformBuffers Uniform buffers to bind
-     * @param textureImageView Texture image view to bind
-     * @param textureSampler Texture sampler to bind
-     * @details Creates one descriptor set per frame in flight, linking shaders to resources
+     * @param descriptorSet Descriptor set to update
+     * @param uniformBuffer Uniform ring bound at binding 0 (one UniformBufferObject from the
+     *                      dynamic offset given at bind time)
+     * @param textureImageView Texture image view bound at binding 1
+     * @param textureSampler Texture sampler bound at binding 1
+     * @details Links shaders to resources; sets are rewritten after their pool is reset
      */
-    void createDescriptorSets(
+    void writeDescriptorSet(
         VkDevice &device,
-        VkDescriptorPool &descriptorPool,
-        std::vector<VkDescriptorSet> &descriptorSets,
-        VkDescriptorSetLayout &descriptorSetLayout,
-        std::vector<VkBuffer> &uniformBuffers,
+        VkDescriptorSet descriptorSet,
+        VkBuffer uniformBuffer,
         VkImageView &textureImageView,
         VkSampler &textureSampler
     );
@@ -5,7 +5,12 @@
 
 #pragma once
 
+#include "JobSystem.hpp"
+
 #include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <span>
 #include <vector>
 #include <vulkan/vulkan.h>
 
@@ -15,19 +20,149 @@
  */
 namespace Command
 {
+    /// Draw count from which the frame is recorded into secondary buffers on worker threads
+    inline constexpr std::size_t PARALLEL_RECORD_THRESHOLD = 256;
+
+    /// Smallest slice of the draw list recorded into one secondary command buffer
+    inline constexpr std::size_t MIN_DRAWS_PER_JOB = 64;
+
+    /**
+     * @struct DrawItem
+     * @brief One indexed draw of the frame's draw list
+     */
+    struct DrawItem
+    {
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;       ///< Vertex buffer bound at binding 0
+        VkBuffer indexBuffer = VK_NULL_HANDLE;        ///< Index buffer
+        VkIndexType indexType = VK_INDEX_TYPE_UINT16; ///< Index element type
+        std::uint32_t indexCount = 0;                 ///< Number of indices to draw
+        std::uint32_t firstIndex = 0;                 ///< First index in the index buffer
+        std::int32_t vertexOffset = 0;                ///< Value added to each index
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;     ///< Buffer::Instance data at binding 1
+        std::uint32_t instanceCount = 1;              ///< Number of instances to draw
+        std::uint32_t firstInstance = 0;              ///< First instance in the instance buffer
+        std::uint32_t materialIndex = 0;              ///< Pushed as DrawConstants when it changes
+        glm::mat4 model{1.0f};                        ///< Pushed as DrawConstants when it changes
+        glm::vec3 center{0.0f};                       ///< Object-space centre (sort key)
+        float distance = 0.0f;                        ///< View-space depth, set by sortDraws
+        bool blended = false;                         ///< Drawn with the blended pipeline
+    };
+
+    /**
+     * @struct IndirectDraw
+     * @brief A batch of indexed draws whose arguments live in a GPU buffer
+     * @details One record costs one CPU call however many objects it draws. With a count
+     *          buffer, vkCmdDrawIndexedIndirectCount reads the draw count from the GPU as well
+     *          (requires the drawIndirectCount feature). Without multiDrawIndirect the records
+     *          are issued one call each.
+     */
+    struct IndirectDraw
+    {
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;       ///< Vertex buffer bound at binding 0
+        VkBuffer indexBuffer = VK_NULL_HANDLE;        ///< Index buffer
+        VkIndexType indexType = VK_INDEX_TYPE_UINT16; ///< Index element type
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;     ///< Buffer::Instance data at binding 1
+        VkBuffer argumentBuffer = VK_NULL_HANDLE;     ///< VkDrawIndexedIndirectCommand records
+        VkDeviceSize argumentOffset = 0;              ///< Byte offset of the first record
+        std::uint32_t drawCount = 0;                  ///< Records to draw (maximum with a count)
+        VkBuffer countBuffer = VK_NULL_HANDLE;        ///< Optional GPU-written uint32 draw count
+        VkDeviceSize countOffset = 0;                 ///< Byte offset of the count
+        std::uint32_t materialIndex = 0;              ///< Material of every record in the batch
+        glm::mat4 model{1.0f};                        ///< Transform of every record in the batch
+        bool multiDraw = true;                        ///< Device has multiDrawIndirect
+
+        /// Byte stride between records
+        std::uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    };
+
+    /**
+     * @struct DrawPipelines
+     * @brief Pipelines the render pass switches between
+     * @details Opaque draws and GPU-sourced draws use opaque, blended draws blended. With a
+     *          depth pre-pass the opaque and GPU-sourced draws are first recorded with
+     *          depthPrepass, so the color pass shades each pixel once.
+     */
+    struct DrawPipelines
+    {
+        VkPipeline depthPrepass = VK_NULL_HANDLE; ///< Depth-only pipeline (null = no pre-pass)
+        VkPipeline opaque = VK_NULL_HANDLE;       ///< Depth-tested, not blended
+        VkPipeline blended = VK_NULL_HANDLE;      ///< Alpha blended, depth-tested, not written
+    };
+
+    /**
+     * @struct RenderTarget
+     * @brief Attachments the render pass draws into, as a render pass object or dynamically
+     * @details With beginRendering set the pass is a vkCmdBeginRendering instance over the
+     *          views, and renderPass and framebuffer are unused; otherwise the views and formats
+     *          are unused
+     */
+    struct RenderTarget
+    {
+        VkRenderPass renderPass = VK_NULL_HANDLE;   ///< Render pass object (legacy path)
+        VkFramebuffer framebuffer = VK_NULL_HANDLE; ///< Its framebuffer (legacy path)
+        VkImageView colorView = VK_NULL_HANDLE;     ///< Colour attachment (dynamic path)
+        VkImageView depthView = VK_NULL_HANDLE;     ///< Depth attachment (dynamic path)
+        VkFormat colorFormat = VK_FORMAT_UNDEFINED; ///< Colour format (secondary inheritance)
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED; ///< Depth format (secondary inheritance)
+
+        /// Load operations of the attachments (RenderGraph::Access::load)
+        VkAttachmentLoadOp colorLoad = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        VkAttachmentLoadOp depthLoad = VK_ATTACHMENT_LOAD_OP_CLEAR;
+
+        /// Store operations of the attachments (RenderGraph::storeOp)
+        VkAttachmentStoreOp colorStore = VK_ATTACHMENT_STORE_OP_STORE;
+        VkAttachmentStoreOp depthStore = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        VkExtent2D extent = {}; ///< Render area
+
+        PFN_vkCmdBeginRendering beginRendering = nullptr; ///< Dynamic rendering when set
+        PFN_vkCmdEndRendering endRendering = nullptr;     ///< Ends the dynamic instance
+    };
+
+    /**
+     * @struct WorkerCommands
+     * @brief Command pool owned by one worker thread for one frame in flight
+     * @details The pool is reset as a whole once the frame's fence has signaled, so its
+     *          secondary buffers are reused without per-buffer resets
+     */
+    struct WorkerCommands
+    {
+        VkCommandPool pool = VK_NULL_HANDLE;      ///< Transient pool (graphics family)
+        std::vector<VkCommandBuffer> secondaries; ///< Secondary buffers allocated so far
+        std::uint32_t used = 0;                   ///< Secondaries handed out this frame
+    };
+
+    /**
+     * @struct ParallelRecorder
+     * @brief Per-frame, per-thread command pools for multithreaded recording
+     */
+    struct ParallelRecorder
+    {
+        VkDevice device = VK_NULL_HANDLE;                ///< Logical device
+        std::vector<std::vector<WorkerCommands>> frames; ///< Indexed [frame][workerIndex]
+        std::vector<VkCommandBuffer> recorded;           ///< Secondaries in draw-list order
+
+        ParallelRecorder() = default;
+        ParallelRecorder(const ParallelRecorder&) = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+    };
+
     /**
      * @brief Create command pool for allocating command buffers
      * @param device Logical device
      * @param physicalDevice Physical device for queue family queries
      * @param surface Surface for queue family selection
      * @param commandPool Output command pool handle
-     * @details Creates pool with RESET_COMMAND_BUFFER flag for per-frame recording
+     * @param flags Pool creation flags (RESET_COMMAND_BUFFER for per-buffer resets,
+     *              TRANSIENT for pools reset as a whole every frame)
+     * @details Creates pool on the graphics queue family
      */
     void createCommandPool(
         VkDevice &device,
         VkPhysicalDevice &physicalDevice,
         VkSurfaceKHR &surface,
-        VkCommandPool &commandPool
+        VkCommandPool &commandPool,
+        VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
     );
 
     /**
@@ -46,30 +181,92 @@ namespace Command
     );
 
     /**
-     * @brief Record rendering commands into command buffer
-     * @param commandBuffer Command buffer to record into
-     * @param renderPass Render pass to use
-     * @param framebuffer Framebuffer containing attachments
-     * @param extent Render area extent
-     * @param graphicsPipeline Graphics pipeline to bind
-     * @param pipelineLayout Pipeline layout for descriptor sets
-     * @param vertexBuffer Vertex buffer to bind
-     * @param indexBuffer Index buffer to bind
-     * @param descriptorSets Descriptor sets to bind
-     * @param currentFrame Current frame index for descriptor set selection
-     * @details Records begin/end render pass, pipeline binding, draw calls
+     * @brief Create one command pool per worker thread and frame in flight
+     * @param device Logical device
+     * @param physicalDevice Physical device for queue family queries
+     * @param surface Surface for queue family selection
+     * @param frameCount Number of frames in flight
+     * @param threadCount Number of threads that record (Jobs::threadCount)
+     * @param recorder Output recorder state
+     */
+    void createParallelRecorder(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        std::uint32_t frameCount,
+        std::uint32_t threadCount,
+        ParallelRecorder &recorder
+    );
+
+    /**
+     * @brief Destroy every worker command pool
+     * @param recorder Recorder to destroy (its frames must no longer be in flight)
+     */
+    void destroyParallelRecorder(ParallelRecorder &recorder);
+
+    /**
+     * @brief Order a draw list for the render pass: opaque draws front to back, then blended
+     *        draws back to front
+     * @param drawItems Draw list to reorder
+     * @param view World to view transform of the frame
+     * @details Distance is the view-space depth of each draw's centre. Opaque draws nearest
+     *          first let the depth test reject what they hide before it is shaded; blended
+     *          draws farthest first composite correctly over each other.
+     */
+    void sortDraws(std::vector<DrawItem> &drawItems, const glm::mat4 &view);
+
+    /**
+     * @brief Record a frame's primary command buffer
+     * @param commandBuffer Command buffer to record into (its pool was reset)
+     * @param record Commands of the frame, e.g. RenderGraph::execute
+     * @throws std::runtime_error if recording cannot begin or end
      */
     void recordCommandBuffer(
-        VkCommandBuffer &commandBuffer,
-        VkRenderPass &renderPass,
-        VkFramebuffer &framebuffer,
-        VkExtent2D &extent,
-        VkPipeline &graphicsPipeline,
+        VkCommandBuffer &commandBuffer, const std::function<void(VkCommandBuffer)> &record
+    );
+
+    /**
+     * @brief Record the render pass: begin, the frame's draws, end
+     * @param commandBuffer Primary command buffer of the frame, being recorded
+     * @param target Attachments and render area, as a render pass or dynamic rendering
+     * @param pipelines Pipelines of the pre-pass, opaque and blended draws
+     * @param pipelineLayout Pipeline layout for descriptor sets
+     * @param descriptorSets Sets bound from set 0: the frame's set, then the bindless table
+     * @param dynamicOffsets Offsets of the sets' dynamic uniform buffers, in binding order
+     * @param currentFrame Current frame index for worker pool selection
+     * @param drawItems Draws to record, opaque ones first (sortDraws)
+     * @param indirectDraws GPU-sourced draws, opaque, recorded after the opaque drawItems
+     * @param jobs Job system running the secondary recordings
+     * @param recorder Worker command pools
+     * @param pipelineStatistics Statistics of the query active around the pass, inherited by
+     *                           the secondaries (0 = none; nonzero needs inheritedQueries)
+     * @param overlay Commands recorded after the draws, inside the pass with the frame state
+     *                bound (e.g. Sprites::record; empty = none)
+     * @details Records begin/end render pass, pipeline binding, draw calls: the depth
+     *          pre-pass when enabled, the opaque draws, the GPU-sourced draws, the blended
+     *          draws and the overlay, in that order and all in the one subpass. From
+     *          PARALLEL_RECORD_THRESHOLD draws on, slices of the draw list are recorded into
+     *          secondary buffers on the worker threads and executed in order with
+     *          VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS (or, with dynamic rendering,
+     *          VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT and the attachment
+     *          formats inherited instead of the render pass). The frame's fence must have
+     *          signaled, since the frame's worker pools are reset here. Barriers around the
+     *          pass come from the render graph it is a pass of.
+     */
+    void recordRenderPass(
+        VkCommandBuffer commandBuffer,
+        const RenderTarget &target,
+        const DrawPipelines &pipelines,
         VkPipelineLayout &pipelineLayout,
-        VkBuffer &vertexBuffer,
-        VkBuffer &indexBuffer,
-        std::vector<VkDescriptorSet> &descriptorSets,
-        std::uint32_t currentFrame
+        std::span<const VkDescriptorSet> descriptorSets,
+        std::span<const std::uint32_t> dynamicOffsets,
+        std::uint32_t currentFrame,
+        const std::vector<DrawItem> &drawItems,
+        const std::vector<IndirectDraw> &indirectDraws,
+        Jobs::JobSystem &jobs,
+        ParallelRecorder &recorder,
+        VkQueryPipelineStatisticFlags pipelineStatistics,
+        const std::function<void(VkCommandBuffer)> &overlay = {}
     );
 
     /**
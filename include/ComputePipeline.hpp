@@ -0,0 +1,57 @@
+/**
+ * @file ComputePipeline.hpp
+ * @brief Compute pipeline creation
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+/**
+ * @namespace ComputePipeline
+ * @brief Creates compute pipelines and their layouts
+ */
+namespace ComputePipeline
+{
+    /**
+     * @brief Create a compute pipeline layout with one descriptor set and push constants
+     * @param device Logical device
+     * @param descriptorSetLayout Descriptor set layout for the shader's buffers
+     * @param pushConstantSize Bytes of push constants visible to the compute stage (0 = none)
+     * @param pipelineLayout Output pipeline layout
+     */
+    void createPipelineLayout(
+        VkDevice &device,
+        VkDescriptorSetLayout &descriptorSetLayout,
+        std::uint32_t pushConstantSize,
+        VkPipelineLayout &pipelineLayout
+    );
+
+    /**
+     * @brief Create a compute pipeline from an already created shader module
+     * @param device Logical device
+     * @param shaderModule Compute shader module (entry point "main")
+     * @param pipelineLayout Pipeline layout (storage buffers, push constants)
+     * @param pipelineCache Cache consulted and filled by the driver (VK_NULL_HANDLE = none)
+     * @return Compute pipeline
+     * @throws std::runtime_error if pipeline creation fails
+     */
+    VkPipeline createComputePipeline(
+        VkDevice device,
+        VkShaderModule shaderModule,
+        VkPipelineLayout pipelineLayout,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
+    );
+
+    /**
+     * @brief Number of workgroups covering a range of items
+     * @param itemCount Items to process
+     * @param groupSize Invocations per workgroup (local_size_x)
+     * @return Workgroup count rounded up
+     */
+    constexpr std::uint32_t groupCount(std::uint32_t itemCount, std::uint32_t groupSize)
+    {
+        return (itemCount + groupSize - 1) / groupSize;
+    }
+} // namespace ComputePipeline
@@ -0,0 +1,144 @@
+/**
+ * @file Culling.hpp
+ * @brief GPU frustum culling that compacts visible instances and writes indirect arguments
+ */
+
+#pragma once
+
+#include "Buffer.hpp"
+#include "Descriptors.hpp"
+#include "Memory.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Culling
+ * @brief Compute pass recorded before the render pass that decides which instances are drawn
+ * @details Every instance's bounding sphere is tested against the six frustum planes. Visible
+ *          instances are appended to a compacted instance buffer and counted into the
+ *          instanceCount of a VkDrawIndexedIndirectCommand, so the CPU never touches
+ *          per-object visibility: the draw is one vkCmdDrawIndexedIndirect over the output.
+ */
+namespace Culling
+{
+    /// Path to compiled culling shader (SPIR-V)
+    constexpr std::string_view cullShaderPath = "build/shaders/cull.comp.spv";
+
+    /// Invocations per workgroup (local_size_x of cull.comp)
+    inline constexpr std::uint32_t CULL_GROUP_SIZE = 64;
+
+    /// Frustum planes: xyz inward normal, w distance (left, right, bottom, top, near, far)
+    using Frustum = std::array<glm::vec4, 6>;
+
+    /**
+     * @struct PushConstants
+     * @brief Per-dispatch constants, laid out as CullConstants in cull.comp
+     */
+    struct PushConstants
+    {
+        Frustum planes;              ///< Frustum in the instances' space
+        std::uint32_t instanceCount; ///< Source instances to test
+        float boundingRadius;        ///< Mesh bounding radius at scale 1
+    };
+
+    /**
+     * @struct Output
+     * @brief One set of culling results and the descriptor set writing them
+     */
+    struct Output
+    {
+        VkBuffer visibleBuffer = VK_NULL_HANDLE;        ///< Compacted instances (binding 1)
+        Memory::Allocation visibleMemory;               ///< Memory backing visibleBuffer
+        VkBuffer argumentBuffer = VK_NULL_HANDLE;       ///< One VkDrawIndexedIndirectCommand
+        Memory::Allocation argumentMemory;              ///< Memory backing argumentBuffer
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE; ///< Written once at creation
+    };
+
+    /**
+     * @struct CullPass
+     * @brief Compute pipeline, descriptors and output buffers of the culling pass
+     */
+    struct CullPass
+    {
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE; ///< Source, visible, arguments (cached)
+        VkPipelineLayout layout = VK_NULL_HANDLE;         ///< Set 0 plus PushConstants
+        VkPipeline pipeline = VK_NULL_HANDLE;             ///< cull.comp
+        VkBuffer sourceBuffer = VK_NULL_HANDLE;           ///< Instances tested (not owned)
+        std::vector<Output> outputs;                      ///< One per frame in flight
+
+        std::uint32_t instanceCount = 0; ///< Source instances tested per dispatch
+        std::uint32_t indexCount = 0;    ///< Index count of the culled mesh
+        float boundingRadius = 0.0f;     ///< Mesh bounding radius at scale 1
+    };
+
+    /**
+     * @brief Extract the frustum planes of a clip-from-local matrix
+     * @param clipFromLocal proj * view * model
+     * @return Normalised planes in local space, so sphere tests use the true radius
+     * @details Gribb/Hartmann extraction for the OpenGL depth range glm::perspective produces
+     */
+    Frustum extractFrustum(const glm::mat4 &clipFromLocal);
+
+    /**
+     * @brief Create the culling pipeline and its output buffers
+     * @param device Logical device
+     * @param allocator Allocator for the visible instance and argument buffers
+     * @param layouts Layout cache the set layout comes from
+     * @param descriptors Persistent descriptor allocator the set comes from (freed with it)
+     * @param shaderModule cull.comp module (owned by the caller)
+     * @param pipelineCache Pipeline cache (VK_NULL_HANDLE = none)
+     * @param sourceInstances Buffer::Instance storage buffer to cull
+     * @param instanceCount Number of source instances
+     * @param indexCount Index count written into the draw arguments
+     * @param boundingRadius Mesh bounding radius at scale 1 (Mesh::MeshData::boundingRadius;
+     *                       source instance scales include the mesh's scale)
+     * @param outputCount Output sets, one per frame in flight: a frame's dispatch then never
+     *                    waits on the draws of the frames before it
+     * @param pass Output pass
+     */
+    void createCullPass(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        Descriptors::LayoutCache &layouts,
+        Descriptors::Allocator &descriptors,
+        VkShaderModule shaderModule,
+        VkPipelineCache pipelineCache,
+        VkBuffer sourceInstances,
+        std::uint32_t instanceCount,
+        std::uint32_t indexCount,
+        float boundingRadius,
+        std::uint32_t outputCount,
+        CullPass &pass
+    );
+
+    /**
+     * @brief Destroy the culling pipeline and buffers
+     * @param device Logical device
+     * @param allocator Allocator the buffers came from
+     * @param pass Pass to destroy (no submission may still use it)
+     */
+    void destroyCullPass(VkDevice &device, Memory::Allocator &allocator, CullPass &pass);
+
+    /**
+     * @brief Record the culling dispatch (outside any render pass)
+     * @param commandBuffer Command buffer of the frame, recorded before the render pass
+     * @param pass Culling pass
+     * @param output Output set written
+     * @param clipFromLocal proj * view * model of the frame
+     * @details Resets the draw arguments, then culls and compacts. Only the reset-to-dispatch
+     *          barrier is recorded here: as a render graph pass writing the frame slot's
+     *          outputs (imported per frame), the graph makes them visible to DRAW_INDIRECT and
+     *          VERTEX_INPUT. On the async compute queue the caller releases the outputs to
+     *          graphics instead (AsyncCompute::releaseBuffers).
+     */
+    void recordCullPass(
+        VkCommandBuffer commandBuffer,
+        const CullPass &pass,
+        const Output &output,
+        const glm::mat4 &clipFromLocal
+    );
+} // namespace Culling
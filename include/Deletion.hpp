@@ -0,0 +1,70 @@
+/**
+ * @file Deletion.hpp
+ * @brief Deferred destruction of GPU objects keyed on timeline semaphore values
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+/**
+ * @namespace Deletion
+ * @brief Holds destroy callbacks until the GPU timeline passes the value they were queued with
+ * @details A resource still referenced by submitted work is queued with the timeline value of
+ *          the last submission using it. Once Synchronization::completedValue reaches that
+ *          value the callback runs, without idling the device or a queue.
+ */
+namespace Deletion
+{
+    /**
+     * @struct Entry
+     * @brief One deferred destroy callback
+     */
+    struct Entry
+    {
+        std::uint64_t retireValue = 0; ///< Timeline value after which the object is unused
+        std::function<void()> destroy; ///< Releases the object
+    };
+
+    /**
+     * @struct Queue
+     * @brief Deferred destroy callbacks, ordered by retire value
+     */
+    struct Queue
+    {
+        std::deque<Entry> entries; ///< Pending callbacks, oldest first
+
+        Queue() = default;
+        Queue(const Queue&) = delete;
+        Queue& operator=(const Queue&) = delete;
+        Queue(Queue&&) = default;
+        Queue& operator=(Queue&&) = default;
+    };
+
+    /**
+     * @brief Queue a destroy callback
+     * @param queue Deletion queue
+     * @param retireValue Timeline value of the last submission that may use the object
+     * @param destroy Callback releasing the object
+     * @details retireValue is clamped so entries stay ordered; queueing the value of the most
+     *          recent submission is always correct.
+     */
+    void defer(Queue &queue, std::uint64_t retireValue, std::function<void()> destroy);
+
+    /**
+     * @brief Run every callback whose retire value the GPU has reached
+     * @param queue Deletion queue
+     * @param completedValue Current timeline value
+     * @return Number of callbacks run
+     */
+    std::size_t flush(Queue &queue, std::uint64_t completedValue);
+
+    /**
+     * @brief Run every remaining callback (the device must be idle)
+     * @param queue Deletion queue
+     */
+    void flushAll(Queue &queue);
+} // namespace Deletion
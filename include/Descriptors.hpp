@@ -0,0 +1,150 @@
+/**
+ * @file Descriptors.hpp
+ * @brief Growable descriptor pools and a cache of descriptor set layouts
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Descriptors
+ * @brief Descriptor sets that are only ever released in bulk
+ * @details An Allocator chains pools: when vkAllocateDescriptorSets reports
+ *          VK_ERROR_OUT_OF_POOL_MEMORY (or a fragmented pool) the pool is retired as full and
+ *          the next one, twice as large, is used. Persistent allocators are never reset; the
+ *          per-frame ones are reset with vkResetDescriptorPool once the frame retired, which
+ *          frees every set at once and keeps the pools for reuse. Sets are never freed one at
+ *          a time, so pools are created without FREE_DESCRIPTOR_SET.
+ */
+namespace Descriptors
+{
+    /**
+     * @struct PoolSizeRatio
+     * @brief Descriptors of one type reserved per set of a pool
+     */
+    struct PoolSizeRatio
+    {
+        VkDescriptorType type; ///< Descriptor type
+        float perSet;          ///< Descriptors per set (multiplied by the pool's set count)
+    };
+
+    /// Mix of the renderer's sets: frame UBO (dynamic) and texture, cull pass storage buffers
+    inline constexpr std::array<PoolSizeRatio, 3> DEFAULT_RATIOS = {{
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.0f},
+    }};
+
+    /// Upper bound on the sets of one pool as pools double in size
+    inline constexpr std::uint32_t MAX_SETS_PER_POOL = 4096;
+
+    /**
+     * @struct Allocator
+     * @brief Chain of descriptor pools handed out front to back
+     */
+    struct Allocator
+    {
+        VkDevice device = VK_NULL_HANDLE;         ///< Logical device
+        std::vector<PoolSizeRatio> ratios;        ///< Pool composition
+        std::uint32_t setsPerPool = 0;            ///< Set count of the next pool created
+        std::vector<VkDescriptorPool> readyPools; ///< Pools with space left (back = current)
+        std::vector<VkDescriptorPool> fullPools;  ///< Pools exhausted since the last reset
+
+        Allocator() = default;
+        Allocator(const Allocator&) = delete;
+        Allocator& operator=(const Allocator&) = delete;
+        Allocator(Allocator&&) = default;
+        Allocator& operator=(Allocator&&) = default;
+    };
+
+    /**
+     * @brief Create an allocator and its first pool
+     * @param device Logical device
+     * @param initialSets Sets of the first pool
+     * @param ratios Descriptors of each type per set
+     * @param allocator Output allocator
+     */
+    void createAllocator(
+        VkDevice &device,
+        std::uint32_t initialSets,
+        std::span<const PoolSizeRatio> ratios,
+        Allocator &allocator
+    );
+
+    /**
+     * @brief Destroy every pool (and with them every set)
+     * @param allocator Allocator to destroy (no set may still be in use by the GPU)
+     */
+    void destroyAllocator(Allocator &allocator);
+
+    /**
+     * @brief Allocate a set, chaining a new pool when the current one is exhausted
+     * @param allocator Allocator
+     * @param layout Layout of the set
+     * @return Descriptor set (contents undefined until written)
+     * @throws std::runtime_error on errors other than pool exhaustion
+     */
+    VkDescriptorSet allocate(Allocator &allocator, VkDescriptorSetLayout layout);
+
+    /**
+     * @brief Free every set in bulk and keep the pools for reuse
+     * @param allocator Allocator (no set may still be in use by the GPU)
+     */
+    void resetAllocator(Allocator &allocator);
+
+    /// Hash of a flattened list of layout bindings
+    struct LayoutKeyHash
+    {
+        std::size_t operator()(const std::vector<std::uint32_t> &key) const;
+    };
+
+    /**
+     * @struct LayoutCache
+     * @brief Descriptor set layouts keyed by their bindings
+     * @details Equal binding lists share one layout, so sets built for one pipeline are
+     *          compatible with every other pipeline declaring the same bindings
+     */
+    struct LayoutCache
+    {
+        VkDevice device = VK_NULL_HANDLE; ///< Logical device
+
+        /// (binding, type, count, stages) of every binding, sorted by binding
+        std::unordered_map<std::vector<std::uint32_t>, VkDescriptorSetLayout, LayoutKeyHash>
+            layouts;
+
+        LayoutCache() = default;
+        LayoutCache(const LayoutCache&) = delete;
+        LayoutCache& operator=(const LayoutCache&) = delete;
+    };
+
+    /**
+     * @brief Initialise an empty layout cache
+     * @param device Logical device
+     * @param cache Output cache
+     */
+    void createLayoutCache(VkDevice &device, LayoutCache &cache);
+
+    /**
+     * @brief Destroy every cached layout
+     * @param cache Cache to destroy
+     */
+    void destroyLayoutCache(LayoutCache &cache);
+
+    /**
+     * @brief Get the layout for a list of bindings, creating it on first use
+     * @param cache Layout cache
+     * @param bindings Bindings in any order (immutable samplers are not supported)
+     * @return Layout owned by the cache
+     * @throws std::runtime_error if a binding has immutable samplers or creation fails
+     */
+    VkDescriptorSetLayout getLayout(
+        LayoutCache &cache, std::span<const VkDescriptorSetLayoutBinding> bindings
+    );
+} // namespace Descriptors
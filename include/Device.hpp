@@ -5,7 +5,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <vulkan/vulkan_core.h>
 
 /**
@@ -14,43 +17,173 @@
  */
 namespace Device
 {
+    /// Environment variable read as the device selector when none is given on the command line
+    inline constexpr const char *DEVICE_ENV = "VULKAN_TUTO_DEVICE";
+
+    /**
+     * @struct Identity
+     * @brief What tells one GPU apart from another across runs and processes
+     */
+    struct Identity
+    {
+        std::string name;                              ///< Device name
+        std::array<std::uint8_t, VK_UUID_SIZE> uuid{}; ///< deviceUUID (stable across processes)
+        bool hasPciBus = false;                        ///< VK_EXT_pci_bus_info is supported
+        std::uint32_t pciDomain = 0;                   ///< PCI domain (hasPciBus)
+        std::uint32_t pciBus = 0;                      ///< PCI bus (hasPciBus)
+        std::uint32_t pciDevice = 0;                   ///< PCI device (hasPciBus)
+        std::uint32_t pciFunction = 0;                 ///< PCI function (hasPciBus)
+    };
+
+    /**
+     * @struct DynamicRendering
+     * @brief Vulkan 1.3 entry points of the dynamic rendering and synchronization2 path
+     * @details Resolved with vkGetDeviceProcAddr, so the binary still loads on older loaders;
+     *          all null when the path is off
+     */
+    struct DynamicRendering
+    {
+        PFN_vkCmdBeginRendering beginRendering = nullptr;     ///< Begins a render pass instance
+        PFN_vkCmdEndRendering endRendering = nullptr;         ///< Ends it
+        PFN_vkCmdPipelineBarrier2 pipelineBarrier2 = nullptr; ///< Per-barrier stage masks
+        PFN_vkQueueSubmit2 queueSubmit2 = nullptr;            ///< Submit::Batcher flushes
+    };
+
     /**
      * @brief Select suitable physical device (GPU)
      * @param instance Vulkan instance
      * @param physicalDevice Output physical device handle
-     * @param surface Surface for presentation support check
-     * @details Rates all available GPUs and selects the best one
+     * @param surface Surface for presentation support check (VK_NULL_HANDLE = headless)
+     * @param selector Device to use instead of the best rated one (empty = DEVICE_ENV, then
+     *                 none): a device UUID as 32 hex digits (dashes ignored, optionally
+     *                 prefixed "uuid:"), or "pci:" and a PCI address in lspci form
+     *                 ([domain:]bus:device.function, hex; without the domain, trailing parts
+     *                 may be left out)
+     * @details Rates all available GPUs and selects the best one; ties keep enumeration order.
+     *          A selected device must still be suitable.
+     * @throws std::runtime_error if no device is suitable, or the selected one is missing or
+     *         unsuitable (the message lists every device's identity)
+     * @throws std::invalid_argument if the selector cannot be parsed
      */
     void pickPhysicalDevice(
-        const VkInstance instance, VkPhysicalDevice &physicalDevice, const VkSurfaceKHR surface
+        const VkInstance instance,
+        VkPhysicalDevice &physicalDevice,
+        const VkSurfaceKHR surface,
+        std::string_view selector = {}
     );
 
     /**
      * @brief Rate a physical device's suitability
      * @param device Physical device to rate
-     * @param surface Surface for swapchain support check
+     * @param surface Surface for swapchain support check (VK_NULL_HANDLE = headless)
      * @return Suitability score (higher is better, 0 = unsuitable)
-     * @details Prefers discrete GPUs with swapchain and queue support
+     * @details Devices are rejected below Vulkan 1.2, without the required extensions
+     *          (checkDeviceExtensionSupport), queue families, surface formats and present
+     *          modes, or without timeline semaphores or samplerAnisotropy. The rest are
+     *          ranked by device type (discrete, integrated, virtual, CPU), then by their
+     *          largest device-local heap, with a bonus for a dedicated transfer family, a
+     *          dedicated compute family and each optional path they support (dynamic
+     *          rendering, multiDrawIndirect, drawIndirectCount, bindless).
      */
     std::uint32_t rateDevice(const VkPhysicalDevice device, const VkSurfaceKHR surface);
 
+    /**
+     * @brief Read the identity of a physical device
+     * @param device Physical device to query
+     * @return Name, UUID and PCI address (when VK_EXT_pci_bus_info is supported)
+     */
+    Identity queryIdentity(const VkPhysicalDevice device);
+
+    /**
+     * @brief Format a device UUID as 8-4-4-4-12 lowercase hex digits
+     * @param uuid Device UUID
+     * @return Formatted UUID, accepted back as a pickPhysicalDevice selector
+     */
+    std::string formatUuid(const std::array<std::uint8_t, VK_UUID_SIZE> &uuid);
+
     /**
      * @brief Create logical device with required queues
      * @param physicalDevice Physical device to create from
      * @param device Output logical device handle
      * @param graphicsQueue Output graphics queue handle
      * @param presentQueue Output present queue handle
+     * @param transferQueue Output transfer queue handle (graphics queue if no dedicated family)
+     * @param computeQueue Output compute queue handle
+     * @param asyncComputeQueue Output async compute queue handle (VK_NULL_HANDLE when the
+     *                          device has no async compute family or it is not enabled)
      * @param surface Surface for queue selection
-     * @details Creates device with graphics and present queue families
+     * @param enablePresentWait Also enable VK_KHR_present_id and VK_KHR_present_wait
+     * @param enableDynamicRendering Also enable the Vulkan 1.3 dynamicRendering and
+     *                               synchronization2 features (supportsDynamicRendering)
+     * @param enableAsyncCompute Also create a queue on the async compute family, if any
+     * @details Creates device with graphics, present, transfer and compute queue families
      */
     void createLogicalDevice(
         const VkPhysicalDevice physicalDevice,
         VkDevice &device,
         VkQueue &graphicsQueue,
         VkQueue &presentQueue,
-        const VkSurfaceKHR surface
+        VkQueue &transferQueue,
+        VkQueue &computeQueue,
+        VkQueue &asyncComputeQueue,
+        const VkSurfaceKHR surface,
+        bool enablePresentWait = false,
+        bool enableDynamicRendering = false,
+        bool enableAsyncCompute = false
     );
 
+    /**
+     * @brief Check if device can render without render pass objects
+     * @param device Physical device to check
+     * @return true if it reports Vulkan 1.3 with the dynamicRendering and synchronization2
+     *         features
+     */
+    bool supportsDynamicRendering(const VkPhysicalDevice device);
+
+    /**
+     * @brief Resolve the dynamic rendering and synchronization2 entry points
+     * @param device Logical device created with enableDynamicRendering
+     * @param functions Output entry points
+     * @throws std::runtime_error if the driver does not expose them
+     */
+    void loadDynamicRendering(VkDevice device, DynamicRendering &functions);
+
+    /**
+     * @brief Check if device draws more than one indirect record per call
+     * @param device Physical device to check
+     * @return VK_TRUE if the multiDrawIndirect feature is available (enabled if so)
+     */
+    VkBool32 supportsMultiDrawIndirect(const VkPhysicalDevice device);
+
+    /**
+     * @brief Check if device supports vkCmdDrawIndexedIndirectCount
+     * @param device Physical device to check
+     * @return VK_TRUE if the Vulkan 1.2 drawIndirectCount feature is available (enabled if so)
+     */
+    VkBool32 supportsDrawIndirectCount(const VkPhysicalDevice device);
+
+    /**
+     * @brief Check if device supports the descriptor indexing features of Bindless::Table
+     * @param device Physical device to check
+     * @return VK_TRUE if runtime arrays, partially bound and update-after-bind sampled images
+     *         are available (enabled if so)
+     */
+    VkBool32 supportsBindless(const VkPhysicalDevice device);
+
+    /**
+     * @brief Check if device can pace presents with VK_KHR_present_wait
+     * @param device Physical device to check
+     * @return true if present_id and present_wait extensions and features are available
+     */
+    bool supportsPresentWait(const VkPhysicalDevice device);
+
+    /**
+     * @brief Check if device reports heap budgets through VK_EXT_memory_budget
+     * @param device Physical device to check
+     * @return true if the extension is available (enabled if so)
+     */
+    bool supportsMemoryBudget(const VkPhysicalDevice device);
+
     /**
      * @brief Check if device supports required extensions
      * @param device Physical device to check
@@ -0,0 +1,136 @@
+/**
+ * @file Frame.hpp
+ * @brief Per-frame-in-flight resources recycled once the frame's timeline value is reached
+ */
+
+#pragma once
+
+#include "Descriptors.hpp"
+#include "Memory.hpp"
+#include "Synchronisation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Frame
+ * @brief Groups everything a frame in flight records, writes or allocates
+ * @details Each frame slot owns a transient command pool, its sync objects, a region of the
+ *          shared uniform ring and a growable descriptor allocator. Once the GPU timeline
+ *          reaches the value the frame's last submission signalled, they are reset in bulk
+ *          (vkResetCommandPool, vkResetDescriptorPool, uniform rewind) rather than object by
+ *          object. Uploads stage through Upload::StagingRing instead of a per-frame buffer.
+ */
+namespace Frame
+{
+    /// Descriptor sets of a frame's first pool (more pools are chained when it runs out)
+    inline constexpr std::uint32_t FRAME_DESCRIPTOR_SETS = 16;
+
+    /// Bytes of the uniform ring reserved for each frame in flight
+    inline constexpr VkDeviceSize FRAME_UNIFORM_SIZE = 256ull * 1024;
+
+    /**
+     * @struct UniformRing
+     * @brief One persistently mapped uniform buffer split into a region per frame in flight
+     * @details Sets bind it as UNIFORM_BUFFER_DYNAMIC, so a sub-allocation is selected with a
+     *          dynamic offset at bind time instead of a descriptor write or a buffer per object
+     */
+    struct UniformRing
+    {
+        VkBuffer buffer = VK_NULL_HANDLE; ///< Buffer handle (UNIFORM_BUFFER usage)
+        Memory::Allocation allocation;    ///< Host-visible, coherent memory (mapped)
+        VkDeviceSize alignment = 0;       ///< minUniformBufferOffsetAlignment
+        VkDeviceSize regionSize = 0;      ///< Bytes per frame (multiple of alignment)
+    };
+
+    /**
+     * @struct FrameContext
+     * @brief Resources owned by one frame in flight
+     */
+    struct FrameContext
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;     ///< Transient pool, reset after wait
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE; ///< Primary buffer of the frame
+
+        VkSemaphore imageAvailable = VK_NULL_HANDLE; ///< Signaled by vkAcquireNextImageKHR
+        std::uint64_t timelineValue = 0;             ///< Timeline value of the last submission
+
+        VkDeviceSize uniformBase = 0; ///< Start of the frame's region of the uniform ring
+        VkDeviceSize uniformHead = 0; ///< Next free byte of that region (relative)
+
+        Descriptors::Allocator descriptors;             ///< Transient sets, reset in bulk
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE; ///< Set bound by this frame's draws
+    };
+
+    /**
+     * @brief Create every frame context and the uniform ring they share
+     * @param device Logical device
+     * @param physicalDevice Physical device for queue family queries and the UBO alignment
+     * @param surface Surface for queue family selection
+     * @param allocator Allocator for the uniform ring
+     * @param frameCount Number of frames in flight
+     * @param frames Output frame contexts
+     * @param uniforms Output uniform ring (FRAME_UNIFORM_SIZE per frame)
+     */
+    void createFrameContexts(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        Memory::Allocator &allocator,
+        std::size_t frameCount,
+        std::vector<FrameContext> &frames,
+        UniformRing &uniforms
+    );
+
+    /**
+     * @brief Destroy every frame context and the uniform ring
+     * @param device Logical device
+     * @param allocator Allocator the uniform ring came from
+     * @param frames Frame contexts to destroy (none may be in flight)
+     * @param uniforms Uniform ring to destroy
+     */
+    void destroyFrameContexts(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        std::vector<FrameContext> &frames,
+        UniformRing &uniforms
+    );
+
+    /**
+     * @brief Wait for the frame's previous submission and recycle its resources
+     * @param device Logical device
+     * @param timeline GPU timeline the frame's submissions signal
+     * @param frame Frame context to reuse
+     * @details Waits until the timeline reaches frame.timelineValue, then resets the command
+     *          pool and every descriptor pool and rewinds the uniform region.
+     */
+    void waitAndReset(
+        VkDevice &device, const Synchronization::Timeline &timeline, FrameContext &frame
+    );
+
+    /**
+     * @brief Allocate a descriptor set that lives until the frame is reset
+     * @param device Logical device
+     * @param frame Frame context to allocate from
+     * @param layout Layout of the set
+     * @return Descriptor set (contents undefined until written)
+     * @details Chains another pool when the frame's pools are exhausted
+     */
+    VkDescriptorSet allocateDescriptorSet(
+        VkDevice &device, FrameContext &frame, VkDescriptorSetLayout &layout
+    );
+
+    /**
+     * @brief Reserve uniform data in the frame's ring region until the frame is reset
+     * @param uniforms Uniform ring
+     * @param frame Frame context whose region is used
+     * @param size Number of bytes (at most the range of the dynamic descriptor reading it)
+     * @param offset Output dynamic offset into uniforms.buffer (minUniformBufferOffsetAlignment)
+     * @return Host pointer to write to, or nullptr if the frame's region is exhausted
+     */
+    std::byte *allocateUniform(
+        UniformRing &uniforms, FrameContext &frame, VkDeviceSize size, std::uint32_t &offset
+    );
+} // namespace Frame
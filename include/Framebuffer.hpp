@@ -19,6 +19,7 @@ namespace Framebuffer
      * @param device Logical device
      * @param renderPass Render pass defining attachment layout
      * @param swapChainImageViews Image views for color attachments
+     * @param depthImageView Depth attachment shared by every framebuffer (render graph transient)
      * @param swapChainExtent Dimensions of framebuffers
      * @param swapChainFramebuffers Output vector of framebuffers
      * @details Creates one framebuffer per swapchain image
@@ -27,6 +28,7 @@ namespace Framebuffer
         VkDevice &device,
         VkRenderPass &renderPass,
         const std::vector<VkImageView> &swapChainImageViews,
+        VkImageView depthImageView,
         VkExtent2D &swapChainExtent,
         std::vector<VkFramebuffer> &swapChainFramebuffers
     );
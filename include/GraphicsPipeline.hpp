@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -19,24 +23,118 @@ namespace GraphicsPipeline
     constexpr std::string_view vertShaderPath = "build/shaders/shader.vert.spv";
     /// Path to compiled fragment shader (SPIR-V)
     constexpr std::string_view fragShaderPath = "build/shaders/shader.frag.spv";
+    /// Fragment shader reading the material and texture tables of Bindless::Table (set 1)
+    constexpr std::string_view bindlessFragShaderPath = "build/shaders/bindless.frag.spv";
 
     /**
-     * @brief Create graphics pipeline with shaders and fixed-function state
+     * @struct DrawConstants
+     * @brief Push constants set per draw (vertex and fragment stages)
+     * @details 68 bytes, inside the 128 bytes every device guarantees
+     */
+    struct DrawConstants
+    {
+        glm::mat4 model{1.0f};           ///< Object to world transform (vertex stage)
+        std::uint32_t materialIndex = 0; ///< Entry of the bindless material table (fragment)
+    };
+
+    /**
+     * @enum VertexLayout
+     * @brief Vertex input layouts a pipeline can be built for
+     */
+    enum class VertexLayout : std::uint8_t
+    {
+        PositionColorTexCoord, ///< Buffer::Vertex at binding 0, Buffer::Instance at binding 1
+        Packed,                ///< Mesh::PackedVertex at binding 0, Buffer::Instance at binding 1
+        Sprite                 ///< Sprites::Vertex at binding 0, no instance binding
+    };
+
+    /**
+     * @struct PipelineState
+     * @brief Everything that distinguishes one graphics pipeline variant from another
+     * @details Viewport and scissor are dynamic and therefore not part of the state
+     */
+    struct PipelineState
+    {
+        /// SPIR-V vertex and fragment shader paths
+        std::string vertexShader = std::string(vertShaderPath);
+        std::string fragmentShader = std::string(fragShaderPath);
+
+        /// Vertex input and input assembly
+        VertexLayout vertexLayout = VertexLayout::Packed;
+        VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        /// Rasterization
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+        VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        /// Color blending of the color attachment (off for opaque draws, which leaves hidden
+        /// fragments to the early depth test)
+        bool blendEnable = false;
+        VkBlendFactor srcColorBlend = VK_BLEND_FACTOR_SRC_ALPHA;
+        VkBlendFactor dstColorBlend = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+
+        /// Color writes; depth-only pipelines turn them off and may leave fragmentShader empty
+        bool colorWrite = true;
+
+        /// Depth test and write against the render pass's depth attachment
+        bool depthTest = true;
+        bool depthWrite = true;
+        VkCompareOp depthCompare = VK_COMPARE_OP_LESS;
+
+        /// Render pass and subpass the pipeline is used in
+        VkRenderPass renderPass = VK_NULL_HANDLE;
+        std::uint32_t subpass = 0;
+
+        /// Attachment formats of dynamic rendering, used when renderPass is VK_NULL_HANDLE
+        VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+        VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+        bool operator==(const PipelineState &) const = default;
+    };
+
+    /**
+     * @brief Hash a pipeline state (FNV-1a over every field)
+     * @param state Pipeline state
+     * @return 64-bit key identifying the variant
+     */
+    std::uint64_t hashState(const PipelineState &state);
+
+    /**
+     * @brief Create the pipeline layout shared by every variant
      * @param device Logical device
-     * @param swapChainExtent Viewport/scissor dimensions
+     * @param setLayouts Descriptor set layouts from set 0 (frame resources, then the bindless
+     *                   table when enabled)
      * @param pipelineLayout Output pipeline layout
-     * @param graphicsPipeline Output graphics pipeline
-     * @param renderPass Render pass for pipeline
-     * @param descriptorSetLayout Descriptor set layout for resources
-     * @details Configures vertex input, rasterization, depth/stencil, blending
+     * @details Always declares the DrawConstants push constant range
      */
-    void createGraphicsPipeline(
+    void createPipelineLayout(
         VkDevice &device,
-        VkExtent2D &swapChainExtent,
-        VkPipelineLayout &pipelineLayout,
-        VkPipeline &graphicsPipeline,
-        VkRenderPass &renderPass,
-        VkDescriptorSetLayout &descriptorSetLayout
+        std::span<const VkDescriptorSetLayout> setLayouts,
+        VkPipelineLayout &pipelineLayout
+    );
+
+    /**
+     * @brief Create a graphics pipeline variant from already created shader modules
+     * @param device Logical device
+     * @param state Fixed-function state, vertex layout and render pass (or dynamic rendering
+     *              attachment formats)
+     * @param vertShaderModule Vertex shader module for state.vertexShader
+     * @param fragShaderModule Fragment shader module for state.fragmentShader (VK_NULL_HANDLE
+     *                         = no fragment stage, for depth-only pipelines)
+     * @param pipelineLayout Pipeline layout (uniforms, push constants)
+     * @param pipelineCache Cache consulted and filled by the driver (VK_NULL_HANDLE = none)
+     * @return Graphics pipeline
+     * @throws std::runtime_error if pipeline creation fails
+     * @details Thread-safe: may run on a background thread while the render loop records
+     */
+    VkPipeline createGraphicsPipeline(
+        VkDevice device,
+        const PipelineState &state,
+        VkShaderModule vertShaderModule,
+        VkShaderModule fragShaderModule,
+        VkPipelineLayout pipelineLayout,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
     );
 
     /**
@@ -46,13 +144,14 @@ namespace GraphicsPipeline
      * @return Shader module handle
      * @details Wraps compiled shader code for pipeline usage
      */
-    VkShaderModule createShaderModule(VkDevice &device, const std::vector<std::byte> &code);
+    VkShaderModule createShaderModule(VkDevice &device, std::span<const std::byte> code);
 
     /**
-     * @brief Create render pass defining attachments and subpasses
-     * @param device Logical device
-     * @param renderPass Output render pass handle
-     * @details Defines single color attachment with clear on load, store on finish
+     * @brief Pick the depth attachment format of the render pass
+     * @param physicalDevice Physical device
+     * @return First of D32_SFLOAT, D32_SFLOAT_S8_UINT and D24_UNORM_S8_UINT usable as an
+     *         optimal-tiling depth attachment
+     * @throws std::runtime_error if none is supported
      */
-    void createRenderPass(VkDevice &device, VkRenderPass &renderPass);
+    VkFormat findDepthFormat(VkPhysicalDevice physicalDevice);
 } // namespace GraphicsPipeline
\ No newline at end of file
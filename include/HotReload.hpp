@@ -0,0 +1,141 @@
+/**
+ * @file HotReload.hpp
+ * @brief Watches shader sources and textures, rebuilding what changed in the background
+ */
+
+#pragma once
+
+#include "Ktx.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace HotReload
+ * @brief A watcher thread that turns edited files into ready-to-use SPIR-V and texels
+ * @details Watched files are polled for a new modification time. A changed GLSL source is
+ *          compiled with shaderc (HOT_RELOAD_SHADERC; without it the SPIR-V output itself is
+ *          watched, rebuilt by the shaders target of the build) and a changed texture is
+ *          decoded, both on the watcher thread. The results wait in a queue the render loop
+ *          drains at a frame boundary, so it only creates modules, pipelines and images from
+ *          finished data.
+ */
+namespace HotReload
+{
+    /// Time between two checks of the watched files
+    inline constexpr std::chrono::milliseconds POLL_INTERVAL{250};
+
+    /// Directory holding the GLSL sources, relative to the working directory
+    inline constexpr std::string_view SHADER_SOURCE_DIR = "shaders";
+
+    /**
+     * @enum AssetKind
+     * @brief What a watched file is turned into
+     */
+    enum class AssetKind : std::uint8_t
+    {
+        Shader, ///< SPIR-V for Pipelines::reloadShader
+        Texture ///< Decoded mip chain
+    };
+
+    /**
+     * @struct WatchedFile
+     * @brief A file on disk and the asset it produces
+     */
+    struct WatchedFile
+    {
+        std::filesystem::path path;                ///< File polled (GLSL source, SPIR-V, image)
+        std::string key;                           ///< SPIR-V or texture path the app knows
+        AssetKind kind = AssetKind::Shader;        ///< Product of the file
+        std::filesystem::file_time_type lastWrite; ///< Modification time last processed
+    };
+
+    /**
+     * @struct Change
+     * @brief Rebuilt asset of a changed file
+     */
+    struct Change
+    {
+        AssetKind kind = AssetKind::Shader; ///< Which of the fields below is set
+        std::string key;                    ///< WatchedFile::key
+        std::filesystem::path path;         ///< File that changed
+        std::vector<std::byte> spirv;       ///< Compiled or read SPIR-V (Shader)
+        Ktx::TextureData texels;            ///< Decoded levels (Texture)
+        std::string error;                  ///< Why the rebuild failed (empty = success)
+    };
+
+    /**
+     * @struct Watcher
+     * @brief Watched files, the polling thread and the changes it produced
+     */
+    struct Watcher
+    {
+        std::vector<WatchedFile> files;                   ///< The thread's own once started
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Picks .ktx2 transcode targets
+        std::thread thread;                               ///< Polling thread
+
+        std::mutex mutex;             ///< Guards changes and stopping
+        std::condition_variable wake; ///< Signals shutdown
+        std::deque<Change> changes;   ///< Finished rebuilds, oldest first
+        bool stopping = false;        ///< Set when the watcher is stopped
+
+        Watcher() = default;
+        Watcher(const Watcher&) = delete;
+        Watcher& operator=(const Watcher&) = delete;
+    };
+
+    /**
+     * @brief Watch the GLSL source of a SPIR-V file the pipelines are built from
+     * @param watcher Watcher (not started yet)
+     * @param spirvPath Path the registry loads, e.g. build/shaders/shader.vert.spv; its source
+     *                  is SHADER_SOURCE_DIR/shader.vert
+     */
+    void watchShader(Watcher &watcher, const std::string &spirvPath);
+
+    /**
+     * @brief Watch a texture file
+     * @param watcher Watcher (not started yet)
+     * @param path .ktx2 or stb_image file
+     */
+    void watchTexture(Watcher &watcher, const std::string &path);
+
+    /**
+     * @brief Record the current modification times and start polling
+     * @param watcher Watcher with its files added
+     * @param physicalDevice Device textures are decoded for
+     * @details Files missing now are picked up once they appear
+     */
+    void start(Watcher &watcher, VkPhysicalDevice physicalDevice);
+
+    /**
+     * @brief Stop and join the polling thread (a rebuild in progress finishes first)
+     * @param watcher Watcher
+     */
+    void stop(Watcher &watcher);
+
+    /**
+     * @brief Take the changes finished since the last call
+     * @param watcher Watcher
+     * @return Changes, oldest first
+     */
+    std::vector<Change> takeChanges(Watcher &watcher);
+
+    /**
+     * @brief Compile a GLSL source to SPIR-V
+     * @param source .vert, .frag or .comp file
+     * @return SPIR-V words as bytes
+     * @throws std::runtime_error with the compiler's messages if the source does not compile,
+     *         or if the build has no shaderc
+     */
+    std::vector<std::byte> compileShader(const std::filesystem::path &source);
+} // namespace HotReload
@@ -5,7 +5,14 @@
 
 #pragma once
 
+#include "Ktx.hpp"
+#include "Memory.hpp"
+#include "Upload.hpp"
+
 #include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
 #include <vulkan/vulkan_core.h>
 
 /**
@@ -14,29 +21,199 @@
  */
 namespace Image
 {
+    /// Scene texture, decoded at startup unless it comes pre-decoded from an asset pack
+    constexpr std::string_view texturePath = "textures/texture.jpg";
+
+    /**
+     * @brief Check whether decoding a file needs the physical device
+     * @param path Image file
+     * @return true for .ktx2 files, whose transcode target depends on the device's formats
+     */
+    bool decodeNeedsDevice(const std::filesystem::path &path);
+
+    /**
+     * @brief Read and decode an image file into a mip chain, without touching the GPU
+     * @param path Image file: .ktx2 or any format stb_image decodes (RGBA8 sRGB, one level)
+     * @param physicalDevice Device the texture will be sampled on (only read for .ktx2)
+     * @return Levels that own their bytes
+     * @throws std::runtime_error if the file cannot be read or decoded
+     * @details Thread-safe, so decoding can overlap device creation (except for .ktx2)
+     */
+    Ktx::TextureData decodeTexture(
+        const std::filesystem::path &path, VkPhysicalDevice physicalDevice = VK_NULL_HANDLE
+    );
+
+    /**
+     * @brief Create texture image from a decoded mip chain
+     * @param device Logical device
+     * @param physicalDevice Physical device deciding whether missing levels can be generated
+     * @param allocator Device memory allocator
+     * @param texels Decoded levels (copied into staging memory while recording)
+     * @param textureImage Output texture image handle
+     * @param textureAllocation Output image memory sub-allocation
+     * @param format Output format of the created image
+     * @param mipLevels Output number of mip levels of the created image
+     * @param uploads Upload context recording the staging copy
+     * @details A single stored level gets a full generated mip chain when the format can be
+     *          blitted
+     */
+    void createTextureImage(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const Ktx::TextureData &texels,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        VkFormat &format,
+        std::uint32_t &mipLevels,
+        Upload::Context &uploads
+    );
+
     /**
      * @brief Load and create texture image from file
      * @param device Logical device
-     * @param physicalDevice Physical device for memory queries
+     * @param physicalDevice Physical device whose formats decide how KTX2 sources are transcoded
+     * @param allocator Device memory allocator
+     * @param path Image file: .ktx2 (every level, block-compressed or Basis Universal) or any
+     *             format stb_image decodes (uploaded as RGBA8 sRGB, one level)
      * @param textureImage Output texture image handle
-     * @param textureImageMemory Output image memory handle
-     * @param commandPool Command pool for transfer operations
-     * @param graphicsQueue Queue for executing transfers
-     * @details Loads JPG from disk, uses staging buffer, transitions layouts for optimal access
+     * @param textureAllocation Output image memory sub-allocation
+     * @param format Output format of the created image
+     * @param mipLevels Output number of mip levels of the created image
+     * @param uploads Upload context recording the staging copy
+     * @details decodeTexture followed by createTextureImage. Records the upload into the
+     *          current batch; the image is only usable once that batch has been submitted
      */
     void createTextureImage(
         VkDevice &device,
         VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const std::filesystem::path &path,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        VkFormat &format,
+        std::uint32_t &mipLevels,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Create texture image from already decoded texels
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param pixels Tightly packed texels, levelSize bytes (e.g. an asset pack mapping)
+     * @param width Image width in pixels
+     * @param height Image height in pixels
+     * @param format Texel format of pixels (may be block-compressed)
+     * @param mipLevels Mip levels of the image; levels past 0 are generated with blits
+     * @param textureImage Output texture image handle
+     * @param textureAllocation Output image memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     * @details pixels is copied into staging memory while recording and may be released after
+     */
+    void createTextureImage(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *pixels,
+        std::uint32_t width,
+        std::uint32_t height,
+        VkFormat format,
+        std::uint32_t mipLevels,
         VkImage &textureImage,
-        VkDeviceMemory &textureImageMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocation &textureAllocation,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Create texture image from pre-built mip levels
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param data Source bytes the level offsets refer to
+     * @param format Texel format of every level (may be block-compressed)
+     * @param levels Mip levels, level 0 first
+     * @param mipLevels Mip levels of the image; those past levels are generated with blits
+     * @param textureImage Output texture image handle
+     * @param textureAllocation Output image memory sub-allocation
+     * @param uploads Upload context recording the staging copy
+     */
+    void createTextureImage(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *data,
+        VkFormat format,
+        std::span<const Upload::ImageLevel> levels,
+        std::uint32_t mipLevels,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Texel block size of a format
+     * @param format Image format
+     * @return Block width and height in texels (1x1 for uncompressed formats)
+     */
+    VkExtent2D blockExtent(VkFormat format);
+
+    /**
+     * @brief Bytes of one texel block of a format
+     * @param format Image format
+     * @return Block size in bytes (the texel size for uncompressed formats), 0 if unknown
+     */
+    std::uint32_t blockBytes(VkFormat format);
+
+    /**
+     * @brief Bytes of one tightly packed level
+     * @param format Image format
+     * @param width Level width in texels
+     * @param height Level height in texels
+     * @return Size of the level's whole blocks, 0 if the format is unknown
+     */
+    VkDeviceSize levelSize(VkFormat format, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * @brief Length of a full mip chain
+     * @param width Level 0 width
+     * @param height Level 0 height
+     * @return floor(log2(max(width, height))) + 1
+     */
+    std::uint32_t mipLevelCount(std::uint32_t width, std::uint32_t height);
+
+    /**
+     * @brief Check that mips of a format can be generated with linear blits
+     * @param physicalDevice Physical device
+     * @param format Image format
+     * @return true if optimal tiling supports BLIT_SRC, BLIT_DST and linear filtering
+     *         (never for block-compressed formats)
+     */
+    bool canGenerateMipmaps(VkPhysicalDevice physicalDevice, VkFormat format);
+
+    /**
+     * @brief Record the blits that build a mip chain down from an uploaded level
+     * @param commandBuffer Command buffer on a graphics-capable queue
+     * @param image Image whose levels [0, mipLevels) are all in TRANSFER_DST_OPTIMAL
+     * @param format Image format
+     * @param width Width of baseLevel
+     * @param height Height of baseLevel
+     * @param baseLevel Last uploaded level, the source of the first blit
+     * @param mipLevels Mip levels of the image
+     * @details Each level is halved from the previous one with a linear filter, then moved to
+     *          SHADER_READ_ONLY_OPTIMAL with a per-level barrier once it has been read; every
+     *          level ends in SHADER_READ_ONLY_OPTIMAL
+     */
+    void generateMipmaps(
+        VkCommandBuffer commandBuffer,
+        VkImage image,
+        VkFormat format,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t baseLevel,
+        std::uint32_t mipLevels
     );
 
     /**
      * @brief Create a Vulkan image with specified properties
      * @param device Logical device
-     * @param physicalDevice Physical device for memory allocation
+     * @param allocator Device memory allocator to sub-allocate from
      * @param width Image width in pixels
      * @param height Image height in pixels
      * @param format Pixel format (e.g., R8G8B8A8_SRGB)
@@ -44,12 +221,14 @@ namespace Image
      * @param usage Image usage flags (transfer dst, sampled, etc.)
      * @param properties Memory properties (device local, host visible, etc.)
      * @param image Output image handle
-     * @param imageMemory Output memory handle
+     * @param imageAllocation Output memory sub-allocation
+     * @param mipLevels Number of mip levels
+     * @param category Category the memory is counted against
      * @details Generic image creation used for textures and framebuffers
      */
     void createImage(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
         std::uint32_t width,
         std::uint32_t height,
         VkFormat format,
@@ -57,49 +236,67 @@ namespace Image
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkImage &image,
-        VkDeviceMemory &imageMemory
+        Memory::Allocation &imageAllocation,
+        std::uint32_t mipLevels,
+        Memory::Category category
     );
 
     /**
-     * @brief Transition image layout using pipeline barriers
+     * @brief Destroy an image and return its memory to the allocator
      * @param device Logical device
-     * @param commandPool Command pool for transition command
-     * @param graphicsQueue Queue to submit transition
+     * @param allocator Allocator the image memory came from
+     * @param image Image to destroy (reset to VK_NULL_HANDLE)
+     * @param imageAllocation Memory sub-allocation to free
+     */
+    void destroyImage(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        VkImage &image,
+        Memory::Allocation &imageAllocation
+    );
+
+    /**
+     * @brief Record an image layout transition barrier
+     * @param commandBuffer Command buffer in recording state
      * @param image Image to transition
      * @param format Image format
      * @param oldLayout Current layout
      * @param newLayout Desired layout
-     * @details Synchronizes access between layout transitions (undefined -> transfer dst -> shader read)
+     * @param levelCount Number of mip levels transitioned
+     * @param baseMipLevel First mip level transitioned
+     * @details Synchronizes access between layout transitions: undefined -> transfer dst ->
+     *          shader read, and transfer dst -> transfer src -> shader read while mips are blitted
      */
     void transitionImageLayout(
-        VkDevice &device,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue,
+        VkCommandBuffer commandBuffer,
         VkImage image,
         VkFormat format,
         VkImageLayout oldLayout,
-        VkImageLayout newLayout
+        VkImageLayout newLayout,
+        std::uint32_t levelCount = 1,
+        std::uint32_t baseMipLevel = 0
     );
 
     /**
-     * @brief Copy data from buffer to image
-     * @param device Logical device
-     * @param commandPool Command pool for copy command
-     * @param graphicsQueue Queue to submit copy
+     * @brief Record a copy from buffer to image
+     * @param commandBuffer Command buffer in recording state
      * @param buffer Source buffer containing pixel data
      * @param image Destination image
-     * @param width Image width
-     * @param height Image height
-     * @details Used after staging buffer upload to transfer texture data to GPU image
+     * @param width Width of the mip level
+     * @param height Height of the mip level
+     * @param mipLevel Destination mip level
+     * @param bufferOffset Offset of the tightly packed level in buffer (a multiple of the
+     *                     format's block size)
+     * @details The image must be in TRANSFER_DST_OPTIMAL layout
      */
     void copyBufferToImage(
-        VkDevice &device,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue,
+        VkCommandBuffer commandBuffer,
         VkBuffer buffer,
         VkImage image,
         uint32_t width,
-        uint32_t height
+        uint32_t height,
+        std::uint32_t mipLevel = 0,
+        VkDeviceSize bufferOffset = 0
     );
 
     /**
@@ -107,13 +304,18 @@ namespace Image
      * @param device Logical device
      * @param physicalDevice Physical device for querying max anisotropy
      * @param textureSampler Output sampler handle
+     * @param mipLevels Mip levels of the sampled image (the LOD range is [0, mipLevels])
      * @details Creates sampler with:
      *          - Linear filtering (mag/min)
      *          - Repeat addressing mode
      *          - Anisotropic filtering enabled (max device support)
+     *          - Trilinear mip filtering over the image's levels
      *          - Unnormalized coordinates disabled (0-1 range)
      */
     void createTextureSampler(
-        VkDevice &device, VkPhysicalDevice &physicalDevice, VkSampler &textureSampler
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSampler &textureSampler,
+        std::uint32_t mipLevels = 1
     );
 } // namespace Image
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
@@ -19,20 +20,35 @@ namespace ImageViews
      * @param device Logical device
      * @param textureImage Image to create view for
      * @param format Image format
+     * @param mipLevels Number of mip levels the view covers, starting at level 0
+     * @param aspect Aspects the view covers (colour, or depth for depth attachments)
      * @return Created image view handle
-     * @details Generic image view creation with 2D, single mipmap, single layer
+     * @details Generic image view creation with 2D, single layer
      */
-    VkImageView createImageView(VkDevice &device, VkImage &textureImage, VkFormat format);
+    VkImageView createImageView(
+        VkDevice &device,
+        VkImage &textureImage,
+        VkFormat format,
+        std::uint32_t mipLevels = 1,
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT
+    );
 
     /**
      * @brief Create image view specifically for texture
      * @param device Logical device
      * @param textureImage Texture image
      * @param textureImageView Output image view handle
+     * @param format Texture format
+     * @param mipLevels Number of mip levels of the texture
      * @details Convenience wrapper for texture image view creation
      */
-    void
-    createTextureImageView(VkDevice &device, VkImage &textureImage, VkImageView &textureImageView);
+    void createTextureImageView(
+        VkDevice &device,
+        VkImage &textureImage,
+        VkImageView &textureImageView,
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB,
+        std::uint32_t mipLevels = 1
+    );
 
     /**
      * @brief Create image views for all swapchain images
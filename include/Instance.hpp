@@ -22,14 +22,25 @@ namespace Instance
     constexpr const char *engineName = "No Engine";            ///< Engine name (none used)
     constexpr std::uint32_t applicationVersion = VK_MAKE_VERSION(1, 0, 0); ///< App version
     constexpr std::uint32_t engineVersion = VK_MAKE_VERSION(1, 0, 0);      ///< Engine version
-    constexpr std::uint32_t apiVersion = VK_API_VERSION_1_0; ///< Target Vulkan API version
+    constexpr std::uint32_t apiVersion = VK_API_VERSION_1_3; ///< Highest Vulkan API version used
+
+    /**
+     * @brief Check whether the loader offers VK_EXT_debug_utils
+     * @return true if the instance extension is available
+     */
+    bool supportsDebugUtils();
 
     /**
      * @brief Create Vulkan instance
      * @param instance Output instance handle
+     * @param debugUtils Also enable VK_EXT_debug_utils (command buffer labels for profiling)
+     * @param surfaceExtensions Enable the surface extensions GLFW requires (false = headless,
+     *        GLFW is not initialised)
      * @details Creates instance with GLFW extensions and validation layers (debug builds)
      */
-    void createInstance(VkInstance &instance);
+    void createInstance(
+        VkInstance &instance, bool debugUtils = false, bool surfaceExtensions = true
+    );
 
     /**
      * @brief Create window surface for rendering
@@ -0,0 +1,147 @@
+/**
+ * @file JobSystem.hpp
+ * @brief Fixed-size worker thread pool for fork/join CPU work
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @namespace Jobs
+ * @brief Worker threads that split a range of jobs and join before returning
+ * @details Each participating thread has a stable worker index so callers can keep per-thread
+ *          resources (command pools, scratch memory) without locking
+ */
+namespace Jobs
+{
+    /// Job body: job index in [0, jobCount) and index of the thread running it
+    using JobFunction = std::function<void(std::uint32_t jobIndex, std::uint32_t workerIndex)>;
+
+    /**
+     * @struct JobSystem
+     * @brief Worker threads and the state of the dispatch they are running
+     */
+    struct JobSystem
+    {
+        std::vector<std::thread> workers; ///< Background threads (worker indices 1..N)
+
+        std::mutex mutex;                 ///< Guards every field below
+        std::condition_variable wake;     ///< Signals a new dispatch or shutdown
+        std::condition_variable finished; ///< Signals the last job of a dispatch completed
+        const JobFunction *job = nullptr; ///< Body of the current dispatch
+        std::uint32_t jobCount = 0;       ///< Number of jobs in the current dispatch
+        std::uint32_t nextJob = 0;        ///< Next job index to hand out
+        std::uint32_t pendingJobs = 0;    ///< Jobs not yet completed
+        std::uint64_t generation = 0;     ///< Incremented on every dispatch
+        std::exception_ptr error;         ///< First exception thrown by a job
+        bool stopping = false;            ///< Set when the pool is destroyed
+
+        JobSystem() = default;
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+    };
+
+    /**
+     * @brief Start the worker threads
+     * @param jobs Job system to initialise
+     * @param workerCount Number of background threads (0 = hardware threads minus one)
+     */
+    void createJobSystem(JobSystem &jobs, std::uint32_t workerCount = 0);
+
+    /**
+     * @brief Stop and join every worker thread
+     * @param jobs Job system to destroy
+     */
+    void destroyJobSystem(JobSystem &jobs);
+
+    /**
+     * @brief Number of threads that may run jobs (workers plus the calling thread)
+     * @param jobs Job system
+     * @return Upper bound (exclusive) of the worker index passed to jobs
+     */
+    std::uint32_t threadCount(const JobSystem &jobs);
+
+    /**
+     * @brief Run jobCount jobs across the pool and wait for all of them
+     * @param jobs Job system
+     * @param jobCount Number of jobs to run
+     * @param job Job body; the calling thread participates with worker index 0
+     * @details Not reentrant: only one thread may dispatch at a time. The first exception
+     *          thrown by a job is rethrown on the calling thread once all jobs finished.
+     */
+    void dispatch(JobSystem &jobs, std::uint32_t jobCount, const JobFunction &job);
+
+    /// Index of a task in its TaskGraph
+    using TaskId = std::uint32_t;
+
+    /**
+     * @struct Task
+     * @brief One node of a TaskGraph and when it ran
+     */
+    struct Task
+    {
+        const char *name = nullptr;                  ///< Task name (string literal)
+        std::function<void()> body;                  ///< Work, run once on any thread
+        std::vector<TaskId> dependents;              ///< Tasks waiting on this one
+        std::uint32_t pendingDependencies = 0;       ///< Dependencies not yet finished
+        std::chrono::steady_clock::time_point begin; ///< Start time (set when run)
+        std::chrono::steady_clock::time_point end;   ///< Finish time (set when run)
+        std::uint32_t workerIndex = 0;               ///< Thread that ran it (0 = caller)
+    };
+
+    /**
+     * @struct TaskGraph
+     * @brief Tasks with dependencies, run as soon as everything they need has finished
+     * @details Tasks may only depend on tasks added before them, so the graph is acyclic by
+     *          construction
+     */
+    struct TaskGraph
+    {
+        std::vector<Task> tasks; ///< Every task, in the order added
+
+        std::mutex mutex;              ///< Guards the fields below while the graph runs
+        std::condition_variable wake;  ///< Signals a ready task, completion or failure
+        std::deque<TaskId> readyTasks; ///< Tasks whose dependencies have all finished
+        std::uint32_t remaining = 0;   ///< Tasks not yet finished
+        bool failed = false;           ///< A task threw; nothing new is started
+
+        TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator=(const TaskGraph&) = delete;
+    };
+
+    /**
+     * @brief Add a task to a graph
+     * @param graph Graph under construction
+     * @param name Task name (string literal)
+     * @param dependencies Tasks that must finish first (already added)
+     * @param body Work of the task
+     * @return Id to depend on
+     * @throws std::invalid_argument if a dependency is not in the graph yet
+     */
+    TaskId addTask(
+        TaskGraph &graph,
+        const char *name,
+        const std::vector<TaskId> &dependencies,
+        std::function<void()> body
+    );
+
+    /**
+     * @brief Run every task of a graph across the pool and wait for all of them
+     * @param jobs Job system (not dispatching anything else)
+     * @param graph Graph to run (once)
+     * @details Each thread of the pool, the caller included, takes ready tasks until the graph
+     *          is done. Independent tasks overlap; nothing is started once a task throws, and
+     *          the first exception is rethrown after the running tasks finished.
+     */
+    void runGraph(JobSystem &jobs, TaskGraph &graph);
+} // namespace Jobs
@@ -0,0 +1,97 @@
+/**
+ * @file Ktx.hpp
+ * @brief KTX2 texture loading with Basis Universal transcoding to a device-supported format
+ */
+
+#pragma once
+
+#include "Upload.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Ktx
+ * @brief Reads KTX2 containers into upload-ready mip levels
+ * @details Textures stored in a Vulkan format (BCn, ASTC, ETC2 or uncompressed) are used as is,
+ *          after undoing Zstandard supercompression if present. Basis Universal sources (ETC1S
+ *          or UASTC) are transcoded to the best block format the physical device samples:
+ *          BC7/BC1/BC5 on desktop GPUs, ASTC 4x4 or ETC2/EAC on mobile ones, RGBA8 otherwise.
+ */
+namespace Ktx
+{
+    /// How the texels are sampled, which decides the transcode target of Basis sources
+    enum class Usage
+    {
+        Color, ///< sRGB (per the file's transfer function) colour, BC7/BC1, ASTC or ETC2
+        Normal ///< Two-channel tangent-space normals, BC5 or EAC RG11
+    };
+
+    /**
+     * @struct TextureData
+     * @brief Mip chain ready for Upload::uploadImage
+     */
+    struct TextureData
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;  ///< Format of every level
+        std::vector<Upload::ImageLevel> levels; ///< Level 0 first; offsets into data
+        std::span<const std::byte> data;        ///< Level bytes (storage or the source file)
+        std::vector<std::byte> storage;         ///< Owned bytes (read, inflated or transcoded)
+
+        TextureData() = default;
+        TextureData(const TextureData&) = delete;
+        TextureData& operator=(const TextureData&) = delete;
+        TextureData(TextureData&&) = default;
+        TextureData& operator=(TextureData&&) = default;
+    };
+
+    /**
+     * @brief Check for the KTX2 file identifier
+     * @param file File contents
+     * @return true if file starts with the KTX 20 identifier
+     */
+    bool isKtx2(std::span<const std::byte> file);
+
+    /**
+     * @brief Pick the format a Basis Universal texture is transcoded to
+     * @param physicalDevice Device whose features and format properties are queried
+     * @param etc1s Source is ETC1S (low quality; BC1 loses nothing over BC7 without alpha)
+     * @param alpha Source has an alpha channel
+     * @param srgb Source colour is sRGB encoded
+     * @param usage How the texture is sampled
+     * @return Vulkan format of the transcoded levels
+     */
+    VkFormat selectTranscodeFormat(
+        VkPhysicalDevice physicalDevice, bool etc1s, bool alpha, bool srgb, Usage usage
+    );
+
+    /**
+     * @brief Load a KTX2 texture from memory
+     * @param physicalDevice Device the texture will be sampled on
+     * @param file KTX2 file contents (must outlive the result, whose data may point into it)
+     * @param usage How the texture is sampled
+     * @return Mip levels in a format the device can sample
+     * @throws std::runtime_error on malformed files, unsupported layouts (arrays, cube maps,
+     *         3D textures) or formats the device cannot sample
+     */
+    TextureData loadKtx2(
+        VkPhysicalDevice physicalDevice, std::span<const std::byte> file, Usage usage = Usage::Color
+    );
+
+    /**
+     * @brief Load a KTX2 texture from disk
+     * @param physicalDevice Device the texture will be sampled on
+     * @param path Path to the .ktx2 file
+     * @param usage How the texture is sampled
+     * @return Mip levels that own their bytes
+     */
+    TextureData loadKtx2(
+        VkPhysicalDevice physicalDevice,
+        const std::filesystem::path &path,
+        Usage usage = Usage::Color
+    );
+} // namespace Ktx
@@ -0,0 +1,203 @@
+/**
+ * @file Loader.hpp
+ * @brief Thread-safe resource creation: worker threads queue loads, one thread uploads them
+ */
+
+#pragma once
+
+#include "Ktx.hpp"
+#include "Memory.hpp"
+#include "Submit.hpp"
+#include "Upload.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Loader
+ * @brief Creates buffers and textures on a loader thread for any number of producer threads
+ * @details Upload contexts and command pools need external synchronization, so only the loader
+ *          thread touches its own: it owns an Upload::Context (command pools and staging ring) and
+ *          the batches in flight. Memory comes from the app's Memory::Allocator, which locks around
+ *          every allocation and free, so the loader's resources show up in the same category stats,
+ *          budget check and leak check. Producers push requests onto a lock-free multi-producer,
+ *          single-consumer queue and get a std::future back, resolved once the upload batch holding
+ *          the copy has signaled its fence; the resource is then ready to bind with no further
+ *          synchronization. The batches are flushed through the shared Submit::Batcher, whose mutex
+ *          keeps the queues used by one thread at a time. Producers that poll the futures (wait_for
+ *          with a zero timeout) never block.
+ */
+namespace Loader
+{
+    /// Time the loader thread sleeps between two fence checks while batches are in flight
+    inline constexpr std::chrono::milliseconds POLL_INTERVAL{1};
+
+    /**
+     * @struct Resource
+     * @brief A created buffer or image, allocated from the shared allocator
+     */
+    struct Resource
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;      ///< Buffer (loadBuffer)
+        VkImage image = VK_NULL_HANDLE;        ///< Image (loadTexture)
+        Memory::Allocation allocation;         ///< Memory from the shared allocator
+        VkFormat format = VK_FORMAT_UNDEFINED; ///< Image format
+        std::uint32_t mipLevels = 0;           ///< Image mip levels
+    };
+
+    /**
+     * @enum RequestKind
+     * @brief What the loader thread does with a request
+     */
+    enum class RequestKind : std::uint8_t
+    {
+        Buffer,  ///< Create a device-local buffer and upload its contents
+        Texture, ///< Create a sampled image and upload its levels
+        Release, ///< Destroy a resource the loader created
+    };
+
+    /**
+     * @struct Request
+     * @brief One queued load or release, linked into the request queue
+     */
+    struct Request
+    {
+        RequestKind kind = RequestKind::Buffer;                 ///< Which fields are set
+        std::vector<std::byte> data;                            ///< Buffer contents (Buffer)
+        VkBufferUsageFlags usage = 0;                           ///< Buffer usage (Buffer)
+        VkPipelineStageFlags dstStage = 0;                      ///< First consumer (Buffer)
+        VkAccessFlags dstAccess = 0;                            ///< Its access (Buffer)
+        Memory::Category category = Memory::Category::Geometry; ///< Counted against (Buffer)
+        Ktx::TextureData texels;                                ///< Decoded levels (Texture)
+        Resource resource;                                      ///< Created, or to destroy
+        std::promise<Resource> promise;                         ///< Resolved once uploaded
+        std::uint64_t ticket = 0;                               ///< Upload batch of the copy
+        Request *next = nullptr;                                ///< Older request (queue link)
+    };
+
+    /**
+     * @struct RequestQueue
+     * @brief Lock-free multi-producer, single-consumer queue of requests
+     * @details Producers push onto an intrusive stack with a compare-exchange loop; the
+     *          consumer takes the whole stack with one exchange and reverses it into push
+     *          order, so neither side ever waits on the other
+     */
+    struct RequestQueue
+    {
+        std::atomic<Request *> head{nullptr}; ///< Newest request
+        std::atomic<std::uint32_t> pushes{0}; ///< Bumped and notified on every push
+
+        RequestQueue() = default;
+        RequestQueue(const RequestQueue&) = delete;
+        RequestQueue& operator=(const RequestQueue&) = delete;
+    };
+
+    /**
+     * @struct Loader
+     * @brief Loader thread, its uploads, and the requests waiting for it
+     */
+    struct Loader
+    {
+        VkDevice device = VK_NULL_HANDLE;                 ///< Logical device
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Picks mip generation support
+        Submit::Batcher *batcher = nullptr;               ///< Shared with the render thread
+        Memory::Allocator *allocator = nullptr;           ///< Shared with the render thread
+        Upload::Context uploads;                          ///< Loader thread only
+
+        RequestQueue requests;                          ///< Pushed by any thread
+        std::vector<std::unique_ptr<Request>> inFlight; ///< Uploading (loader thread only)
+        std::atomic<bool> stopping{false};              ///< Finish the queue, then exit
+        std::thread thread;                             ///< Loader thread
+
+        Loader() = default;
+        Loader(const Loader&) = delete;
+        Loader& operator=(const Loader&) = delete;
+    };
+
+    /**
+     * @brief Push a request (any thread)
+     * @param queue Request queue
+     * @param request Request to queue (owned by the queue until taken)
+     */
+    void push(RequestQueue &queue, std::unique_ptr<Request> request);
+
+    /**
+     * @brief Take every queued request (consumer thread only)
+     * @param queue Request queue
+     * @return Requests in the order they were pushed
+     */
+    std::vector<std::unique_ptr<Request>> take(RequestQueue &queue);
+
+    /**
+     * @brief Create the loader's upload context and start its thread
+     * @param device Logical device
+     * @param physicalDevice Physical device
+     * @param surface Surface used for queue family selection (may be null when headless)
+     * @param graphicsQueue Graphics queue that consumes the resources
+     * @param transferQueue Transfer queue (may equal graphicsQueue)
+     * @param batcher Batcher the uploads are flushed through (outlives the loader)
+     * @param allocator Allocator shared with the render thread (outlives the loader)
+     * @param loader Output loader
+     */
+    void createLoader(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        VkQueue &graphicsQueue,
+        VkQueue &transferQueue,
+        Submit::Batcher &batcher,
+        Memory::Allocator &allocator,
+        Loader &loader
+    );
+
+    /**
+     * @brief Finish every queued request, stop the thread and destroy the loader
+     * @param loader Loader (every resource it created must be released by now)
+     */
+    void destroyLoader(Loader &loader);
+
+    /**
+     * @brief Queue a device-local buffer created with the given contents (any thread)
+     * @param loader Loader
+     * @param data Source bytes (copied before returning)
+     * @param size Number of bytes
+     * @param usage Buffer usage (TRANSFER_DST is added)
+     * @param dstStage Stage that first consumes the buffer
+     * @param dstAccess Access of that first use
+     * @param category Category the memory is counted against
+     * @return Resolves to the buffer once its copy has completed on the GPU; holds the
+     *         exception instead if the buffer could not be created
+     */
+    std::future<Resource> loadBuffer(
+        Loader &loader,
+        const void *data,
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess,
+        Memory::Category category = Memory::Category::Geometry
+    );
+
+    /**
+     * @brief Queue a sampled texture created from decoded levels (any thread)
+     * @param loader Loader
+     * @param texels Mip chain (moved into the request)
+     * @return Resolves to the image, in SHADER_READ_ONLY_OPTIMAL, once its upload has
+     *         completed; holds the exception instead if the image could not be created
+     */
+    std::future<Resource> loadTexture(Loader &loader, Ktx::TextureData texels);
+
+    /**
+     * @brief Queue the destruction of a resource the loader created (any thread)
+     * @param loader Loader
+     * @param resource Resource no submitted work uses any more
+     */
+    void release(Loader &loader, Resource resource);
+} // namespace Loader
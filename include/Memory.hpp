@@ -0,0 +1,273 @@
+/**
+ * @file Memory.hpp
+ * @brief Device memory sub-allocator backing buffers and images
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Memory
+ * @brief Sub-allocates resources out of large VkDeviceMemory blocks per memory type
+ * @details Avoids one vkAllocateMemory per resource (bounded by maxMemoryAllocationCount)
+ *          and caches the physical device memory properties for memory type lookups. Every
+ *          allocation is also counted against a Category, with a high-water mark, so what the
+ *          memory is spent on (and what outlives its owner) can be reported. One allocator
+ *          serves every thread: allocation, free and the reports lock its mutex.
+ */
+namespace Memory
+{
+    /// Size of a regular memory block (resources larger than half of it get a dedicated block)
+    inline constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+    /// Fraction of a heap's budget past which checkBudget reports the heap
+    inline constexpr float BUDGET_WARNING_FRACTION = 0.9f;
+
+    /**
+     * @enum ResourceKind
+     * @brief Resource layout class used to honour bufferImageGranularity
+     * @details Linear (buffers, linear images) and optimal-tiling images may not share a
+     *          granularity page; free ranges are tagged Free
+     */
+    enum class ResourceKind : std::uint8_t
+    {
+        Free,    ///< Unused range
+        Linear,  ///< Buffers and VK_IMAGE_TILING_LINEAR images
+        Optimal, ///< VK_IMAGE_TILING_OPTIMAL images
+    };
+
+    /**
+     * @enum Strategy
+     * @brief Sub-allocation strategy of a memory block
+     */
+    enum class Strategy : std::uint8_t
+    {
+        FreeList, ///< Best-fit free list with neighbour coalescing on free
+        Linear,   ///< Bump allocation, rewound once every allocation in the block is freed
+    };
+
+    /**
+     * @enum Category
+     * @brief What an allocation holds, for the per-category accounting
+     */
+    enum class Category : std::uint8_t
+    {
+        Other,      ///< Anything not listed below
+        Geometry,   ///< Vertex, index, instance and indirect buffers
+        Uniform,    ///< Uniform rings and CPU-written shader tables
+        Texture,    ///< Sampled images
+        Staging,    ///< Host-visible sources of upload copies
+        Attachment, ///< Render targets and depth buffers
+    };
+
+    /// Number of Category values
+    inline constexpr std::size_t CATEGORY_COUNT = 6;
+
+    /**
+     * @struct Range
+     * @brief Contiguous range inside a free-list block
+     */
+    struct Range
+    {
+        VkDeviceSize offset = 0;                ///< Offset from block start
+        VkDeviceSize size = 0;                  ///< Range size in bytes
+        ResourceKind kind = ResourceKind::Free; ///< Occupant kind (Free if unused)
+    };
+
+    /**
+     * @struct Block
+     * @brief One VkDeviceMemory allocation carved into sub-allocations
+     */
+    struct Block
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE; ///< Backing device memory
+        VkDeviceSize size = 0;                  ///< Block size in bytes
+        std::uint32_t memoryType = 0;           ///< Memory type index of the block
+        Strategy strategy = Strategy::FreeList; ///< Sub-allocation strategy
+        bool dedicated = false;                 ///< Block holds exactly one resource
+        std::byte *mapped = nullptr;            ///< Persistent mapping (host-visible types only)
+        VkDeviceSize used = 0;                  ///< Bytes currently handed out
+
+        std::vector<Range> ranges; ///< Sorted ranges covering the block (free-list strategy)
+
+        VkDeviceSize linearHead = 0;                      ///< Bump pointer (linear strategy)
+        std::uint32_t linearCount = 0;                    ///< Live allocations (linear strategy)
+        ResourceKind linearLastKind = ResourceKind::Free; ///< Kind of last bump allocation
+    };
+
+    /**
+     * @struct Allocation
+     * @brief Sub-allocated memory handed out to a single buffer or image
+     */
+    struct Allocation
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE; ///< Block memory to bind against
+        VkDeviceSize offset = 0;                ///< Offset to bind at
+        VkDeviceSize size = 0;                  ///< Allocated size in bytes
+        void *mapped = nullptr;                 ///< Host pointer at offset (host-visible only)
+        Block *block = nullptr;                 ///< Owning block (allocator internal)
+        Category category = Category::Other;    ///< Accounting category
+    };
+
+    /**
+     * @struct CategoryStats
+     * @brief Bytes one Category holds now and at most so far
+     */
+    struct CategoryStats
+    {
+        VkDeviceSize bytes = 0;     ///< Bytes of the live allocations
+        VkDeviceSize highWater = 0; ///< Most bytes live at once since the allocator was created
+        std::uint32_t count = 0;    ///< Live allocations
+    };
+
+    /**
+     * @struct HeapStats
+     * @brief Usage summary of one memory heap
+     */
+    struct HeapStats
+    {
+        std::uint32_t heapIndex = 0;  ///< Index into VkPhysicalDeviceMemoryProperties heaps
+        VkDeviceSize heapSize = 0;    ///< Total heap size reported by the driver
+        VkDeviceSize reserved = 0;    ///< Bytes allocated from the driver as blocks
+        VkDeviceSize used = 0;        ///< Bytes handed out to resources
+        std::uint32_t blockCount = 0; ///< Number of vkAllocateMemory blocks
+        VkDeviceSize budget = 0;      ///< Bytes the process may use (VK_EXT_memory_budget)
+        VkDeviceSize usage = 0;       ///< Bytes the process uses, all allocators included
+    };
+
+    /**
+     * @struct Allocator
+     * @brief Allocator state: cached device properties and blocks per memory type
+     */
+    struct Allocator
+    {
+        VkDevice device = VK_NULL_HANDLE;                    ///< Logical device
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;    ///< Physical device
+        VkPhysicalDeviceMemoryProperties memoryProperties{}; ///< Cached memory properties
+        VkDeviceSize bufferImageGranularity = 1;             ///< Linear/optimal page size
+        VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE;         ///< Regular block size
+        std::uint32_t deviceAllocationCount = 0;             ///< Live vkAllocateMemory calls
+        std::uint32_t maxDeviceAllocationCount = 0;          ///< maxMemoryAllocationCount limit
+        bool memoryBudget = false;                           ///< VK_EXT_memory_budget enabled
+        std::uint32_t overBudgetHeaps = 0;                   ///< Heaps checkBudget reported (bits)
+
+        /// Blocks indexed by memory type
+        std::array<std::vector<std::unique_ptr<Block>>, VK_MAX_MEMORY_TYPES> blocks;
+
+        /// Accounting indexed by Category
+        std::array<CategoryStats, CATEGORY_COUNT> categories{};
+
+        /// Guards the blocks, the accounting and overBudgetHeaps (the rest is set once)
+        mutable std::mutex mutex;
+
+        Allocator() = default;
+        Allocator(const Allocator&) = delete;
+        Allocator& operator=(const Allocator&) = delete;
+    };
+
+    /**
+     * @brief Initialise the allocator and cache device memory properties
+     * @param device Logical device
+     * @param physicalDevice Physical device to query once
+     * @param allocator Output allocator state
+     * @param memoryBudget VK_EXT_memory_budget is enabled on the device
+     * @param blockSize Size of regular blocks in bytes
+     */
+    void createAllocator(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Allocator &allocator,
+        bool memoryBudget = false,
+        VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE
+    );
+
+    /**
+     * @brief Release every block owned by the allocator
+     * @param allocator Allocator to destroy
+     * @details All resources bound to the allocator must already be destroyed
+     */
+    void destroyAllocator(Allocator &allocator);
+
+    /**
+     * @brief Sub-allocate memory satisfying the given requirements
+     * @param allocator Allocator to allocate from
+     * @param requirements Size, alignment and memory type bits of the resource
+     * @param properties Required memory property flags
+     * @param kind Linear (buffers) or optimal (images) for granularity handling
+     * @param allocation Output allocation
+     * @param category Category the allocation is counted against
+     * @param strategy Free-list (default) or linear block strategy
+     * @throws std::runtime_error if no memory type matches or the device is out of memory
+     */
+    void allocateMemory(
+        Allocator &allocator,
+        const VkMemoryRequirements &requirements,
+        VkMemoryPropertyFlags properties,
+        ResourceKind kind,
+        Allocation &allocation,
+        Category category,
+        Strategy strategy = Strategy::FreeList
+    );
+
+    /**
+     * @brief Return an allocation to its block
+     * @param allocator Allocator that produced the allocation
+     * @param allocation Allocation to free (reset to empty on return)
+     * @details Dedicated and empty surplus blocks are given back to the driver
+     */
+    void freeAllocation(Allocator &allocator, Allocation &allocation);
+
+    /**
+     * @brief Report bytes used versus reserved for every memory heap
+     * @param allocator Allocator to inspect
+     * @return One entry per memory heap
+     * @details budget and usage come from VK_EXT_memory_budget when enabled; otherwise they
+     *          fall back to the heap size and to the bytes this allocator reserved
+     */
+    std::vector<HeapStats> getHeapStats(const Allocator &allocator);
+
+    /**
+     * @brief Report the heaps whose usage crossed a fraction of their budget
+     * @param allocator Allocator to inspect (remembers which heaps were reported)
+     * @param fraction Fraction of the budget counted as close to oversubscribed
+     * @return Heaps over the fraction now that were under it at the previous call
+     * @details A heap is reported once per crossing: it must drop back under the fraction to
+     *          be reported again. Without VK_EXT_memory_budget the budget is the heap size and
+     *          the usage is this allocator's own, so other processes go unseen.
+     */
+    std::vector<HeapStats> checkBudget(
+        Allocator &allocator, float fraction = BUDGET_WARNING_FRACTION
+    );
+
+    /**
+     * @brief Lower-case name of a category, as the reports print it
+     * @param category Category
+     * @return Name, e.g. "geometry"
+     */
+    std::string_view categoryName(Category category);
+
+    /**
+     * @brief Read one category's accounting
+     * @param allocator Allocator to inspect
+     * @param category Category
+     * @return Snapshot of its live bytes, allocation count and high-water mark
+     */
+    CategoryStats getCategoryStats(const Allocator &allocator, Category category);
+
+    /**
+     * @brief Describe every heap and category in a few human-readable lines
+     * @param allocator Allocator to inspect
+     * @return One line per heap (usage versus budget) then one per category (live bytes,
+     *         high-water mark and allocation count), each ending in a newline
+     */
+    std::string formatReport(const Allocator &allocator);
+} // namespace Memory
@@ -0,0 +1,62 @@
+/**
+ * @file PipelineCache.hpp
+ * @brief VkPipelineCache persisted to disk between runs
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace PipelineCache
+ * @brief Loads the driver's pipeline cache blob at startup and writes it back on shutdown
+ * @details The blob is only handed to the driver when its header matches the current GPU
+ *          (vendor ID, device ID and pipelineCacheUUID); otherwise the cache starts empty
+ *          and is overwritten on save.
+ */
+namespace PipelineCache
+{
+    /// Default location of the serialized cache (next to the compiled shaders)
+    constexpr std::string_view cachePath = "build/pipeline_cache.bin";
+
+    /**
+     * @brief Check that a cache blob was produced by this GPU and driver
+     * @param physicalDevice Physical device the cache will be used with
+     * @param data Blob contents
+     * @param size Blob size in bytes
+     * @return true if the VkPipelineCacheHeaderVersionOne header matches
+     */
+    bool isCompatible(const VkPhysicalDevice physicalDevice, const void *data, std::size_t size);
+
+    /**
+     * @brief Create the pipeline cache, seeded from disk when a compatible file exists
+     * @param device Logical device
+     * @param physicalDevice Physical device used to validate the file header
+     * @param pipelineCache Output pipeline cache
+     * @param path File to load from
+     * @throws std::runtime_error if the cache cannot be created
+     * @details A missing, truncated or foreign file is ignored rather than treated as an error
+     */
+    void createPipelineCache(
+        VkDevice &device,
+        const VkPhysicalDevice physicalDevice,
+        VkPipelineCache &pipelineCache,
+        const std::filesystem::path &path = cachePath
+    );
+
+    /**
+     * @brief Write the cache contents to disk
+     * @param device Logical device
+     * @param pipelineCache Pipeline cache to serialize
+     * @param path File to write (replaced atomically through a temporary file)
+     * @return true if the file was written
+     */
+    bool savePipelineCache(
+        VkDevice &device,
+        const VkPipelineCache pipelineCache,
+        const std::filesystem::path &path = cachePath
+    );
+} // namespace PipelineCache
@@ -0,0 +1,217 @@
+/**
+ * @file PipelineRegistry.hpp
+ * @brief Graphics pipeline variants keyed by a state hash, compiled in the background
+ */
+
+#pragma once
+
+#include "AssetPack.hpp"
+#include "GraphicsPipeline.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Pipelines
+ * @brief Owns every pipeline variant and the shader modules they are built from
+ * @details A variant is requested by its GraphicsPipeline::PipelineState. Unknown variants are
+ *          queued for a compiler thread and draws use the fallback pipeline until the real one
+ *          is ready, so the render loop never waits on the driver. Shader modules are created
+ *          once per SPIR-V path and shared by all variants.
+ *
+ *          Reloading a shader replaces its module and queues every variant built from it.
+ *          The rebuilt pipelines wait as replacements until swapReloaded installs them at a
+ *          frame boundary, so a frame never mixes old and new pipelines and nothing waits on
+ *          a compile. The replaced module is handed out there too, once every compile that
+ *          started before the reload has finished.
+ */
+namespace Pipelines
+{
+    /// Identifies a variant (GraphicsPipeline::hashState of its state)
+    using PipelineKey = std::uint64_t;
+
+    /**
+     * @enum Status
+     * @brief Compilation progress of a variant
+     */
+    enum class Status : std::uint8_t
+    {
+        Queued, ///< Waiting for or being compiled by a compiler thread
+        Ready,  ///< Pipeline handle is valid
+        Failed  ///< Compilation threw; the fallback is used until a shader reload
+    };
+
+    /**
+     * @struct Variant
+     * @brief One pipeline variant and its compilation state
+     */
+    struct Variant
+    {
+        GraphicsPipeline::PipelineState state;   ///< State the pipeline is built from
+        VkPipeline pipeline = VK_NULL_HANDLE;    ///< Valid once status is Ready
+        Status status = Status::Queued;          ///< Compilation progress
+        std::string error;                       ///< Why the compile (or last rebuild) failed
+        VkPipeline replacement = VK_NULL_HANDLE; ///< Rebuilt after a reload, not yet swapped in
+        std::uint32_t pendingRebuilds = 0;       ///< Reload compiles queued or in progress
+    };
+
+    /**
+     * @struct RetiredModule
+     * @brief A module replaced by a reload, kept while an earlier compile may read it
+     */
+    struct RetiredModule
+    {
+        VkShaderModule module = VK_NULL_HANDLE; ///< Replaced module
+        std::uint64_t lastCompile = 0;          ///< Last compile started before the reload
+    };
+
+    /**
+     * @struct Registry
+     * @brief Pipeline variants, the compile queue and the shader module cache
+     */
+    struct Registry
+    {
+        VkDevice device = VK_NULL_HANDLE;         ///< Logical device
+        VkPipelineLayout layout = VK_NULL_HANDLE; ///< Layout shared by every variant
+        VkPipelineCache cache = VK_NULL_HANDLE;   ///< Driver cache used for compiles
+        VkPipeline fallback = VK_NULL_HANDLE;     ///< Bound while a variant compiles
+        PipelineKey fallbackKey = 0;              ///< Variant of the fallback (followed on swap)
+        const AssetPack::Pack *pack = nullptr;    ///< Checked for SPIR-V before the disk
+
+        std::mutex mutex;                                  ///< Guards variants, queue, stopping
+        std::condition_variable wake;                      ///< Signals queued work or shutdown
+        std::unordered_map<PipelineKey, Variant> variants; ///< Every requested variant
+        std::deque<PipelineKey> queue;                     ///< Variants waiting for a compiler
+        std::vector<std::thread> compilers;                ///< Background compile threads
+        bool stopping = false;                             ///< Set when the registry is destroyed
+
+        std::uint64_t compilesStarted = 0;         ///< Serial of the last compile begun
+        std::vector<std::uint64_t> running;        ///< Serials of the compiles under way
+        std::vector<RetiredModule> retiredModules; ///< Replaced, in reload order (mutex)
+
+        std::mutex moduleMutex;                                  ///< Guards the modules
+        std::unordered_map<std::string, VkShaderModule> modules; ///< One module per SPIR-V path
+
+        Registry() = default;
+        Registry(const Registry&) = delete;
+        Registry& operator=(const Registry&) = delete;
+    };
+
+    /**
+     * @brief Initialise the registry and start its compiler threads
+     * @param device Logical device
+     * @param layout Pipeline layout shared by every variant
+     * @param cache Pipeline cache (may be VK_NULL_HANDLE)
+     * @param registry Registry to initialise
+     * @param compilerCount Number of background compile threads
+     * @param pack Mapped asset pack to take shaders from (may be nullptr; must outlive registry)
+     */
+    void createRegistry(
+        VkDevice &device,
+        VkPipelineLayout &layout,
+        VkPipelineCache &cache,
+        Registry &registry,
+        std::uint32_t compilerCount = 1,
+        const AssetPack::Pack *pack = nullptr
+    );
+
+    /**
+     * @brief Stop the compiler threads and destroy every pipeline and shader module
+     * @param registry Registry to destroy (no pipeline may still be in use by the GPU)
+     */
+    void destroyRegistry(Registry &registry);
+
+    /**
+     * @brief Get the shader module of a SPIR-V file, loading it on first use
+     * @param registry Registry
+     * @param path Path to the SPIR-V binary
+     * @return Shader module owned by the registry
+     * @throws std::runtime_error if the file is missing or not SPIR-V
+     * @details Thread-safe; concurrent requests for a new path may both read the file but only
+     *          one module is kept
+     */
+    VkShaderModule getShaderModule(Registry &registry, const std::string &path);
+
+    /**
+     * @brief Replace the module of a SPIR-V path and queue the variants built from it
+     * @param registry Registry
+     * @param path SPIR-V path the variants name (GraphicsPipeline::PipelineState)
+     * @param code New SPIR-V
+     * @return Number of variants queued for a rebuild
+     * @throws std::runtime_error if the code is not SPIR-V (the old module stays)
+     * @details Ready variants keep their pipeline until swapReloaded; failed ones are retried
+     *          and bound as soon as they are ready. A compile started earlier may still be
+     *          reading the replaced module, so swapReloaded hands it out only once those
+     *          compiles are done; queued compiles read the new one.
+     */
+    std::uint32_t reloadShader(
+        Registry &registry, const std::string &path, std::span<const std::byte> code
+    );
+
+    /**
+     * @brief Install the pipelines rebuilt since the last call
+     * @param registry Registry
+     * @param retired Output: the pipelines replaced, to destroy once no submitted frame uses
+     *                them
+     * @param retiredModules Output: replaced shader modules no compile can still read, to
+     *                       destroy (the caller owns them now)
+     * @return Number of variants swapped
+     * @details Call at a frame boundary, before the frame resolves its pipelines
+     */
+    std::uint32_t swapReloaded(
+        Registry &registry,
+        std::vector<VkPipeline> &retired,
+        std::vector<VkShaderModule> &retiredModules
+    );
+
+    /**
+     * @brief Request a variant, queueing it for background compilation if it is new
+     * @param registry Registry
+     * @param state Pipeline state
+     * @return Key to resolve the pipeline with
+     * @throws std::runtime_error on a hash collision between two different states
+     */
+    PipelineKey request(Registry &registry, const GraphicsPipeline::PipelineState &state);
+
+    /**
+     * @brief Compile a variant on the calling thread and wait for it
+     * @param registry Registry
+     * @param state Pipeline state
+     * @return Key of the ready variant
+     * @throws std::runtime_error if compilation fails
+     * @details Used for the fallback and anything needed before the first frame
+     */
+    PipelineKey build(Registry &registry, const GraphicsPipeline::PipelineState &state);
+
+    /**
+     * @brief Make a ready variant the pipeline used for unfinished variants
+     * @param registry Registry
+     * @param key Key returned by build
+     * @throws std::runtime_error if the variant is not ready
+     */
+    void setFallback(Registry &registry, PipelineKey key);
+
+    /**
+     * @brief Pipeline to bind for a variant
+     * @param registry Registry
+     * @param key Variant key
+     * @return The variant's pipeline when ready, the fallback otherwise
+     */
+    VkPipeline resolve(Registry &registry, PipelineKey key);
+
+    /**
+     * @brief Compilation progress of a variant
+     * @param registry Registry
+     * @param key Variant key
+     * @return Status (Failed for unknown keys)
+     */
+    Status status(Registry &registry, PipelineKey key);
+} // namespace Pipelines
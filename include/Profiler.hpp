@@ -0,0 +1,299 @@
+/**
+ * @file Profiler.hpp
+ * @brief CPU scoped timers, GPU timestamp and statistics queries, and Chrome trace export
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Profiler
+ * @brief Frame-time breakdown for the CPU stages and the GPU passes of every frame
+ * @details CPU zones nest on a stack and are timed with steady_clock on the main thread. GPU
+ *          zones write a timestamp pair into the frame slot's range of one query pool, and each
+ *          frame is wrapped in a pipeline-statistics query. A slot's results are read back
+ *          without waiting the next time the slot is recorded, after its timeline wait, so
+ *          reading never stalls. GPU zones also open VK_EXT_debug_utils labels when the
+ *          instance enabled the extension. Averages go to the console every SUMMARY_INTERVAL
+ *          frames; with a trace path every zone is kept and written as Chrome trace JSON
+ *          (chrome://tracing, ui.perfetto.dev) at shutdown. A disabled profiler costs a branch
+ *          per call.
+ */
+namespace Profiler
+{
+    /// GPU zones a frame may open (each takes two timestamp queries)
+    inline constexpr std::uint32_t MAX_GPU_ZONES = 16;
+
+    /// Frames between two console summaries
+    inline constexpr std::uint32_t SUMMARY_INTERVAL = 300;
+
+    /// Trace events kept for export; later zones are only counted in the summaries
+    inline constexpr std::size_t MAX_TRACE_EVENTS = std::size_t{1} << 20;
+
+    /// Pipeline statistics gathered per frame, in query result order
+    inline constexpr std::array<VkQueryPipelineStatisticFlagBits, 5> STATISTICS = {
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT,
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT,
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT,
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT,
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT,
+    };
+
+    /// Summary labels of STATISTICS
+    inline constexpr std::array<std::string_view, 5> STATISTIC_NAMES = {
+        "vertices", "primitives", "vertex invocations", "fragment invocations",
+        "compute invocations"
+    };
+
+    /**
+     * @struct TraceEvent
+     * @brief One finished zone, in microseconds since the profiler was created
+     */
+    struct TraceEvent
+    {
+        const char *name = nullptr; ///< Zone name (string literal)
+        double beginUs = 0.0;       ///< Start time
+        double durationUs = 0.0;    ///< Length
+        bool gpu = false;           ///< GPU track (placed relative to the frame's submission)
+        std::uint32_t worker = 0;   ///< Job system worker of a CPU zone (0 = main thread)
+    };
+
+    /**
+     * @struct ZoneStats
+     * @brief Time accumulated by one zone name since the last summary
+     */
+    struct ZoneStats
+    {
+        double totalMs = 0.0;    ///< Summed duration
+        std::uint32_t count = 0; ///< Zones summed
+    };
+
+    /**
+     * @struct GpuFrame
+     * @brief Queries recorded by one frame slot
+     */
+    struct GpuFrame
+    {
+        std::vector<const char *> zones;      ///< Timestamps 2i (begin) and 2i+1 (end)
+        std::vector<std::uint32_t> openZones; ///< Zones begun but not yet ended
+        bool statistics = false;              ///< The statistics query was recorded
+        bool submitted = false;               ///< Results are pending read-back
+        double submitUs = 0.0;                ///< CPU time of the submission
+    };
+
+    /**
+     * @struct Profiler
+     * @brief Zone timings, query pools and the trace being collected
+     */
+    struct Profiler
+    {
+        bool enabled = false;                         ///< Every call is a no-op when false
+        std::string tracePath;                        ///< Chrome trace path (empty = console)
+        std::chrono::steady_clock::time_point origin; ///< Trace time zero
+
+        /// Open CPU zones, innermost last
+        std::vector<std::pair<const char *, std::chrono::steady_clock::time_point>> cpuStack;
+
+        VkDevice device = VK_NULL_HANDLE;        ///< Logical device (GPU queries only)
+        VkQueryPool timestamps = VK_NULL_HANDLE; ///< 2 * MAX_GPU_ZONES queries per slot
+        VkQueryPool statistics = VK_NULL_HANDLE; ///< One query per slot (if supported)
+        bool inheritedQueries = false;           ///< Secondaries may run inside the query
+        double timestampPeriod = 0.0;            ///< Nanoseconds per timestamp tick
+        std::uint64_t timestampMask = 0;         ///< Valid bits of a timestamp
+        std::vector<GpuFrame> frames;            ///< Indexed by frame slot
+
+        PFN_vkCmdBeginDebugUtilsLabelEXT beginLabel = nullptr; ///< Null without debug_utils
+        PFN_vkCmdEndDebugUtilsLabelEXT endLabel = nullptr;     ///< Null without debug_utils
+
+        std::vector<TraceEvent> events;                 ///< Kept only with a trace path
+        std::map<std::string_view, ZoneStats> cpuZones; ///< CPU time per zone name
+        std::map<std::string_view, ZoneStats> gpuZones; ///< GPU time per zone name
+        std::uint32_t framesSinceSummary = 0;           ///< Frames ended since the summary
+
+        std::array<std::uint64_t, STATISTICS.size()> statisticTotals{}; ///< Summed statistics
+        std::uint32_t statisticFrames = 0;                              ///< Frames summed
+
+        bool keepFrameTimes = false;      ///< Record every "gpu frame" duration (benchmarks)
+        std::vector<double> frameTimesMs; ///< "gpu frame" durations in submission order
+        double lastFrameMs = 0.0;         ///< Latest "gpu frame" read back (0 = none yet)
+
+        Profiler() = default;
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+    };
+
+    /**
+     * @class Scope
+     * @brief Times a CPU zone for the lifetime of the object
+     * @details Zones opened with beginCpuZone inside the scope and still open when it ends
+     *          (an early return) are closed with it
+     */
+    class Scope
+    {
+      public:
+        /**
+         * @brief Open a CPU zone
+         * @param profiler Profiler
+         * @param name Zone name (string literal)
+         */
+        Scope(Profiler &profiler, const char *name);
+
+        /// Close the zone and any zone left open inside it
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+      private:
+        Profiler &profiler; ///< Profiler the zone belongs to
+        std::size_t depth;  ///< cpuStack size before the zone was opened
+    };
+
+    /**
+     * @brief Start timing (CPU zones only until createGpuQueries)
+     * @param profiler Output profiler
+     * @param enabled Record anything at all
+     * @param tracePath Trace file written by destroyProfiler (empty = summaries only)
+     */
+    void createProfiler(Profiler &profiler, bool enabled, const std::string &tracePath);
+
+    /**
+     * @brief Create the query pools and resolve the debug label entry points
+     * @param profiler Profiler
+     * @param instance Instance (debug_utils entry points)
+     * @param device Logical device
+     * @param physicalDevice Physical device for the timestamp period and statistics support
+     * @param surface Surface for queue family selection
+     * @param frameCount Frames in flight
+     * @param debugLabels The instance enabled VK_EXT_debug_utils
+     * @details GPU zones are skipped when the graphics family has no timestamp bits; the
+     *          statistics query when pipelineStatisticsQuery is not enabled. The device is
+     *          expected to enable inheritedQueries whenever it is supported.
+     */
+    void createGpuQueries(
+        Profiler &profiler,
+        VkInstance instance,
+        VkDevice device,
+        VkPhysicalDevice physicalDevice,
+        VkSurfaceKHR surface,
+        std::uint32_t frameCount,
+        bool debugLabels
+    );
+
+    /**
+     * @brief Print the last summary, write the trace and destroy the query pools
+     * @param profiler Profiler to destroy (no frame may be in flight)
+     * @throws std::runtime_error if the trace file cannot be written
+     */
+    void destroyProfiler(Profiler &profiler);
+
+    /**
+     * @brief Read back every submitted slot
+     * @param profiler Profiler (no frame may be in flight)
+     * @details Lets frameTimesMs be complete before the profiler is destroyed
+     */
+    void collect(Profiler &profiler);
+
+    /**
+     * @brief Open a CPU zone (main thread only)
+     * @param profiler Profiler
+     * @param name Zone name (string literal)
+     */
+    void beginCpuZone(Profiler &profiler, const char *name);
+
+    /**
+     * @brief Close the innermost CPU zone
+     * @param profiler Profiler
+     */
+    void endCpuZone(Profiler &profiler);
+
+    /**
+     * @brief Record a CPU zone timed elsewhere, e.g. by a task on a worker thread
+     * @param profiler Profiler (main thread only)
+     * @param name Zone name (string literal)
+     * @param begin Start time
+     * @param end Finish time
+     * @param worker Job system worker that ran it (its own trace thread; 0 = main thread)
+     */
+    void addCpuZone(
+        Profiler &profiler,
+        const char *name,
+        std::chrono::steady_clock::time_point begin,
+        std::chrono::steady_clock::time_point end,
+        std::uint32_t worker
+    );
+
+    /**
+     * @brief Read back the slot's previous results and start its queries
+     * @param profiler Profiler
+     * @param commandBuffer Frame's primary command buffer, outside a render pass
+     * @param frameIndex Frame slot (its timeline wait has completed)
+     * @param secondaries The frame executes secondary command buffers
+     * @details Resets the slot's queries, opens a "gpu frame" zone and begins the statistics
+     *          query. Without inheritedQueries no query may be active around
+     *          vkCmdExecuteCommands, so such frames go uncounted.
+     */
+    void beginGpuFrame(
+        Profiler &profiler,
+        VkCommandBuffer commandBuffer,
+        std::uint32_t frameIndex,
+        bool secondaries
+    );
+
+    /**
+     * @brief Statistics counted by the slot's active query
+     * @param profiler Profiler
+     * @param frameIndex Frame slot, between beginGpuFrame and endGpuFrame
+     * @return Flags for VkCommandBufferInheritanceInfo::pipelineStatistics (0 = no query)
+     */
+    VkQueryPipelineStatisticFlags activeStatistics(
+        const Profiler &profiler, std::uint32_t frameIndex
+    );
+
+    /**
+     * @brief End the statistics query and the "gpu frame" zone
+     * @param profiler Profiler
+     * @param commandBuffer Frame's primary command buffer, outside a render pass
+     * @param frameIndex Frame slot
+     */
+    void endGpuFrame(Profiler &profiler, VkCommandBuffer commandBuffer, std::uint32_t frameIndex);
+
+    /**
+     * @brief Open a GPU zone and its debug label
+     * @param profiler Profiler
+     * @param commandBuffer Primary command buffer, outside a render pass with secondaries
+     * @param frameIndex Frame slot
+     * @param name Zone name (string literal)
+     */
+    void beginGpuZone(
+        Profiler &profiler,
+        VkCommandBuffer commandBuffer,
+        std::uint32_t frameIndex,
+        const char *name
+    );
+
+    /**
+     * @brief Close the innermost GPU zone of the slot
+     * @param profiler Profiler
+     * @param commandBuffer Command buffer the zone was opened in
+     * @param frameIndex Frame slot
+     */
+    void endGpuZone(Profiler &profiler, VkCommandBuffer commandBuffer, std::uint32_t frameIndex);
+
+    /**
+     * @brief Mark the slot's queries as submitted and print a summary when one is due
+     * @param profiler Profiler
+     * @param frameIndex Frame slot just submitted
+     */
+    void endFrame(Profiler &profiler, std::uint32_t frameIndex);
+} // namespace Profiler
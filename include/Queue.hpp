@@ -11,7 +11,7 @@
 
 /**
  * @namespace Queue
- * @brief Finds queue families supporting graphics and presentation
+ * @brief Finds queue families supporting graphics, compute and presentation
  */
 namespace Queue
 {
@@ -23,23 +23,58 @@ namespace Queue
     {
         std::optional<std::uint32_t> graphicsFamily; ///< Graphics operations queue family
         std::optional<std::uint32_t> presentFamily;  ///< Presentation to surface queue family
+        std::optional<std::uint32_t> transferFamily; ///< Transfer family (dedicated if available)
+        std::optional<std::uint32_t> computeFamily;  ///< Compute family (shared with graphics)
+
+        /// Compute family without graphics, for work that overlaps the frame (async compute)
+        std::optional<std::uint32_t> asyncComputeFamily;
+
+        /// Queue index in asyncComputeFamily (1 when it shares the transfer family's)
+        std::uint32_t asyncComputeIndex = 0;
+
+        /**
+         * @brief Check if transfers run on a family other than graphics
+         * @return true if a dedicated transfer family was found
+         */
+        bool hasDedicatedTransfer() const
+        {
+            return transferFamily.has_value() && transferFamily != graphicsFamily;
+        }
+
+        /**
+         * @brief Check if compute can run beside graphics on a queue of its own
+         * @return true if an async compute family (and queue) was found
+         */
+        bool hasAsyncCompute() const
+        {
+            return asyncComputeFamily.has_value();
+        }
 
         /**
          * @brief Check if all required queue families are found
-         * @return true if both graphics and present families are available
+         * @return true if graphics, compute and present families are available
          */
         bool isComplete() const
         {
-            return graphicsFamily.has_value() && presentFamily.has_value();
+            return graphicsFamily.has_value() && presentFamily.has_value()
+                   && computeFamily.has_value();
         }
     };
 
     /**
-     * @brief Find queue families supporting graphics and presentation
+     * @brief Find queue families supporting graphics, compute and presentation
      * @param device Physical device to query
-     * @param surface Surface for presentation support check
+     * @param surface Surface for presentation support check (VK_NULL_HANDLE = headless, the
+     *        graphics family doubles as the present family)
      * @return Queue family indices
-     * @details Searches for families supporting both graphics commands and surface presentation
+     * @details Searches for families supporting both graphics commands and surface presentation.
+     *          The graphics family is one that also supports compute (the spec guarantees one
+     *          exists), so compute passes record into the frame's command buffer and the
+     *          compute family is the graphics family. The transfer family prefers a
+     *          transfer-only family (DMA engine), then any non-graphics family with transfer
+     *          support, and falls back to graphics. The async compute family is a compute
+     *          family without graphics other than the transfer family, or the transfer family
+     *          itself when it has a second queue; there is none otherwise.
      */
     FamilyIndices findQueueFamilies(const VkPhysicalDevice device, const VkSurfaceKHR surface);
 } // namespace Queue
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 /**
@@ -42,4 +43,12 @@ namespace RenderConstants
     /// Axis of rotation (Z-axis for spinning in XY plane)
     constexpr glm::vec3 ROTATION_AXIS{0.0f, 0.0f, 1.0f};
 
+    /// Sideways drift of the farthest sprite layer in pixels per second (nearer ones multiply it)
+    constexpr float SPRITE_SPEED = 20.0f;
+
+    // === Memory Configuration ===
+
+    /// Frames between two checks of the heap budgets (each one queries the driver)
+    constexpr std::uint32_t MEMORY_CHECK_FRAMES = 60;
+
 } // namespace RenderConstants
@@ -0,0 +1,351 @@
+/**
+ * @file RenderGraph.hpp
+ * @brief Frame passes declared by what they read and write, with derived barriers and
+ *        aliased transient attachments
+ */
+
+#pragma once
+
+#include "Memory.hpp"
+#include "Profiler.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace RenderGraph
+ * @brief Orders the GPU work of a frame and synchronises it from declared resource usage
+ * @details Passes run in declaration order. compile() walks them once, tracking the pipeline
+ *          stages, accesses and layout each resource was last used with, and emits one batched
+ *          barrier per pass boundary that actually has a hazard: read after read in the same
+ *          layout needs none, buffer hazards are merged into one global memory barrier, and
+ *          image hazards become image barriers of the same call. A frame's first use of a
+ *          resource waits on its last use in the previous frame, so resources shared by frames
+ *          in flight need no barrier of their own. Buffers imported per frame have one copy
+ *          per frame slot, last used by a frame the host already waited for, so their first
+ *          use waits on nothing and frames in flight overlap.
+ *
+ *          Stages and accesses are tracked as synchronization2 masks, so each image barrier
+ *          waits on its own stages only and reads are told apart (sampled, storage, vertex
+ *          attribute). With Graph::pipelineBarrier2 set a boundary is one vkCmdPipelineBarrier2;
+ *          otherwise the masks are folded into their Vulkan 1.0 equivalents and one
+ *          vkCmdPipelineBarrier waits on the union of the stages.
+ *
+ *          Transient images live for one frame. They are owned by the graph, created for an
+ *          extent by createTransients, and images whose pass ranges do not overlap share one
+ *          memory range. Attachment-only transients get VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+ *          and lazily allocated memory when the device has it (tilers keep them on chip).
+ *          Imported images and buffers are owned by the caller.
+ */
+namespace RenderGraph
+{
+    /// Index of an image (Graph::images) or a buffer (Graph::buffers)
+    using ResourceId = std::uint32_t;
+
+    /// Index of a pass in Graph::passes
+    using PassId = std::uint32_t;
+
+    /// firstPass and lastPass of an image no pass uses
+    inline constexpr PassId NO_PASS = UINT32_MAX;
+
+    /**
+     * @enum Usage
+     * @brief How a pass uses a resource: the stages, accesses and image layout it implies
+     */
+    enum class Usage : std::uint8_t
+    {
+        ColorAttachment, ///< Colour attachment, written (and read when blending)
+        DepthAttachment, ///< Depth attachment, tested and written
+        DepthRead,       ///< Depth attachment, tested only (read-only layout)
+        SampledFragment, ///< Sampled by fragment shaders
+        SampledCompute,  ///< Sampled by compute shaders
+        StorageRead,     ///< Storage image or buffer read by compute shaders
+        StorageWrite,    ///< Storage image or buffer written (and read) by compute shaders
+        TransferRead,    ///< Copy or blit source
+        TransferWrite,   ///< Copy, fill or update destination
+        IndirectRead,    ///< Indirect draw or dispatch arguments
+        VertexRead,      ///< Vertex or instance attributes
+        Present,         ///< Handed to the presentation engine (exit usage only)
+    };
+
+    /**
+     * @struct Access
+     * @brief One resource used by a pass
+     */
+    struct Access
+    {
+        ResourceId resource = 0;                                   ///< Image or buffer id
+        Usage usage = Usage::SampledFragment;                      ///< How it is used
+        VkAttachmentLoadOp load = VK_ATTACHMENT_LOAD_OP_DONT_CARE; ///< Attachments only
+    };
+
+    /**
+     * @struct State
+     * @brief Last use of a resource while the graph is walked
+     */
+    struct State
+    {
+        VkPipelineStageFlags2 stages = 0;                 ///< Stages since the last hazard
+        VkAccessFlags2 access = 0;                        ///< Accesses made by those stages
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; ///< Current layout (images only)
+        bool written = false;                             ///< The accesses include a write
+    };
+
+    /**
+     * @struct Image
+     * @brief Image resource of the graph
+     */
+    struct Image
+    {
+        const char *name = nullptr;            ///< Debug name (string literal)
+        VkFormat format = VK_FORMAT_UNDEFINED; ///< Image and view format
+        VkImageAspectFlags aspect = 0;         ///< Aspects the barriers and views cover
+        bool transient = false;                ///< Created by the graph, one frame long
+        VkImage image = VK_NULL_HANDLE;        ///< Imported only: bound with bindImage
+        State ready;                           ///< Imported only: state at frame start
+        std::optional<Usage> exitUsage;        ///< Imported only: usage after the frame
+        VkImageUsageFlags usage = 0;           ///< Usage flags derived by compile()
+        std::uint32_t slot = 0;                ///< Transient only: shared memory range
+        PassId firstPass = NO_PASS;            ///< First pass using it
+        PassId lastPass = NO_PASS;             ///< Last pass using it
+    };
+
+    /**
+     * @struct Buffer
+     * @brief Imported buffer resource of the graph
+     * @details Only accesses are tracked: buffer hazards become global memory barriers, so
+     *          the handle itself is never needed
+     */
+    struct Buffer
+    {
+        const char *name = nullptr; ///< Debug name (string literal)
+        bool perFrame = false;      ///< One copy per frame slot, bound before every execute
+    };
+
+    /**
+     * @struct Pass
+     * @brief One node of the graph
+     */
+    struct Pass
+    {
+        const char *name = nullptr;  ///< Pass name, also its GPU profiler zone
+        std::vector<Access> images;  ///< Images used, attachments in attachment order
+        std::vector<Access> buffers; ///< Buffers used
+
+        /// Pass commands, set before every execute
+        std::function<void(VkCommandBuffer)> record;
+    };
+
+    /**
+     * @struct ImageBarrier
+     * @brief Layout transition or memory dependency of one image at a pass boundary
+     */
+    struct ImageBarrier
+    {
+        ResourceId image = 0;                                ///< Image id
+        VkPipelineStageFlags2 srcStages = 0;                 ///< Stages of its last use
+        VkPipelineStageFlags2 dstStages = 0;                 ///< Stages of its next use
+        VkAccessFlags2 srcAccess = 0;                        ///< Writes made available
+        VkAccessFlags2 dstAccess = 0;                        ///< Accesses made visible
+        VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED; ///< Prior layout (UNDEFINED: discard)
+        VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED; ///< Layout of the next use
+    };
+
+    /**
+     * @struct Barrier
+     * @brief Everything recorded at one pass boundary, as a single pipeline barrier
+     */
+    struct Barrier
+    {
+        VkPipelineStageFlags2 srcStages = 0; ///< Buffer stages waited on (0 = no memory barrier)
+        VkPipelineStageFlags2 dstStages = 0; ///< Buffer stages that wait
+        VkAccessFlags2 srcAccess = 0;        ///< Buffer writes made available
+        VkAccessFlags2 dstAccess = 0;        ///< Buffer accesses made visible
+        std::vector<ImageBarrier> images;    ///< Image transitions of the boundary
+    };
+
+    /**
+     * @struct Graph
+     * @brief Declared resources and passes, and the barriers compile() derived for them
+     */
+    struct Graph
+    {
+        std::vector<Image> images;     ///< Transient and imported images
+        std::vector<Buffer> buffers;   ///< Imported buffers
+        std::vector<Pass> passes;      ///< Passes in execution order
+        std::vector<Barrier> barriers; ///< Before each pass, then one after the last
+        std::uint32_t slotCount = 0;   ///< Memory ranges the transient images alias into
+        bool compiled = false;         ///< compile() ran since the last declaration
+
+        /// vkCmdPipelineBarrier2 when the device enabled synchronization2 (null = Vulkan 1.0)
+        PFN_vkCmdPipelineBarrier2 pipelineBarrier2 = nullptr;
+
+        std::vector<VkImageMemoryBarrier> scratch;   ///< Barrier structs reused by execute
+        std::vector<VkImageMemoryBarrier2> scratch2; ///< Same, on the synchronization2 path
+
+        Graph() = default;
+        Graph(const Graph&) = delete;
+        Graph& operator=(const Graph&) = delete;
+        Graph(Graph&&) = default;
+        Graph& operator=(Graph&&) = default;
+    };
+
+    /**
+     * @struct Transients
+     * @brief Transient images of a graph created for one extent
+     */
+    struct Transients
+    {
+        std::vector<VkImage> images;            ///< Indexed by image id (null when imported)
+        std::vector<VkImageView> views;         ///< Indexed by image id (null when imported)
+        std::vector<Memory::Allocation> memory; ///< One allocation per aliasing slot
+        bool lazilyAllocated = false;           ///< Some slot uses lazily allocated memory
+
+        Transients() = default;
+        Transients(const Transients&) = delete;
+        Transients& operator=(const Transients&) = delete;
+        Transients(Transients&&) = default;
+        Transients& operator=(Transients&&) = default;
+    };
+
+    /**
+     * @brief Declare an image created by the graph and discarded at the end of each frame
+     * @param graph Graph to extend
+     * @param name Debug name (string literal)
+     * @param format Image format
+     * @param aspect Aspects used (colour or depth)
+     * @return Image id
+     */
+    ResourceId createImage(
+        Graph &graph, const char *name, VkFormat format, VkImageAspectFlags aspect
+    );
+
+    /**
+     * @brief Declare an image owned by the caller, bound per frame with bindImage
+     * @param graph Graph to extend
+     * @param name Debug name (string literal)
+     * @param format Image format
+     * @param aspect Aspects used
+     * @param readyStages Stages its previous user (a semaphore wait, e.g. the acquire's
+     *                    COLOR_ATTACHMENT_OUTPUT) finished in; contents are discarded
+     * @param exitUsage Usage it is left in after the last pass (e.g. Present)
+     * @return Image id
+     */
+    ResourceId importImage(
+        Graph &graph,
+        const char *name,
+        VkFormat format,
+        VkImageAspectFlags aspect,
+        VkPipelineStageFlags2 readyStages,
+        std::optional<Usage> exitUsage = std::nullopt
+    );
+
+    /**
+     * @brief Declare a buffer owned by the caller, kept across frames
+     * @param graph Graph to extend
+     * @param name Debug name (string literal)
+     * @param perFrame The caller keeps one copy per frame slot, so a frame's first use does
+     *                 not wait on the previous frame's last one
+     * @return Buffer id
+     */
+    ResourceId importBuffer(Graph &graph, const char *name, bool perFrame = false);
+
+    /**
+     * @brief Declare a pass after the ones already declared
+     * @param graph Graph to extend
+     * @param name Pass name (string literal)
+     * @param images Images used; colour and depth attachments in attachment order
+     * @param buffers Buffers used
+     * @return Pass id
+     * @details A resource may be listed more than once, e.g. reset by a transfer and then
+     *          written by a dispatch; hazards between uses inside the pass are the pass's own
+     */
+    PassId addPass(
+        Graph &graph, const char *name, std::vector<Access> images, std::vector<Access> buffers
+    );
+
+    /**
+     * @brief Derive the barriers, lifetimes, usage flags and aliasing slots
+     * @param graph Graph whose declarations are complete
+     * @throws std::invalid_argument if an id is out of range or a pass uses an image in two
+     *         layouts
+     */
+    void compile(Graph &graph);
+
+    /**
+     * @brief Store operation of an attachment of a pass
+     * @param graph Compiled graph
+     * @param pass Pass using the attachment
+     * @param image Image id of the attachment
+     * @return STORE when the image is imported or a later pass reads it, DONT_CARE otherwise,
+     *         so transient depth never leaves the tile
+     */
+    VkAttachmentStoreOp storeOp(const Graph &graph, PassId pass, ResourceId image);
+
+    /**
+     * @brief Create the render pass of a pass from its declared attachments
+     * @param device Logical device
+     * @param graph Compiled graph
+     * @param pass Pass whose colour and depth attachments make the subpass
+     * @param renderPass Output render pass handle
+     * @details Attachments keep the layout of their use from start to end, since the graph's
+     *          barriers transition them. Attachments are stored as storeOp says. Not needed
+     *          with dynamic rendering, which takes the same operations at vkCmdBeginRendering.
+     * @throws std::runtime_error if the render pass cannot be created
+     */
+    void createRenderPass(
+        VkDevice &device, const Graph &graph, PassId pass, VkRenderPass &renderPass
+    );
+
+    /**
+     * @brief Create the transient images of a graph and alias their memory
+     * @param device Logical device
+     * @param allocator Allocator the aliasing slots come from
+     * @param graph Compiled graph
+     * @param extent Size of every transient image
+     * @param transients Output images, views and slot allocations
+     * @throws std::runtime_error if an image cannot be created or memory allocated
+     */
+    void createTransients(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const Graph &graph,
+        VkExtent2D extent,
+        Transients &transients
+    );
+
+    /**
+     * @brief Destroy transient images and free their memory
+     * @param device Logical device
+     * @param allocator Allocator the slots came from
+     * @param transients Transients to destroy (no submission may still use them)
+     */
+    void destroyTransients(VkDevice &device, Memory::Allocator &allocator, Transients &transients);
+
+    /**
+     * @brief Set the handle an imported image has this frame
+     * @param graph Graph
+     * @param image Imported image id
+     * @param handle Image recorded by the next execute
+     */
+    void bindImage(Graph &graph, ResourceId image, VkImage handle);
+
+    /**
+     * @brief Record every pass with its leading barrier, then the exit barrier
+     * @param graph Compiled graph with every pass's record set
+     * @param transients Transient images for the current extent
+     * @param commandBuffer Frame's primary command buffer, outside a render pass instance
+     * @param profiler Profiler; each pass is a GPU zone named after it
+     * @param frameIndex Frame slot
+     */
+    void execute(
+        Graph &graph,
+        const Transients &transients,
+        VkCommandBuffer commandBuffer,
+        Profiler::Profiler &profiler,
+        std::uint32_t frameIndex
+    );
+} // namespace RenderGraph
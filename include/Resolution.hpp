@@ -0,0 +1,99 @@
+/**
+ * @file Resolution.hpp
+ * @brief Dynamic resolution: scene rendered at a fraction of the swapchain size, then upscaled
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Resolution
+ * @brief Picks the scene's render scale from measured GPU frame time and blits it to the target
+ * @details The scene colour and depth images keep the full swapchain size and the scene is
+ *          drawn into their top-left corner, so changing the scale never recreates an image or
+ *          a framebuffer. An upscale pass then blits that corner over the whole swapchain image
+ *          with linear filtering.
+ */
+namespace Resolution
+{
+    /// Smallest scale the controller goes down to (a quarter of the pixels)
+    inline constexpr float MIN_SCALE = 0.5f;
+
+    /// Largest scale (native resolution; no supersampling)
+    inline constexpr float MAX_SCALE = 1.0f;
+
+    /// Scales are multiples of this, so small timing noise does not move the image
+    inline constexpr float SCALE_STEP = 1.0f / 32.0f;
+
+    /// Largest change of one adjustment
+    inline constexpr float MAX_STEP = 0.1f;
+
+    /// Frames measured at a new scale before the next adjustment (covers frames in flight)
+    inline constexpr std::uint32_t SETTLE_FRAMES = 8;
+
+    /// Weight of the newest sample in the smoothed GPU frame time
+    inline constexpr double SMOOTHING = 0.1;
+
+    /// Smoothed frame time, as a fraction of the target, above which the scale goes down
+    inline constexpr double SLOWER_THRESHOLD = 1.05;
+
+    /// Fraction of the target below which the scale goes up (wider, so it does not oscillate)
+    inline constexpr double FASTER_THRESHOLD = 0.85;
+
+    /**
+     * @struct Controller
+     * @brief Render scale and the frame time it is steered by
+     */
+    struct Controller
+    {
+        float scale = MAX_SCALE;        ///< Fraction of the swapchain extent rendered per axis
+        double targetMs = 0.0;          ///< GPU frame time aimed for (0 = fixed scale)
+        double smoothedMs = 0.0;        ///< Smoothed GPU frame time (0 = no sample yet)
+        std::uint32_t settleFrames = 0; ///< Samples still ignored after the last change
+    };
+
+    /**
+     * @brief Set up a controller
+     * @param controller Output controller
+     * @param scale Starting scale, clamped to [MIN_SCALE, MAX_SCALE]
+     * @param targetFps Frame rate to hold (0 = keep the scale fixed)
+     */
+    void createController(Controller &controller, float scale, double targetFps);
+
+    /**
+     * @brief Feed a GPU frame time and adjust the scale
+     * @param controller Controller
+     * @param gpuFrameMs Latest measured GPU frame time (0 = no new sample)
+     * @return True when the scale changed
+     * @details GPU cost follows the pixel count, i.e. the square of the scale, so the scale
+     *          moves by sqrt(target / measured), at most MAX_STEP at a time
+     */
+    bool update(Controller &controller, double gpuFrameMs);
+
+    /**
+     * @brief Extent the scene is rendered at
+     * @param controller Controller
+     * @param full Swapchain extent
+     * @return Scaled extent, at least 1x1
+     */
+    VkExtent2D scaledExtent(const Controller &controller, VkExtent2D full);
+
+    /**
+     * @brief Record the upscale from the scene image to the swapchain image
+     * @param commandBuffer Command buffer, outside a render pass instance
+     * @param source Scene image in TRANSFER_SRC_OPTIMAL
+     * @param sourceExtent Rendered region of the scene image (from the origin)
+     * @param target Swapchain image in TRANSFER_DST_OPTIMAL
+     * @param targetExtent Swapchain extent
+     * @details Linear filtering; the layouts are the render graph's
+     */
+    void recordUpscale(
+        VkCommandBuffer commandBuffer,
+        VkImage source,
+        VkExtent2D sourceExtent,
+        VkImage target,
+        VkExtent2D targetExtent
+    );
+} // namespace Resolution
@@ -0,0 +1,160 @@
+/**
+ * @file Scene.hpp
+ * @brief Transform hierarchy stored as structure of arrays, and the cached camera matrices
+ */
+
+#pragma once
+
+#include "JobSystem.hpp"
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Scene
+ * @brief Local transforms, parents and world matrices of the scene's nodes, one array per field
+ * @details Nodes are stored breadth first: every node comes after its parent and the nodes of
+ *          one depth are contiguous, so a level is a range whose parents are all final once
+ *          the levels above it are. updateWorld walks the levels in order. A level below a
+ *          changed one is scanned whole, split into chunks run across the job system; any
+ *          other level only visits the nodes set dirty in it, so an update costs what changed
+ *          rather than the size of the graph. A node's world matrix is recomputed only when
+ *          its local transform was set or its parent's world matrix changed, and the nodes
+ *          recomputed are kept as ranges so consumers copy only those.
+ *
+ *          The matrix products use SSE intrinsics where the target has them (VEX-encoded
+ *          with ENABLE_AVX). glm's own SIMD paths only serve its aligned types, which would
+ *          change the layout of the vectors shared with shaders, so they stay off.
+ */
+namespace Scene
+{
+    /// Index of a node in its Graph
+    using NodeId = std::uint32_t;
+
+    /// Parent of top-level nodes
+    inline constexpr NodeId NO_PARENT = UINT32_MAX;
+
+    /// Nodes per job when a level is updated in parallel (smaller levels run inline)
+    inline constexpr std::uint32_t CHUNK_SIZE = 1024;
+
+    /**
+     * @struct Range
+     * @brief Consecutive nodes whose world matrices changed in the last update
+     */
+    struct Range
+    {
+        NodeId first = 0;        ///< First node
+        std::uint32_t count = 0; ///< Number of nodes
+    };
+
+    /**
+     * @struct Graph
+     * @brief Every node's transform, one array per field, indexed by NodeId
+     */
+    struct Graph
+    {
+        std::vector<glm::vec3> positions;      ///< Local translation
+        std::vector<glm::quat> rotations;      ///< Local rotation
+        std::vector<glm::vec3> scales;         ///< Local scale
+        std::vector<NodeId> parents;           ///< Parent node (NO_PARENT = top level)
+        std::vector<glm::mat4> world;          ///< Parent world times local, as of updateWorld
+        std::vector<std::uint8_t> dirty;       ///< Local transform set since updateWorld (0/1)
+        std::vector<std::uint8_t> changed;     ///< World recomputed by the last update (0/1)
+        std::vector<std::uint32_t> levelStart; ///< First node of each depth, plus the end
+        std::vector<NodeId> changedNodes;      ///< Changed nodes of the last update, ascending
+        std::vector<Range> ranges;             ///< Changed nodes of the last update, in order
+
+        /// Nodes set dirty since updateWorld, per depth (each node at most once)
+        std::vector<std::vector<NodeId>> dirtyNodes;
+
+        /// Number of nodes
+        std::uint32_t size() const
+        {
+            return static_cast<std::uint32_t>(parents.size());
+        }
+    };
+
+    /**
+     * @brief Append a node
+     * @param graph Graph
+     * @param parent Parent node (NO_PARENT = top level)
+     * @param position Local translation
+     * @param rotation Local rotation
+     * @param scale Local scale
+     * @return Id of the node, dirty until the next updateWorld
+     * @throws std::invalid_argument if the parent does not exist, or the node would be placed
+     *         at a depth above the last node added (nodes are added breadth first)
+     */
+    NodeId createNode(
+        Graph &graph,
+        NodeId parent,
+        const glm::vec3 &position = glm::vec3(0.0f),
+        const glm::quat &rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+        const glm::vec3 &scale = glm::vec3(1.0f)
+    );
+
+    /**
+     * @brief Set a node's local translation and mark it dirty
+     * @param graph Graph
+     * @param node Node
+     * @param position Local translation
+     */
+    void setPosition(Graph &graph, NodeId node, const glm::vec3 &position);
+
+    /**
+     * @brief Set a node's local rotation and mark it dirty
+     * @param graph Graph
+     * @param node Node
+     * @param rotation Local rotation
+     */
+    void setRotation(Graph &graph, NodeId node, const glm::quat &rotation);
+
+    /**
+     * @brief Set a node's local scale and mark it dirty
+     * @param graph Graph
+     * @param node Node
+     * @param scale Local scale
+     */
+    void setScale(Graph &graph, NodeId node, const glm::vec3 &scale);
+
+    /**
+     * @brief Recompute the world matrices of dirty nodes and their descendants
+     * @param graph Graph
+     * @param jobs Job system splitting large levels (null = run on the calling thread, e.g.
+     *             from a task of a running TaskGraph, which cannot dispatch)
+     * @details Levels without a dirty node are skipped unless a level above changed. Fills
+     *          Graph::changed, Graph::changedNodes and Graph::ranges and clears the dirty
+     *          flags.
+     */
+    void updateWorld(Graph &graph, Jobs::JobSystem *jobs);
+
+    /**
+     * @struct Camera
+     * @brief Camera parameters and the view and projection matrices derived from them
+     */
+    struct Camera
+    {
+        glm::vec3 position{0.0f};       ///< Eye position in world space
+        glm::vec3 target{0.0f};         ///< Point looked at
+        glm::vec3 up{0.0f, 0.0f, 1.0f}; ///< Up direction
+        float fovDegrees = 45.0f;       ///< Vertical field of view
+        float nearPlane = 0.1f;         ///< Near clipping distance
+        float farPlane = 10.0f;         ///< Far clipping distance
+        glm::mat4 view{1.0f};           ///< World to view, as of updateCamera
+        glm::mat4 proj{1.0f};           ///< View to clip (Vulkan Y down), as of updateCamera
+        VkExtent2D extent{0, 0};        ///< Extent proj was built for
+        bool dirty = true;              ///< Parameters set since updateCamera
+    };
+
+    /**
+     * @brief Rebuild the camera matrices if its parameters or the extent changed
+     * @param camera Camera (set dirty after changing a parameter)
+     * @param extent Extent of the target drawn into
+     * @return True when the matrices were rebuilt
+     * @note proj[1][1] is negated to flip Y for Vulkan's coordinate system
+     */
+    bool updateCamera(Camera &camera, VkExtent2D extent);
+} // namespace Scene
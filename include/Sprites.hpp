@@ -0,0 +1,272 @@
+/**
+ * @file Sprites.hpp
+ * @brief Screen-space quads batched by texture into a few large indexed draws
+ */
+
+#pragma once
+
+#include "JobSystem.hpp"
+#include "Memory.hpp"
+#include "Upload.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+
+/**
+ * @namespace Sprites
+ * @brief A sprite renderer streaming four vertices per quad and sharing one index buffer
+ * @details The sprites are sorted by layer, blending and material when they are added or
+ *          re-keyed, and every frame their corners are written in that order into the frame
+ *          slot's persistently mapped vertex stream; the stream doubles when the sprites
+ *          outgrow it. Consecutive sprites sharing a pipeline
+ *          and a material form one batch, drawn with a static index buffer describing
+ *          QUADS_PER_DRAW quads (the most 16-bit indices can address), so a batch costs one
+ *          vkCmdDrawIndexed per QUADS_PER_DRAW sprites whatever it draws. Coordinates are in
+ *          pixels, origin top left; a batch samples the frame's texture (an atlas addressed
+ *          by each sprite's uvRect) or, with the bindless table, the texture of its material.
+ */
+namespace Sprites
+{
+    /// Quads one draw addresses with 16-bit indices (4 vertices each, 65536 in all)
+    inline constexpr std::uint32_t QUADS_PER_DRAW = 16384;
+
+    /// Quads a vertex stream holds when first created
+    inline constexpr std::uint32_t MIN_STREAM_QUADS = 1024;
+
+    /// Sprites per job when the vertices are written in parallel
+    inline constexpr std::uint32_t WRITE_CHUNK = 4096;
+
+    /// Layers createField spreads its sprites over
+    inline constexpr std::uint16_t FIELD_LAYERS = 4;
+
+    /// Vertex shader of the sprite pipelines (SPIR-V)
+    constexpr std::string_view spriteVertShaderPath = "build/shaders/sprite.vert.spv";
+    /// Fragment shader sampling the frame's texture as an atlas
+    constexpr std::string_view spriteFragShaderPath = "build/shaders/sprite.frag.spv";
+    /// Fragment shader sampling the texture of a Bindless::Table material
+    constexpr std::string_view spriteBindlessFragShaderPath =
+        "build/shaders/sprite_bindless.frag.spv";
+
+    /**
+     * @struct Sprite
+     * @brief One textured, tinted screen-space quad
+     */
+    struct Sprite
+    {
+        glm::vec2 position{0.0f};                 ///< Centre, in pixels from the top left
+        glm::vec2 size{1.0f};                     ///< Width and height in pixels
+        glm::vec4 uvRect{0.0f, 0.0f, 1.0f, 1.0f}; ///< Atlas region: min uv, then max uv
+        std::uint32_t color = 0xffffffff;         ///< RGBA8 tint (R in the low byte)
+        std::uint32_t materialIndex = 0;          ///< Bindless material (ignored otherwise)
+        std::uint16_t layer = 0;                  ///< Painter's order: higher draws on top
+        bool blended = true;                      ///< Alpha blended, else written as is
+    };
+
+    /**
+     * @struct Vertex
+     * @brief One corner of a sprite in the vertex stream (binding 0)
+     */
+    struct Vertex
+    {
+        glm::vec2 position;  ///< Pixels from the top left
+        glm::vec2 texCoord;  ///< Texture coordinates
+        std::uint32_t color; ///< RGBA8 tint, read as UNORM
+
+        /**
+         * @brief Get vertex input binding description
+         * @return Binding description for the vertex stream (binding 0)
+         */
+        static VkVertexInputBindingDescription getBindingDescription()
+        {
+            VkVertexInputBindingDescription bindingDescription{};
+            bindingDescription.binding = 0;
+            bindingDescription.stride = sizeof(Vertex);
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+            return bindingDescription;
+        }
+
+        /**
+         * @brief Get vertex attribute descriptions
+         * @return Array of 3 attribute descriptions (position, texCoord, color)
+         */
+        static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions()
+        {
+            std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions{};
+
+            attributeDescriptions[0].binding = 0;
+            attributeDescriptions[0].location = 0;
+            attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
+            attributeDescriptions[0].offset = offsetof(Vertex, position);
+
+            attributeDescriptions[1].binding = 0;
+            attributeDescriptions[1].location = 1;
+            attributeDescriptions[1].format = VK_FORMAT_R32G32_SFLOAT;
+            attributeDescriptions[1].offset = offsetof(Vertex, texCoord);
+
+            attributeDescriptions[2].binding = 0;
+            attributeDescriptions[2].location = 2;
+            attributeDescriptions[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+            attributeDescriptions[2].offset = offsetof(Vertex, color);
+
+            return attributeDescriptions;
+        }
+    };
+
+    /**
+     * @struct Batch
+     * @brief Consecutive sorted sprites drawn with one pipeline and material
+     */
+    struct Batch
+    {
+        std::uint32_t firstQuad = 0;     ///< First quad in the frame's stream
+        std::uint32_t quadCount = 0;     ///< Number of quads
+        std::uint32_t materialIndex = 0; ///< Pushed as DrawConstants::materialIndex
+        bool blended = false;            ///< Drawn with the blended pipeline
+    };
+
+    /**
+     * @struct Stream
+     * @brief Host-visible vertex buffer written by one frame slot
+     */
+    struct Stream
+    {
+        VkBuffer buffer = VK_NULL_HANDLE; ///< Vertex buffer
+        Memory::Allocation allocation;    ///< Host-visible, coherent memory (mapped)
+        std::uint32_t capacity = 0;       ///< Quads the buffer holds
+    };
+
+    /**
+     * @struct DrawPipelines
+     * @brief Pipelines the sprite batches switch between (owned by the registry)
+     */
+    struct DrawPipelines
+    {
+        VkPipeline opaque = VK_NULL_HANDLE;  ///< Not blended
+        VkPipeline blended = VK_NULL_HANDLE; ///< Alpha blended
+    };
+
+    /**
+     * @struct Renderer
+     * @brief Shared index buffer, per-frame streams and the batches of the last prepare
+     */
+    struct Renderer
+    {
+        VkBuffer indexBuffer = VK_NULL_HANDLE; ///< QUADS_PER_DRAW quads of 16-bit indices
+        Memory::Allocation indexMemory;        ///< Memory backing the index buffer
+        std::vector<Stream> streams;           ///< One per frame in flight
+
+        /// Sort key (layer, blending, material) and sprite index of each sprite, in order
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> order;
+        std::vector<Batch> batches; ///< Batches of the order, the same for every frame
+        bool orderStale = true;     ///< Sprites added or re-keyed since the order was built
+
+        Renderer() = default;
+        Renderer(const Renderer&) = delete;
+        Renderer& operator=(const Renderer&) = delete;
+    };
+
+    /**
+     * @brief Create the shared index buffer and the (still empty) per-frame streams
+     * @param device Logical device
+     * @param allocator Device memory allocator
+     * @param frameCount Number of frames in flight
+     * @param renderer Output renderer
+     * @param uploads Upload context recording the index buffer copy
+     */
+    void createRenderer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        std::uint32_t frameCount,
+        Renderer &renderer,
+        Upload::Context &uploads
+    );
+
+    /**
+     * @brief Destroy the index buffer and every stream
+     * @param device Logical device
+     * @param allocator Allocator the buffers came from
+     * @param renderer Renderer to destroy (no frame may be in flight)
+     */
+    void destroyRenderer(VkDevice &device, Memory::Allocator &allocator, Renderer &renderer);
+
+    /**
+     * @brief Have the next prepare sort the sprites again
+     * @param renderer Renderer
+     * @details Call after changing a sprite's layer, blending or material, or after adding or
+     *          removing sprites without changing their count; a new count is noticed anyway
+     */
+    void invalidateOrder(Renderer &renderer);
+
+    /**
+     * @brief Write the sprites into a frame slot's stream as batches, sorting them if needed
+     * @param device Logical device
+     * @param allocator Allocator a grown stream comes from
+     * @param renderer Renderer
+     * @param frameIndex Frame slot (its previous submission has completed)
+     * @param sprites Sprites of the frame
+     * @param jobs Job system writing the vertices in chunks (null = on the calling thread)
+     * @details Order is layer first, then opaque before blended, then material; sprites
+     *          equal in all three keep no particular order. The order and batches are kept
+     *          until invalidateOrder, so moving sprites costs no sort. A stream too small for
+     *          the sprites is replaced by one of twice the size (or more) right away, since
+     *          only its own frame slot, already waited for, can have used it.
+     */
+    void prepare(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        Renderer &renderer,
+        std::uint32_t frameIndex,
+        std::span<const Sprite> sprites,
+        Jobs::JobSystem *jobs
+    );
+
+    /**
+     * @brief Record the batches of the last prepare into the current render pass
+     * @param commandBuffer Command buffer inside the render pass (frame state bound)
+     * @param pipelineLayout Pipeline layout the DrawConstants are pushed to
+     * @param renderer Renderer
+     * @param frameIndex Frame slot prepared
+     * @param pipelines Sprite pipelines (both must be ready)
+     * @param space Extent the sprite coordinates span (stretched over the render area)
+     * @details The pixel-to-clip matrix is pushed as DrawConstants::model once; each batch
+     *          pushes its material and draws QUADS_PER_DRAW quads at a time, offsetting the
+     *          vertices instead of the indices.
+     */
+    void record(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        const Renderer &renderer,
+        std::uint32_t frameIndex,
+        const DrawPipelines &pipelines,
+        VkExtent2D space
+    );
+
+    /**
+     * @brief Number of indexed draws record issues for the last prepare
+     * @param renderer Renderer
+     * @return One per QUADS_PER_DRAW quads (or part) of each batch
+     */
+    std::uint32_t drawCount(const Renderer &renderer);
+
+    /**
+     * @brief Scatter sprites over an extent, for benchmarks and the demo scene
+     * @param count Number of sprites
+     * @param extent Extent to cover
+     * @param firstMaterial First material cycled over the sprites
+     * @param materialCount Number of materials cycled
+     * @return Sprites on FIELD_LAYERS layers, in a fixed pseudo-random layout
+     */
+    std::vector<Sprite> createField(
+        std::uint32_t count,
+        VkExtent2D extent,
+        std::uint32_t firstMaterial,
+        std::uint32_t materialCount
+    );
+} // namespace Sprites
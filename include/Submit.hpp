@@ -0,0 +1,122 @@
+/**
+ * @file Submit.hpp
+ * @brief Queue submissions collected over a frame and flushed in as few calls as possible
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Submit
+ * @brief Batches the frame's submissions from the graphics, upload and compute producers
+ * @details Producers enqueue Work instead of calling vkQueueSubmit; flush hands each queue's
+ *          pending work to one vkQueueSubmit2 (vkQueueSubmit with timeline values when
+ *          synchronization2 is off). Consecutive work on a queue shares one submit info unless
+ *          it waits on something: its command buffers run back to back, signals move to the
+ *          end of the merged work and repeated semaphores keep their highest value. A queue's
+ *          work is only split when it waits on a binary semaphore signalled by work still
+ *          pending on another queue (a binary signal must be submitted before its wait, while
+ *          timeline waits may go first) or when it carries a second fence. Flushes hold the
+ *          batcher's mutex, and so do present and waitIdle: threads that flush their own
+ *          work (Loader) never use a queue at the same time as the render thread.
+ */
+namespace Submit
+{
+    /**
+     * @struct Work
+     * @brief One producer's submission: command buffers and the semaphores around them
+     */
+    struct Work
+    {
+        VkQueue queue = VK_NULL_HANDLE;              ///< Queue the work runs on
+        std::vector<VkCommandBuffer> commandBuffers; ///< Run in order
+        std::vector<VkSemaphoreSubmitInfo> waits;    ///< Waited on before the stages named
+        std::vector<VkSemaphoreSubmitInfo> signals;  ///< Signalled once the work completes
+        VkFence fence = VK_NULL_HANDLE;              ///< Signalled with the flushed submission
+    };
+
+    /**
+     * @struct Stats
+     * @brief Submission counts and the CPU time spent inside the submit calls
+     */
+    struct Stats
+    {
+        std::uint32_t calls = 0;   ///< vkQueueSubmit2 / vkQueueSubmit calls
+        std::uint32_t batches = 0; ///< Submit infos across those calls
+        std::uint32_t work = 0;    ///< Work items enqueued
+        double submitMs = 0.0;     ///< Time in the driver's submit path (user and kernel)
+    };
+
+    /**
+     * @struct Batcher
+     * @brief Work pending submission and the statistics of the flushes
+     * @details Enqueue and flush may come from different threads (uploads recorded by startup
+     *          tasks, frames on the main thread)
+     */
+    struct Batcher
+    {
+        PFN_vkQueueSubmit2 queueSubmit2 = nullptr; ///< Device::DynamicRendering (null = sync1)
+        std::vector<Work> pending;                 ///< Enqueued, in order
+        std::mutex mutex;                          ///< Guards pending and the statistics
+        Stats frame;                               ///< Since the last endFrame
+        Stats last;                                ///< The last completed frame
+        Stats total;                               ///< Every completed frame
+        std::uint64_t frames = 0;                  ///< Frames counted in total
+    };
+
+    /**
+     * @brief Describe a semaphore wait or signal
+     * @param semaphore Binary or timeline semaphore
+     * @param value Timeline value (0 = binary semaphore, which flush orders after its signal)
+     * @param stages Stages that wait (signals: VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT)
+     * @return Submit info for Work::waits or Work::signals
+     */
+    VkSemaphoreSubmitInfo semaphore(
+        VkSemaphore semaphore,
+        std::uint64_t value = 0,
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+    );
+
+    /**
+     * @brief Queue work for the next flush
+     * @param batcher Batcher
+     * @param work Work to submit (no call is made until flush)
+     */
+    void enqueue(Batcher &batcher, Work work);
+
+    /**
+     * @brief Submit everything pending
+     * @param batcher Batcher
+     * @details Call before presenting, before waiting on a fence of enqueued work, and at
+     *          shutdown
+     * @throws std::runtime_error if a submission fails
+     */
+    void flush(Batcher &batcher);
+
+    /**
+     * @brief Present under the batcher's mutex
+     * @param batcher Batcher other threads flush through
+     * @param queue Present queue
+     * @param presentInfo Images to present
+     * @return Result of vkQueuePresentKHR
+     */
+    VkResult present(Batcher &batcher, VkQueue queue, const VkPresentInfoKHR &presentInfo);
+
+    /**
+     * @brief Wait for the device to go idle under the batcher's mutex
+     * @param batcher Batcher other threads flush through
+     * @param device Logical device (vkDeviceWaitIdle uses every queue)
+     */
+    void waitIdle(Batcher &batcher, VkDevice device);
+
+    /**
+     * @brief Close the frame's statistics
+     * @param batcher Batcher
+     * @details Moves Batcher::frame into Batcher::last and adds it to Batcher::total
+     */
+    void endFrame(Batcher &batcher);
+} // namespace Submit
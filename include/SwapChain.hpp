@@ -19,6 +19,51 @@ namespace SwapChain
     
     inline constexpr std::uint32_t DEFAULT_WIDTH = 800;  ///< Initial window width in pixels
     inline constexpr std::uint32_t DEFAULT_HEIGHT = 600; ///< Initial window height in pixels
+
+    // === Latency Configuration ===
+
+    /**
+     * @enum LatencyMode
+     * @brief Startup policy trading input-to-display latency against throughput
+     */
+    enum class LatencyMode
+    {
+        Balanced,   ///< MAILBOX else FIFO, minImageCount + 1 images, 2 frames in flight
+        Benchmark,  ///< IMMEDIATE (uncapped) else MAILBOX else FIFO, no CPU pacing
+        LowLatency, ///< FIFO, fewest images, 1 frame in flight, paced by VK_KHR_present_wait
+        Throughput  ///< MAILBOX else FIFO, minImageCount + 2 images, 3 frames in flight
+    };
+
+    /**
+     * @struct PresentConfig
+     * @brief Presentation settings chosen at startup
+     * @details Zero counts select the mode's default; explicit counts are clamped to what the
+     *          surface and the renderer support
+     */
+    struct PresentConfig
+    {
+        LatencyMode mode = LatencyMode::Balanced; ///< Present mode and pacing policy
+        std::uint32_t imageCount = 0;             ///< Requested swapchain images (0 = mode default)
+        std::uint32_t framesInFlight = 0;         ///< Requested frames in flight (0 = mode default)
+        bool blitTarget = false;                  ///< Images are blit destinations (upscaling)
+    };
+
+    /**
+     * @struct PresentPacer
+     * @brief VK_KHR_present_wait state used by LatencyMode::LowLatency
+     */
+    struct PresentPacer
+    {
+        PFN_vkWaitForPresentKHR waitForPresent = nullptr; ///< Loaded when present_wait is enabled
+        std::uint64_t lastPresentId = 0; ///< Id of the last present on the current swapchain
+    };
+
+    /// Upper bound of the frames-in-flight count a PresentConfig may request
+    inline constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 4;
+
+    /// Longest CPU stall allowed while waiting for a present (nanoseconds)
+    inline constexpr std::uint64_t PRESENT_WAIT_TIMEOUT_NS = 100'000'000;
+
     /**
      * @struct SwapChainSupportDetails
      * @brief Swapchain capabilities and supported formats/modes
@@ -53,11 +98,53 @@ namespace SwapChain
     /**
      * @brief Choose optimal presentation mode
      * @param availablePresentModes Available present modes
+     * @param mode Latency policy
      * @return Selected present mode
-     * @details Prefers MAILBOX (triple buffering) if available, falls back to FIFO (vsync)
+     * @details Walks the mode's preference list (see LatencyMode) and falls back to FIFO
+     *          (vsync), which every implementation supports
+     */
+    VkPresentModeKHR chooseSwapPresentMode(
+        const std::vector<VkPresentModeKHR> &availablePresentModes,
+        LatencyMode mode = LatencyMode::Balanced
+    );
+
+    /**
+     * @brief Choose the number of swapchain images
+     * @param capabilities Surface capabilities
+     * @param config Presentation settings
+     * @return Image count within [minImageCount, maxImageCount]
+     */
+    std::uint32_t
+    chooseImageCount(const VkSurfaceCapabilitiesKHR &capabilities, const PresentConfig &config);
+
+    /**
+     * @brief Resolve the number of frames in flight
+     * @param config Presentation settings
+     * @return Count within [1, MAX_FRAMES_IN_FLIGHT]
      */
-    VkPresentModeKHR
-    chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes);
+    std::uint32_t chooseFramesInFlight(const PresentConfig &config);
+
+    /**
+     * @brief Load vkWaitForPresentKHR if present_wait was enabled on the device
+     * @param device Logical device
+     * @param enabled Whether VK_KHR_present_id and VK_KHR_present_wait were enabled
+     * @param pacer Output pacer (left disabled when enabled is false)
+     */
+    void createPresentPacer(VkDevice &device, bool enabled, PresentPacer &pacer);
+
+    /**
+     * @brief Block until the present lag presents ago has reached the display
+     * @param device Logical device
+     * @param swapChain Swapchain the ids were presented on
+     * @param pacer Present pacer
+     * @param lag Presents allowed to be queued ahead of the display
+     * @details Called right before the CPU samples input and records, so the work of a frame
+     *          starts as late as possible. Does nothing when the pacer is disabled or fewer than
+     *          lag presents were made; a timeout is treated as success.
+     */
+    void waitForPresent(
+        VkDevice &device, VkSwapchainKHR swapChain, const PresentPacer &pacer, std::uint64_t lag
+    );
 
     /**
      * @brief Choose swapchain extent (resolution)
@@ -75,7 +162,11 @@ namespace SwapChain
      * @param swapChain Output swapchain handle
      * @param swapChainImages Output vector of swapchain images
      * @param swapChainExtent Output swapchain extent
-     * @details Creates swapchain with min image count + 1, selected format/mode/extent
+     * @param config Presentation settings (present mode and image count)
+     * @param oldSwapChain Swapchain being replaced (VK_NULL_HANDLE on first creation)
+     * @details Creates swapchain with the configured image count and format/mode/extent. Passing
+     *          the retiring swapchain lets the driver reuse its resources and keeps its
+     *          already-queued presents valid; the caller still destroys it once they retire.
      */
     void createSwapChain(
         VkPhysicalDevice &physicalDevice,
@@ -83,6 +174,8 @@ namespace SwapChain
         VkSurfaceKHR &surface,
         VkSwapchainKHR &swapChain,
         std::vector<VkImage> &swapChainImages,
-        VkExtent2D &swapChainExtent
+        VkExtent2D &swapChainExtent,
+        const PresentConfig &config = {},
+        VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE
     );
 } // namespace SwapChain
\ No newline at end of file
@@ -5,35 +5,79 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <vulkan/vulkan.h>
 
 /**
  * @namespace Synchronization
- * @brief Creates semaphores and fences for proper GPU-CPU and GPU-GPU synchronization
+ * @brief Creates semaphores for proper GPU-CPU and GPU-GPU synchronization
+ * @details GPU progress is tracked by a single timeline semaphore: every graphics submission
+ *          signals the next value, and CPU-side waits (frame pacing, deferred destruction)
+ *          compare against the counter instead of per-frame fences.
  */
 namespace Synchronization
 {
     /**
-     * @brief Create all synchronization objects for frame-in-flight rendering
+     * @struct Timeline
+     * @brief Timeline semaphore plus the last value a submission was told to signal
+     */
+    struct Timeline
+    {
+        VkSemaphore semaphore = VK_NULL_HANDLE; ///< VK_SEMAPHORE_TYPE_TIMELINE semaphore
+        std::uint64_t lastSubmitted = 0;        ///< Highest value handed to a queue submit
+    };
+
+    /**
+     * @brief Create the per-swapchain-image synchronization objects
      * @param device Logical device
-     * @param imageAvailableSemaphores Output vector of semaphores (per frame in flight)
      * @param renderFinishedSemaphores Output vector of semaphores (per swapchain image)
-     * @param inFlightFences Output vector of fences (per frame in flight)
      * @param swapChainImageCount Number of swapchain images
-     * @param maxFramesInFlight Maximum concurrent frames
-     * @details Creates proper semaphore/fence architecture to prevent validation errors:
-     *          - imageAvailableSemaphores: Signaled by vkAcquireNextImageKHR (one per frame)
-     *          - renderFinishedSemaphores: Signaled by vkQueueSubmit (one per swapchain image)
-     *          - inFlightFences: CPU-GPU synchronization (one per frame)
+     * @details renderFinishedSemaphores are signaled by vkQueueSubmit and waited on by present
      * @note CRITICAL: renderFinishedSemaphores indexed by imageIndex prevents reuse before present
      */
     void createSyncObjects(
         VkDevice &device,
-        std::vector<VkSemaphore> &imageAvailableSemaphores, // per frame in flight
         std::vector<VkSemaphore> &renderFinishedSemaphores, // per swapchain image
-        std::vector<VkFence> &inFlightFences,
-        std::size_t swapChainImageCount,
-        std::size_t maxFramesInFlight
+        std::size_t swapChainImageCount
     );
+
+    /**
+     * @brief Create the synchronization objects of one frame in flight
+     * @param device Logical device
+     * @param imageAvailableSemaphore Output semaphore signaled by vkAcquireNextImageKHR
+     * @note Frame pacing uses the timeline value stored in the frame, not a fence
+     */
+    void createFrameSyncObjects(VkDevice &device, VkSemaphore &imageAvailableSemaphore);
+
+    /**
+     * @brief Create a timeline semaphore starting at value 0
+     * @param device Logical device
+     * @param timeline Output timeline
+     * @throws std::runtime_error if creation fails
+     */
+    void createTimeline(VkDevice &device, Timeline &timeline);
+
+    /**
+     * @brief Destroy a timeline semaphore (no submission may still reference it)
+     * @param device Logical device
+     * @param timeline Timeline to destroy
+     */
+    void destroyTimeline(VkDevice &device, Timeline &timeline);
+
+    /**
+     * @brief Query the value the GPU has reached
+     * @param device Logical device
+     * @param timeline Timeline to query
+     * @return Current counter value; every submission signalling at most this value retired
+     */
+    std::uint64_t completedValue(VkDevice &device, const Timeline &timeline);
+
+    /**
+     * @brief Block until the GPU reached a value
+     * @param device Logical device
+     * @param timeline Timeline to wait on
+     * @param value Value to wait for (0 returns immediately)
+     */
+    void waitForValue(VkDevice &device, const Timeline &timeline, std::uint64_t value);
 } // namespace Synchronization
\ No newline at end of file
@@ -0,0 +1,174 @@
+/**
+ * @file TextureStreamer.hpp
+ * @brief Mip-level residency for KTX2 textures kept in VRAM under a memory budget
+ */
+
+#pragma once
+
+#include "Deletion.hpp"
+#include "Ktx.hpp"
+#include "Memory.hpp"
+#include "Upload.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Streaming
+ * @brief Keeps only the mip levels a texture needs on screen in device memory
+ * @details Textures are read and transcoded on a background loader thread. Once loaded, the
+ *          small tail of the chain (levels no larger than MIN_RESIDENT_EXTENT) is made resident
+ *          straight away so something can be sampled; finer levels follow one at a time as the
+ *          screen-space size requested for the texture grows, while the device-local heap
+ *          budget (VK_EXT_memory_budget) allows. Textures no longer requested, or the least
+ *          recently requested ones when over budget, are coarsened again. A residency change
+ *          rebuilds the image with levels [residentLevel, levelCount) through the upload
+ *          context; the replaced image is released through the deletion queue.
+ */
+namespace Streaming
+{
+    /// Levels no larger than this (in texels) are resident as soon as the texture is loaded
+    inline constexpr std::uint32_t MIN_RESIDENT_EXTENT = 64;
+
+    /// Bytes of new level data uploaded per update, so refinement never stalls a frame
+    inline constexpr VkDeviceSize MAX_UPDATE_BYTES = 8ull * 1024 * 1024;
+
+    /// Share of the device-local heap budget the process may fill with streamed levels
+    inline constexpr float BUDGET_FRACTION = 0.8f;
+
+    /// Updates without a request after which a texture falls back to its tail levels
+    inline constexpr std::uint64_t EVICT_AFTER_UPDATES = 120;
+
+    /// Level count the shared sampler clamps to
+    inline constexpr std::uint32_t MAX_LEVELS = 16;
+
+    /// Index of a texture in Streamer::textures
+    using TextureHandle = std::uint32_t;
+
+    /**
+     * @struct StreamedTexture
+     * @brief Host copy of a texture's mip chain and the levels currently resident
+     */
+    struct StreamedTexture
+    {
+        std::filesystem::path path;        ///< Source .ktx2 file
+        Ktx::TextureData source;           ///< Every level, in host memory once loaded
+        bool loaded = false;               ///< source holds the file's levels
+        std::uint32_t levelCount = 0;      ///< Levels in the full chain
+        std::uint32_t tailLevel = 0;       ///< First level resident regardless of demand
+        std::uint32_t residentLevel = 0;   ///< Finest resident level (levelCount = none)
+        std::uint32_t requestedExtent = 0; ///< Largest on-screen size asked for this update
+        std::uint64_t lastRequested = 0;   ///< Update of the last non-zero request
+        VkImage image = VK_NULL_HANDLE;    ///< Image holding the resident levels
+        Memory::Allocation memory;         ///< Device-local memory backing the image
+        VkImageView view = VK_NULL_HANDLE; ///< View over every resident level
+        VkDeviceSize residentBytes = 0;    ///< Size of memory
+
+        StreamedTexture() = default;
+        StreamedTexture(const StreamedTexture&) = delete;
+        StreamedTexture& operator=(const StreamedTexture&) = delete;
+    };
+
+    /**
+     * @struct Streamer
+     * @brief Streamed textures, the loader thread and the residency budget
+     */
+    struct Streamer
+    {
+        VkDevice device = VK_NULL_HANDLE;                 ///< Logical device
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE; ///< Device textures are transcoded for
+        Memory::Allocator *allocator = nullptr;           ///< Allocator for the images
+        Upload::Context *uploads = nullptr;               ///< Upload context for level data
+        Deletion::Queue *deletion = nullptr;              ///< Queue releasing replaced images
+        VkSampler sampler = VK_NULL_HANDLE;               ///< Trilinear sampler (MAX_LEVELS)
+
+        VkDeviceSize budgetLimit = 0;   ///< Hard cap on resident bytes (0 = heap budget only)
+        VkDeviceSize residentBytes = 0; ///< Bytes of every streamed image
+        std::uint64_t updateIndex = 0;  ///< Number of update() calls so far
+
+        std::vector<std::unique_ptr<StreamedTexture>> textures; ///< Indexed by TextureHandle
+
+        std::thread loader;           ///< Reads and transcodes queued files
+        std::mutex mutex;             ///< Guards every field below
+        std::condition_variable wake; ///< Signals a queued file or shutdown
+        std::deque<std::pair<TextureHandle, std::filesystem::path>> loadQueue; ///< Files to read
+        std::vector<std::pair<TextureHandle, Ktx::TextureData>> loadedTextures; ///< Read files
+        std::exception_ptr error; ///< First exception thrown by the loader
+        bool stopping = false;    ///< Set when the streamer is destroyed
+
+        Streamer() = default;
+        Streamer(const Streamer&) = delete;
+        Streamer& operator=(const Streamer&) = delete;
+    };
+
+    /**
+     * @brief Create the shared sampler and start the loader thread
+     * @param device Logical device
+     * @param physicalDevice Physical device (transcode targets and sampler limits)
+     * @param allocator Allocator for the streamed images
+     * @param uploads Upload context level data is recorded into
+     * @param deletion Deletion queue for replaced images (flushed against the frame timeline)
+     * @param streamer Output streamer
+     * @param budgetLimit Hard cap on resident bytes (0 = BUDGET_FRACTION of the heap budget)
+     */
+    void createStreamer(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        Upload::Context &uploads,
+        Deletion::Queue &deletion,
+        Streamer &streamer,
+        VkDeviceSize budgetLimit = 0
+    );
+
+    /**
+     * @brief Stop the loader thread and destroy every streamed image
+     * @param streamer Streamer to destroy (no image may still be in use by the GPU)
+     */
+    void destroyStreamer(Streamer &streamer);
+
+    /**
+     * @brief Queue a KTX2 texture for loading on the background thread
+     * @param streamer Streamer
+     * @param path Path to the .ktx2 file
+     * @return Handle of the texture (nothing is resident until a later update)
+     */
+    TextureHandle addTexture(Streamer &streamer, const std::filesystem::path &path);
+
+    /**
+     * @brief Record how large the texture appears on screen this update
+     * @param streamer Streamer
+     * @param handle Texture drawn
+     * @param screenExtent Texels across the texture's largest on-screen footprint
+     * @details Several requests between updates keep the largest one
+     */
+    void requestResolution(Streamer &streamer, TextureHandle handle, std::uint32_t screenExtent);
+
+    /**
+     * @brief Move loaded textures in and change residency towards the requested levels
+     * @param streamer Streamer
+     * @param retireValue Timeline value after which replaced images are no longer sampled
+     * @return true if any texture's view changed
+     * @details Call once per frame before the frame's descriptors are written; level uploads
+     *          are recorded and submitted on the upload context without waiting.
+     * @throws std::runtime_error (or the loader's exception) if a texture failed to load
+     */
+    bool update(Streamer &streamer, std::uint64_t retireValue);
+
+    /**
+     * @brief View over a texture's resident levels
+     * @param streamer Streamer
+     * @param handle Texture
+     * @return Image view, or VK_NULL_HANDLE while nothing is resident
+     */
+    VkImageView view(const Streamer &streamer, TextureHandle handle);
+} // namespace Streaming
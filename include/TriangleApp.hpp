@@ -14,15 +14,86 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "AssetPack.hpp"
+#include "AsyncCompute.hpp"
+#include "Benchmark.hpp"
+#include "Bindless.hpp"
+#include "Command.hpp"
+#include "Culling.hpp"
+#include "Deletion.hpp"
+#include "Descriptors.hpp"
+#include "Device.hpp"
+#include "Frame.hpp"
+#include "HotReload.hpp"
+#include "JobSystem.hpp"
+#include "Ktx.hpp"
+#include "Loader.hpp"
+#include "Memory.hpp"
+#include "PipelineRegistry.hpp"
+#include "Profiler.hpp"
+#include "RenderGraph.hpp"
+#include "Resolution.hpp"
+#include "Scene.hpp"
+#include "Sprites.hpp"
+#include "Submit.hpp"
+#include "SwapChain.hpp"
+#include "Synchronisation.hpp"
+#include "TextureStreamer.hpp"
+#include "Upload.hpp"
+
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <future>
+#include <string>
 #include <vector>
 
-/// Maximum number of frames that can be processed concurrently on the GPU
-constexpr std::uint8_t MAX_FRAMES_IN_FLIGHT = 2;
-
 /// Callback function for window framebuffer resize events
 static void frameBufferResizeCallback(GLFWwindow *window, int width, int height);
 
+/**
+ * @struct SceneConfig
+ * @brief What the application draws, chosen at startup
+ */
+struct SceneConfig
+{
+    std::string device;                ///< GPU selector (empty = Device::DEVICE_ENV, then best)
+    std::string meshPath;              ///< glTF/OBJ file to draw (empty = built-in quad)
+    std::uint32_t instanceCount = 1;   ///< Copies drawn from the instance buffer
+    bool indirect = false;             ///< Draw through vkCmdDrawIndexedIndirect instead
+    bool gpuCulling = false;           ///< Frustum-cull instances on the GPU (implies indirect)
+    std::string assetPack;             ///< Baked asset pack to map at startup (empty = loose files)
+    std::string texturePath;           ///< .ktx2 or stb_image file (empty = Image::texturePath)
+    std::string streamPath;            ///< .ktx2 streamed over the texture (empty = not streamed)
+    std::uint32_t streamBudgetMiB = 0; ///< Cap on streamed residency (0 = heap budget only)
+    bool bindless = false;             ///< Sample through Bindless::Table (descriptor indexing)
+    bool profile = false;              ///< Time CPU stages and GPU passes (Profiler)
+    std::string tracePath;             ///< Chrome trace written at exit (empty = summaries only)
+
+    bool benchmark = false;         ///< Headless: offscreen targets, simulated clock, report
+    std::string benchmarkPath;      ///< JSON report (empty = standard output)
+    std::uint32_t drawCount = 1;    ///< Draw records the instances are split into
+    std::uint32_t textureCount = 1; ///< Textures cycled over the draws (bindless only)
+    std::uint32_t blendedDraws = 0; ///< Last draw records drawn with the blended pipeline
+    bool depthPrepass = false;      ///< Lay down depth before shading the opaque draws
+    bool renderPass = false;        ///< Keep render pass objects where dynamic rendering works
+    bool singleQueue = false;       ///< Cull on the graphics queue despite an async compute one
+
+    std::uint32_t renderScalePercent = 100; ///< Scene resolution per axis (start, if targetFps)
+    std::uint32_t targetFps = 0;            ///< Frame rate the render scale holds (0 = fixed)
+    bool hotReload = false;                 ///< Swap in edited shaders and texture (windowed)
+    std::uint32_t spriteCount = 0;          ///< Sprites batched over the scene (0 = none)
+
+    /// The scene is drawn offscreen and upscaled to the swapchain image
+    bool upscaled() const
+    {
+        return renderScalePercent < 100 || targetFps > 0;
+    }
+
+    /// Measured frames, after Benchmark::WARMUP_FRAMES
+    std::uint32_t benchmarkFrames = Benchmark::DEFAULT_FRAMES;
+};
+
 /**
  * @struct VulkanCore
  * @brief Core Vulkan objects required for rendering
@@ -36,8 +107,14 @@ struct VulkanCore
     VkDevice device = VK_NULL_HANDLE;                 ///< Logical device (interface to GPU)
     VkQueue graphicsQueue = VK_NULL_HANDLE;           ///< Queue for graphics commands
     VkQueue presentQueue = VK_NULL_HANDLE;            ///< Queue for presentation
+    VkQueue transferQueue = VK_NULL_HANDLE;           ///< Queue for uploads (may be graphics)
+    VkQueue computeQueue = VK_NULL_HANDLE;            ///< Queue for compute (graphics family)
+    VkQueue asyncComputeQueue = VK_NULL_HANDLE;       ///< Compute-only queue (null = none)
     VkSurfaceKHR surface = VK_NULL_HANDLE;            ///< Window surface for rendering
 
+    /// Vulkan 1.3 entry points (null: render pass objects and synchronization 1)
+    Device::DynamicRendering dynamicRendering;
+
     VulkanCore() = default;
     VulkanCore(const VulkanCore&) = delete;
     VulkanCore& operator=(const VulkanCore&) = delete;
@@ -57,7 +134,12 @@ struct SwapchainResources
     VkExtent2D extent = {};                    ///< Resolution of swapchain images
     std::vector<VkImage> images;               ///< Swapchain images (owned by swapchain)
     std::vector<VkImageView> imageViews;       ///< Image views for swapchain images
-    std::vector<VkFramebuffer> framebuffers;   ///< Framebuffers (one per swapchain image)
+    std::vector<VkFramebuffer> framebuffers;   ///< Per image (render pass objects only)
+    std::vector<Memory::Allocation> memory;    ///< Memory of offscreen images (headless only)
+    RenderGraph::Transients transients;        ///< Frame graph transients (depth attachment)
+
+    /// Per image, of PipelineResources::overlayRenderPass (upscaled render pass objects only)
+    std::vector<VkFramebuffer> overlayFramebuffers;
 
     SwapchainResources() = default;
     SwapchainResources(const SwapchainResources&) = delete;
@@ -73,10 +155,22 @@ struct SwapchainResources
  */
 struct PipelineResources
 {
-    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE; ///< Layout for shader resources
-    VkPipelineLayout layout = VK_NULL_HANDLE; ///< Pipeline layout (uniforms, push constants)
-    VkRenderPass renderPass = VK_NULL_HANDLE; ///< Render pass (attachments and subpasses)
-    VkPipeline pipeline = VK_NULL_HANDLE;     ///< Graphics pipeline (shaders and state)
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE; ///< Frame set layout (cached)
+    VkPipelineLayout layout = VK_NULL_HANDLE;   ///< Pipeline layout (uniforms, push constants)
+    VkRenderPass renderPass = VK_NULL_HANDLE;   ///< Render pass (attachments and subpasses)
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED; ///< Depth attachment format
+    Command::DrawPipelines bound;               ///< Pipelines bound this frame (owned by registry)
+    Pipelines::PipelineKey fallbackKey = 0;     ///< Opaque without pre-pass, built at startup
+    Pipelines::PipelineKey key = 0;             ///< Opaque variant drawn by the frame
+    Pipelines::PipelineKey blendedKey = 0;      ///< Blended variant
+    Pipelines::PipelineKey prepassKey = 0;      ///< Depth-only variant (sceneConfig.depthPrepass)
+    Pipelines::PipelineKey spriteKey = 0;       ///< Opaque sprites (sceneConfig.spriteCount)
+    Pipelines::PipelineKey spriteBlendKey = 0;  ///< Blended sprites
+    Sprites::DrawPipelines boundSprites;        ///< Bound this frame (null until both are ready)
+    VkPipelineCache cache = VK_NULL_HANDLE;     ///< Driver pipeline cache persisted to disk
+
+    /// Sprites drawn over the upscaled swapchain image (upscaled render pass objects only)
+    VkRenderPass overlayRenderPass = VK_NULL_HANDLE;
 
     PipelineResources() = default;
     PipelineResources(const PipelineResources&) = delete;
@@ -85,21 +179,46 @@ struct PipelineResources
     PipelineResources& operator=(PipelineResources&&) = default;
 };
 
+/**
+ * @struct FrameGraph
+ * @brief Render graph of a frame and the ids of its passes and resources
+ * @details Declared and compiled once at startup; the colour target is bound every frame
+ */
+struct FrameGraph
+{
+    RenderGraph::Graph graph;                           ///< Passes and their derived barriers
+    RenderGraph::ResourceId color = 0;                  ///< Swapchain or offscreen image (imported)
+    RenderGraph::ResourceId depth = 0;                  ///< Depth attachment (transient)
+    RenderGraph::ResourceId visible = 0;                ///< Culled instances (gpuCulling only)
+    RenderGraph::ResourceId arguments = 0;              ///< Indirect arguments (gpuCulling only)
+    RenderGraph::PassId cull = RenderGraph::NO_PASS;    ///< Culling dispatch (gpuCulling only)
+    RenderGraph::PassId forward = 0;                    ///< The render pass
+    RenderGraph::ResourceId scene = 0;                  ///< Scaled colour target (upscaled only)
+    RenderGraph::PassId upscale = RenderGraph::NO_PASS; ///< Blit to the swapchain (upscaled only)
+    RenderGraph::PassId overlay = RenderGraph::NO_PASS; ///< Sprites after the blit (upscaled only)
+    RenderGraph::ResourceId overlayDepth = 0;           ///< Depth of the overlay pass (unused)
+
+    /// Stage the acquire's semaphore wait must cover: the colour target's first write
+    VkPipelineStageFlags2 colorReady = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+};
+
 /**
  * @struct BufferResources
- * @brief Vertex, index, and uniform buffers with their backing memory
+ * @brief Vertex, index, instance and indirect buffers with their backing memory
  * @details Groups all buffer objects and their associated device memory
  */
 struct BufferResources
 {
     VkBuffer vertexBuffer = VK_NULL_HANDLE;       ///< GPU buffer for vertex data
-    VkDeviceMemory vertexMemory = VK_NULL_HANDLE; ///< Memory backing vertex buffer
+    Memory::Allocation vertexMemory;              ///< Memory backing vertex buffer
     VkBuffer indexBuffer = VK_NULL_HANDLE;        ///< GPU buffer for index data
-    VkDeviceMemory indexMemory = VK_NULL_HANDLE;  ///< Memory backing index buffer
-
-    std::vector<VkBuffer> uniformBuffers;      ///< Uniform buffers for transformation matrices
-    std::vector<VkDeviceMemory> uniformMemory; ///< Memory backing uniform buffers
-    std::vector<void *> uniformMapped;         ///< Persistently mapped pointers for updates
+    Memory::Allocation indexMemory;               ///< Memory backing index buffer
+    VkIndexType indexType = VK_INDEX_TYPE_UINT16; ///< 16-bit unless the mesh needs 32
+    VkBuffer instanceBuffer = VK_NULL_HANDLE;     ///< Per-instance data (binding 1)
+    Memory::Allocation instanceMemory;            ///< Memory backing instance buffer
+    VkBuffer indirectBuffer = VK_NULL_HANDLE;     ///< VkDrawIndexedIndirectCommand records
+    Memory::Allocation indirectMemory;            ///< Memory backing indirect buffer
+    float boundingRadius = 0.0f;                  ///< Mesh bounding sphere (texture demand)
 
     BufferResources() = default;
     BufferResources(const BufferResources&) = delete;
@@ -115,10 +234,13 @@ struct BufferResources
  */
 struct TextureResources
 {
-    VkImage image = VK_NULL_HANDLE;         ///< Texture image on GPU
-    VkDeviceMemory memory = VK_NULL_HANDLE; ///< Memory backing texture image
-    VkImageView view = VK_NULL_HANDLE;      ///< Image view for texture
-    VkSampler sampler = VK_NULL_HANDLE;     ///< Sampler (filtering and addressing)
+    VkImage image = VK_NULL_HANDLE;            ///< Texture image on GPU
+    Memory::Allocation memory;                 ///< Memory backing texture image
+    VkImageView view = VK_NULL_HANDLE;         ///< Image view for texture
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB; ///< Image format (block-compressed for KTX2)
+    std::uint32_t mipLevels = 1;               ///< Mip levels uploaded
+    VkSampler sampler = VK_NULL_HANDLE;        ///< Sampler (filtering and addressing)
+    bool loaded = false;                       ///< Image made by the Loader (released to it)
 
     TextureResources() = default;
     TextureResources(const TextureResources&) = delete;
@@ -130,16 +252,10 @@ struct TextureResources
 /**
  * @struct SyncResources
  * @brief Synchronization primitives for frame coordination
- * @details Groups semaphores and fences with proper documentation of indexing
+ * @details Groups the GPU timeline and the per-image semaphores with documentation of indexing
  */
 struct SyncResources
 {
-    /**
-     * Semaphores indexed by currentFrame (0 to MAX_FRAMES_IN_FLIGHT-1)
-     * Used for vkAcquireNextImageKHR to signal when image is available
-     */
-    std::vector<VkSemaphore> imageAvailable;
-
     /**
      * Semaphores indexed by imageIndex (0 to swapChainImages.size()-1)
      * Used in vkQueueSubmit to signal when rendering is finished
@@ -148,10 +264,10 @@ struct SyncResources
     std::vector<VkSemaphore> renderFinished;
 
     /**
-     * Fences indexed by currentFrame for CPU-GPU synchronization
-     * Ensures a frame slot isn't reused until GPU finishes with it
+     * Timeline signalled by every frame submission with an increasing value
+     * Frame slots wait on it for pacing; the deletion queue compares against it
      */
-    std::vector<VkFence> inFlight;
+    Synchronization::Timeline timeline;
 
     SyncResources() = default;
     SyncResources(const SyncResources&) = delete;
@@ -173,6 +289,15 @@ struct SyncResources
 class TriangleApp
 {
   public:
+    /**
+     * @brief Configure the application before run()
+     * @param presentConfig Latency mode, swapchain image count and frames in flight
+     * @param sceneConfig Instance count and draw path
+     */
+    explicit TriangleApp(
+        const SwapChain::PresentConfig &presentConfig = {}, const SceneConfig &sceneConfig = {}
+    );
+
     /**
      * @brief Main application entry point
      * @details Initializes, runs main loop, and cleans up
@@ -193,7 +318,8 @@ class TriangleApp
 
     /**
      * @brief Initialize all Vulkan resources
-     * @details Creates instance, devices, swapchain, pipeline, buffers, and sync objects
+     * @details Creates instance, devices, swapchain, pipeline, buffers, and sync objects as
+     *          a Jobs::TaskGraph, so independent steps overlap on the worker threads
      */
     void initVulkan();
 
@@ -205,27 +331,125 @@ class TriangleApp
      */
     void mainLoop();
 
+    /**
+     * @brief Headless loop: draw the warm-up and measured frames and write the report
+     * @details CPU time is the wall time of drawFrame; GPU time is the profiler's
+     *          "gpu frame" zone
+     */
+    void runBenchmark();
+
     /**
      * @brief Render a single frame
      * @details Acquires image, updates uniforms, records commands, submits, and presents
+     *          (headless: renders into the slot's offscreen image and only submits)
      */
     void drawFrame();
 
     /**
-     * @brief Update uniform buffer with transformation matrices
-     * @param currentImage Index of uniform buffer to update
-     * @details Updates model, view, and projection matrices for animation
+     * @brief Animated rotation of the scene's mesh node
+     * @return Local rotation of the mesh node (the model matrix of every draw)
+     * @details Wall-clock animation, or frameNumber steps of simulated time in benchmarks
+     */
+    glm::quat sceneRotation() const;
+
+    /**
+     * @brief Seconds the scene has been animated for
+     * @return Wall-clock time since the first call, or frameNumber steps of simulated time in
+     *         benchmarks
      */
-    void updateUniformBuffer(std::uint32_t currentImage);
+    float sceneTime() const;
+
+    /**
+     * @brief Scroll the sprites and write them into the frame slot's stream
+     * @details Each layer drifts sideways at its own speed and wraps around the swapchain
+     *          extent; Sprites::prepare then sorts and batches them
+     */
+    void updateSprites();
+
+    /**
+     * @brief Write the frame's camera matrices into the uniform ring
+     * @param frame Frame context whose ring region is used
+     * @param dynamicOffset Output dynamic offset for set 0
+     * @return Matrices written, reused by the cull pass
+     * @details View and projection come from the cached camera, rebuilt only when the extent
+     *          or the camera changed
+     */
+    Buffer::Vertex::UniformBufferObject updateUniformBuffer(
+        Frame::FrameContext &frame, std::uint32_t &dynamicOffset
+    );
 
     // === Resource Management ===
 
+    /**
+     * @brief Declare and compile the frame's render graph and create its render pass
+     * @details The culling dispatch (gpuCulling only, unless it runs on the async compute
+     *          queue, when its outputs are imported), then the render pass drawing into the
+     *          imported colour target and the transient depth attachment
+     */
+    void createFrameGraph();
+
+    /**
+     * @brief Create the headless render targets in place of a swapchain
+     * @details One colour image per frame slot in the swapchain format, so the render pass
+     *          and pipeline are the windowed ones
+     */
+    void createOffscreenTargets();
+
+    /**
+     * @brief Create one framebuffer per swapchain image (render pass path only)
+     * @details Upscaled frames draw into the scene image, so every framebuffer shares it
+     */
+    void createFramebuffers();
+
+    /**
+     * @brief Path of the scene texture (sceneConfig.texturePath or the default)
+     * @return Path, as looked up in the asset pack
+     */
+    std::string sceneTexturePath() const;
+
+    /**
+     * @brief Create the scene texture (from the pack when baked) with its view and sampler
+     * @param target Output texture
+     * @param texturePath Path of the texture
+     * @param texels Texels decoded from texturePath (unused when the pack holds them)
+     */
+    void loadTexture(
+        TextureResources &target,
+        const std::string &texturePath,
+        const Ktx::TextureData &texels
+    );
+
+    /**
+     * @brief Destroy a texture's sampler, view and image
+     * @param target Texture no submitted frame uses any more (reset on return)
+     * @details Images the loader made go back to it; the others to the app's allocator
+     */
+    void destroyTexture(TextureResources &target);
+
+    /**
+     * @brief Install the shaders and textures the watcher rebuilt (sceneConfig.hotReload)
+     * @details Called between frames. Shaders go to the registry, which rebuilds the affected
+     *          variants in the background; rebuilt pipelines are swapped in here and the old
+     *          ones retired through the deletion queue. A texture is handed to the loader
+     *          thread and replaces the scene texture once its future is ready, so the frame
+     *          never waits on the upload.
+     */
+    void applyReloads();
+
     /**
      * @brief Recreate swapchain after window resize
-     * @details Destroys old swapchain and creates new one with updated dimensions
+     * @details Creates the new swapchain from the old one and retires the old resources
+     *          through the deletion queue instead of draining the device
      */
     void recreateSwapChain();
 
+    /**
+     * @brief Queue the current swapchain, views, framebuffers, transient attachments and
+     *        per-image semaphores for deferred destruction and clear the handles
+     * @param oldSwapChain Output handle of the retired swapchain (still valid until flushed)
+     */
+    void retireSwapChain(VkSwapchainKHR &oldSwapChain);
+
     /**
      * @brief Clean up swapchain-dependent resources
      * @details Destroys framebuffers, image views, swapchain, and per-image semaphores
@@ -242,18 +466,66 @@ class TriangleApp
 
     GLFWwindow *window = nullptr; ///< GLFW window handle
 
-    VulkanCore vulkan;            ///< Core Vulkan objects (instance, device, queues)
-    SwapchainResources swapchain; ///< Swapchain and dependent resources
-    PipelineResources pipeline;   ///< Graphics pipeline and layout
-    BufferResources buffers;      ///< Vertex, index, and uniform buffers
-    TextureResources texture;     ///< Texture image, view, and sampler
-    SyncResources sync;           ///< Synchronization primitives
+    VulkanCore vulkan;                 ///< Core Vulkan objects (instance, device, queues)
+    Memory::Allocator allocator;       ///< Device memory sub-allocator for buffers and images
+    Upload::Context uploads;           ///< Batched staging uploads in flight
+    SwapchainResources swapchain;      ///< Swapchain and dependent resources
+    PipelineResources pipeline;        ///< Graphics pipeline and layout
+    FrameGraph frameGraph;             ///< Passes of a frame and their barriers
+    Pipelines::Registry pipelines;     ///< Pipeline variants and shared shader modules
+    Profiler::Profiler profiler;       ///< CPU and GPU frame timings (sceneConfig.profile only)
+    AssetPack::Pack assets;            ///< Mapped asset pack (closed unless sceneConfig.assetPack)
+    BufferResources buffers;           ///< Vertex and index buffers
+    TextureResources texture;          ///< Texture image, view, and sampler
+    SyncResources sync;                ///< Synchronization primitives
+    Deletion::Queue deletionQueue;     ///< Objects released once the GPU timeline passes them
+    Submit::Batcher submits;           ///< Frame, upload and compute submissions, flushed together
+    Resolution::Controller resolution; ///< Render scale (sceneConfig.upscaled() only)
+
+    Descriptors::LayoutCache layouts;   ///< Every descriptor set layout built from bindings
+    Descriptors::Allocator descriptors; ///< Persistent sets, freed only at shutdown
+
+    SwapChain::PresentConfig presentConfig; ///< Startup latency policy
+    SceneConfig sceneConfig;                ///< Startup scene settings
+    SwapChain::PresentPacer presentPacer;   ///< present_wait pacing (LowLatency mode only)
+
+    std::vector<Frame::FrameContext> frames; ///< Per-frame-in-flight resources
+    Frame::UniformRing uniforms;             ///< Uniform buffer shared by the frames, by region
+    std::uint32_t framesInFlight = 2;        ///< Frame slots, resolved from presentConfig
 
-    VkCommandPool commandPool = VK_NULL_HANDLE;  ///< Command pool for allocating command buffers
-    std::vector<VkCommandBuffer> commandBuffers; ///< Command buffers (one per frame in flight)
+    Jobs::JobSystem jobs;               ///< Worker threads for startup tasks and recording
+    Command::ParallelRecorder recorder; ///< Per-thread, per-frame secondary command pools
 
-    VkDescriptorPool descriptorPool = VK_NULL_HANDLE; ///< Pool for allocating descriptor sets
-    std::vector<VkDescriptorSet> descriptorSets; ///< Descriptor sets (bind resources to shaders)
+    std::vector<Command::DrawItem> drawItems;         ///< CPU draw list recorded every frame
+    std::vector<Command::IndirectDraw> indirectDraws; ///< GPU-sourced draws recorded every frame
+    Culling::CullPass culling;                        ///< GPU frustum culling (gpuCulling only)
+    AsyncCompute::Context asyncCompute;               ///< Culling queue (null = graphics queue)
+
+    Scene::Graph scene;   ///< Mesh node, then one node per instance (mesh space)
+    Scene::Camera camera; ///< View and projection, rebuilt on change only
+
+    Streaming::Streamer streamer;                 ///< Mip residency (sceneConfig.streamPath only)
+    Streaming::TextureHandle streamedTexture = 0; ///< Drawn instead of texture once resident
+
+    Bindless::Table bindless;        ///< Texture and material table (sceneConfig.bindless only)
+    std::uint32_t textureSlot = 0;   ///< Bindless slot of the texture drawn
+    std::uint32_t materialIndex = 0; ///< Material of the scene's draws
+
+    std::vector<TextureResources> extraTextures; ///< Further copies (sceneConfig.textureCount)
+
+    Sprites::Renderer spriteRenderer;     ///< Sprite streams and index buffer (spriteCount only)
+    std::vector<Sprites::Sprite> sprites; ///< Sprites drawn over the scene, in pixels
+    float spriteClock = 0.0f;             ///< sceneTime() of the last sprite update
+
+    HotReload::Watcher watcher; ///< Shader and texture watcher (sceneConfig.hotReload)
+    Loader::Loader loader;      ///< Uploads edited textures off the render thread (hotReload)
+
+    /// Edited textures still uploading, oldest first
+    std::deque<std::future<Loader::Resource>> reloadLoads;
 
     std::uint32_t currentFrame = 0; ///< Current frame index (wraps around)
+    std::uint64_t frameNumber = 0;  ///< Frames submitted (the simulated clock in benchmarks)
+
+    std::chrono::steady_clock::time_point launchTime; ///< Start of run()
+    double startupMs = 0.0;                           ///< Time to the first frame's submission
 };
\ No newline at end of file
@@ -0,0 +1,248 @@
+/**
+ * @file Upload.hpp
+ * @brief Batched, non-blocking uploads of buffer and image data to the GPU
+ */
+
+#pragma once
+
+#include "Memory.hpp"
+#include "Submit.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+/**
+ * @namespace Upload
+ * @brief Records many copies and barriers into one batch and submits it with a fence
+ * @details Replaces one vkQueueWaitIdle per copy: uploads are recorded into the current batch,
+ *          submitted together through the Submit::Batcher and retired once the batch fence
+ *          signals. Source data is staged in one persistently mapped ring; uploads larger than
+ *          the free space are streamed in chunks. When the device exposes a dedicated transfer
+ *          family, copies run there and ownership is handed to graphics.
+ */
+namespace Upload
+{
+    /// Size of the persistently mapped staging ring shared by all uploads
+    inline constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 16ull * 1024 * 1024;
+
+    /**
+     * @struct ImageLevel
+     * @brief One mip level of an image upload
+     */
+    struct ImageLevel
+    {
+        VkDeviceSize offset = 0;  ///< Byte offset of the level in the source data
+        VkDeviceSize size = 0;    ///< Tightly packed bytes (whole texel blocks)
+        std::uint32_t width = 0;  ///< Level width in texels
+        std::uint32_t height = 0; ///< Level height in texels
+    };
+
+    /**
+     * @struct Retirement
+     * @brief Ring position to release once a submitted batch retires
+     */
+    struct Retirement
+    {
+        std::uint64_t batchId = 0; ///< Batch that consumed the ring up to end
+        VkDeviceSize end = 0;      ///< Ring head when the batch was submitted
+        bool done = false;         ///< Batch retired (released once all older batches are)
+    };
+
+    /**
+     * @struct StagingRing
+     * @brief Host-visible ring buffer that uploads take staging slices from
+     * @details Slices are handed out between tail and head; the tail only moves forward when the
+     *          oldest outstanding batch retires, so slices are recycled in submission order
+     */
+    struct StagingRing
+    {
+        VkBuffer buffer = VK_NULL_HANDLE; ///< Staging buffer (TRANSFER_SRC)
+        Memory::Allocation allocation;    ///< Persistently mapped host-visible memory
+        VkDeviceSize size = 0;            ///< Ring capacity in bytes
+        VkDeviceSize alignment = 16;      ///< Slice offset alignment (copy offset requirements)
+        VkDeviceSize head = 0;            ///< Next free byte
+        VkDeviceSize tail = 0;            ///< Oldest byte still read by the GPU
+        std::deque<Retirement> pending;   ///< Submitted batches, oldest first
+    };
+
+    /**
+     * @struct Batch
+     * @brief Command buffers and sync objects for one submission of uploads
+     */
+    struct Batch
+    {
+        VkCommandBuffer transferCommands = VK_NULL_HANDLE; ///< Copies (transfer family)
+        VkCommandBuffer graphicsCommands = VK_NULL_HANDLE; ///< Ownership acquires (graphics family)
+        VkSemaphore transferDone = VK_NULL_HANDLE;         ///< Transfer -> graphics hand-off
+        VkFence fence = VK_NULL_HANDLE;                    ///< Signaled when the batch retired
+        VkPipelineStageFlags graphicsWaitStages = 0;       ///< Stages waiting on transferDone
+        std::uint64_t id = 0;                              ///< Batch ticket (0 = free slot)
+        bool submitted = false;                            ///< Submitted and not yet retired
+    };
+
+    /**
+     * @struct Context
+     * @brief Upload queues, command pools and the batches in flight
+     */
+    struct Context
+    {
+        VkDevice device = VK_NULL_HANDLE;            ///< Logical device
+        Memory::Allocator *allocator = nullptr;      ///< Allocator for staging memory
+        VkQueue graphicsQueue = VK_NULL_HANDLE;      ///< Queue consuming uploaded resources
+        VkQueue transferQueue = VK_NULL_HANDLE;      ///< Queue executing copies
+        Submit::Batcher *batcher = nullptr;          ///< Takes the batches' submissions
+        std::uint32_t graphicsFamily = 0;            ///< Graphics queue family index
+        std::uint32_t transferFamily = 0;            ///< Transfer queue family index
+        VkCommandPool graphicsPool = VK_NULL_HANDLE; ///< Pool for ownership-acquire commands
+        VkCommandPool transferPool = VK_NULL_HANDLE; ///< Pool for copy commands
+        StagingRing ring;                            ///< Staging memory shared by all batches
+
+        std::vector<Batch> batches;           ///< Reusable batch slots
+        std::optional<std::size_t> recording; ///< Slot currently being recorded
+        std::uint64_t nextBatchId = 1;        ///< Ticket of the next batch
+
+        /// True when copies run on a separate family and need ownership transfers
+        bool dedicatedTransfer() const
+        {
+            return graphicsFamily != transferFamily;
+        }
+
+        Context() = default;
+        Context(const Context&) = delete;
+        Context& operator=(const Context&) = delete;
+        Context(Context&&) = default;
+        Context& operator=(Context&&) = default;
+    };
+
+    /**
+     * @brief Create the upload context, its command pools and the staging ring
+     * @param device Logical device
+     * @param physicalDevice Physical device for queue family lookup
+     * @param surface Surface used for queue family selection
+     * @param allocator Allocator for staging buffers
+     * @param graphicsQueue Graphics queue that consumes uploads
+     * @param transferQueue Transfer queue (may equal graphicsQueue)
+     * @param batcher Batcher the submissions go through (outlives the context)
+     * @param context Output upload context
+     * @param stagingSize Capacity of the staging ring in bytes
+     */
+    void createContext(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        Memory::Allocator &allocator,
+        VkQueue &graphicsQueue,
+        VkQueue &transferQueue,
+        Submit::Batcher &batcher,
+        Context &context,
+        VkDeviceSize stagingSize = DEFAULT_STAGING_SIZE
+    );
+
+    /**
+     * @brief Wait for outstanding batches and destroy the context
+     * @param context Upload context to destroy
+     */
+    void destroyContext(Context &context);
+
+    /**
+     * @brief Record a buffer upload into the current batch
+     * @param context Upload context
+     * @param data Source data (copied into staging memory immediately)
+     * @param size Number of bytes to upload
+     * @details Uploads larger than half the ring are split into chunks; when the ring is full
+     *          the current batch is submitted and the oldest batch is waited on
+     * @param dstBuffer Destination device-local buffer
+     * @param dstOffset Byte offset into the destination
+     * @param dstStage Pipeline stage that first consumes the buffer
+     * @param dstAccess Access type of that first consumer
+     */
+    void uploadBuffer(
+        Context &context,
+        const void *data,
+        VkDeviceSize size,
+        VkBuffer dstBuffer,
+        VkDeviceSize dstOffset,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess
+    );
+
+    /**
+     * @brief Record a full 2D image upload into the current batch
+     * @param context Upload context
+     * @param data Tightly packed texel data
+     * @param size Number of bytes to upload
+     * @param image Destination image (contents undefined before the upload)
+     * @param format Image format
+     * @param width Image width in texels
+     * @param height Image height in texels
+     * @details Transitions UNDEFINED -> TRANSFER_DST -> SHADER_READ_ONLY around the copy.
+     *          Large images are copied in bands of whole rows
+     */
+    void uploadImage(
+        Context &context,
+        const void *data,
+        VkDeviceSize size,
+        VkImage image,
+        VkFormat format,
+        std::uint32_t width,
+        std::uint32_t height
+    );
+
+    /**
+     * @brief Record a 2D image upload of every mip level into the current batch
+     * @param context Upload context
+     * @param data Source bytes the level offsets refer to
+     * @param image Destination image (contents undefined before the upload)
+     * @param format Image format (block-compressed formats are copied in whole block rows)
+     * @param levels Levels to copy, level 0 first
+     * @param mipLevels Mip levels of the image (0 = levels.size()); those past levels are
+     *                  generated by blitting down from the last copied one (the image needs
+     *                  TRANSFER_SRC usage and a format Image::canGenerateMipmaps accepts)
+     * @details Same transitions as the single-level upload, covering all levels. Blits run on
+     *          the graphics queue: with a dedicated transfer family the image is handed over
+     *          before they are recorded.
+     */
+    void uploadImage(
+        Context &context,
+        const void *data,
+        VkImage image,
+        VkFormat format,
+        std::span<const ImageLevel> levels,
+        std::uint32_t mipLevels = 0
+    );
+
+    /**
+     * @brief Submit the current batch without waiting for it
+     * @param context Upload context
+     * @return Batch ticket, or 0 if nothing was recorded
+     * @details The work is enqueued on the batcher and reaches the queues with its next flush;
+     *          waiting on the ticket flushes first
+     */
+    std::uint64_t submit(Context &context);
+
+    /**
+     * @brief Retire every batch whose fence has signaled and recycle its staging slices
+     * @param context Upload context
+     */
+    void collect(Context &context);
+
+    /**
+     * @brief Check whether a submitted batch has finished on the GPU
+     * @param context Upload context
+     * @param ticket Ticket returned by submit()
+     * @return true once the batch retired
+     */
+    bool isComplete(Context &context, std::uint64_t ticket);
+
+    /**
+     * @brief Block until a submitted batch has finished
+     * @param context Upload context
+     * @param ticket Ticket returned by submit()
+     */
+    void wait(Context &context, std::uint64_t ticket);
+} // namespace Upload
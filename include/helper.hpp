@@ -18,15 +18,11 @@ namespace Helper
      * @param filename Path to file (relative or absolute)
      * @return Vector of bytes containing file contents
      * @throws std::runtime_error if file doesn't exist or can't be opened
-     * @details Reads binary files (e.g., SPIR-V shaders) into memory.
-     *          Prints current working directory for debugging path issues.
+     * @details Reads binary files (e.g., SPIR-V shaders) into memory. Startup assets can come
+     *          from an asset pack instead (see AssetPack), which avoids this copy.
      */
     static std::vector<std::byte> readFile(const std::filesystem::path &filename)
     {
-
-        std::filesystem::path exePath = std::filesystem::current_path();
-        std::printf("Current path: %s\n", exePath.string().c_str());
-
         if (!std::filesystem::exists(filename))
         {
             throw std::runtime_error("file does not exist!");
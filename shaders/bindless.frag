@@ -0,0 +1,37 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) in vec4 fragTint;
+
+// Bindless::Table (set 1): material records and every texture, selected per draw
+struct Material
+{
+    vec4 baseColor;
+    uint textureIndex;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Materials
+{
+    Material materials[];
+};
+
+layout(set = 1, binding = 1) uniform sampler2D textures[];
+
+// GraphicsPipeline::DrawConstants (the vertex stage reads the model matrix before it)
+layout(push_constant) uniform DrawConstants
+{
+    layout(offset = 64) uint materialIndex;
+}
+draw;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    // The index comes from a push constant, so it is uniform across the draw
+    Material material = materials[draw.materialIndex];
+    outColor = texture(textures[material.textureIndex], fragTexCoord) * material.baseColor
+               * fragTint;
+}
\ No newline at end of file
@@ -1,23 +1,42 @@
 #version 450
 
+// Camera matrices, read from the uniform ring at the frame's dynamic offset
 layout(binding = 0) uniform UniformBufferObject
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
 }
 ubo;
 
-layout(location = 0) in vec2 inPosition;
+// GraphicsPipeline::DrawConstants (materialIndex follows at offset 64)
+layout(push_constant) uniform DrawConstants
+{
+    mat4 model;
+}
+draw;
+
+// Packed meshes fetch xyz from half floats; the 2D Buffer::Vertex layout reads z as 0
+layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 
+// Per-instance data (binding 1): xyz translation + uniform scale, and a tint
+layout(location = 3) in vec4 inOffsetScale;
+layout(location = 4) in vec4 inTint;
+
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) out vec4 fragTint;
+
+// The depth pre-pass and the opaque pass are separate pipelines over this shader; both must
+// compute bit-identical depth for the EQUAL/LESS_OR_EQUAL test to pass
+invariant gl_Position;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 0.0, 1.0);
+    vec3 position = inPosition * inOffsetScale.w + inOffsetScale.xyz;
+    gl_Position = ubo.proj * ubo.view * draw.model * vec4(position, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    fragTint = inTint;
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec4 fragColor;
+
+// The frame's texture, addressed as an atlas by each sprite's uvRect
+layout(binding = 1) uniform sampler2D texSampler;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = texture(texSampler, fragTexCoord) * fragColor;
+}
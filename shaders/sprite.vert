@@ -0,0 +1,23 @@
+#version 450
+
+// GraphicsPipeline::DrawConstants: model holds the pixel-to-clip matrix of Sprites::record
+layout(push_constant) uniform DrawConstants
+{
+    mat4 model;
+}
+draw;
+
+// Sprites::Vertex (binding 0), the four corners of every quad
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec4 inColor;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec4 fragColor;
+
+void main()
+{
+    gl_Position = draw.model * vec4(inPosition, 0.0, 1.0);
+    fragTexCoord = inTexCoord;
+    fragColor = inColor;
+}
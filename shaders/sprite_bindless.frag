@@ -0,0 +1,36 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec4 fragColor;
+
+// Bindless::Table (set 1): material records and every texture
+struct Material
+{
+    vec4 baseColor;
+    uint textureIndex;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Materials
+{
+    Material materials[];
+};
+
+layout(set = 1, binding = 1) uniform sampler2D textures[];
+
+// GraphicsPipeline::DrawConstants: the batch's material, after the matrix
+layout(push_constant) uniform DrawConstants
+{
+    layout(offset = 64) uint materialIndex;
+}
+draw;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    // Batches never mix materials, so the index is uniform across the draw
+    Material material = materials[draw.materialIndex];
+    outColor = texture(textures[material.textureIndex], fragTexCoord) * material.baseColor
+               * fragColor;
+}
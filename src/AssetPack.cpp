@@ -0,0 +1,404 @@
+#include "AssetPack.hpp"
+#include "Culling.hpp"
+#include "GraphicsPipeline.hpp"
+#include "Image.hpp"
+#include "helper.hpp"
+
+#include <stb_image.h>
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AssetPack
+{
+    namespace
+    {
+        std::uint64_t alignUp(std::uint64_t value)
+        {
+            return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+        }
+
+        /// Map the whole file read-only; the OS pages payloads in on first touch
+        void mapFile(const std::filesystem::path &path, Pack &pack)
+        {
+#ifdef _WIN32
+            pack.file = CreateFileW(
+                path.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_FLAG_SEQUENTIAL_SCAN,
+                nullptr
+            );
+            if (pack.file == INVALID_HANDLE_VALUE)
+            {
+                pack.file = nullptr;
+                throw std::runtime_error("failed to open asset pack!");
+            }
+
+            LARGE_INTEGER size{};
+            GetFileSizeEx(pack.file, &size);
+            pack.size = static_cast<std::size_t>(size.QuadPart);
+
+            pack.mapping = CreateFileMappingW(pack.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const void *view = pack.mapping != nullptr
+                                   ? MapViewOfFile(pack.mapping, FILE_MAP_READ, 0, 0, 0)
+                                   : nullptr;
+            if (view == nullptr)
+            {
+                closePack(pack);
+                throw std::runtime_error("failed to map asset pack!");
+            }
+            pack.data = static_cast<const std::byte *>(view);
+#else
+            pack.fd = open(path.c_str(), O_RDONLY);
+            if (pack.fd < 0)
+            {
+                throw std::runtime_error("failed to open asset pack!");
+            }
+
+            struct stat status{};
+            if (fstat(pack.fd, &status) != 0 || status.st_size <= 0)
+            {
+                closePack(pack);
+                throw std::runtime_error("failed to map asset pack!");
+            }
+            pack.size = static_cast<std::size_t>(status.st_size);
+
+            void *view = mmap(nullptr, pack.size, PROT_READ, MAP_PRIVATE, pack.fd, 0);
+            if (view == MAP_FAILED)
+            {
+                pack.size = 0;
+                closePack(pack);
+                throw std::runtime_error("failed to map asset pack!");
+            }
+            pack.data = static_cast<const std::byte *>(view);
+#endif
+        }
+
+        /// The payload holds exactly the bytes its consumer reads from the entry's params
+        bool payloadMatches(const Entry &entry)
+        {
+            switch (entry.type)
+            {
+            case AssetType::Shader:
+                return entry.size > 0 && entry.size % sizeof(std::uint32_t) == 0;
+            case AssetType::Texture:
+            {
+                const VkDeviceSize size = Image::levelSize(
+                    static_cast<VkFormat>(entry.params[2]), entry.params[0], entry.params[1]
+                );
+                return size > 0 && entry.size == size;
+            }
+            case AssetType::Vertices:
+                return entry.size == std::uint64_t{entry.params[0]} * sizeof(Mesh::PackedVertex);
+            case AssetType::Indices:
+            {
+                const auto indexType = static_cast<VkIndexType>(entry.params[0]);
+                const std::uint64_t indexSize = indexType == VK_INDEX_TYPE_UINT16   ? 2
+                                                : indexType == VK_INDEX_TYPE_UINT32 ? 4
+                                                                                    : 0;
+                return indexSize > 0 && entry.size == std::uint64_t{entry.params[1]} * indexSize;
+            }
+            case AssetType::Placement:
+                return entry.size == 0;
+            default:
+                return false;
+            }
+        }
+
+        /// Check the header and that every record lies inside the file, aligned and sized
+        /// for its type
+        bool validate(const Pack &pack)
+        {
+            if (pack.size < sizeof(Header))
+            {
+                return false;
+            }
+
+            Header header;
+            std::memcpy(&header, pack.data, sizeof(header));
+            if (header.magic != PACK_MAGIC || header.version != PACK_VERSION
+                || header.fileSize != pack.size || header.tocOffset % alignof(Entry) != 0
+                || header.tocOffset > pack.size
+                || header.entryCount > (pack.size - header.tocOffset) / sizeof(Entry))
+            {
+                return false;
+            }
+
+            const auto *entries = reinterpret_cast<const Entry *>(pack.data + header.tocOffset);
+            for (std::uint32_t i = 0; i < header.entryCount; i++)
+            {
+                const Entry &entry = entries[i];
+                if (entry.offset % PACK_ALIGNMENT != 0 || entry.offset > pack.size
+                    || entry.size > pack.size - entry.offset
+                    || std::memchr(entry.name, '\0', sizeof(entry.name)) == nullptr
+                    || !payloadMatches(entry))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<std::byte> readShader(std::string_view path)
+        {
+            return Helper::readFile(std::string(path));
+        }
+    } // namespace
+
+    void openPack(const std::filesystem::path &path, Pack &pack)
+    {
+        mapFile(path, pack);
+
+        if (!validate(pack))
+        {
+            closePack(pack);
+            throw std::runtime_error("invalid asset pack!");
+        }
+
+        Header header;
+        std::memcpy(&header, pack.data, sizeof(header));
+        pack.entries = std::span(
+            reinterpret_cast<const Entry *>(pack.data + header.tocOffset), header.entryCount
+        );
+    }
+
+    void closePack(Pack &pack)
+    {
+#ifdef _WIN32
+        if (pack.data != nullptr)
+        {
+            UnmapViewOfFile(pack.data);
+        }
+        if (pack.mapping != nullptr)
+        {
+            CloseHandle(pack.mapping);
+        }
+        if (pack.file != nullptr)
+        {
+            CloseHandle(pack.file);
+        }
+        pack.mapping = nullptr;
+        pack.file = nullptr;
+#else
+        if (pack.data != nullptr)
+        {
+            munmap(const_cast<std::byte *>(pack.data), pack.size);
+        }
+        if (pack.fd >= 0)
+        {
+            close(pack.fd);
+        }
+        pack.fd = -1;
+#endif
+        pack.data = nullptr;
+        pack.size = 0;
+        pack.entries = {};
+    }
+
+    bool isOpen(const Pack &pack)
+    {
+        return pack.data != nullptr;
+    }
+
+    const Entry *find(const Pack &pack, std::string_view name, AssetType type)
+    {
+        for (const Entry &entry : pack.entries)
+        {
+            if (entry.type == type && name == entry.name)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    std::span<const std::byte> payload(const Pack &pack, const Entry &entry)
+    {
+        return std::span(pack.data + entry.offset, static_cast<std::size_t>(entry.size));
+    }
+
+    bool findMesh(const Pack &pack, Mesh::MeshView &mesh)
+    {
+        const Entry *vertices = find(pack, meshVerticesName, AssetType::Vertices);
+        const Entry *indices = find(pack, meshIndicesName, AssetType::Indices);
+        const Entry *placement = find(pack, meshPlacementName, AssetType::Placement);
+        if (vertices == nullptr || indices == nullptr || placement == nullptr)
+        {
+            return false;
+        }
+
+        mesh.vertices = payload(pack, *vertices);
+        mesh.boundingRadius = std::bit_cast<float>(vertices->params[1]);
+        mesh.indices = payload(pack, *indices);
+        mesh.indexType = static_cast<VkIndexType>(indices->params[0]);
+        mesh.indexCount = indices->params[1];
+        mesh.center = glm::vec3(
+            std::bit_cast<float>(placement->params[0]),
+            std::bit_cast<float>(placement->params[1]),
+            std::bit_cast<float>(placement->params[2])
+        );
+        mesh.scale = std::bit_cast<float>(placement->params[3]);
+        return true;
+    }
+
+    void writePack(const std::filesystem::path &path, const std::vector<BakeEntry> &entries)
+    {
+        /// Header, table of contents, then the payloads in order
+        Header header;
+        header.entryCount = static_cast<std::uint32_t>(entries.size());
+        header.tocOffset = sizeof(Header);
+
+        std::vector<Entry> toc(entries.size());
+        std::uint64_t offset = alignUp(header.tocOffset + sizeof(Entry) * toc.size());
+        for (std::size_t i = 0; i < entries.size(); i++)
+        {
+            const BakeEntry &source = entries[i];
+            if (source.name.size() >= sizeof(Entry::name))
+            {
+                throw std::runtime_error("asset pack entry name too long!");
+            }
+
+            Entry &entry = toc[i];
+            std::memcpy(entry.name, source.name.data(), source.name.size());
+            entry.type = source.type;
+            std::memcpy(entry.params, source.params.data(), sizeof(entry.params));
+            entry.offset = offset;
+            entry.size = source.bytes.size();
+            offset = alignUp(offset + entry.size);
+        }
+        header.fileSize = offset;
+
+        std::error_code error;
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        /// Write next to the target and rename, so a crash never leaves a truncated pack
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(
+                reinterpret_cast<const char *>(toc.data()),
+                static_cast<std::streamsize>(sizeof(Entry) * toc.size())
+            );
+
+            std::uint64_t position = sizeof(header) + sizeof(Entry) * toc.size();
+            for (std::size_t i = 0; i < entries.size(); i++)
+            {
+                const std::vector<char> padding(toc[i].offset - position, 0);
+                file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+                file.write(
+                    reinterpret_cast<const char *>(entries[i].bytes.data()),
+                    static_cast<std::streamsize>(entries[i].bytes.size())
+                );
+                position = toc[i].offset + toc[i].size;
+            }
+            const std::vector<char> padding(header.fileSize - position, 0);
+            file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+            if (!file)
+            {
+                throw std::runtime_error("failed to write asset pack!");
+            }
+        }
+
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            throw std::runtime_error("failed to write asset pack!");
+        }
+    }
+
+    void bakeSceneAssets(const std::filesystem::path &path, const std::string &meshPath)
+    {
+        std::vector<BakeEntry> entries;
+
+        /// Compiled shaders, looked up by the paths the pipelines are built from
+        for (std::string_view shader :
+             {GraphicsPipeline::vertShaderPath,
+              GraphicsPipeline::fragShaderPath,
+              GraphicsPipeline::bindlessFragShaderPath,
+              Culling::cullShaderPath})
+        {
+            entries.push_back({std::string(shader), AssetType::Shader, {}, readShader(shader)});
+        }
+
+        /// Texture decoded once here instead of at every startup
+        int width, height, channels;
+        stbi_uc *pixels = stbi_load(
+            std::string(Image::texturePath).c_str(), &width, &height, &channels, STBI_rgb_alpha
+        );
+        if (!pixels)
+        {
+            throw std::runtime_error("failed to load texture image!");
+        }
+        const auto texelBytes = static_cast<std::size_t>(Image::levelSize(
+            VK_FORMAT_R8G8B8A8_SRGB,
+            static_cast<std::uint32_t>(width),
+            static_cast<std::uint32_t>(height)
+        ));
+        BakeEntry texture{
+            std::string(Image::texturePath),
+            AssetType::Texture,
+            {static_cast<std::uint32_t>(width),
+             static_cast<std::uint32_t>(height),
+             static_cast<std::uint32_t>(VK_FORMAT_R8G8B8A8_SRGB),
+             0},
+            std::vector<std::byte>(texelBytes)
+        };
+        std::memcpy(texture.bytes.data(), pixels, texelBytes);
+        stbi_image_free(pixels);
+        entries.push_back(std::move(texture));
+
+        /// Mesh after welding, optimisation and quantisation
+        const Mesh::MeshData mesh = meshPath.empty()
+                                        ? Mesh::fromVertices(Buffer::vertices, Buffer::indices)
+                                        : Mesh::loadMesh(meshPath);
+        const Mesh::MeshView meshView = Mesh::view(mesh);
+        entries.push_back(
+            {std::string(meshVerticesName),
+             AssetType::Vertices,
+             {static_cast<std::uint32_t>(mesh.vertices.size()),
+              std::bit_cast<std::uint32_t>(mesh.boundingRadius),
+              0,
+              0},
+             std::vector<std::byte>(meshView.vertices.begin(), meshView.vertices.end())}
+        );
+        entries.push_back(
+            {std::string(meshIndicesName),
+             AssetType::Indices,
+             {static_cast<std::uint32_t>(mesh.indexType), mesh.indexCount, 0, 0},
+             mesh.indices}
+        );
+        entries.push_back(
+            {std::string(meshPlacementName),
+             AssetType::Placement,
+             {std::bit_cast<std::uint32_t>(mesh.center.x),
+              std::bit_cast<std::uint32_t>(mesh.center.y),
+              std::bit_cast<std::uint32_t>(mesh.center.z),
+              std::bit_cast<std::uint32_t>(mesh.scale)},
+             {}}
+        );
+
+        writePack(path, entries);
+    }
+} // namespace AssetPack
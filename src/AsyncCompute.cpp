@@ -0,0 +1,292 @@
+#include "AsyncCompute.hpp"
+#include "Queue.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace AsyncCompute
+{
+    namespace
+    {
+        VkCommandPool createPool(VkDevice device, std::uint32_t queueFamily)
+        {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolInfo.queueFamilyIndex = queueFamily;
+
+            VkCommandPool pool;
+            VK_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &pool), "create compute pool");
+            return pool;
+        }
+
+        VkCommandBuffer allocateCommands(VkDevice device, VkCommandPool pool)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = pool;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            VK_CHECK(
+                vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer),
+                "allocate compute command buffer"
+            );
+            return commandBuffer;
+        }
+
+        void beginOneTime(VkCommandBuffer commandBuffer)
+        {
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo), "begin compute commands");
+        }
+
+        std::vector<VkBufferMemoryBarrier> ownershipBarriers(
+            std::span<const VkBuffer> buffers,
+            std::uint32_t srcFamily,
+            std::uint32_t dstFamily,
+            VkAccessFlags srcAccess,
+            VkAccessFlags dstAccess
+        )
+        {
+            std::vector<VkBufferMemoryBarrier> barriers;
+            barriers.reserve(buffers.size());
+            for (VkBuffer buffer : buffers)
+            {
+                VkBufferMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                barrier.srcAccessMask = srcAccess;
+                barrier.dstAccessMask = dstAccess;
+                barrier.srcQueueFamilyIndex = srcFamily;
+                barrier.dstQueueFamilyIndex = dstFamily;
+                barrier.buffer = buffer;
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+                barriers.push_back(barrier);
+            }
+            return barriers;
+        }
+    } // namespace
+
+    void createContext(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        VkQueue queue,
+        Submit::Batcher &batcher,
+        std::uint32_t frameCount,
+        Context &context
+    )
+    {
+        Queue::FamilyIndices indices = Queue::findQueueFamilies(physicalDevice, surface);
+        if (queue == VK_NULL_HANDLE || !indices.hasAsyncCompute())
+        {
+            throw std::invalid_argument("async compute context needs an async compute queue");
+        }
+
+        context.device = device;
+        context.queue = queue;
+        context.batcher = &batcher;
+        context.family = indices.asyncComputeFamily.value();
+        context.graphicsFamily = indices.graphicsFamily.value();
+
+        context.pools.resize(frameCount);
+        context.commands.resize(frameCount);
+        for (std::uint32_t i = 0; i < frameCount; i++)
+        {
+            context.pools[i] = createPool(device, context.family);
+            context.commands[i] = allocateCommands(device, context.pools[i]);
+        }
+
+        context.graphicsPool = createPool(device, context.graphicsFamily);
+        Synchronization::createTimeline(device, context.timeline);
+    }
+
+    void destroyContext(Context &context)
+    {
+        if (context.device == VK_NULL_HANDLE)
+        {
+            return;
+        }
+
+        /// Frames are already drained and flushed; the compute timeline tells when its last
+        /// work finished
+        if (context.timeline.semaphore != VK_NULL_HANDLE)
+        {
+            VkSemaphoreWaitInfo waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &context.timeline.semaphore;
+            waitInfo.pValues = &context.timeline.lastSubmitted;
+            vkWaitSemaphores(context.device, &waitInfo, UINT64_MAX);
+            Synchronization::destroyTimeline(context.device, context.timeline);
+        }
+
+        for (VkCommandPool pool : context.pools)
+        {
+            vkDestroyCommandPool(context.device, pool, nullptr);
+        }
+        if (context.graphicsPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(context.device, context.graphicsPool, nullptr);
+        }
+
+        context = Context{};
+    }
+
+    void handOverBuffers(
+        Context &context,
+        VkQueue graphicsQueue,
+        Synchronization::Timeline &graphicsTimeline,
+        std::span<const VkBuffer> buffers
+    )
+    {
+        if (context.handOver != VK_NULL_HANDLE)
+        {
+            throw std::runtime_error("failed to hand over buffers: already handed over!");
+        }
+
+        /// Uploads may have written the buffers on this queue; cover any earlier command
+        context.handOver = allocateCommands(context.device, context.graphicsPool);
+        beginOneTime(context.handOver);
+        releaseBuffers(
+            context.handOver,
+            buffers,
+            context.graphicsFamily,
+            context.family,
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            VK_ACCESS_MEMORY_WRITE_BIT
+        );
+        VK_CHECK(vkEndCommandBuffer(context.handOver), "end compute hand-over");
+
+        context.pendingWait = ++graphicsTimeline.lastSubmitted;
+
+        Submit::Work work;
+        work.queue = graphicsQueue;
+        work.commandBuffers = {context.handOver};
+        work.signals = {Submit::semaphore(graphicsTimeline.semaphore, context.pendingWait)};
+        Submit::enqueue(*context.batcher, std::move(work));
+
+        context.pendingAcquire = ownershipBarriers(
+            buffers, context.graphicsFamily, context.family, 0, VK_ACCESS_SHADER_READ_BIT
+        );
+    }
+
+    VkCommandBuffer begin(Context &context, std::uint32_t frameIndex)
+    {
+        VK_CHECK(
+            vkResetCommandPool(context.device, context.pools[frameIndex], 0),
+            "reset compute pool"
+        );
+
+        VkCommandBuffer commandBuffer = context.commands[frameIndex];
+        beginOneTime(commandBuffer);
+
+        if (!context.pendingAcquire.empty())
+        {
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                0,
+                0,
+                nullptr,
+                static_cast<std::uint32_t>(context.pendingAcquire.size()),
+                context.pendingAcquire.data(),
+                0,
+                nullptr
+            );
+        }
+        return commandBuffer;
+    }
+
+    std::uint64_t submit(
+        Context &context,
+        std::uint32_t frameIndex,
+        VkSemaphore graphicsTimeline,
+        std::uint64_t graphicsValue
+    )
+    {
+        VkCommandBuffer commandBuffer = context.commands[frameIndex];
+        VK_CHECK(vkEndCommandBuffer(commandBuffer), "end compute commands");
+
+        /// The first submission after a hand-over also waits for its release
+        const std::uint64_t waitValue = std::max(graphicsValue, context.pendingWait);
+        const std::uint64_t signalValue = ++context.timeline.lastSubmitted;
+        const VkPipelineStageFlags2 waitStage = context.pendingAcquire.empty()
+                                                    ? VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+                                                    : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        Submit::Work work;
+        work.queue = context.queue;
+        work.commandBuffers = {commandBuffer};
+        if (waitValue != 0)
+        {
+            work.waits = {Submit::semaphore(graphicsTimeline, waitValue, waitStage)};
+        }
+        work.signals = {Submit::semaphore(context.timeline.semaphore, signalValue)};
+        Submit::enqueue(*context.batcher, std::move(work));
+
+        context.pendingAcquire.clear();
+        context.pendingWait = 0;
+        return signalValue;
+    }
+
+    void releaseBuffers(
+        VkCommandBuffer commandBuffer,
+        std::span<const VkBuffer> buffers,
+        std::uint32_t srcFamily,
+        std::uint32_t dstFamily,
+        VkPipelineStageFlags srcStages,
+        VkAccessFlags srcAccess
+    )
+    {
+        /// Release half: the destination access is ignored, the acquire supplies it
+        std::vector<VkBufferMemoryBarrier> barriers =
+            ownershipBarriers(buffers, srcFamily, dstFamily, srcAccess, 0);
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            srcStages,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            nullptr,
+            static_cast<std::uint32_t>(barriers.size()),
+            barriers.data(),
+            0,
+            nullptr
+        );
+    }
+
+    void acquireBuffers(
+        VkCommandBuffer commandBuffer,
+        std::span<const VkBuffer> buffers,
+        std::uint32_t srcFamily,
+        std::uint32_t dstFamily,
+        VkPipelineStageFlags dstStages,
+        VkAccessFlags dstAccess
+    )
+    {
+        /// Acquire half: the source access is ignored, the semaphore wait made it available
+        std::vector<VkBufferMemoryBarrier> barriers =
+            ownershipBarriers(buffers, srcFamily, dstFamily, 0, dstAccess);
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            dstStages,
+            0,
+            0,
+            nullptr,
+            static_cast<std::uint32_t>(barriers.size()),
+            barriers.data(),
+            0,
+            nullptr
+        );
+    }
+} // namespace AsyncCompute
@@ -0,0 +1,139 @@
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+
+namespace Benchmark
+{
+    namespace
+    {
+        /// Nearest-rank percentile of sorted samples: the smallest value covering p of them
+        double percentile(const std::vector<double> &sorted, double p)
+        {
+            const auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+        }
+
+        std::string formatSummary(const Summary &summary)
+        {
+            return std::format(
+                "{{\"samples\":{},\"min\":{:.4f},\"median\":{:.4f},\"p99\":{:.4f},"
+                "\"max\":{:.4f},\"mean\":{:.4f}}}",
+                summary.samples,
+                summary.min,
+                summary.median,
+                summary.p99,
+                summary.max,
+                summary.mean
+            );
+        }
+
+        std::string formatMemory(const std::vector<MemoryPeak> &peaks)
+        {
+            std::string json = "{";
+            for (const MemoryPeak &peak : peaks)
+            {
+                json += std::format(
+                    "{}\"{}\":{}", json.size() > 1 ? "," : "", peak.category, peak.bytes
+                );
+            }
+            return json + "}";
+        }
+
+        /// Device names come from the driver; keep the JSON valid whatever they hold
+        std::string escape(std::string_view text)
+        {
+            std::string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+    } // namespace
+
+    Summary summarize(std::vector<double> &samples)
+    {
+        Summary summary;
+        if (samples.empty())
+        {
+            return summary;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        summary.samples = static_cast<std::uint32_t>(samples.size());
+        summary.min = samples.front();
+        summary.median = percentile(samples, 0.5);
+        summary.p99 = percentile(samples, 0.99);
+        summary.max = samples.back();
+        summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        return summary;
+    }
+
+    void writeReport(const Report &report, const std::string &path)
+    {
+        const std::string json = std::format(
+            "{{\n  \"device\":\"{}\",\n  \"deviceUuid\":\"{}\",\n  \"driverVersion\":{},\n"
+            "  \"width\":{},\n  \"height\":{},\n  \"frames\":{},\n  \"warmupFrames\":{},\n"
+            "  \"instances\":{},\n"
+            "  \"draws\":{},\n  \"textures\":{},\n  \"drawPath\":\"{}\",\n"
+            "  \"blendedDraws\":{},\n  \"depthPrepass\":{},\n  \"renderPath\":\"{}\",\n"
+            "  \"asyncCompute\":{},\n  \"submitsPerFrame\":{:.2f},\n  \"submitMs\":{:.3f},\n"
+            "  \"renderScale\":{:.3f},\n  \"sprites\":{},\n  \"spriteDraws\":{},\n"
+            "  \"startupMs\":{:.1f},\n  \"memoryPeakBytes\":{},\n"
+            "  \"cpuFrameMs\":{},\n  \"gpuFrameMs\":{}\n}}\n",
+            escape(report.deviceName),
+            report.deviceUuid,
+            report.driverVersion,
+            report.width,
+            report.height,
+            report.frames,
+            WARMUP_FRAMES,
+            report.instances,
+            report.draws,
+            report.textures,
+            report.drawPath,
+            report.blendedDraws,
+            report.depthPrepass,
+            report.renderPath,
+            report.asyncCompute,
+            report.submitsPerFrame,
+            report.submitMs,
+            report.renderScale,
+            report.sprites,
+            report.spriteDraws,
+            report.startupMs,
+            formatMemory(report.memory),
+            formatSummary(report.cpu),
+            formatSummary(report.gpu)
+        );
+
+        if (path.empty())
+        {
+            std::cout << json;
+            std::cout.flush();
+            return;
+        }
+
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+        {
+            throw std::runtime_error("failed to open benchmark report file!");
+        }
+        file << json;
+        if (!file)
+        {
+            throw std::runtime_error("failed to write benchmark report file!");
+        }
+    }
+} // namespace Benchmark
@@ -0,0 +1,276 @@
+#include "Bindless.hpp"
+#include "Buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace Bindless
+{
+    namespace
+    {
+        /// Texture slots the device allows in one update-after-bind set and shader stage
+        std::uint32_t textureLimit(VkPhysicalDevice physicalDevice)
+        {
+            VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+            vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+            VkPhysicalDeviceProperties2 properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &vulkan12Properties;
+            vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+            /// Set 0 holds one more sampler in the fragment stage
+            const std::uint32_t limit = std::min(
+                vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages
+            );
+            return std::min(MAX_TEXTURES, limit > 1 ? limit - 1 : 0);
+        }
+
+        void createLayout(Table &table)
+        {
+            std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+            bindings[0].binding = 0;
+            bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[0].descriptorCount = 1;
+            bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+            bindings[1].binding = 1;
+            bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            bindings[1].descriptorCount = table.textureCapacity;
+            bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+            /// Unwritten slots are never sampled; written ones may change while frames run
+            std::array<VkDescriptorBindingFlags, 2> bindingFlags = {
+                0,
+                VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+                    | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+                    | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+            };
+
+            VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+            flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+            flagsInfo.bindingCount = static_cast<std::uint32_t>(bindingFlags.size());
+            flagsInfo.pBindingFlags = bindingFlags.data();
+
+            VkDescriptorSetLayoutCreateInfo layoutInfo{};
+            layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            layoutInfo.pNext = &flagsInfo;
+            layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+            layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
+            layoutInfo.pBindings = bindings.data();
+
+            if (vkCreateDescriptorSetLayout(table.device, &layoutInfo, nullptr, &table.layout)
+                != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create bindless descriptor set layout!");
+            }
+        }
+
+        void allocateSets(Table &table)
+        {
+            const auto setCount = static_cast<std::uint32_t>(table.sets.size());
+
+            std::array<VkDescriptorPoolSize, 2> poolSizes{};
+            poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            poolSizes[0].descriptorCount = setCount;
+            poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            poolSizes[1].descriptorCount = table.textureCapacity * setCount;
+
+            VkDescriptorPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+            poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+            poolInfo.pPoolSizes = poolSizes.data();
+            poolInfo.maxSets = setCount;
+
+            if (vkCreateDescriptorPool(table.device, &poolInfo, nullptr, &table.pool)
+                != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create bindless descriptor pool!");
+            }
+
+            const std::vector<VkDescriptorSetLayout> layouts(setCount, table.layout);
+
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = table.pool;
+            allocInfo.descriptorSetCount = setCount;
+            allocInfo.pSetLayouts = layouts.data();
+
+            if (vkAllocateDescriptorSets(table.device, &allocInfo, table.sets.data())
+                != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate bindless descriptor sets!");
+            }
+        }
+    } // namespace
+
+    void createTable(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        std::uint32_t frameCount,
+        Table &table
+    )
+    {
+        table.device = device;
+        table.allocator = &allocator;
+        table.textureCapacity = textureLimit(physicalDevice);
+        if (table.textureCapacity == 0)
+        {
+            throw std::runtime_error("failed to find update-after-bind texture slots!");
+        }
+
+        createLayout(table);
+        table.sets.resize(frameCount);
+        allocateSets(table);
+
+        /// Regions start on a storage buffer offset the device accepts
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        const VkDeviceSize alignment = properties.limits.minStorageBufferOffsetAlignment;
+        table.regionSize =
+            (sizeof(Material) * MAX_MATERIALS + alignment - 1) / alignment * alignment;
+        table.materials.resize(MAX_MATERIALS);
+        table.staleMaterials.resize(frameCount);
+
+        /// Small and rewritten from the CPU, so it stays host-visible rather than staged
+        Buffer::createBuffer(
+            device,
+            allocator,
+            table.regionSize * frameCount,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            table.materialBuffer,
+            table.materialMemory,
+            Memory::Category::Uniform
+        );
+
+        for (std::uint32_t i = 0; i < frameCount; i++)
+        {
+            VkDescriptorBufferInfo bufferInfo{};
+            bufferInfo.buffer = table.materialBuffer;
+            bufferInfo.offset = table.regionSize * i;
+            bufferInfo.range = sizeof(Material) * MAX_MATERIALS;
+
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = table.sets[i];
+            write.dstBinding = 0;
+            write.dstArrayElement = 0;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.descriptorCount = 1;
+            write.pBufferInfo = &bufferInfo;
+            vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+        }
+    }
+
+    void destroyTable(Table &table)
+    {
+        Buffer::destroyBuffer(
+            table.device, *table.allocator, table.materialBuffer, table.materialMemory
+        );
+
+        /// Destroying the pool frees the sets
+        vkDestroyDescriptorPool(table.device, table.pool, nullptr);
+        vkDestroyDescriptorSetLayout(table.device, table.layout, nullptr);
+
+        table.pool = VK_NULL_HANDLE;
+        table.sets.clear();
+        table.layout = VK_NULL_HANDLE;
+        table.freeTextures.clear();
+        table.textureCount = 0;
+        table.materials.clear();
+        table.staleMaterials.clear();
+        table.materialCount = 0;
+    }
+
+    VkDescriptorSet beginFrame(Table &table, std::uint32_t frameIndex)
+    {
+        /// The slot's last frame has retired, so nothing reads its region any more
+        auto *region = reinterpret_cast<Material *>(
+            static_cast<std::byte *>(table.materialMemory.mapped)
+            + table.regionSize * frameIndex
+        );
+        for (std::uint32_t index : table.staleMaterials[frameIndex])
+        {
+            std::memcpy(&region[index], &table.materials[index], sizeof(Material));
+        }
+        table.staleMaterials[frameIndex].clear();
+
+        return table.sets[frameIndex];
+    }
+
+    std::uint32_t addTexture(Table &table, VkImageView view, VkSampler sampler)
+    {
+        std::uint32_t index;
+        if (!table.freeTextures.empty())
+        {
+            index = table.freeTextures.back();
+            table.freeTextures.pop_back();
+        }
+        else if (table.textureCount < table.textureCapacity)
+        {
+            index = table.textureCount++;
+        }
+        else
+        {
+            throw std::runtime_error("failed to find a free bindless texture slot!");
+        }
+
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = view;
+        imageInfo.sampler = sampler;
+
+        /// Slot is unused by every frame in flight, so all sets take it at once
+        std::vector<VkWriteDescriptorSet> writes(table.sets.size());
+        for (std::size_t i = 0; i < writes.size(); i++)
+        {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = table.sets[i];
+            writes[i].dstBinding = 1;
+            writes[i].dstArrayElement = index;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writes[i].descriptorCount = 1;
+            writes[i].pImageInfo = &imageInfo;
+        }
+        vkUpdateDescriptorSets(
+            table.device, static_cast<std::uint32_t>(writes.size()), writes.data(), 0, nullptr
+        );
+
+        return index;
+    }
+
+    void removeTexture(Table &table, std::uint32_t index)
+    {
+        /// The stale descriptor stays behind; partially bound slots may hold one if unused
+        table.freeTextures.push_back(index);
+    }
+
+    std::uint32_t addMaterial(Table &table, const Material &material)
+    {
+        if (table.materialCount == MAX_MATERIALS)
+        {
+            throw std::runtime_error("failed to add material, bindless table is full!");
+        }
+
+        const std::uint32_t index = table.materialCount++;
+        setMaterial(table, index, material);
+        return index;
+    }
+
+    void setMaterial(Table &table, std::uint32_t index, const Material &material)
+    {
+        /// Each region takes the record when its slot next begins a frame
+        table.materials[index] = material;
+        for (std::vector<std::uint32_t> &stale : table.staleMaterials)
+        {
+            stale.push_back(index);
+        }
+    }
+} // namespace Bindless
@@ -1,10 +1,9 @@
 #include "Buffer.hpp"
-#include "Command.hpp"
-#include "TriangleApp.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <stdexcept>
 #include <vulkan/vulkan_core.h>
 
@@ -12,100 +11,175 @@ namespace Buffer
 {
     void createVertexBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const void *vertexData,
+        VkDeviceSize size,
         VkBuffer &vertexBuffer,
-        VkDeviceMemory &vertexBufferMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocation &vertexAllocation,
+        Upload::Context &uploads
     )
     {
-        VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-
-        createBuffer(
-            device,
-            physicalDevice,
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
-        );
-
-        void *data;
-        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, vertices.data(), (size_t)bufferSize);
-        vkUnmapMemory(device, stagingBufferMemory);
-
         createBuffer(
             device,
-            physicalDevice,
-            bufferSize,
+            allocator,
+            size,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             vertexBuffer,
-            vertexBufferMemory
+            vertexAllocation,
+            Memory::Category::Geometry
         );
 
-        copyBuffer(device, stagingBuffer, vertexBuffer, bufferSize, commandPool, graphicsQueue);
-
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        vkFreeMemory(device, stagingBufferMemory, nullptr);
+        Upload::uploadBuffer(
+            uploads,
+            vertexData,
+            size,
+            vertexBuffer,
+            0,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+        );
     }
 
     void createIndexBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const void *indexData,
+        VkDeviceSize size,
         VkBuffer &indexBuffer,
-        VkDeviceMemory &indexBufferMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocation &indexAllocation,
+        Upload::Context &uploads
     )
     {
-        VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
-
         createBuffer(
             device,
-            physicalDevice,
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
+            allocator,
+            size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            indexBuffer,
+            indexAllocation,
+            Memory::Category::Geometry
+        );
+
+        Upload::uploadBuffer(
+            uploads,
+            indexData,
+            size,
+            indexBuffer,
+            0,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            VK_ACCESS_INDEX_READ_BIT
         );
+    }
+
+    std::vector<Instance> createInstanceGrid(std::uint32_t count)
+    {
+        std::vector<Instance> instances(count);
+        if (count == 0)
+        {
+            return instances;
+        }
 
-        void *data;
-        vkMapMemory(device, stagingBufferMemory, 0, bufferSize, 0, &data);
-        memcpy(data, indices.data(), (size_t)bufferSize);
-        vkUnmapMemory(device, stagingBufferMemory);
+        const auto side = static_cast<std::uint32_t>(std::ceil(std::sqrt(float(count))));
+        const float cell = 2.0f / static_cast<float>(side);
+        const float scale = std::min(1.0f, cell * 0.8f); ///< Leave a gap between neighbours
 
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            const float x = -1.0f + cell * (static_cast<float>(i % side) + 0.5f);
+            const float y = -1.0f + cell * (static_cast<float>(i / side) + 0.5f);
+            instances[i].offsetScale = {x, y, 0.0f, scale};
+        }
+
+        return instances;
+    }
+
+    void createDeviceBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *data,
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess,
+        VkBuffer &buffer,
+        Memory::Allocation &allocation,
+        Upload::Context &uploads,
+        Memory::Category category
+    )
+    {
         createBuffer(
             device,
-            physicalDevice,
-            bufferSize,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            allocator,
+            size,
+            usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            indexBuffer,
-            indexBufferMemory
+            buffer,
+            allocation,
+            category
         );
 
-        copyBuffer(device, stagingBuffer, indexBuffer, bufferSize, commandPool, graphicsQueue);
+        Upload::uploadBuffer(uploads, data, size, buffer, 0, dstStage, dstAccess);
+    }
 
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        vkFreeMemory(device, stagingBufferMemory, nullptr);
+    void createInstanceBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const std::vector<Instance> &instances,
+        VkBuffer &instanceBuffer,
+        Memory::Allocation &instanceAllocation,
+        Upload::Context &uploads
+    )
+    {
+        createDeviceBuffer(
+            device,
+            allocator,
+            instances.data(),
+            sizeof(instances[0]) * instances.size(),
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+            instanceBuffer,
+            instanceAllocation,
+            uploads,
+            Memory::Category::Geometry
+        );
+    }
+
+    void createIndirectBuffer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const std::vector<VkDrawIndexedIndirectCommand> &commands,
+        VkBuffer &indirectBuffer,
+        Memory::Allocation &indirectAllocation,
+        Upload::Context &uploads
+    )
+    {
+        createDeviceBuffer(
+            device,
+            allocator,
+            commands.data(),
+            sizeof(commands[0]) * commands.size(),
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            indirectBuffer,
+            indirectAllocation,
+            uploads,
+            Memory::Category::Geometry
+        );
     }
 
     void createBuffer(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
         VkDeviceSize size,
         VkBufferUsageFlags usage,
         VkMemoryPropertyFlags properties,
-        VkBuffer &vertexBuffer,
-        VkDeviceMemory &vertexBufferMemory
+        VkBuffer &buffer,
+        Memory::Allocation &allocation,
+        Memory::Category category
     )
     {
         VkBufferCreateInfo bufferInfo{};
@@ -114,56 +188,65 @@ namespace Buffer
         bufferInfo.usage = usage;
         bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-        if (vkCreateBuffer(device, &bufferInfo, nullptr, &vertexBuffer) != VK_SUCCESS)
+        if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
         {
-            throw std::runtime_error("failed to create vertex buffer!");
+            throw std::runtime_error("failed to create buffer!");
         }
 
         VkMemoryRequirements memRequirements;
-        vkGetBufferMemoryRequirements(device, vertexBuffer, &memRequirements);
+        vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex =
-            findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
-
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &vertexBufferMemory) != VK_SUCCESS)
+        try
+        {
+            Memory::allocateMemory(
+                allocator,
+                memRequirements,
+                properties,
+                Memory::ResourceKind::Linear,
+                allocation,
+                category
+            );
+        }
+        catch (...)
         {
-            throw std::runtime_error("failed to allocate vertex buffer memory!");
+            vkDestroyBuffer(device, buffer, nullptr);
+            buffer = VK_NULL_HANDLE;
+            throw;
         }
 
-        vkBindBufferMemory(device, vertexBuffer, vertexBufferMemory, 0);
+        vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
     }
 
-    void copyBuffer(
+    void destroyBuffer(
         VkDevice &device,
-        VkBuffer srcBuffer,
-        VkBuffer dstBuffer,
-        VkDeviceSize size,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+        Memory::Allocator &allocator,
+        VkBuffer &buffer,
+        Memory::Allocation &allocation
     )
     {
-        VkCommandBuffer commandBuffer = Command::beginSingleTimeCommands(device, commandPool);
+        vkDestroyBuffer(device, buffer, nullptr);
+        Memory::freeAllocation(allocator, allocation);
+        buffer = VK_NULL_HANDLE;
+    }
 
+    void copyBuffer(
+        VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size
+    )
+    {
         VkBufferCopy copyRegion{};
         copyRegion.srcOffset = 0;
         copyRegion.dstOffset = 0;
         copyRegion.size = size;
 
         vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-        Command::endSingleTimeCommands(device, commandPool, commandBuffer, graphicsQueue);
     }
 
     std::uint32_t findMemoryType(
-        VkPhysicalDevice &physicalDevice, std::uint32_t typeFilter, VkMemoryPropertyFlags properties
+        const VkPhysicalDeviceMemoryProperties &memProperties,
+        std::uint32_t typeFilter,
+        VkMemoryPropertyFlags properties
     )
     {
-        VkPhysicalDeviceMemoryProperties memProperties;
-        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-
         for (std::uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
         {
             if ((typeFilter & (1 << i))
@@ -176,11 +259,13 @@ namespace Buffer
         throw std::runtime_error("failed to find suitable memory type!");
     }
 
-    void createDescriptorSetLayout(VkDevice &device, VkDescriptorSetLayout &descriptorLayout)
+    void createDescriptorSetLayout(
+        Descriptors::LayoutCache &layouts, VkDescriptorSetLayout &descriptorLayout
+    )
     {
         VkDescriptorSetLayoutBinding uboLayoutBinding{};
         uboLayoutBinding.binding = 0;
-        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uboLayoutBinding.descriptorCount = 1;
         uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
         uboLayoutBinding.pImmutableSamplers = nullptr;
@@ -195,131 +280,52 @@ namespace Buffer
         std::array<VkDescriptorSetLayoutBinding, 2> bindings =
             {uboLayoutBinding, samplerLayoutBinding};
 
-        VkDescriptorSetLayoutCreateInfo layoutInfo{};
-        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-        layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
-        layoutInfo.pBindings = bindings.data();
-
-        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorLayout)
-            != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create descriptor set layout!");
-        }
-    }
-
-    void createUniformBuffers(
-        VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
-        std::vector<VkBuffer> &uniformBuffers,
-        std::vector<VkDeviceMemory> &uniformBuffersMemory,
-        std::vector<void *> &uniformBuffersMapped
-    )
-    {
-        VkDeviceSize bufferSize = sizeof(Vertex::UniformBufferObject);
-
-        uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-        uniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-        uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
-
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-        {
-            createBuffer(
-                device,
-                physicalDevice,
-                bufferSize,
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                uniformBuffers[i],
-                uniformBuffersMemory[i]
-            );
-
-            vkMapMemory(device, uniformBuffersMemory[i], 0, bufferSize, 0, &uniformBuffersMapped[i]);
-        }
-    }
-
-    void createDescriptorPool(VkDevice &device, VkDescriptorPool &descriptorPool)
-    {
-        std::array<VkDescriptorPoolSize, 2> poolSizes{};
-        poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-        poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-
-        VkDescriptorPoolCreateInfo poolInfo{};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
-        poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.maxSets = static_cast<std::uint32_t>(MAX_FRAMES_IN_FLIGHT);
-
-        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create descriptor pool!");
-        }
+        descriptorLayout = Descriptors::getLayout(layouts, bindings);
     }
 
-    void createDescriptorSets(
+    void writeDescriptorSet(
         VkDevice &device,
-        VkDescriptorPool &descriptorPool,
-        std::vector<VkDescriptorSet> &descriptorSets,
-        VkDescriptorSetLayout &descriptorSetLayout,
-        std::vector<VkBuffer> &uniformBuffers,
+        VkDescriptorSet descriptorSet,
+        VkBuffer uniformBuffer,
         VkImageView &textureImageView,
         VkSampler &textureSampler
     )
     {
-        std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
-
-        VkDescriptorSetAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = descriptorPool;
-        allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-        allocInfo.pSetLayouts = layouts.data();
-
-        descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
-
-        if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to allocate descriptor sets!");
-        }
-
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-        {
-            VkDescriptorBufferInfo bufferInfo{};
-            bufferInfo.buffer = uniformBuffers[i];
-            bufferInfo.offset = 0;
-            bufferInfo.range = sizeof(Vertex::UniformBufferObject);
-
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = textureImageView;
-            imageInfo.sampler = textureSampler;
-
-            std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-
-            descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[0].dstSet = descriptorSets[i];
-            descriptorWrites[0].dstBinding = 0;
-            descriptorWrites[0].dstArrayElement = 0;
-            descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptorWrites[0].descriptorCount = 1;
-            descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-            descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptorWrites[1].dstSet = descriptorSets[i];
-            descriptorWrites[1].dstBinding = 1;
-            descriptorWrites[1].dstArrayElement = 0;
-            descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            descriptorWrites[1].descriptorCount = 1;
-            descriptorWrites[1].pImageInfo = &imageInfo;
-
-            vkUpdateDescriptorSets(
-                device,
-                static_cast<std::uint32_t>(descriptorWrites.size()),
-                descriptorWrites.data(),
-                0,
-                nullptr
-            );
-        }
+        VkDescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = uniformBuffer;
+        bufferInfo.offset = 0;
+        bufferInfo.range = sizeof(Vertex::UniformBufferObject);
+
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfo.imageView = textureImageView;
+        imageInfo.sampler = textureSampler;
+
+        std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+
+        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[0].dstSet = descriptorSet;
+        descriptorWrites[0].dstBinding = 0;
+        descriptorWrites[0].dstArrayElement = 0;
+        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrites[0].descriptorCount = 1;
+        descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[1].dstSet = descriptorSet;
+        descriptorWrites[1].dstBinding = 1;
+        descriptorWrites[1].dstArrayElement = 0;
+        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWrites[1].descriptorCount = 1;
+        descriptorWrites[1].pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(
+            device,
+            static_cast<std::uint32_t>(descriptorWrites.size()),
+            descriptorWrites.data(),
+            0,
+            nullptr
+        );
     }
 
 } // namespace Buffer
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "Command.hpp"
-#include "Buffer.hpp"
+#include "GraphicsPipeline.hpp"
 #include "Queue.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <stdexcept>
 #include <vulkan/vulkan_core.h>
 
@@ -8,14 +11,15 @@ void Command::createCommandPool(
     VkDevice &device,
     VkPhysicalDevice &physicalDevice,
     VkSurfaceKHR &surface,
-    VkCommandPool &commandPool
+    VkCommandPool &commandPool,
+    VkCommandPoolCreateFlags flags
 )
 {
     Queue::FamilyIndices queueFamilyIndices = Queue::findQueueFamilies(physicalDevice, surface);
 
     VkCommandPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.flags = flags;
     poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
 
     if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
@@ -45,17 +49,435 @@ void Command::createCommandBuffers(
     }
 }
 
+namespace
+{
+    /// Bind the descriptors and set the dynamic viewport and scissor (pipelines are bound per
+    /// draw; every one shares the layout)
+    void bindFrameState(
+        VkCommandBuffer commandBuffer,
+        const VkExtent2D &extent,
+        VkPipelineLayout pipelineLayout,
+        std::span<const VkDescriptorSet> descriptorSets,
+        std::span<const std::uint32_t> dynamicOffsets
+    )
+    {
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = static_cast<float>(extent.width);
+        viewport.height = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = extent;
+
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            0,
+            static_cast<std::uint32_t>(descriptorSets.size()),
+            descriptorSets.data(),
+            static_cast<std::uint32_t>(dynamicOffsets.size()),
+            dynamicOffsets.data()
+        );
+    }
+
+    /**
+     * @struct BoundGeometry
+     * @brief Buffers and draw constants currently bound, so consecutive draws sharing them skip
+     *        the rebind
+     */
+    struct BoundGeometry
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        bool pushed = false;                       ///< constants holds what was pushed
+        GraphicsPipeline::DrawConstants constants; ///< Last pushed draw constants
+    };
+
+    /// Push the draw's transform and material unless the previous draw used the same ones
+    void pushDrawConstants(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        BoundGeometry &bound,
+        const glm::mat4 &model,
+        std::uint32_t materialIndex
+    )
+    {
+        if (bound.pushed && materialIndex == bound.constants.materialIndex
+            && model == bound.constants.model)
+        {
+            return;
+        }
+
+        bound.constants.model = model;
+        bound.constants.materialIndex = materialIndex;
+        bound.pushed = true;
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(bound.constants),
+            &bound.constants
+        );
+    }
+
+    void bindPipeline(VkCommandBuffer commandBuffer, BoundGeometry &bound, VkPipeline pipeline)
+    {
+        if (pipeline != bound.pipeline)
+        {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            bound.pipeline = pipeline;
+        }
+    }
+
+    void bindGeometry(
+        VkCommandBuffer commandBuffer,
+        BoundGeometry &bound,
+        VkBuffer vertexBuffer,
+        VkBuffer instanceBuffer,
+        VkBuffer indexBuffer,
+        VkIndexType indexType
+    )
+    {
+        if (vertexBuffer != bound.vertexBuffer || instanceBuffer != bound.instanceBuffer)
+        {
+            VkBuffer vertexBuffers[] = {vertexBuffer, instanceBuffer};
+            VkDeviceSize offsets[] = {0, 0};
+            vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+            bound.vertexBuffer = vertexBuffer;
+            bound.instanceBuffer = instanceBuffer;
+        }
+        if (indexBuffer != bound.indexBuffer)
+        {
+            vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+            bound.indexBuffer = indexBuffer;
+        }
+    }
+
+    /// Draw a slice of the draw list (frame state already bound); depth-only slices hold opaque
+    /// draws only
+    void recordDraws(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        BoundGeometry &bound,
+        const Command::DrawPipelines &pipelines,
+        const Command::DrawItem *drawItems,
+        std::size_t drawCount,
+        bool depthOnly
+    )
+    {
+        for (std::size_t i = 0; i < drawCount; i++)
+        {
+            const Command::DrawItem &draw = drawItems[i];
+
+            bindPipeline(
+                commandBuffer,
+                bound,
+                depthOnly      ? pipelines.depthPrepass
+                : draw.blended ? pipelines.blended
+                               : pipelines.opaque
+            );
+            bindGeometry(
+                commandBuffer,
+                bound,
+                draw.vertexBuffer,
+                draw.instanceBuffer,
+                draw.indexBuffer,
+                draw.indexType
+            );
+            pushDrawConstants(
+                commandBuffer, pipelineLayout, bound, draw.model, draw.materialIndex
+            );
+
+            vkCmdDrawIndexed(
+                commandBuffer,
+                draw.indexCount,
+                draw.instanceCount,
+                draw.firstIndex,
+                draw.vertexOffset,
+                draw.firstInstance
+            );
+        }
+    }
+
+    /// Issue the GPU-sourced draws (frame state already bound)
+    void recordIndirectDraws(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        BoundGeometry &bound,
+        const Command::DrawPipelines &pipelines,
+        const std::vector<Command::IndirectDraw> &indirectDraws,
+        bool depthOnly
+    )
+    {
+        bindPipeline(commandBuffer, bound, depthOnly ? pipelines.depthPrepass : pipelines.opaque);
+        for (const auto &draw : indirectDraws)
+        {
+            bindGeometry(
+                commandBuffer,
+                bound,
+                draw.vertexBuffer,
+                draw.instanceBuffer,
+                draw.indexBuffer,
+                draw.indexType
+            );
+            pushDrawConstants(
+                commandBuffer, pipelineLayout, bound, draw.model, draw.materialIndex
+            );
+
+            if (draw.countBuffer != VK_NULL_HANDLE)
+            {
+                vkCmdDrawIndexedIndirectCount(
+                    commandBuffer,
+                    draw.argumentBuffer,
+                    draw.argumentOffset,
+                    draw.countBuffer,
+                    draw.countOffset,
+                    draw.drawCount,
+                    draw.stride
+                );
+            }
+            else if (draw.multiDraw)
+            {
+                vkCmdDrawIndexedIndirect(
+                    commandBuffer,
+                    draw.argumentBuffer,
+                    draw.argumentOffset,
+                    draw.drawCount,
+                    draw.stride
+                );
+            }
+            else
+            {
+                /// Without multiDrawIndirect a call draws one record at most
+                for (std::uint32_t record = 0; record < draw.drawCount; record++)
+                {
+                    vkCmdDrawIndexedIndirect(
+                        commandBuffer,
+                        draw.argumentBuffer,
+                        draw.argumentOffset + VkDeviceSize{record} * draw.stride,
+                        1,
+                        draw.stride
+                    );
+                }
+            }
+        }
+    }
+
+    /**
+     * @struct Segment
+     * @brief A run of the render pass recorded into one command buffer: a slice of the draw
+     *        list or the GPU-sourced draws, for the pre-pass or the color pass
+     */
+    struct Segment
+    {
+        std::size_t first = 0;  ///< First draw item
+        std::size_t count = 0;  ///< Draw items (indirect segments have none)
+        bool indirect = false;  ///< Records the GPU-sourced draws instead
+        bool depthOnly = false; ///< Pre-pass segment
+    };
+
+    /// Split [first, first + count) into segments of at most sliceSize draws
+    void addSlices(
+        std::vector<Segment> &segments,
+        std::size_t first,
+        std::size_t count,
+        std::size_t sliceSize,
+        bool depthOnly
+    )
+    {
+        for (std::size_t offset = 0; offset < count; offset += sliceSize)
+        {
+            const std::size_t sliceCount = std::min(sliceSize, count - offset);
+            segments.push_back({first + offset, sliceCount, false, depthOnly});
+        }
+    }
+
+    /// Pre-pass (opaque and GPU-sourced draws, depth only), then opaque, GPU-sourced and
+    /// blended draws, in submission order
+    std::vector<Segment> planSegments(
+        const std::vector<Command::DrawItem> &drawItems,
+        bool indirectDraws,
+        bool depthPrepass,
+        std::size_t sliceSize
+    )
+    {
+        const auto opaqueEnd = std::partition_point(
+            drawItems.begin(),
+            drawItems.end(),
+            [](const Command::DrawItem &draw) { return !draw.blended; }
+        );
+        const auto opaqueCount = static_cast<std::size_t>(opaqueEnd - drawItems.begin());
+
+        std::vector<Segment> segments;
+        if (depthPrepass)
+        {
+            addSlices(segments, 0, opaqueCount, sliceSize, true);
+            if (indirectDraws)
+            {
+                segments.push_back({0, 0, true, true});
+            }
+        }
+        addSlices(segments, 0, opaqueCount, sliceSize, false);
+        if (indirectDraws)
+        {
+            segments.push_back({0, 0, true, false});
+        }
+        addSlices(segments, opaqueCount, drawItems.size() - opaqueCount, sliceSize, false);
+        return segments;
+    }
+
+    void recordSegment(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        BoundGeometry &bound,
+        const Command::DrawPipelines &pipelines,
+        const std::vector<Command::DrawItem> &drawItems,
+        const std::vector<Command::IndirectDraw> &indirectDraws,
+        const Segment &segment
+    )
+    {
+        if (segment.indirect)
+        {
+            recordIndirectDraws(
+                commandBuffer, pipelineLayout, bound, pipelines, indirectDraws, segment.depthOnly
+            );
+        }
+        else
+        {
+            recordDraws(
+                commandBuffer,
+                pipelineLayout,
+                bound,
+                pipelines,
+                drawItems.data() + segment.first,
+                segment.count,
+                segment.depthOnly
+            );
+        }
+    }
+
+    /// Hand out the next secondary buffer of a worker pool, allocating more on demand
+    VkCommandBuffer acquireSecondary(VkDevice device, Command::WorkerCommands &worker)
+    {
+        if (worker.used == worker.secondaries.size())
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.commandPool = worker.pool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate secondary command buffer!");
+            }
+            worker.secondaries.push_back(commandBuffer);
+        }
+
+        return worker.secondaries[worker.used++];
+    }
+
+    /// Begin a secondary that continues the render pass described by the inheritance info
+    void beginSecondary(
+        VkCommandBuffer secondary, const VkCommandBufferInheritanceInfo &inheritance
+    )
+    {
+        VkCommandBufferBeginInfo secondaryBegin{};
+        secondaryBegin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        secondaryBegin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+                               | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        secondaryBegin.pInheritanceInfo = &inheritance;
+
+        if (vkBeginCommandBuffer(secondary, &secondaryBegin) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin secondary command buffer!");
+        }
+    }
+} // namespace
+
+void Command::createParallelRecorder(
+    VkDevice &device,
+    VkPhysicalDevice &physicalDevice,
+    VkSurfaceKHR &surface,
+    std::uint32_t frameCount,
+    std::uint32_t threadCount,
+    ParallelRecorder &recorder
+)
+{
+    Queue::FamilyIndices queueFamilyIndices = Queue::findQueueFamilies(physicalDevice, surface);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+    recorder.device = device;
+    recorder.frames.resize(frameCount);
+    for (auto &workers : recorder.frames)
+    {
+        workers.resize(threadCount);
+        for (auto &worker : workers)
+        {
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &worker.pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create worker command pool!");
+            }
+        }
+    }
+}
+
+void Command::destroyParallelRecorder(ParallelRecorder &recorder)
+{
+    /// Destroying a pool frees its secondary buffers
+    for (auto &workers : recorder.frames)
+    {
+        for (auto &worker : workers)
+        {
+            vkDestroyCommandPool(recorder.device, worker.pool, nullptr);
+        }
+    }
+    recorder.frames.clear();
+    recorder.recorded.clear();
+}
+
+void Command::sortDraws(std::vector<DrawItem> &drawItems, const glm::mat4 &view)
+{
+    /// View space looks down -z, so the distance in front of the camera is -z; computed once
+    /// per draw rather than per comparison
+    for (DrawItem &draw : drawItems)
+    {
+        draw.distance = -(view * (draw.model * glm::vec4(draw.center, 1.0f))).z;
+    }
+
+    std::sort(
+        drawItems.begin(),
+        drawItems.end(),
+        [](const DrawItem &a, const DrawItem &b)
+        {
+            if (a.blended != b.blended)
+            {
+                return !a.blended;
+            }
+            return a.blended ? a.distance > b.distance : a.distance < b.distance;
+        }
+    );
+}
+
 void Command::recordCommandBuffer(
-    VkCommandBuffer &commandBuffer,
-    VkRenderPass &renderPass,
-    VkFramebuffer &framebuffer,
-    VkExtent2D &extent,
-    VkPipeline &graphicsPipeline,
-    VkPipelineLayout &pipelineLayout,
-    VkBuffer &vertexBuffer,
-    VkBuffer &indexBuffer,
-    std::vector<VkDescriptorSet> &descriptorSets,
-    std::uint32_t currentFrame
+    VkCommandBuffer &commandBuffer, const std::function<void(VkCommandBuffer)> &record
 )
 {
     VkCommandBufferBeginInfo beginInfo{};
@@ -68,62 +490,208 @@ void Command::recordCommandBuffer(
         throw std::runtime_error("failed to begin recording command buffer!");
     }
 
+    record(commandBuffer);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record command buffer!");
+    }
+}
+
+void Command::recordRenderPass(
+    VkCommandBuffer commandBuffer,
+    const RenderTarget &target,
+    const DrawPipelines &pipelines,
+    VkPipelineLayout &pipelineLayout,
+    std::span<const VkDescriptorSet> descriptorSets,
+    std::span<const std::uint32_t> dynamicOffsets,
+    std::uint32_t currentFrame,
+    const std::vector<DrawItem> &drawItems,
+    const std::vector<IndirectDraw> &indirectDraws,
+    Jobs::JobSystem &jobs,
+    ParallelRecorder &recorder,
+    VkQueryPipelineStatisticFlags pipelineStatistics,
+    const std::function<void(VkCommandBuffer)> &overlay
+)
+{
+    const VkExtent2D extent = target.extent;
+    const bool dynamic = target.beginRendering != nullptr;
+
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = renderPass;
-    renderPassInfo.framebuffer = framebuffer;
+    renderPassInfo.renderPass = target.renderPass;
+    renderPassInfo.framebuffer = target.framebuffer;
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = extent;
 
-    VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
+    renderPassInfo.clearValueCount = static_cast<std::uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    /// Same attachments without a render pass object: views are named at begin, so nothing
+    /// needs recreating with the swapchain but the views themselves
+    VkRenderingAttachmentInfo colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    colorAttachment.imageView = target.colorView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = target.colorLoad;
+    colorAttachment.storeOp = target.colorStore;
+    colorAttachment.clearValue = clearValues[0];
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+    VkRenderingAttachmentInfo depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depthAttachment.imageView = target.depthView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = target.depthLoad;
+    depthAttachment.storeOp = target.depthStore;
+    depthAttachment.clearValue = clearValues[1];
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(extent.width);
-    viewport.height = static_cast<float>(extent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.renderArea = renderPassInfo.renderArea;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
 
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    const bool depthPrepass = pipelines.depthPrepass != VK_NULL_HANDLE;
+    if (drawItems.size() < PARALLEL_RECORD_THRESHOLD)
+    {
+        if (dynamic)
+        {
+            target.beginRendering(commandBuffer, &renderingInfo);
+        }
+        else
+        {
+            vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        }
+        bindFrameState(commandBuffer, extent, pipelineLayout, descriptorSets, dynamicOffsets);
+
+        BoundGeometry bound;
+        for (const Segment &segment : planSegments(
+                 drawItems,
+                 !indirectDraws.empty(),
+                 depthPrepass,
+                 std::numeric_limits<std::size_t>::max()
+             ))
+        {
+            recordSegment(
+                commandBuffer, pipelineLayout, bound, pipelines, drawItems, indirectDraws, segment
+            );
+        }
+        if (overlay)
+        {
+            overlay(commandBuffer);
+        }
+    }
+    else
+    {
+        /// The frame's fence has signaled: every secondary of this frame can be recycled
+        std::vector<WorkerCommands> &workers = recorder.frames[currentFrame];
+        for (auto &worker : workers)
+        {
+            vkResetCommandPool(recorder.device, worker.pool, 0);
+            worker.used = 0;
+        }
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = extent;
+        /// A few slices per thread keeps workers busy when draws have uneven cost; indirect
+        /// draws are few and cheap to record and get a secondary of their own per pass
+        const std::size_t threads = workers.size();
+        const std::size_t jobCount = std::min(
+            threads * 4, (drawItems.size() + MIN_DRAWS_PER_JOB - 1) / MIN_DRAWS_PER_JOB
+        );
+        const std::size_t drawsPerJob = (drawItems.size() + jobCount - 1) / jobCount;
+        const std::vector<Segment> segments =
+            planSegments(drawItems, !indirectDraws.empty(), depthPrepass, drawsPerJob);
+        recorder.recorded.assign(segments.size(), VK_NULL_HANDLE);
 
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+        VkCommandBufferInheritanceRenderingInfo renderingInheritance{};
+        renderingInheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+        renderingInheritance.colorAttachmentCount = 1;
+        renderingInheritance.pColorAttachmentFormats = &target.colorFormat;
+        renderingInheritance.depthAttachmentFormat = target.depthFormat;
+        renderingInheritance.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+        /// Dynamic rendering inherits attachment formats instead of a render pass
+        VkCommandBufferInheritanceInfo inheritanceInfo{};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.pNext = dynamic ? &renderingInheritance : nullptr;
+        inheritanceInfo.renderPass = dynamic ? VK_NULL_HANDLE : target.renderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = dynamic ? VK_NULL_HANDLE : target.framebuffer;
+        inheritanceInfo.pipelineStatistics = pipelineStatistics;
 
-    VkBuffer vertexBuffers[] = {vertexBuffer};
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+        Jobs::dispatch(
+            jobs,
+            static_cast<std::uint32_t>(segments.size()),
+            [&](std::uint32_t jobIndex, std::uint32_t workerIndex)
+            {
+                VkCommandBuffer secondary = acquireSecondary(recorder.device, workers[workerIndex]);
+                beginSecondary(secondary, inheritanceInfo);
+                bindFrameState(secondary, extent, pipelineLayout, descriptorSets, dynamicOffsets);
 
-    vkCmdBindDescriptorSets(
-        commandBuffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        pipelineLayout,
-        0,
-        1,
-        &descriptorSets[currentFrame],
-        0,
-        nullptr
-    );
+                BoundGeometry bound;
+                recordSegment(
+                    secondary,
+                    pipelineLayout,
+                    bound,
+                    pipelines,
+                    drawItems,
+                    indirectDraws,
+                    segments[jobIndex]
+                );
 
-    vkCmdDrawIndexed(commandBuffer, static_cast<std::uint32_t>(Buffer::indices.size()), 1, 0, 0, 0);
+                if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to record secondary command buffer!");
+                }
 
-    vkCmdEndRenderPass(commandBuffer);
+                recorder.recorded[jobIndex] = secondary;
+            }
+        );
 
-    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        /// The overlay goes last in a secondary of its own; the workers are done with their
+        /// pools, so the first one's is free to record it from this thread
+        if (overlay)
+        {
+            VkCommandBuffer secondary = acquireSecondary(recorder.device, workers.front());
+            beginSecondary(secondary, inheritanceInfo);
+            bindFrameState(secondary, extent, pipelineLayout, descriptorSets, dynamicOffsets);
+            overlay(secondary);
+            if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to record secondary command buffer!");
+            }
+            recorder.recorded.push_back(secondary);
+        }
+
+        if (dynamic)
+        {
+            renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+            target.beginRendering(commandBuffer, &renderingInfo);
+        }
+        else
+        {
+            vkCmdBeginRenderPass(
+                commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+            );
+        }
+        vkCmdExecuteCommands(
+            commandBuffer,
+            static_cast<std::uint32_t>(recorder.recorded.size()),
+            recorder.recorded.data()
+        );
+    }
+
+    if (dynamic)
     {
-        throw std::runtime_error("failed to record command buffer!");
+        target.endRendering(commandBuffer);
+    }
+    else
+    {
+        vkCmdEndRenderPass(commandBuffer);
     }
 }
 
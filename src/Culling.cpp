@@ -0,0 +1,205 @@
+#include "Culling.hpp"
+#include "ComputePipeline.hpp"
+
+#include <stdexcept>
+
+namespace Culling
+{
+    namespace
+    {
+        /// Row i of a column-major glm matrix
+        glm::vec4 row(const glm::mat4 &m, int i)
+        {
+            return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+        }
+
+        /// Allocate an output's set and point it at the source and that output's buffers
+        void createDescriptorSet(
+            VkDevice &device,
+            Descriptors::Allocator &descriptors,
+            const CullPass &pass,
+            Output &output
+        )
+        {
+            output.descriptorSet = Descriptors::allocate(descriptors, pass.setLayout);
+
+            std::array<VkDescriptorBufferInfo, 3> bufferInfos = {
+                VkDescriptorBufferInfo{pass.sourceBuffer, 0, VK_WHOLE_SIZE},
+                VkDescriptorBufferInfo{output.visibleBuffer, 0, VK_WHOLE_SIZE},
+                VkDescriptorBufferInfo{output.argumentBuffer, 0, VK_WHOLE_SIZE}
+            };
+
+            std::array<VkWriteDescriptorSet, 3> writes{};
+            for (std::uint32_t i = 0; i < writes.size(); i++)
+            {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = output.descriptorSet;
+                writes[i].dstBinding = i;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].descriptorCount = 1;
+                writes[i].pBufferInfo = &bufferInfos[i];
+            }
+
+            vkUpdateDescriptorSets(
+                device, static_cast<std::uint32_t>(writes.size()), writes.data(), 0, nullptr
+            );
+        }
+    } // namespace
+
+    Frustum extractFrustum(const glm::mat4 &clipFromLocal)
+    {
+        const glm::vec4 x = row(clipFromLocal, 0);
+        const glm::vec4 y = row(clipFromLocal, 1);
+        const glm::vec4 z = row(clipFromLocal, 2);
+        const glm::vec4 w = row(clipFromLocal, 3);
+
+        /// -w <= x, y, z <= w; glm::perspective maps depth to [-1, 1] (no DEPTH_ZERO_TO_ONE)
+        Frustum planes = {w + x, w - x, w + y, w - y, w + z, w - z};
+        for (auto &plane : planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return planes;
+    }
+
+    void createCullPass(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        Descriptors::LayoutCache &layouts,
+        Descriptors::Allocator &descriptors,
+        VkShaderModule shaderModule,
+        VkPipelineCache pipelineCache,
+        VkBuffer sourceInstances,
+        std::uint32_t instanceCount,
+        std::uint32_t indexCount,
+        float boundingRadius,
+        std::uint32_t outputCount,
+        CullPass &pass
+    )
+    {
+        pass.sourceBuffer = sourceInstances;
+        pass.instanceCount = instanceCount;
+        pass.indexCount = indexCount;
+        pass.boundingRadius = boundingRadius;
+
+        /// Outputs are GPU-only: written by the dispatch, read by the indirect draw
+        pass.outputs.resize(outputCount);
+        for (Output &output : pass.outputs)
+        {
+            Buffer::createBuffer(
+                device,
+                allocator,
+                sizeof(Buffer::Instance) * instanceCount,
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                output.visibleBuffer,
+                output.visibleMemory,
+                Memory::Category::Geometry
+            );
+            Buffer::createBuffer(
+                device,
+                allocator,
+                sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                    | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                output.argumentBuffer,
+                output.argumentMemory,
+                Memory::Category::Geometry
+            );
+        }
+
+        std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+        for (std::uint32_t i = 0; i < bindings.size(); i++)
+        {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+        pass.setLayout = Descriptors::getLayout(layouts, bindings);
+        ComputePipeline::createPipelineLayout(
+            device, pass.setLayout, sizeof(PushConstants), pass.layout
+        );
+        pass.pipeline = ComputePipeline::createComputePipeline(
+            device, shaderModule, pass.layout, pipelineCache
+        );
+
+        for (Output &output : pass.outputs)
+        {
+            createDescriptorSet(device, descriptors, pass, output);
+        }
+    }
+
+    void destroyCullPass(VkDevice &device, Memory::Allocator &allocator, CullPass &pass)
+    {
+        vkDestroyPipeline(device, pass.pipeline, nullptr);
+        vkDestroyPipelineLayout(device, pass.layout, nullptr);
+
+        /// The set goes with the persistent descriptor allocator, the layout with the cache
+
+        for (Output &output : pass.outputs)
+        {
+            Buffer::destroyBuffer(device, allocator, output.argumentBuffer, output.argumentMemory);
+            Buffer::destroyBuffer(device, allocator, output.visibleBuffer, output.visibleMemory);
+        }
+        pass.outputs.clear();
+    }
+
+    void recordCullPass(
+        VkCommandBuffer commandBuffer,
+        const CullPass &pass,
+        const Output &output,
+        const glm::mat4 &clipFromLocal
+    )
+    {
+        /// Arguments start with zero instances; the dispatch counts the visible ones in
+        const VkDrawIndexedIndirectCommand reset{pass.indexCount, 0, 0, 0, 0};
+        vkCmdUpdateBuffer(commandBuffer, output.argumentBuffer, 0, sizeof(reset), &reset);
+
+        VkMemoryBarrier resetBarrier{};
+        resetBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        resetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        resetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            1,
+            &resetBarrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
+
+        PushConstants constants{};
+        constants.planes = extractFrustum(clipFromLocal);
+        constants.instanceCount = pass.instanceCount;
+        constants.boundingRadius = pass.boundingRadius;
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pass.pipeline);
+        vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pass.layout,
+            0,
+            1,
+            &output.descriptorSet,
+            0,
+            nullptr
+        );
+        vkCmdPushConstants(
+            commandBuffer,
+            pass.layout,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(constants),
+            &constants
+        );
+        vkCmdDispatch(
+            commandBuffer, ComputePipeline::groupCount(pass.instanceCount, CULL_GROUP_SIZE), 1, 1
+        );
+    }
+} // namespace Culling
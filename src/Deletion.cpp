@@ -0,0 +1,41 @@
+#include "Deletion.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace Deletion
+{
+    void defer(Queue &queue, std::uint64_t retireValue, std::function<void()> destroy)
+    {
+        /// Keep the deque sorted so flush only ever looks at the front
+        if (!queue.entries.empty())
+        {
+            retireValue = std::max(retireValue, queue.entries.back().retireValue);
+        }
+        queue.entries.push_back({retireValue, std::move(destroy)});
+    }
+
+    std::size_t flush(Queue &queue, std::uint64_t completedValue)
+    {
+        std::size_t flushed = 0;
+        while (!queue.entries.empty() && queue.entries.front().retireValue <= completedValue)
+        {
+            /// Pop first so a throwing callback is not run twice
+            Entry entry = std::move(queue.entries.front());
+            queue.entries.pop_front();
+            entry.destroy();
+            flushed++;
+        }
+        return flushed;
+    }
+
+    void flushAll(Queue &queue)
+    {
+        while (!queue.entries.empty())
+        {
+            Entry entry = std::move(queue.entries.front());
+            queue.entries.pop_front();
+            entry.destroy();
+        }
+    }
+} // namespace Deletion
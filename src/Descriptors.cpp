@@ -0,0 +1,201 @@
+#include "Descriptors.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace Descriptors
+{
+    namespace
+    {
+        VkDescriptorPool createPool(const Allocator &allocator, std::uint32_t setCount)
+        {
+            std::vector<VkDescriptorPoolSize> poolSizes;
+            poolSizes.reserve(allocator.ratios.size());
+            for (const PoolSizeRatio &ratio : allocator.ratios)
+            {
+                const auto count = static_cast<std::uint32_t>(std::ceil(ratio.perSet * setCount));
+                poolSizes.push_back({ratio.type, std::max(count, 1u)});
+            }
+
+            VkDescriptorPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+            poolInfo.flags = 0; ///< Sets are only released by resetting the whole pool
+            poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+            poolInfo.pPoolSizes = poolSizes.data();
+            poolInfo.maxSets = setCount;
+
+            VkDescriptorPool pool;
+            if (vkCreateDescriptorPool(allocator.device, &poolInfo, nullptr, &pool) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to create descriptor pool!");
+            }
+            return pool;
+        }
+
+        /// Current pool, creating the next (larger) one if every pool is full
+        VkDescriptorPool currentPool(Allocator &allocator)
+        {
+            if (allocator.readyPools.empty())
+            {
+                allocator.readyPools.push_back(createPool(allocator, allocator.setsPerPool));
+                allocator.setsPerPool = std::min(allocator.setsPerPool * 2, MAX_SETS_PER_POOL);
+            }
+            return allocator.readyPools.back();
+        }
+
+        VkResult tryAllocate(
+            VkDevice device,
+            VkDescriptorPool pool,
+            VkDescriptorSetLayout layout,
+            VkDescriptorSet &descriptorSet
+        )
+        {
+            VkDescriptorSetAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+            allocInfo.descriptorPool = pool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &layout;
+            return vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+        }
+    } // namespace
+
+    void createAllocator(
+        VkDevice &device,
+        std::uint32_t initialSets,
+        std::span<const PoolSizeRatio> ratios,
+        Allocator &allocator
+    )
+    {
+        allocator.device = device;
+        allocator.ratios.assign(ratios.begin(), ratios.end());
+        allocator.setsPerPool = std::clamp(initialSets, 1u, MAX_SETS_PER_POOL);
+        currentPool(allocator);
+    }
+
+    void destroyAllocator(Allocator &allocator)
+    {
+        /// Destroying a pool frees its descriptor sets
+        for (VkDescriptorPool pool : allocator.readyPools)
+        {
+            vkDestroyDescriptorPool(allocator.device, pool, nullptr);
+        }
+        for (VkDescriptorPool pool : allocator.fullPools)
+        {
+            vkDestroyDescriptorPool(allocator.device, pool, nullptr);
+        }
+        allocator.readyPools.clear();
+        allocator.fullPools.clear();
+    }
+
+    VkDescriptorSet allocate(Allocator &allocator, VkDescriptorSetLayout layout)
+    {
+        VkDescriptorSet descriptorSet;
+        VkResult result =
+            tryAllocate(allocator.device, currentPool(allocator), layout, descriptorSet);
+
+        /// Exhausted: retire the pool and retry once from the next one
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            allocator.fullPools.push_back(allocator.readyPools.back());
+            allocator.readyPools.pop_back();
+
+            result = tryAllocate(allocator.device, currentPool(allocator), layout, descriptorSet);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+        return descriptorSet;
+    }
+
+    void resetAllocator(Allocator &allocator)
+    {
+        for (VkDescriptorPool pool : allocator.readyPools)
+        {
+            VK_CHECK(vkResetDescriptorPool(allocator.device, pool, 0), "reset descriptor pool");
+        }
+        for (VkDescriptorPool pool : allocator.fullPools)
+        {
+            VK_CHECK(vkResetDescriptorPool(allocator.device, pool, 0), "reset descriptor pool");
+            allocator.readyPools.push_back(pool);
+        }
+        allocator.fullPools.clear();
+    }
+
+    std::size_t LayoutKeyHash::operator()(const std::vector<std::uint32_t> &key) const
+    {
+        /// FNV-1a over the key's words
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        for (std::uint32_t word : key)
+        {
+            hash = (hash ^ word) * 0x100000001b3ull;
+        }
+        return static_cast<std::size_t>(hash);
+    }
+
+    void createLayoutCache(VkDevice &device, LayoutCache &cache)
+    {
+        cache.device = device;
+    }
+
+    void destroyLayoutCache(LayoutCache &cache)
+    {
+        for (const auto &[key, layout] : cache.layouts)
+        {
+            vkDestroyDescriptorSetLayout(cache.device, layout, nullptr);
+        }
+        cache.layouts.clear();
+    }
+
+    VkDescriptorSetLayout getLayout(
+        LayoutCache &cache, std::span<const VkDescriptorSetLayoutBinding> bindings
+    )
+    {
+        std::vector<VkDescriptorSetLayoutBinding> sorted(bindings.begin(), bindings.end());
+        std::sort(
+            sorted.begin(),
+            sorted.end(),
+            [](const VkDescriptorSetLayoutBinding &a, const VkDescriptorSetLayoutBinding &b)
+            {
+                return a.binding < b.binding;
+            }
+        );
+
+        std::vector<std::uint32_t> key;
+        key.reserve(sorted.size() * 4);
+        for (const VkDescriptorSetLayoutBinding &binding : sorted)
+        {
+            if (binding.pImmutableSamplers != nullptr)
+            {
+                throw std::runtime_error("failed to cache layout with immutable samplers!");
+            }
+            key.push_back(binding.binding);
+            key.push_back(static_cast<std::uint32_t>(binding.descriptorType));
+            key.push_back(binding.descriptorCount);
+            key.push_back(binding.stageFlags);
+        }
+
+        if (auto found = cache.layouts.find(key); found != cache.layouts.end())
+        {
+            return found->second;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<std::uint32_t>(sorted.size());
+        layoutInfo.pBindings = sorted.data();
+
+        VkDescriptorSetLayout layout;
+        if (vkCreateDescriptorSetLayout(cache.device, &layoutInfo, nullptr, &layout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor set layout!");
+        }
+
+        cache.layouts.emplace(std::move(key), layout);
+        return layout;
+    }
+} // namespace Descriptors
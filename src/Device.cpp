@@ -3,17 +3,187 @@
 
 #include "Queue.hpp"
 #include "ValidationLayers.hpp"
-#include <map>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <format>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
 
 namespace Device
 {
     const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
+    namespace
+    {
+        /// Device-type rank, above any heap size in MiB
+        constexpr std::uint32_t DISCRETE_SCORE = 1u << 22;
+        constexpr std::uint32_t INTEGRATED_SCORE = 1u << 21;
+        constexpr std::uint32_t VIRTUAL_SCORE = 1u << 20;
+
+        /// Largest heap counted, in MiB (1 TiB), so heaps never outrank device types
+        constexpr std::uint32_t MAX_HEAP_SCORE = VIRTUAL_SCORE - 1;
+
+        /// A dedicated queue family is worth as much as 1 GiB of device-local memory
+        constexpr std::uint32_t DEDICATED_QUEUE_SCORE = 1024;
+
+        /// Each optional rendering path the device supports
+        constexpr std::uint32_t OPTIONAL_FEATURE_SCORE = 256;
+
+        bool hasExtension(const VkPhysicalDevice device, std::string_view name)
+        {
+            std::uint32_t extensionCount;
+            vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+            std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+            vkEnumerateDeviceExtensionProperties(
+                device, nullptr, &extensionCount, availableExtensions.data()
+            );
+
+            for (const auto &extension : availableExtensions)
+            {
+                if (std::string_view(extension.extensionName) == name)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Largest device-local heap, in MiB
+        std::uint32_t deviceLocalHeapMiB(const VkPhysicalDevice device)
+        {
+            VkPhysicalDeviceMemoryProperties memoryProperties;
+            vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+
+            VkDeviceSize largest = 0;
+            for (std::uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+            {
+                const VkMemoryHeap &heap = memoryProperties.memoryHeaps[i];
+                if (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                {
+                    largest = std::max(largest, heap.size);
+                }
+            }
+            return static_cast<std::uint32_t>(
+                std::min<VkDeviceSize>(largest >> 20, MAX_HEAP_SCORE)
+            );
+        }
+
+        std::uint32_t parseHex(std::string_view digits, std::string_view selector)
+        {
+            std::uint32_t value = 0;
+            const auto [end, error] =
+                std::from_chars(digits.data(), digits.data() + digits.size(), value, 16);
+            if (digits.empty() || error != std::errc() || end != digits.data() + digits.size())
+            {
+                throw std::invalid_argument(std::format("invalid device selector: {}", selector));
+            }
+            return value;
+        }
+
+        /**
+         * @brief Check a device against a pickPhysicalDevice selector
+         * @param identity Identity of the device
+         * @param selector UUID or "pci:" address
+         * @return true if the device is the one selected
+         * @throws std::invalid_argument if the selector cannot be parsed
+         */
+        bool matchesSelector(const Identity &identity, std::string_view selector)
+        {
+            if (selector.starts_with("pci:"))
+            {
+                /// [domain:]bus[:device[.function]]; parts that are left out match any value
+                std::string_view address = selector.substr(4);
+                std::vector<std::string_view> parts;
+                while (true)
+                {
+                    const std::size_t separator = address.find_first_of(":.");
+                    parts.push_back(address.substr(0, separator));
+                    if (separator == std::string_view::npos)
+                    {
+                        break;
+                    }
+                    address.remove_prefix(separator + 1);
+                }
+
+                const bool hasDomain = std::ranges::count(selector, ':') == 3;
+                if (parts.size() > 4 || (hasDomain && parts.size() != 4))
+                {
+                    throw std::invalid_argument(
+                        std::format("invalid device selector: {}", selector)
+                    );
+                }
+                if (hasDomain && parseHex(parts[0], selector) != identity.pciDomain)
+                {
+                    return false;
+                }
+
+                const std::array<std::uint32_t, 3> location = {
+                    identity.pciBus, identity.pciDevice, identity.pciFunction
+                };
+                for (std::size_t i = hasDomain ? 1 : 0, field = 0; i < parts.size(); i++, field++)
+                {
+                    if (parseHex(parts[i], selector) != location[field])
+                    {
+                        return false;
+                    }
+                }
+                return identity.hasPciBus;
+            }
+
+            std::string digits;
+            for (char c : selector.starts_with("uuid:") ? selector.substr(5) : selector)
+            {
+                if (c != '-')
+                {
+                    digits.push_back(
+                        static_cast<char>(std::tolower(static_cast<unsigned char>(c)))
+                    );
+                }
+            }
+            if (digits.size() != VK_UUID_SIZE * 2
+                || digits.find_first_not_of("0123456789abcdef") != std::string::npos)
+            {
+                throw std::invalid_argument(std::format("invalid device selector: {}", selector));
+            }
+
+            std::string uuid = formatUuid(identity.uuid);
+            std::erase(uuid, '-');
+            return digits == uuid;
+        }
+
+        /// One line per device, so a failed override shows what could have been selected
+        std::string describeDevices(const std::vector<VkPhysicalDevice> &devices)
+        {
+            std::string list;
+            for (const VkPhysicalDevice device : devices)
+            {
+                const Identity identity = queryIdentity(device);
+                list += std::format("\n  {} uuid:{}", identity.name, formatUuid(identity.uuid));
+                if (identity.hasPciBus)
+                {
+                    list += std::format(
+                        " pci:{:04x}:{:02x}:{:02x}.{:x}",
+                        identity.pciDomain,
+                        identity.pciBus,
+                        identity.pciDevice,
+                        identity.pciFunction
+                    );
+                }
+            }
+            return list;
+        }
+    } // namespace
+
     void pickPhysicalDevice(
-        const VkInstance instance, VkPhysicalDevice &physicalDevice, const VkSurfaceKHR surface
+        const VkInstance instance,
+        VkPhysicalDevice &physicalDevice,
+        const VkSurfaceKHR surface,
+        std::string_view selector
     )
     {
         std::uint32_t deviceCount = 0;
@@ -27,22 +197,54 @@ namespace Device
         std::vector<VkPhysicalDevice> devices(deviceCount);
         vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
 
-        std::multimap<std::uint32_t, VkPhysicalDevice> candidates;
-
-        for (auto device : devices)
+        /// Pinning a process to a GPU: the command line first, then the environment
+        const char *environment = std::getenv(DEVICE_ENV);
+        if (selector.empty() && environment != nullptr)
         {
-            auto rate = rateDevice(device, surface);
-            candidates.insert(std::make_pair(rate, device));
+            selector = environment;
+        }
 
-            if (candidates.rbegin()->first > 0)
+        if (!selector.empty())
+        {
+            const auto selected = std::ranges::find_if(
+                devices,
+                [&](VkPhysicalDevice device)
+                { return matchesSelector(queryIdentity(device), selector); }
+            );
+            if (selected == devices.end())
             {
-                physicalDevice = candidates.rbegin()->second;
+                throw std::runtime_error(std::format(
+                    "failed to find the GPU {}! available:{}", selector, describeDevices(devices)
+                ));
             }
-            else
+            if (rateDevice(*selected, surface) == 0)
+            {
+                throw std::runtime_error(std::format(
+                    "failed to use the GPU {}, it is not suitable!", selector
+                ));
+            }
+            physicalDevice = *selected;
+            return;
+        }
+
+        /// The first of the best rated devices; the loop only ranks, the verdict comes after
+        std::uint32_t bestScore = 0;
+        for (auto device : devices)
+        {
+            const std::uint32_t score = rateDevice(device, surface);
+            if (score > bestScore)
             {
-                throw std::runtime_error("failed to find a suitable GPU!");
+                bestScore = score;
+                physicalDevice = device;
             }
         }
+
+        if (bestScore == 0)
+        {
+            throw std::runtime_error(
+                std::format("failed to find a suitable GPU! available:{}", describeDevices(devices))
+            );
+        }
     }
 
     std::uint32_t rateDevice(const VkPhysicalDevice device, const VkSurfaceKHR surface)
@@ -60,58 +262,259 @@ namespace Device
             return 0;
         }
 
-        std::uint32_t score = 0;
+        /// VK_KHR_swapchain is enabled even headless (offscreen targets end in PRESENT_SRC_KHR)
+        if (!checkDeviceExtensionSupport(device))
+        {
+            return 0;
+        }
 
-        if (deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+        if (surface != VK_NULL_HANDLE)
         {
-            score += 1000;
+            std::uint32_t formatCount = 0;
+            vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
+            std::uint32_t presentModeCount = 0;
+            vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, nullptr);
+            if (formatCount == 0 || presentModeCount == 0)
+            {
+                return 0;
+            }
         }
 
-        score += deviceProperties.limits.maxImageDimension2D;
+        /// Textures are sampled with anisotropy, which createLogicalDevice enables
+        /// unconditionally
+        if (!deviceFeatures.samplerAnisotropy)
+        {
+            return 0;
+        }
 
-        if (!deviceFeatures.geometryShader)
+        /// Frame pacing and deferred destruction are built on timeline semaphores (core 1.2)
+        if (deviceProperties.apiVersion < VK_API_VERSION_1_2)
         {
             return 0;
         }
 
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+
+        if (!vulkan12Features.timelineSemaphore)
+        {
+            return 0;
+        }
+
+        /// Hybrid laptops list an integrated GPU whose heap is system memory and can look large
+        std::uint32_t score = 0;
+        switch (deviceProperties.deviceType)
+        {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            score += DISCRETE_SCORE;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            score += INTEGRATED_SCORE;
+            break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            score += VIRTUAL_SCORE;
+            break;
+        default:
+            break;
+        }
+
+        /// Never 0 for a suitable device, even a CPU implementation with a tiny heap
+        score += std::max(deviceLocalHeapMiB(device), 1u);
+
+        if (indices.hasDedicatedTransfer())
+        {
+            score += DEDICATED_QUEUE_SCORE;
+        }
+        if (indices.hasAsyncCompute())
+        {
+            score += DEDICATED_QUEUE_SCORE;
+        }
+
+        for (const bool supported :
+             {supportsDynamicRendering(device),
+              supportsMultiDrawIndirect(device) == VK_TRUE,
+              supportsDrawIndirectCount(device) == VK_TRUE,
+              supportsBindless(device) == VK_TRUE})
+        {
+            score += supported ? OPTIONAL_FEATURE_SCORE : 0;
+        }
+
         return score;
     }
 
+    Identity queryIdentity(const VkPhysicalDevice device)
+    {
+        const bool hasPciBus = hasExtension(device, VK_EXT_PCI_BUS_INFO_EXTENSION_NAME);
+
+        VkPhysicalDevicePCIBusInfoPropertiesEXT pciBusInfo{};
+        pciBusInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT;
+
+        VkPhysicalDeviceIDProperties idProperties{};
+        idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+        idProperties.pNext = hasPciBus ? &pciBusInfo : nullptr;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &idProperties;
+        vkGetPhysicalDeviceProperties2(device, &properties2);
+
+        Identity identity;
+        identity.name = properties2.properties.deviceName;
+        std::copy(
+            std::begin(idProperties.deviceUUID),
+            std::end(idProperties.deviceUUID),
+            identity.uuid.begin()
+        );
+        identity.hasPciBus = hasPciBus;
+        identity.pciDomain = pciBusInfo.pciDomain;
+        identity.pciBus = pciBusInfo.pciBus;
+        identity.pciDevice = pciBusInfo.pciDevice;
+        identity.pciFunction = pciBusInfo.pciFunction;
+        return identity;
+    }
+
+    std::string formatUuid(const std::array<std::uint8_t, VK_UUID_SIZE> &uuid)
+    {
+        std::string text;
+        for (std::size_t i = 0; i < uuid.size(); i++)
+        {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+            {
+                text.push_back('-');
+            }
+            text += std::format("{:02x}", uuid[i]);
+        }
+        return text;
+    }
+
     void createLogicalDevice(
         const VkPhysicalDevice physicalDevice,
         VkDevice &device,
         VkQueue &graphicsQueue,
         VkQueue &presentQueue,
-        const VkSurfaceKHR surface
+        VkQueue &transferQueue,
+        VkQueue &computeQueue,
+        VkQueue &asyncComputeQueue,
+        const VkSurfaceKHR surface,
+        bool enablePresentWait,
+        bool enableDynamicRendering,
+        bool enableAsyncCompute
     )
     {
         Queue::FamilyIndices indices = Queue::findQueueFamilies(physicalDevice, surface);
+        const bool asyncCompute = enableAsyncCompute && indices.hasAsyncCompute();
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        std::set<std::uint32_t> uniqueQueueFamilies =
-            {indices.graphicsFamily.value(), indices.presentFamily.value()};
+        std::set<std::uint32_t> uniqueQueueFamilies = {
+            indices.graphicsFamily.value(),
+            indices.presentFamily.value(),
+            indices.transferFamily.value(),
+            indices.computeFamily.value()
+        };
+        if (asyncCompute)
+        {
+            uniqueQueueFamilies.insert(indices.asyncComputeFamily.value());
+        }
 
-        float queuePriority = 1.0f;
+        /// The async compute queue may be the second queue of the transfer family
+        const std::array<float, 2> queuePriorities = {1.0f, 1.0f};
         for (std::uint32_t queueFamily : uniqueQueueFamilies)
         {
             VkDeviceQueueCreateInfo queueCreateInfo{};
             queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queueFamily;
-            queueCreateInfo.queueCount = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount =
+                asyncCompute && queueFamily == indices.asyncComputeFamily
+                    ? indices.asyncComputeIndex + 1
+                    : 1;
+            queueCreateInfo.pQueuePriorities = queuePriorities.data();
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
-        VkPhysicalDeviceFeatures deviceFeatures{};
-        deviceFeatures.samplerAnisotropy = VK_TRUE;
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+        vulkan12Features.drawIndirectCount = supportsDrawIndirectCount(physicalDevice);
+
+        /// Bindless texture table: a partially bound array written while frames are in flight
+        const VkBool32 bindless = supportsBindless(physicalDevice);
+        vulkan12Features.descriptorIndexing = bindless;
+        vulkan12Features.runtimeDescriptorArray = bindless;
+        vulkan12Features.descriptorBindingPartiallyBound = bindless;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = bindless;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = bindless;
+
+        VkPhysicalDeviceFeatures2 deviceFeatures{};
+        deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        deviceFeatures.pNext = &vulkan12Features;
+        deviceFeatures.features.samplerAnisotropy = VK_TRUE;
+        deviceFeatures.features.multiDrawIndirect = supportsMultiDrawIndirect(physicalDevice);
+
+        /// Whatever block compression the GPU has; Ktx picks among the formats it enables
+        VkPhysicalDeviceFeatures supported;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &supported);
+        deviceFeatures.features.textureCompressionBC = supported.textureCompressionBC;
+        deviceFeatures.features.textureCompressionASTC_LDR = supported.textureCompressionASTC_LDR;
+        deviceFeatures.features.textureCompressionETC2 = supported.textureCompressionETC2;
+
+        /// Indirect records that start past instance 0 (benchmark draw splitting)
+        deviceFeatures.features.drawIndirectFirstInstance = supported.drawIndirectFirstInstance;
+
+        /// Per-frame statistics queries of the profiler, when the GPU can count them, and
+        /// the secondaries of a parallel-recorded pass counted by them
+        deviceFeatures.features.pipelineStatisticsQuery = supported.pipelineStatisticsQuery;
+        deviceFeatures.features.inheritedQueries = supported.inheritedQueries;
+
+        /// Optional low-latency pacing: both extensions and their features
+        std::vector<const char *> enabledExtensions = deviceExtensions;
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+        presentWaitFeatures.presentWait = VK_TRUE;
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        presentIdFeatures.presentId = VK_TRUE;
+
+        /// Heap budgets for texture streaming; without it the allocator's own totals are used
+        if (supportsMemoryBudget(physicalDevice))
+        {
+            enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+
+        if (enablePresentWait)
+        {
+            enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+            enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+            vulkan12Features.pNext = &presentIdFeatures;
+        }
+
+        /// Render pass objects and framebuffers give way to vkCmdBeginRendering, and barriers
+        /// carry their own stage masks (core 1.3, ahead of the rest of the chain)
+        VkPhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        vulkan13Features.pNext = deviceFeatures.pNext;
+        vulkan13Features.dynamicRendering = VK_TRUE;
+        vulkan13Features.synchronization2 = VK_TRUE;
+        if (enableDynamicRendering)
+        {
+            deviceFeatures.pNext = &vulkan13Features;
+        }
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &deviceFeatures; ///< Features2 chain replaces pEnabledFeatures
         createInfo.queueCreateInfoCount = static_cast<std::uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
-        createInfo.pEnabledFeatures = &deviceFeatures;
-        createInfo.enabledExtensionCount = static_cast<std::uint32_t>(deviceExtensions.size());
-        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+        createInfo.pEnabledFeatures = nullptr;
+        createInfo.enabledExtensionCount = static_cast<std::uint32_t>(enabledExtensions.size());
+        createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
         if (ValidationLayers::enableValidationLayers)
         {
@@ -130,6 +533,19 @@ namespace Device
 
         vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
         vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+        vkGetDeviceQueue(device, indices.transferFamily.value(), 0, &transferQueue);
+        vkGetDeviceQueue(device, indices.computeFamily.value(), 0, &computeQueue);
+
+        asyncComputeQueue = VK_NULL_HANDLE;
+        if (asyncCompute)
+        {
+            vkGetDeviceQueue(
+                device,
+                indices.asyncComputeFamily.value(),
+                indices.asyncComputeIndex,
+                &asyncComputeQueue
+            );
+        }
     }
 
     bool checkDeviceExtensionSupport(const VkPhysicalDevice device)
@@ -151,4 +567,124 @@ namespace Device
 
         return requiredExtensions.empty();
     }
+
+    VkBool32 supportsMultiDrawIndirect(const VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceFeatures supported;
+        vkGetPhysicalDeviceFeatures(device, &supported);
+        return supported.multiDrawIndirect;
+    }
+
+    VkBool32 supportsDrawIndirectCount(const VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+
+        return vulkan12Features.drawIndirectCount;
+    }
+
+    VkBool32 supportsBindless(const VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+
+        return vulkan12Features.descriptorIndexing && vulkan12Features.runtimeDescriptorArray
+               && vulkan12Features.descriptorBindingPartiallyBound
+               && vulkan12Features.descriptorBindingSampledImageUpdateAfterBind
+               && vulkan12Features.descriptorBindingUpdateUnusedWhilePending;
+    }
+
+    bool supportsPresentWait(const VkPhysicalDevice device)
+    {
+        std::uint32_t extensionCount;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+        std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(
+            device, nullptr, &extensionCount, availableExtensions.data()
+        );
+
+        std::set<std::string> requiredExtensions = {
+            VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME
+        };
+        for (const auto &extension : availableExtensions)
+        {
+            requiredExtensions.erase(extension.extensionName);
+        }
+        if (!requiredExtensions.empty())
+        {
+            return false;
+        }
+
+        VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+        presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+        VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+        presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &presentIdFeatures;
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+
+        return presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+
+    bool supportsDynamicRendering(const VkPhysicalDevice device)
+    {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        if (properties.apiVersion < VK_API_VERSION_1_3)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceVulkan13Features vulkan13Features{};
+        vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &vulkan13Features;
+        vkGetPhysicalDeviceFeatures2(device, &features2);
+
+        return vulkan13Features.dynamicRendering && vulkan13Features.synchronization2;
+    }
+
+    void loadDynamicRendering(VkDevice device, DynamicRendering &functions)
+    {
+        functions.beginRendering = reinterpret_cast<PFN_vkCmdBeginRendering>(
+            vkGetDeviceProcAddr(device, "vkCmdBeginRendering")
+        );
+        functions.endRendering = reinterpret_cast<PFN_vkCmdEndRendering>(
+            vkGetDeviceProcAddr(device, "vkCmdEndRendering")
+        );
+        functions.pipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(
+            vkGetDeviceProcAddr(device, "vkCmdPipelineBarrier2")
+        );
+        functions.queueSubmit2 = reinterpret_cast<PFN_vkQueueSubmit2>(
+            vkGetDeviceProcAddr(device, "vkQueueSubmit2")
+        );
+
+        if (!functions.beginRendering || !functions.endRendering || !functions.pipelineBarrier2
+            || !functions.queueSubmit2)
+        {
+            throw std::runtime_error("failed to load dynamic rendering entry points!");
+        }
+    }
+
+    bool supportsMemoryBudget(const VkPhysicalDevice device)
+    {
+        return hasExtension(device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
 } // namespace Device
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "Frame.hpp"
+#include "Buffer.hpp"
+#include "Command.hpp"
+#include "Synchronisation.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+
+namespace Frame
+{
+    void createFrameContexts(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        Memory::Allocator &allocator,
+        std::size_t frameCount,
+        std::vector<FrameContext> &frames,
+        UniformRing &uniforms
+    )
+    {
+        frames.resize(frameCount);
+
+        /// Regions start on the device's dynamic offset alignment
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        uniforms.alignment = std::max<VkDeviceSize>(
+            properties.limits.minUniformBufferOffsetAlignment, 1
+        );
+        uniforms.regionSize =
+            (FRAME_UNIFORM_SIZE + uniforms.alignment - 1) / uniforms.alignment * uniforms.alignment;
+
+        Buffer::createBuffer(
+            device,
+            allocator,
+            uniforms.regionSize * frameCount,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            uniforms.buffer,
+            uniforms.allocation,
+            Memory::Category::Uniform
+        );
+
+        VkDeviceSize uniformBase = 0;
+
+        for (auto &frame : frames)
+        {
+            /// Transient pool: buffers are never reset individually, the pool is reset per frame
+            Command::createCommandPool(
+                device,
+                physicalDevice,
+                surface,
+                frame.commandPool,
+                VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+            );
+
+            std::vector<VkCommandBuffer> commandBuffers;
+            Command::createCommandBuffers(device, frame.commandPool, commandBuffers, 1);
+            frame.commandBuffer = commandBuffers[0];
+
+            Synchronization::createFrameSyncObjects(device, frame.imageAvailable);
+            frame.timelineValue = 0;
+
+            frame.uniformBase = uniformBase;
+            frame.uniformHead = 0;
+            uniformBase += uniforms.regionSize;
+
+            Descriptors::createAllocator(
+                device, FRAME_DESCRIPTOR_SETS, Descriptors::DEFAULT_RATIOS, frame.descriptors
+            );
+        }
+    }
+
+    void destroyFrameContexts(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        std::vector<FrameContext> &frames,
+        UniformRing &uniforms
+    )
+    {
+        for (auto &frame : frames)
+        {
+            Descriptors::destroyAllocator(frame.descriptors);
+
+            vkDestroySemaphore(device, frame.imageAvailable, nullptr);
+
+            /// Destroying the pool frees its command buffer
+            vkDestroyCommandPool(device, frame.commandPool, nullptr);
+        }
+        frames.clear();
+
+        Buffer::destroyBuffer(device, allocator, uniforms.buffer, uniforms.allocation);
+    }
+
+    void waitAndReset(
+        VkDevice &device, const Synchronization::Timeline &timeline, FrameContext &frame
+    )
+    {
+        Synchronization::waitForValue(device, timeline, frame.timelineValue);
+
+        VK_CHECK(vkResetCommandPool(device, frame.commandPool, 0), "reset frame command pool");
+        Descriptors::resetAllocator(frame.descriptors);
+        frame.descriptorSet = VK_NULL_HANDLE;
+        frame.uniformHead = 0;
+    }
+
+    VkDescriptorSet allocateDescriptorSet(
+        VkDevice &device, FrameContext &frame, VkDescriptorSetLayout &layout
+    )
+    {
+        return Descriptors::allocate(frame.descriptors, layout);
+    }
+
+    std::byte *allocateUniform(
+        UniformRing &uniforms, FrameContext &frame, VkDeviceSize size, std::uint32_t &offset
+    )
+    {
+        const VkDeviceSize start =
+            (frame.uniformHead + uniforms.alignment - 1) / uniforms.alignment * uniforms.alignment;
+        if (start + size > uniforms.regionSize)
+        {
+            return nullptr;
+        }
+
+        frame.uniformHead = start + size;
+        offset = static_cast<std::uint32_t>(frame.uniformBase + start);
+        return static_cast<std::byte *>(uniforms.allocation.mapped) + frame.uniformBase + start;
+    }
+} // namespace Frame
@@ -1,11 +1,13 @@
 #include "Framebuffer.hpp"
 
+#include <array>
 #include <stdexcept>
 
 void Framebuffer::createFramebuffers(
     VkDevice &device,
     VkRenderPass &renderPass,
     const std::vector<VkImageView> &swapChainImageViews,
+    VkImageView depthImageView,
     VkExtent2D &swapChainExtent,
     std::vector<VkFramebuffer> &swapChainFramebuffers
 )
@@ -14,13 +16,13 @@ void Framebuffer::createFramebuffers(
 
     for (size_t i = 0; i < swapChainImageViews.size(); i++)
     {
-        VkImageView attachments[] = {swapChainImageViews[i]};
+        const std::array<VkImageView, 2> attachments = {swapChainImageViews[i], depthImageView};
 
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
+        framebufferInfo.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+        framebufferInfo.pAttachments = attachments.data();
         framebufferInfo.width = swapChainExtent.width;
         framebufferInfo.height = swapChainExtent.height;
         framebufferInfo.layers = 1;
@@ -1,42 +1,91 @@
-#include <cassert>
+#include <array>
 #include <stdexcept>
 #include <vulkan/vulkan_core.h>
 
 #include "Buffer.hpp"
 #include "GraphicsPipeline.hpp"
-#include "helper.hpp"
+#include "Mesh.hpp"
+#include "Sprites.hpp"
 
-void GraphicsPipeline::createGraphicsPipeline(
-    VkDevice &device,
-    VkExtent2D &swapChainExtent,
-    VkPipelineLayout &pipelineLayout,
-    VkPipeline &graphicsPipeline,
-    VkRenderPass &renderPass,
-    VkDescriptorSetLayout &descriptorSetLayout
-)
+namespace
 {
-    auto vertShaderCode = Helper::readFile(vertShaderPath);
-    auto fragShaderCode = Helper::readFile(fragShaderPath);
-
-    if (vertShaderCode.empty() || fragShaderCode.empty())
+    /// FNV-1a step over the raw bytes of a value
+    template <typename T> void hashBytes(std::uint64_t &hash, const T &value)
     {
-        throw std::runtime_error("failed to read shader files!");
+        const auto *bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (std::size_t i = 0; i < sizeof(T); i++)
+        {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
     }
 
-    if (vertShaderCode.size() % 4 != 0 || fragShaderCode.size() % 4 != 0)
+    void hashString(std::uint64_t &hash, const std::string &value)
     {
-        throw std::runtime_error("shader code size is not a multiple of 4!");
+        for (const char c : value)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+        }
+        hashBytes(hash, value.size()); ///< Separates consecutive strings
     }
+} // namespace
 
-    std::uint32_t magicVert = *reinterpret_cast<const std::uint32_t *>(vertShaderCode.data());
-    std::uint32_t magicFrag = *reinterpret_cast<const std::uint32_t *>(fragShaderCode.data());
+std::uint64_t GraphicsPipeline::hashState(const PipelineState &state)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    hashString(hash, state.vertexShader);
+    hashString(hash, state.fragmentShader);
+    hashBytes(hash, state.vertexLayout);
+    hashBytes(hash, state.topology);
+    hashBytes(hash, state.polygonMode);
+    hashBytes(hash, state.cullMode);
+    hashBytes(hash, state.frontFace);
+    hashBytes(hash, state.blendEnable);
+    hashBytes(hash, state.srcColorBlend);
+    hashBytes(hash, state.dstColorBlend);
+    hashBytes(hash, state.colorWrite);
+    hashBytes(hash, state.depthTest);
+    hashBytes(hash, state.depthWrite);
+    hashBytes(hash, state.depthCompare);
+    hashBytes(hash, state.renderPass);
+    hashBytes(hash, state.subpass);
+    hashBytes(hash, state.colorFormat);
+    hashBytes(hash, state.depthFormat);
+    return hash;
+}
+
+void GraphicsPipeline::createPipelineLayout(
+    VkDevice &device,
+    std::span<const VkDescriptorSetLayout> setLayouts,
+    VkPipelineLayout &pipelineLayout
+)
+{
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(DrawConstants);
 
-    assert(magicVert == 0x07230203);
-    assert(magicFrag == 0x07230203);
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<std::uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-    VkShaderModule vertShaderModule = createShaderModule(device, vertShaderCode);
-    VkShaderModule fragShaderModule = createShaderModule(device, fragShaderCode);
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+}
 
+VkPipeline GraphicsPipeline::createGraphicsPipeline(
+    VkDevice device,
+    const PipelineState &state,
+    VkShaderModule vertShaderModule,
+    VkShaderModule fragShaderModule,
+    VkPipelineLayout pipelineLayout,
+    VkPipelineCache pipelineCache
+)
+{
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -50,6 +99,7 @@ void GraphicsPipeline::createGraphicsPipeline(
     fragShaderStageInfo.pName = "main";
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
+    const std::uint32_t stageCount = fragShaderModule != VK_NULL_HANDLE ? 2 : 1;
 
     std::vector<VkDynamicState> dynamicStates =
         {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
@@ -62,48 +112,72 @@ void GraphicsPipeline::createGraphicsPipeline(
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-    auto bindingDescription = Buffer::Vertex::getBindingDescription();
-    auto attributeDescriptions = Buffer::Vertex::getAttributeDescriptions();
+    /// Binding 0 depends on the layout; binding 1 is the per-instance data, except for sprites
+    std::array<VkVertexInputBindingDescription, 2> bindingDescriptions = {
+        Buffer::Vertex::getBindingDescription(), Buffer::Instance::getBindingDescription()
+    };
+    std::uint32_t bindingCount = 2;
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
+    switch (state.vertexLayout)
+    {
+    case VertexLayout::PositionColorTexCoord:
+        for (const auto &attribute : Buffer::Vertex::getAttributeDescriptions())
+        {
+            attributeDescriptions.push_back(attribute);
+        }
+        break;
+    case VertexLayout::Packed:
+        bindingDescriptions[0] = Mesh::PackedVertex::getBindingDescription();
+        for (const auto &attribute : Mesh::PackedVertex::getAttributeDescriptions())
+        {
+            attributeDescriptions.push_back(attribute);
+        }
+        break;
+    case VertexLayout::Sprite:
+        bindingDescriptions[0] = Sprites::Vertex::getBindingDescription();
+        bindingCount = 1;
+        for (const auto &attribute : Sprites::Vertex::getAttributeDescriptions())
+        {
+            attributeDescriptions.push_back(attribute);
+        }
+        break;
+    }
+    if (bindingCount == 2)
+    {
+        for (const auto &attribute : Buffer::Instance::getAttributeDescriptions())
+        {
+            attributeDescriptions.push_back(attribute);
+        }
+    }
 
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
+    vertexInputInfo.vertexBindingDescriptionCount = bindingCount;
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(
         attributeDescriptions.size()
     );
-    vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
     vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = state.topology;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)swapChainExtent.width;
-    viewport.height = (float)swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapChainExtent;
-
+    /// Viewport and scissor are dynamic; only their counts are baked into the pipeline
     VkPipelineViewportStateCreateInfo viewportState{};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
+    viewportState.pViewports = nullptr;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+    viewportState.pScissors = nullptr;
 
     VkPipelineRasterizationStateCreateInfo rasterizer{};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     rasterizer.depthClampEnable = VK_FALSE;
     rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.polygonMode = state.polygonMode;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.cullMode = state.cullMode;
+    rasterizer.frontFace = state.frontFace;
     rasterizer.depthBiasEnable = VK_FALSE;
     rasterizer.depthBiasConstantFactor = 0.0f;
     rasterizer.depthBiasClamp = 0.0f;
@@ -119,11 +193,13 @@ void GraphicsPipeline::createGraphicsPipeline(
     multisampling.alphaToOneEnable = VK_FALSE;
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
-                                          | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorWriteMask =
+        state.colorWrite ? VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT
+                               | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+                         : 0;
+    colorBlendAttachment.blendEnable = state.blendEnable ? VK_TRUE : VK_FALSE;
+    colorBlendAttachment.srcColorBlendFactor = state.srcColorBlend;
+    colorBlendAttachment.dstColorBlendFactor = state.dstColorBlend;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
     colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
     colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
@@ -140,22 +216,20 @@ void GraphicsPipeline::createGraphicsPipeline(
     colorBlending.blendConstants[2] = 0.0f;
     colorBlending.blendConstants[3] = 0.0f;
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to create pipeline layout!");
-    }
+    /// Opaque draws test and write depth; blended ones test without writing, and after a
+    /// depth pre-pass opaque draws only pass where they are the pre-pass's nearest surface
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = state.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = state.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = state.depthCompare;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = stageCount;
     pipelineInfo.pStages = shaderStages;
 
     pipelineInfo.pVertexInputState = &vertexInputInfo;
@@ -163,32 +237,43 @@ void GraphicsPipeline::createGraphicsPipeline(
     pipelineInfo.pViewportState = &viewportState;
     pipelineInfo.pRasterizationState = &rasterizer;
     pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = nullptr;
+    pipelineInfo.pDepthStencilState = &depthStencil;
     pipelineInfo.pColorBlendState = &colorBlending;
     pipelineInfo.pDynamicState = &dynamicState;
 
     pipelineInfo.layout = pipelineLayout;
 
-    pipelineInfo.renderPass = renderPass;
-    pipelineInfo.subpass = 0;
+    pipelineInfo.renderPass = state.renderPass;
+    pipelineInfo.subpass = state.subpass;
+
+    /// Without a render pass the attachment formats come from dynamic rendering
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &state.colorFormat;
+    renderingInfo.depthAttachmentFormat = state.depthFormat;
+    if (state.renderPass == VK_NULL_HANDLE)
+    {
+        pipelineInfo.pNext = &renderingInfo;
+    }
 
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
     pipelineInfo.basePipelineIndex = -1;
 
+    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
     if (vkCreateGraphicsPipelines(
-            device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline
+            device, pipelineCache, 1, &pipelineInfo, nullptr, &graphicsPipeline
         )
         != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
 
-    vkDestroyShaderModule(device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    return graphicsPipeline;
 }
 
 VkShaderModule
-GraphicsPipeline::createShaderModule(VkDevice &device, const std::vector<std::byte> &code)
+GraphicsPipeline::createShaderModule(VkDevice &device, std::span<const std::byte> code)
 {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -204,47 +289,18 @@ GraphicsPipeline::createShaderModule(VkDevice &device, const std::vector<std::by
     return shaderModule;
 }
 
-void GraphicsPipeline::createRenderPass(VkDevice &device, VkRenderPass &renderPass)
+VkFormat GraphicsPipeline::findDepthFormat(VkPhysicalDevice physicalDevice)
 {
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = VK_FORMAT_B8G8R8A8_SRGB;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.srcAccessMask = 0;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
-
-    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+    for (VkFormat format :
+         {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT})
     {
-        throw std::runtime_error("failed to create render pass!");
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+        if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)
+        {
+            return format;
+        }
     }
+
+    throw std::runtime_error("failed to find a supported depth format!");
 }
@@ -0,0 +1,191 @@
+#include "HotReload.hpp"
+#include "Image.hpp"
+#include "helper.hpp"
+
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#ifdef HOT_RELOAD_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+
+namespace HotReload
+{
+    namespace
+    {
+        /// Modification time of a file, or the minimum when it cannot be read (e.g. an editor
+        /// replacing it right now)
+        std::filesystem::file_time_type writeTime(const std::filesystem::path &path)
+        {
+            std::error_code error;
+            const auto time = std::filesystem::last_write_time(path, error);
+            return error ? std::filesystem::file_time_type::min() : time;
+        }
+
+        /// Rebuild the asset of a changed file; failures are reported, not thrown
+        Change rebuild(const Watcher &watcher, const WatchedFile &file)
+        {
+            Change change;
+            change.kind = file.kind;
+            change.key = file.key;
+            change.path = file.path;
+            try
+            {
+                if (file.kind == AssetKind::Texture)
+                {
+                    change.texels = Image::decodeTexture(file.path, watcher.physicalDevice);
+                }
+                else
+                {
+#ifdef HOT_RELOAD_SHADERC
+                    change.spirv = compileShader(file.path);
+#else
+                    change.spirv = Helper::readFile(file.path);
+#endif
+                }
+            }
+            catch (const std::exception &e)
+            {
+                change.error = e.what();
+            }
+            return change;
+        }
+
+        void pollLoop(Watcher &watcher)
+        {
+            std::unique_lock<std::mutex> lock(watcher.mutex);
+            while (!watcher.wake.wait_for(
+                lock, POLL_INTERVAL, [&watcher] { return watcher.stopping; }
+            ))
+            {
+                lock.unlock();
+                std::vector<Change> changes;
+                for (WatchedFile &file : watcher.files)
+                {
+                    const auto time = writeTime(file.path);
+                    if (time == file.lastWrite || time == std::filesystem::file_time_type::min())
+                    {
+                        continue;
+                    }
+                    file.lastWrite = time;
+                    changes.push_back(rebuild(watcher, file));
+                }
+                lock.lock();
+
+                for (Change &change : changes)
+                {
+                    watcher.changes.push_back(std::move(change));
+                }
+            }
+        }
+    } // namespace
+
+    void watchShader(Watcher &watcher, const std::string &spirvPath)
+    {
+        WatchedFile file;
+        file.key = spirvPath;
+        file.kind = AssetKind::Shader;
+#ifdef HOT_RELOAD_SHADERC
+        /// shader.vert.spv is compiled from SHADER_SOURCE_DIR/shader.vert
+        file.path = std::filesystem::path(SHADER_SOURCE_DIR)
+                    / std::filesystem::path(spirvPath).stem();
+#else
+        file.path = spirvPath;
+#endif
+        watcher.files.push_back(std::move(file));
+    }
+
+    void watchTexture(Watcher &watcher, const std::string &path)
+    {
+        WatchedFile file;
+        file.key = path;
+        file.path = path;
+        file.kind = AssetKind::Texture;
+        watcher.files.push_back(std::move(file));
+    }
+
+    void start(Watcher &watcher, VkPhysicalDevice physicalDevice)
+    {
+        watcher.physicalDevice = physicalDevice;
+        watcher.stopping = false;
+        for (WatchedFile &file : watcher.files)
+        {
+            file.lastWrite = writeTime(file.path);
+        }
+        watcher.thread = std::thread(pollLoop, std::ref(watcher));
+    }
+
+    void stop(Watcher &watcher)
+    {
+        if (!watcher.thread.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(watcher.mutex);
+            watcher.stopping = true;
+        }
+        watcher.wake.notify_all();
+        watcher.thread.join();
+        watcher.changes.clear();
+    }
+
+    std::vector<Change> takeChanges(Watcher &watcher)
+    {
+        std::lock_guard<std::mutex> lock(watcher.mutex);
+        std::vector<Change> changes(
+            std::make_move_iterator(watcher.changes.begin()),
+            std::make_move_iterator(watcher.changes.end())
+        );
+        watcher.changes.clear();
+        return changes;
+    }
+
+    std::vector<std::byte> compileShader(const std::filesystem::path &source)
+    {
+#ifdef HOT_RELOAD_SHADERC
+        const std::string extension = source.extension().string();
+        shaderc_shader_kind kind = shaderc_glsl_infer_from_source;
+        if (extension == ".vert")
+        {
+            kind = shaderc_glsl_vertex_shader;
+        }
+        else if (extension == ".frag")
+        {
+            kind = shaderc_glsl_fragment_shader;
+        }
+        else if (extension == ".comp")
+        {
+            kind = shaderc_glsl_compute_shader;
+        }
+
+        const std::vector<std::byte> text = Helper::readFile(source);
+        const shaderc::Compiler compiler;
+        shaderc::CompileOptions options;
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+        const shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
+            reinterpret_cast<const char *>(text.data()),
+            text.size(),
+            kind,
+            source.string().c_str(),
+            options
+        );
+        if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        {
+            throw std::runtime_error("failed to compile shader: " + result.GetErrorMessage());
+        }
+
+        const std::size_t size = (result.cend() - result.cbegin()) * sizeof(std::uint32_t);
+        std::vector<std::byte> spirv(size);
+        std::memcpy(spirv.data(), result.cbegin(), size);
+        return spirv;
+#else
+        throw std::runtime_error(
+            "failed to compile " + source.string() + ", the build has no shaderc!"
+        );
+#endif
+    }
+} // namespace HotReload
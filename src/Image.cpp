@@ -1,7 +1,9 @@
 #include "Image.hpp"
 #include "Buffer.hpp"
-#include "Command.hpp"
+#include "Ktx.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstring>
 #include <stdexcept>
@@ -12,97 +14,398 @@
 
 namespace Image
 {
-    void createTextureImage(
-        VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
-        VkImage &textureImage,
-        VkDeviceMemory &textureImageMemory,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue
+    bool decodeNeedsDevice(const std::filesystem::path &path)
+    {
+        return path.extension() == ".ktx2";
+    }
+
+    Ktx::TextureData decodeTexture(
+        const std::filesystem::path &path, VkPhysicalDevice physicalDevice
     )
     {
+        /// KTX2 levels are uploaded as stored (or as transcoded for this device)
+        if (decodeNeedsDevice(path))
+        {
+            return Ktx::loadKtx2(physicalDevice, path);
+        }
+
         int texWidth, texHeight, texChannels;
 
         stbi_uc *pixels =
-            stbi_load("textures/texture.jpg", &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-
-        VkDeviceSize imageSize = texWidth * texHeight * 4;
+            stbi_load(path.string().c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
         if (!pixels)
         {
             throw std::runtime_error("failed to load texture image!");
         }
 
-        VkBuffer stagingBuffer;
-        VkDeviceMemory stagingBufferMemory;
+        const auto width = static_cast<std::uint32_t>(texWidth);
+        const auto height = static_cast<std::uint32_t>(texHeight);
+        Ktx::TextureData texels;
+        texels.format = VK_FORMAT_R8G8B8A8_SRGB;
+        const VkDeviceSize imageSize = levelSize(texels.format, width, height);
+        texels.levels.push_back({0, imageSize, width, height});
+        texels.storage.resize(imageSize);
+        std::memcpy(texels.storage.data(), pixels, imageSize);
+        texels.data = texels.storage;
 
-        Buffer::createBuffer(
-            device,
-            physicalDevice,
-            imageSize,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            stagingBuffer,
-            stagingBufferMemory
-        );
+        stbi_image_free(pixels);
+        return texels;
+    }
 
-        void *data;
-        vkMapMemory(device, stagingBufferMemory, 0, imageSize, 0, &data);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
-        vkUnmapMemory(device, stagingBufferMemory);
+    void createTextureImage(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const Ktx::TextureData &texels,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        VkFormat &format,
+        std::uint32_t &mipLevels,
+        Upload::Context &uploads
+    )
+    {
+        format = texels.format;
+        mipLevels = static_cast<std::uint32_t>(texels.levels.size());
 
-        stbi_image_free(pixels);
+        /// A source without a mip chain gets one generated when the format can be blitted
+        if (mipLevels == 1 && canGenerateMipmaps(physicalDevice, format))
+        {
+            mipLevels = mipLevelCount(texels.levels[0].width, texels.levels[0].height);
+        }
 
-        createImage(
+        createTextureImage(
             device,
-            physicalDevice,
-            texWidth,
-            texHeight,
-            VK_FORMAT_R8G8B8A8_SRGB,
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            allocator,
+            texels.data.data(),
+            texels.format,
+            texels.levels,
+            mipLevels,
             textureImage,
-            textureImageMemory
+            textureAllocation,
+            uploads
         );
+    }
 
-        transitionImageLayout(
+    void createTextureImage(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        const std::filesystem::path &path,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        VkFormat &format,
+        std::uint32_t &mipLevels,
+        Upload::Context &uploads
+    )
+    {
+        const Ktx::TextureData texels = decodeTexture(path, physicalDevice);
+        createTextureImage(
             device,
-            commandPool,
-            graphicsQueue,
+            physicalDevice,
+            allocator,
+            texels,
             textureImage,
-            VK_FORMAT_R8G8B8A8_SRGB,
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+            textureAllocation,
+            format,
+            mipLevels,
+            uploads
         );
+    }
 
-        copyBufferToImage(
+    void createTextureImage(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *pixels,
+        std::uint32_t width,
+        std::uint32_t height,
+        VkFormat format,
+        std::uint32_t mipLevels,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        Upload::Context &uploads
+    )
+    {
+        const VkDeviceSize imageSize = levelSize(format, width, height);
+        if (imageSize == 0)
+        {
+            throw std::runtime_error("unsupported texture format!");
+        }
+        const Upload::ImageLevel level{0, imageSize, width, height};
+        createTextureImage(
             device,
-            commandPool,
-            graphicsQueue,
-            stagingBuffer,
+            allocator,
+            pixels,
+            format,
+            std::span(&level, 1),
+            mipLevels,
             textureImage,
-            static_cast<std::uint32_t>(texWidth),
-            static_cast<std::uint32_t>(texHeight)
+            textureAllocation,
+            uploads
         );
+    }
 
-        transitionImageLayout(
+    void createTextureImage(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const void *data,
+        VkFormat format,
+        std::span<const Upload::ImageLevel> levels,
+        std::uint32_t mipLevels,
+        VkImage &textureImage,
+        Memory::Allocation &textureAllocation,
+        Upload::Context &uploads
+    )
+    {
+        mipLevels = std::max(mipLevels, static_cast<std::uint32_t>(levels.size()));
+
+        /// Generated levels are blitted from the ones above them
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (mipLevels > levels.size())
+        {
+            usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
+
+        createImage(
             device,
-            commandPool,
-            graphicsQueue,
+            allocator,
+            levels[0].width,
+            levels[0].height,
+            format,
+            VK_IMAGE_TILING_OPTIMAL,
+            usage,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             textureImage,
-            VK_FORMAT_R8G8B8A8_SRGB,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            textureAllocation,
+            mipLevels,
+            Memory::Category::Texture
         );
 
-        vkDestroyBuffer(device, stagingBuffer, nullptr);
-        vkFreeMemory(device, stagingBufferMemory, nullptr);
+        Upload::uploadImage(uploads, data, textureImage, format, levels, mipLevels);
+    }
+
+    VkExtent2D blockExtent(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return {4, 4};
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+            return {5, 5};
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+            return {6, 6};
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            return {8, 8};
+        default:
+            return {1, 1};
+        }
+    }
+
+    std::uint32_t blockBytes(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_SRGB:
+            return 1;
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R8G8_SRGB:
+            return 2;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            return 4;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+        case VK_FORMAT_BC4_SNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11_SNORM_BLOCK:
+            return 8;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC5_SNORM_BLOCK:
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+        case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        case VK_FORMAT_EAC_R11G11_UNORM_BLOCK:
+        case VK_FORMAT_EAC_R11G11_SNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_5x5_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_5x5_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_6x6_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_6x6_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_8x8_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_8x8_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    VkDeviceSize levelSize(VkFormat format, std::uint32_t width, std::uint32_t height)
+    {
+        const VkExtent2D block = blockExtent(format);
+        const VkDeviceSize columns = (width + block.width - 1) / block.width;
+        const VkDeviceSize rows = (height + block.height - 1) / block.height;
+        return columns * rows * blockBytes(format);
+    }
+
+    std::uint32_t mipLevelCount(std::uint32_t width, std::uint32_t height)
+    {
+        return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    bool canGenerateMipmaps(VkPhysicalDevice physicalDevice, VkFormat format)
+    {
+        const VkExtent2D block = blockExtent(format);
+        if (block.width != 1 || block.height != 1)
+        {
+            return false;
+        }
+
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+
+        const VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT
+                                              | VK_FORMAT_FEATURE_BLIT_DST_BIT
+                                              | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        return (properties.optimalTilingFeatures & required) == required;
+    }
+
+    void generateMipmaps(
+        VkCommandBuffer commandBuffer,
+        VkImage image,
+        VkFormat format,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t baseLevel,
+        std::uint32_t mipLevels
+    )
+    {
+        /// Levels above the base were uploaded as they are
+        if (baseLevel > 0)
+        {
+            transitionImageLayout(
+                commandBuffer,
+                image,
+                format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                baseLevel
+            );
+        }
+
+        auto srcWidth = static_cast<std::int32_t>(width);
+        auto srcHeight = static_cast<std::int32_t>(height);
+
+        for (std::uint32_t level = baseLevel + 1; level < mipLevels; level++)
+        {
+            const std::int32_t dstWidth = std::max(srcWidth / 2, 1);
+            const std::int32_t dstHeight = std::max(srcHeight / 2, 1);
+
+            transitionImageLayout(
+                commandBuffer,
+                image,
+                format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                1,
+                level - 1
+            );
+
+            VkImageBlit blit{};
+            blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1};
+            blit.srcOffsets[1] = {srcWidth, srcHeight, 1};
+            blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            blit.dstOffsets[1] = {dstWidth, dstHeight, 1};
+
+            vkCmdBlitImage(
+                commandBuffer,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &blit,
+                VK_FILTER_LINEAR
+            );
+
+            /// The source level is final once the blit reading it has run
+            transitionImageLayout(
+                commandBuffer,
+                image,
+                format,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                1,
+                level - 1
+            );
+
+            srcWidth = dstWidth;
+            srcHeight = dstHeight;
+        }
+
+        transitionImageLayout(
+            commandBuffer,
+            image,
+            format,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            1,
+            mipLevels - 1
+        );
     }
 
     void createImage(
         VkDevice &device,
-        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
         std::uint32_t width,
         std::uint32_t height,
         VkFormat format,
@@ -110,7 +413,9 @@ namespace Image
         VkImageUsageFlags usage,
         VkMemoryPropertyFlags properties,
         VkImage &image,
-        VkDeviceMemory &imageMemory
+        Memory::Allocation &imageAllocation,
+        std::uint32_t mipLevels,
+        Memory::Category category
     )
     {
         VkImageCreateInfo imageInfo{};
@@ -119,7 +424,7 @@ namespace Image
         imageInfo.extent.width = static_cast<std::uint32_t>(width);
         imageInfo.extent.height = static_cast<std::uint32_t>(height);
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = mipLevels;
         imageInfo.arrayLayers = 1;
         imageInfo.format = format;
         imageInfo.tiling = tiling;
@@ -137,33 +442,48 @@ namespace Image
         VkMemoryRequirements memRequirements;
         vkGetImageMemoryRequirements(device, image, &memRequirements);
 
-        VkMemoryAllocateInfo allocInfo{};
-        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        allocInfo.allocationSize = memRequirements.size;
-        allocInfo.memoryTypeIndex = Buffer::
-            findMemoryType(physicalDevice, memRequirements.memoryTypeBits, properties);
+        const Memory::ResourceKind kind = tiling == VK_IMAGE_TILING_OPTIMAL
+                                              ? Memory::ResourceKind::Optimal
+                                              : Memory::ResourceKind::Linear;
 
-        if (vkAllocateMemory(device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+        try
+        {
+            Memory::allocateMemory(
+                allocator, memRequirements, properties, kind, imageAllocation, category
+            );
+        }
+        catch (...)
         {
             vkDestroyImage(device, image, nullptr);
-            throw std::runtime_error("failed to allocate image memory!");
+            image = VK_NULL_HANDLE;
+            throw;
         }
 
-        vkBindImageMemory(device, image, imageMemory, 0);
+        vkBindImageMemory(device, image, imageAllocation.memory, imageAllocation.offset);
     }
 
-    void transitionImageLayout(
+    void destroyImage(
         VkDevice &device,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue,
+        Memory::Allocator &allocator,
+        VkImage &image,
+        Memory::Allocation &imageAllocation
+    )
+    {
+        vkDestroyImage(device, image, nullptr);
+        Memory::freeAllocation(allocator, imageAllocation);
+        image = VK_NULL_HANDLE;
+    }
+
+    void transitionImageLayout(
+        VkCommandBuffer commandBuffer,
         VkImage image,
         VkFormat format,
         VkImageLayout oldLayout,
-        VkImageLayout newLayout
+        VkImageLayout newLayout,
+        std::uint32_t levelCount,
+        std::uint32_t baseMipLevel
     )
     {
-        VkCommandBuffer commandBuffer = Command::beginSingleTimeCommands(device, commandPool);
-
         VkImageMemoryBarrier barrier{};
         barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
         barrier.oldLayout = oldLayout;
@@ -172,8 +492,8 @@ namespace Image
         barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.image = image;
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
 
@@ -198,6 +518,24 @@ namespace Image
             sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
             destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
         }
+        else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                 && newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+        {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        }
+        else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                 && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+        {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+            sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        }
         else
         {
             throw std::invalid_argument("unsupported layout transition!");
@@ -206,28 +544,24 @@ namespace Image
         vkCmdPipelineBarrier(
             commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier
         );
-
-        Command::endSingleTimeCommands(device, commandPool, commandBuffer, graphicsQueue);
     }
 
     void copyBufferToImage(
-        VkDevice &device,
-        VkCommandPool &commandPool,
-        VkQueue &graphicsQueue,
+        VkCommandBuffer commandBuffer,
         VkBuffer buffer,
         VkImage image,
         uint32_t width,
-        uint32_t height
+        uint32_t height,
+        std::uint32_t mipLevel,
+        VkDeviceSize bufferOffset
     )
     {
-        VkCommandBuffer commandBuffer = Command::beginSingleTimeCommands(device, commandPool);
-
         VkBufferImageCopy region{};
-        region.bufferOffset = 0;
+        region.bufferOffset = bufferOffset;
         region.bufferRowLength = 0;
         region.bufferImageHeight = 0;
         region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.mipLevel = mipLevel;
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount = 1;
         region.imageOffset = {0, 0, 0};
@@ -236,8 +570,6 @@ namespace Image
         vkCmdCopyBufferToImage(
             commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region
         );
-
-        Command::endSingleTimeCommands(device, commandPool, commandBuffer, graphicsQueue);
     }
 
 } // namespace Image
\ No newline at end of file
@@ -5,16 +5,22 @@
 namespace ImageViews
 {
 
-    VkImageView createImageView(VkDevice &device, VkImage &textureImage, VkFormat format)
+    VkImageView createImageView(
+        VkDevice &device,
+        VkImage &textureImage,
+        VkFormat format,
+        std::uint32_t mipLevels,
+        VkImageAspectFlags aspect
+    )
     {
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
         viewInfo.image = textureImage;
         viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
         viewInfo.format = format;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.aspectMask = aspect;
         viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.levelCount = mipLevels;
         viewInfo.subresourceRange.baseArrayLayer = 0;
         viewInfo.subresourceRange.layerCount = 1;
 
@@ -43,10 +49,15 @@ namespace ImageViews
         }
     }
 
-    void
-    createTextureImageView(VkDevice &device, VkImage &textureImage, VkImageView &textureImageView)
+    void createTextureImageView(
+        VkDevice &device,
+        VkImage &textureImage,
+        VkImageView &textureImageView,
+        VkFormat format,
+        std::uint32_t mipLevels
+    )
     {
-        textureImageView = createImageView(device, textureImage, VK_FORMAT_R8G8B8A8_SRGB);
+        textureImageView = createImageView(device, textureImage, format, mipLevels);
     }
 
 } // namespace ImageViews
\ No newline at end of file
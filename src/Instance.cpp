@@ -1,13 +1,32 @@
 #include "Instance.hpp"
 
 #include <GLFW/glfw3.h>
+#include <cstring>
 #include <stdexcept>
+#include <vector>
 
 #include "ValidationLayers.hpp"
 
 namespace Instance
 {
-    void createInstance(VkInstance &instance)
+    bool supportsDebugUtils()
+    {
+        std::uint32_t extensionCount = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensions.data());
+
+        for (const VkExtensionProperties &extension : extensions)
+        {
+            if (std::strcmp(extension.extensionName, VK_EXT_DEBUG_UTILS_EXTENSION_NAME) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void createInstance(VkInstance &instance, bool debugUtils, bool surfaceExtensions)
     {
         if (ValidationLayers::enableValidationLayers
             && !ValidationLayers::checkValidationLayerSupport())
@@ -23,14 +42,23 @@ namespace Instance
         appInfo.engineVersion = engineVersion;
         appInfo.apiVersion = apiVersion;
 
-        uint32_t extensionCount = 0;
-        const char **extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+        std::vector<const char *> extensions;
+        if (surfaceExtensions)
+        {
+            uint32_t extensionCount = 0;
+            const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+            extensions.assign(glfwExtensions, glfwExtensions + extensionCount);
+        }
+        if (debugUtils)
+        {
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
 
         VkInstanceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
         createInfo.pApplicationInfo = &appInfo;
-        createInfo.enabledExtensionCount = extensionCount;
-        createInfo.ppEnabledExtensionNames = extensions;
+        createInfo.enabledExtensionCount = static_cast<std::uint32_t>(extensions.size());
+        createInfo.ppEnabledExtensionNames = extensions.data();
 
         if (ValidationLayers::enableValidationLayers)
         {
@@ -0,0 +1,220 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace Jobs
+{
+    namespace
+    {
+        /// Claim and run jobs of the current dispatch until none are left (lock held on entry)
+        void runJobs(JobSystem &jobs, std::uint32_t workerIndex, std::unique_lock<std::mutex> &lock)
+        {
+            while (jobs.nextJob < jobs.jobCount)
+            {
+                const std::uint32_t jobIndex = jobs.nextJob++;
+                const JobFunction &job = *jobs.job;
+
+                lock.unlock();
+                std::exception_ptr error;
+                try
+                {
+                    job(jobIndex, workerIndex);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                lock.lock();
+
+                if (error && !jobs.error)
+                {
+                    jobs.error = error;
+                }
+                if (--jobs.pendingJobs == 0)
+                {
+                    jobs.finished.notify_all();
+                }
+            }
+        }
+
+        void workerLoop(JobSystem &jobs, std::uint32_t workerIndex)
+        {
+            std::unique_lock<std::mutex> lock(jobs.mutex);
+            while (true)
+            {
+                jobs.wake.wait(
+                    lock, [&jobs] { return jobs.stopping || jobs.nextJob < jobs.jobCount; }
+                );
+                if (jobs.stopping)
+                {
+                    return;
+                }
+                runJobs(jobs, workerIndex, lock);
+            }
+        }
+    } // namespace
+
+    void createJobSystem(JobSystem &jobs, std::uint32_t workerCount)
+    {
+        if (workerCount == 0)
+        {
+            workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        jobs.workers.reserve(workerCount);
+        for (std::uint32_t i = 0; i < workerCount; i++)
+        {
+            jobs.workers.emplace_back(workerLoop, std::ref(jobs), i + 1);
+        }
+    }
+
+    void destroyJobSystem(JobSystem &jobs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(jobs.mutex);
+            jobs.stopping = true;
+        }
+        jobs.wake.notify_all();
+
+        for (auto &worker : jobs.workers)
+        {
+            worker.join();
+        }
+        jobs.workers.clear();
+    }
+
+    std::uint32_t threadCount(const JobSystem &jobs)
+    {
+        return static_cast<std::uint32_t>(jobs.workers.size()) + 1;
+    }
+
+    void dispatch(JobSystem &jobs, std::uint32_t jobCount, const JobFunction &job)
+    {
+        if (jobCount == 0)
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(jobs.mutex);
+        jobs.job = &job;
+        jobs.jobCount = jobCount;
+        jobs.nextJob = 0;
+        jobs.pendingJobs = jobCount;
+        jobs.error = nullptr;
+        jobs.generation++;
+        jobs.wake.notify_all();
+
+        /// The dispatching thread works too instead of sleeping
+        runJobs(jobs, 0, lock);
+        jobs.finished.wait(lock, [&jobs] { return jobs.pendingJobs == 0; });
+
+        jobs.job = nullptr;
+        jobs.jobCount = 0;
+        jobs.nextJob = 0;
+
+        if (jobs.error)
+        {
+            std::rethrow_exception(std::exchange(jobs.error, nullptr));
+        }
+    }
+
+    TaskId addTask(
+        TaskGraph &graph,
+        const char *name,
+        const std::vector<TaskId> &dependencies,
+        std::function<void()> body
+    )
+    {
+        const auto id = static_cast<TaskId>(graph.tasks.size());
+        for (TaskId dependency : dependencies)
+        {
+            if (dependency >= id)
+            {
+                throw std::invalid_argument("task dependency is not in the graph yet");
+            }
+            graph.tasks[dependency].dependents.push_back(id);
+        }
+
+        Task &task = graph.tasks.emplace_back();
+        task.name = name;
+        task.body = std::move(body);
+        task.pendingDependencies = static_cast<std::uint32_t>(dependencies.size());
+        return id;
+    }
+
+    void runGraph(JobSystem &jobs, TaskGraph &graph)
+    {
+        {
+            std::lock_guard<std::mutex> lock(graph.mutex);
+            graph.remaining = static_cast<std::uint32_t>(graph.tasks.size());
+            graph.failed = false;
+            graph.readyTasks.clear();
+            for (TaskId id = 0; id < graph.tasks.size(); id++)
+            {
+                if (graph.tasks[id].pendingDependencies == 0)
+                {
+                    graph.readyTasks.push_back(id);
+                }
+            }
+        }
+
+        /// One job per thread, each taking ready tasks until the graph is done; the task list
+        /// is not resized while running, so tasks are used outside the lock
+        dispatch(
+            jobs,
+            threadCount(jobs),
+            [&graph](std::uint32_t, std::uint32_t workerIndex)
+            {
+                std::unique_lock<std::mutex> lock(graph.mutex);
+                while (true)
+                {
+                    graph.wake.wait(
+                        lock,
+                        [&graph]
+                        {
+                            return graph.failed || graph.remaining == 0
+                                   || !graph.readyTasks.empty();
+                        }
+                    );
+                    if (graph.failed || graph.remaining == 0)
+                    {
+                        return;
+                    }
+
+                    Task &task = graph.tasks[graph.readyTasks.front()];
+                    graph.readyTasks.pop_front();
+                    lock.unlock();
+
+                    task.workerIndex = workerIndex;
+                    task.begin = std::chrono::steady_clock::now();
+                    try
+                    {
+                        task.body();
+                    }
+                    catch (...)
+                    {
+                        /// dispatch rethrows it on the calling thread
+                        lock.lock();
+                        graph.failed = true;
+                        graph.wake.notify_all();
+                        throw;
+                    }
+                    task.end = std::chrono::steady_clock::now();
+
+                    lock.lock();
+                    graph.remaining--;
+                    for (TaskId dependent : task.dependents)
+                    {
+                        if (--graph.tasks[dependent].pendingDependencies == 0)
+                        {
+                            graph.readyTasks.push_back(dependent);
+                        }
+                    }
+                    graph.wake.notify_all();
+                }
+            }
+        );
+    }
+} // namespace Jobs
@@ -0,0 +1,351 @@
+#include "Ktx.hpp"
+#include "helper.hpp"
+
+#include <basisu_transcoder.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace Ktx
+{
+    namespace
+    {
+        constexpr std::array<std::uint8_t, 12> KTX2_IDENTIFIER = {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        /// supercompressionScheme values
+        constexpr std::uint32_t SUPERCOMPRESSION_NONE = 0;
+        constexpr std::uint32_t SUPERCOMPRESSION_BASIS_LZ = 1;
+        constexpr std::uint32_t SUPERCOMPRESSION_ZSTD = 2;
+
+        /// Data format descriptor transfer function of sRGB-encoded colour
+        constexpr std::uint32_t KHR_DF_TRANSFER_SRGB = 2;
+
+        /// File header up to the level index
+        struct Header
+        {
+            std::uint8_t identifier[12];
+            std::uint32_t vkFormat;
+            std::uint32_t typeSize;
+            std::uint32_t pixelWidth;
+            std::uint32_t pixelHeight;
+            std::uint32_t pixelDepth;
+            std::uint32_t layerCount;
+            std::uint32_t faceCount;
+            std::uint32_t levelCount;
+            std::uint32_t supercompressionScheme;
+            std::uint32_t dfdByteOffset;
+            std::uint32_t dfdByteLength;
+            std::uint32_t kvdByteOffset;
+            std::uint32_t kvdByteLength;
+            std::uint64_t sgdByteOffset;
+            std::uint64_t sgdByteLength;
+        };
+
+        struct LevelIndex
+        {
+            std::uint64_t byteOffset;
+            std::uint64_t byteLength;
+            std::uint64_t uncompressedByteLength;
+        };
+
+        static_assert(sizeof(Header) == 80 && sizeof(LevelIndex) == 24, "KTX2 layout");
+
+        using Format = basist::transcoder_texture_format;
+
+        /// Basis transcode target and the Vulkan formats it is uploaded as
+        struct Target
+        {
+            Format basis;
+            VkFormat unorm;
+            VkFormat srgb;
+        };
+
+        bool canSample(VkPhysicalDevice physicalDevice, VkFormat format)
+        {
+            VkFormatProperties properties{};
+            vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &properties);
+            return (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+        }
+
+        /// Mip extent, never below one texel
+        std::uint32_t mipExtent(std::uint32_t extent, std::uint32_t level)
+        {
+            return std::max(extent >> level, 1u);
+        }
+
+        /// Best transcode target the device samples, preferring BCn, then ASTC, then ETC2
+        std::pair<Format, VkFormat> selectTarget(
+            VkPhysicalDevice physicalDevice, bool etc1s, bool alpha, bool srgb, Usage usage
+        )
+        {
+            std::vector<Target> targets;
+            if (usage == Usage::Normal)
+            {
+                targets = {
+                    {Format::cTFBC5_RG, VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_BC5_UNORM_BLOCK},
+                    {Format::cTFASTC_4x4_RGBA,
+                     VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+                     VK_FORMAT_ASTC_4x4_UNORM_BLOCK},
+                    {Format::cTFETC2_EAC_RG11,
+                     VK_FORMAT_EAC_R11G11_UNORM_BLOCK,
+                     VK_FORMAT_EAC_R11G11_UNORM_BLOCK},
+                };
+                srgb = false;
+            }
+            else
+            {
+                if (etc1s && !alpha)
+                {
+                    targets.push_back(
+                        {Format::cTFBC1_RGB,
+                         VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+                         VK_FORMAT_BC1_RGB_SRGB_BLOCK}
+                    );
+                }
+                targets.push_back(
+                    {Format::cTFBC7_RGBA, VK_FORMAT_BC7_UNORM_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK}
+                );
+                targets.push_back(
+                    {Format::cTFASTC_4x4_RGBA,
+                     VK_FORMAT_ASTC_4x4_UNORM_BLOCK,
+                     VK_FORMAT_ASTC_4x4_SRGB_BLOCK}
+                );
+                if (alpha)
+                {
+                    targets.push_back(
+                        {Format::cTFETC2_RGBA,
+                         VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+                         VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK}
+                    );
+                }
+                else
+                {
+                    targets.push_back(
+                        {Format::cTFETC1_RGB,
+                         VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+                         VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK}
+                    );
+                }
+            }
+
+            for (const Target &target : targets)
+            {
+                const VkFormat format = srgb ? target.srgb : target.unorm;
+                if (canSample(physicalDevice, format))
+                {
+                    return {target.basis, format};
+                }
+            }
+
+            /// Every device samples RGBA8, at four to eight times the memory
+            return {Format::cTFRGBA32, srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM};
+        }
+
+        /// Levels stored in a Vulkan format; only Zstandard supercompression is undone
+        TextureData loadNative(
+            VkPhysicalDevice physicalDevice,
+            std::span<const std::byte> file,
+            const Header &header,
+            std::span<const LevelIndex> index
+        )
+        {
+            TextureData texture;
+            texture.format = static_cast<VkFormat>(header.vkFormat);
+            if (!canSample(physicalDevice, texture.format))
+            {
+                throw std::runtime_error("texture format not supported by the device!");
+            }
+
+            if (header.supercompressionScheme != SUPERCOMPRESSION_NONE
+                && header.supercompressionScheme != SUPERCOMPRESSION_ZSTD)
+            {
+                throw std::runtime_error("unsupported KTX2 supercompression!");
+            }
+            const bool inflate = header.supercompressionScheme == SUPERCOMPRESSION_ZSTD;
+
+            VkDeviceSize storageSize = 0;
+            for (std::uint32_t level = 0; level < index.size(); level++)
+            {
+                const LevelIndex &entry = index[level];
+                Upload::ImageLevel &out = texture.levels.emplace_back();
+                out.offset = inflate ? storageSize : entry.byteOffset;
+                out.size = inflate ? entry.uncompressedByteLength : entry.byteLength;
+                out.width = mipExtent(header.pixelWidth, level);
+                out.height = mipExtent(header.pixelHeight, level);
+                storageSize += inflate ? entry.uncompressedByteLength : 0;
+            }
+
+            if (!inflate)
+            {
+                texture.data = file;
+                return texture;
+            }
+
+            texture.storage.resize(storageSize);
+            for (std::uint32_t level = 0; level < index.size(); level++)
+            {
+                const LevelIndex &entry = index[level];
+                const std::size_t written = ZSTD_decompress(
+                    texture.storage.data() + texture.levels[level].offset,
+                    entry.uncompressedByteLength,
+                    file.data() + entry.byteOffset,
+                    entry.byteLength
+                );
+                if (ZSTD_isError(written) || written != entry.uncompressedByteLength)
+                {
+                    throw std::runtime_error("failed to inflate KTX2 level!");
+                }
+            }
+            texture.data = texture.storage;
+            return texture;
+        }
+
+        /// ETC1S or UASTC levels transcoded for the device
+        TextureData transcode(
+            VkPhysicalDevice physicalDevice, std::span<const std::byte> file, Usage usage
+        )
+        {
+            static std::once_flag initialised;
+            std::call_once(initialised, [] { basist::basisu_transcoder_init(); });
+
+            basist::ktx2_transcoder transcoder;
+            if (!transcoder.init(file.data(), static_cast<std::uint32_t>(file.size()))
+                || !transcoder.start_transcoding())
+            {
+                throw std::runtime_error("failed to read Basis Universal texture!");
+            }
+
+            const bool srgb = transcoder.get_dfd_transfer_func() == KHR_DF_TRANSFER_SRGB;
+            const auto [target, format] = selectTarget(
+                physicalDevice, transcoder.is_etc1s(), transcoder.get_has_alpha(), srgb, usage
+            );
+
+            TextureData texture;
+            texture.format = format;
+
+            const bool uncompressed = basist::basis_transcoder_format_is_uncompressed(target);
+            const std::uint32_t unitBytes = basist::basis_get_bytes_per_block_or_pixel(target);
+            const std::uint32_t levelCount = std::max(transcoder.get_levels(), 1u);
+
+            /// Size every level first so the transcodes write into one allocation
+            std::vector<std::uint32_t> units(levelCount);
+            VkDeviceSize storageSize = 0;
+            for (std::uint32_t level = 0; level < levelCount; level++)
+            {
+                basist::ktx2_image_level_info info;
+                if (!transcoder.get_image_level_info(info, level, 0, 0))
+                {
+                    throw std::runtime_error("failed to read Basis Universal texture!");
+                }
+                units[level] = uncompressed ? info.m_orig_width * info.m_orig_height
+                                            : info.m_total_blocks;
+
+                Upload::ImageLevel &out = texture.levels.emplace_back();
+                out.offset = storageSize;
+                out.size = static_cast<VkDeviceSize>(units[level]) * unitBytes;
+                out.width = info.m_orig_width;
+                out.height = info.m_orig_height;
+                storageSize += out.size;
+            }
+
+            texture.storage.resize(storageSize);
+            for (std::uint32_t level = 0; level < levelCount; level++)
+            {
+                if (!transcoder.transcode_image_level(
+                        level,
+                        0,
+                        0,
+                        texture.storage.data() + texture.levels[level].offset,
+                        units[level],
+                        target
+                    ))
+                {
+                    throw std::runtime_error("failed to transcode Basis Universal texture!");
+                }
+            }
+            texture.data = texture.storage;
+            return texture;
+        }
+    } // namespace
+
+    bool isKtx2(std::span<const std::byte> file)
+    {
+        return file.size() >= KTX2_IDENTIFIER.size()
+               && std::memcmp(file.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) == 0;
+    }
+
+    VkFormat selectTranscodeFormat(
+        VkPhysicalDevice physicalDevice, bool etc1s, bool alpha, bool srgb, Usage usage
+    )
+    {
+        return selectTarget(physicalDevice, etc1s, alpha, srgb, usage).second;
+    }
+
+    TextureData loadKtx2(
+        VkPhysicalDevice physicalDevice, std::span<const std::byte> file, Usage usage
+    )
+    {
+        if (!isKtx2(file) || file.size() < sizeof(Header))
+        {
+            throw std::runtime_error("file is not KTX2!");
+        }
+
+        Header header;
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1
+            || header.pixelWidth == 0 || header.pixelHeight == 0)
+        {
+            throw std::runtime_error("only single 2D KTX2 textures are supported!");
+        }
+
+        if (header.vkFormat == VK_FORMAT_UNDEFINED
+            || header.supercompressionScheme == SUPERCOMPRESSION_BASIS_LZ)
+        {
+            return transcode(physicalDevice, file, usage);
+        }
+
+        /// Level index follows the header; every level must lie inside the file
+        const std::uint32_t levelCount = std::max(header.levelCount, 1u);
+        const std::size_t indexOffset = sizeof(Header);
+        if (file.size() < indexOffset + levelCount * sizeof(LevelIndex))
+        {
+            throw std::runtime_error("truncated KTX2 file!");
+        }
+
+        std::vector<LevelIndex> index(levelCount);
+        std::memcpy(index.data(), file.data() + indexOffset, levelCount * sizeof(LevelIndex));
+        for (const LevelIndex &entry : index)
+        {
+            if (entry.byteOffset > file.size() || entry.byteLength > file.size() - entry.byteOffset)
+            {
+                throw std::runtime_error("truncated KTX2 file!");
+            }
+        }
+
+        return loadNative(physicalDevice, file, header, index);
+    }
+
+    TextureData loadKtx2(
+        VkPhysicalDevice physicalDevice, const std::filesystem::path &path, Usage usage
+    )
+    {
+        std::vector<std::byte> file = Helper::readFile(path);
+        TextureData texture = loadKtx2(physicalDevice, std::span<const std::byte>(file), usage);
+
+        /// Untranscoded levels still point into the file: keep it alive with the result
+        if (texture.data.data() == file.data())
+        {
+            texture.storage = std::move(file);
+            texture.data = texture.storage;
+        }
+        return texture;
+    }
+} // namespace Ktx
@@ -0,0 +1,262 @@
+#include "Loader.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <utility>
+
+namespace Loader
+{
+    namespace
+    {
+        void destroyResource(Loader &loader, Resource &resource)
+        {
+            if (resource.buffer != VK_NULL_HANDLE)
+            {
+                Buffer::destroyBuffer(
+                    loader.device, *loader.allocator, resource.buffer, resource.allocation
+                );
+            }
+            if (resource.image != VK_NULL_HANDLE)
+            {
+                Image::destroyImage(
+                    loader.device, *loader.allocator, resource.image, resource.allocation
+                );
+            }
+        }
+
+        /// Create the resource and record its upload into the loader's current batch
+        void record(Loader &loader, Request &request)
+        {
+            Resource &resource = request.resource;
+            if (request.kind == RequestKind::Buffer)
+            {
+                Buffer::createDeviceBuffer(
+                    loader.device,
+                    *loader.allocator,
+                    request.data.data(),
+                    request.data.size(),
+                    request.usage,
+                    request.dstStage,
+                    request.dstAccess,
+                    resource.buffer,
+                    resource.allocation,
+                    loader.uploads,
+                    request.category
+                );
+            }
+            else
+            {
+                Image::createTextureImage(
+                    loader.device,
+                    loader.physicalDevice,
+                    *loader.allocator,
+                    request.texels,
+                    resource.image,
+                    resource.allocation,
+                    resource.format,
+                    resource.mipLevels,
+                    loader.uploads
+                );
+            }
+
+            /// The sources are in staging memory now; no need to hold them while uploading
+            request.data = {};
+            request.texels = Ktx::TextureData{};
+        }
+
+        /// Hand out the resources whose batch has retired, in the order they were queued
+        void resolve(Loader &loader)
+        {
+            std::erase_if(
+                loader.inFlight,
+                [&loader](std::unique_ptr<Request> &request)
+                {
+                    if (!Upload::isComplete(loader.uploads, request->ticket))
+                    {
+                        return false;
+                    }
+                    request->promise.set_value(std::move(request->resource));
+                    return true;
+                }
+            );
+        }
+
+        void run(Loader &loader)
+        {
+            while (true)
+            {
+                /// Read before taking: a push after the take wakes the wait below
+                const std::uint32_t seen = loader.requests.pushes.load(std::memory_order_acquire);
+
+                std::vector<std::unique_ptr<Request>> recorded;
+                for (std::unique_ptr<Request> &request : take(loader.requests))
+                {
+                    if (request->kind == RequestKind::Release)
+                    {
+                        destroyResource(loader, request->resource);
+                        continue;
+                    }
+
+                    try
+                    {
+                        record(loader, *request);
+                        recorded.push_back(std::move(request));
+                    }
+                    catch (...)
+                    {
+                        destroyResource(loader, request->resource);
+                        request->promise.set_exception(std::current_exception());
+                    }
+                }
+
+                /// One batch for everything taken. Batches a full staging ring forced out went
+                /// to the same queues before it, so its fence covers their copies as well.
+                if (!recorded.empty())
+                {
+                    const std::uint64_t ticket = Upload::submit(loader.uploads);
+                    Submit::flush(*loader.batcher);
+                    for (std::unique_ptr<Request> &request : recorded)
+                    {
+                        request->ticket = ticket;
+                        loader.inFlight.push_back(std::move(request));
+                    }
+                }
+
+                resolve(loader);
+
+                if (!loader.inFlight.empty())
+                {
+                    std::this_thread::sleep_for(POLL_INTERVAL);
+                    continue;
+                }
+                if (loader.stopping.load(std::memory_order_acquire)
+                    && loader.requests.head.load(std::memory_order_acquire) == nullptr)
+                {
+                    return;
+                }
+                loader.requests.pushes.wait(seen, std::memory_order_acquire);
+            }
+        }
+    } // namespace
+
+    void push(RequestQueue &queue, std::unique_ptr<Request> request)
+    {
+        Request *node = request.release();
+        node->next = queue.head.load(std::memory_order_relaxed);
+        while (!queue.head.compare_exchange_weak(
+            node->next, node, std::memory_order_release, std::memory_order_relaxed
+        ))
+        {
+        }
+
+        queue.pushes.fetch_add(1, std::memory_order_release);
+        queue.pushes.notify_one();
+    }
+
+    std::vector<std::unique_ptr<Request>> take(RequestQueue &queue)
+    {
+        Request *node = queue.head.exchange(nullptr, std::memory_order_acquire);
+
+        /// The stack holds the newest request first
+        std::vector<std::unique_ptr<Request>> requests;
+        while (node != nullptr)
+        {
+            Request *next = node->next;
+            requests.emplace_back(node);
+            node = next;
+        }
+        std::reverse(requests.begin(), requests.end());
+        return requests;
+    }
+
+    void createLoader(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        VkQueue &graphicsQueue,
+        VkQueue &transferQueue,
+        Submit::Batcher &batcher,
+        Memory::Allocator &allocator,
+        Loader &loader
+    )
+    {
+        loader.device = device;
+        loader.physicalDevice = physicalDevice;
+        loader.batcher = &batcher;
+        loader.allocator = &allocator;
+
+        Upload::createContext(
+            device,
+            physicalDevice,
+            surface,
+            allocator,
+            graphicsQueue,
+            transferQueue,
+            batcher,
+            loader.uploads
+        );
+
+        loader.stopping = false;
+        loader.thread = std::thread(run, std::ref(loader));
+    }
+
+    void destroyLoader(Loader &loader)
+    {
+        if (loader.thread.joinable())
+        {
+            loader.stopping.store(true, std::memory_order_release);
+            loader.requests.pushes.fetch_add(1, std::memory_order_release);
+            loader.requests.pushes.notify_all();
+            loader.thread.join();
+        }
+
+        Upload::destroyContext(loader.uploads);
+    }
+
+    std::future<Resource> loadBuffer(
+        Loader &loader,
+        const void *data,
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess,
+        Memory::Category category
+    )
+    {
+        auto request = std::make_unique<Request>();
+        request->kind = RequestKind::Buffer;
+        request->data.resize(static_cast<std::size_t>(size));
+        std::memcpy(request->data.data(), data, request->data.size());
+        request->usage = usage;
+        request->dstStage = dstStage;
+        request->dstAccess = dstAccess;
+        request->category = category;
+
+        std::future<Resource> future = request->promise.get_future();
+        push(loader.requests, std::move(request));
+        return future;
+    }
+
+    std::future<Resource> loadTexture(Loader &loader, Ktx::TextureData texels)
+    {
+        auto request = std::make_unique<Request>();
+        request->kind = RequestKind::Texture;
+        request->texels = std::move(texels);
+
+        std::future<Resource> future = request->promise.get_future();
+        push(loader.requests, std::move(request));
+        return future;
+    }
+
+    void release(Loader &loader, Resource resource)
+    {
+        auto request = std::make_unique<Request>();
+        request->kind = RequestKind::Release;
+        request->resource = std::move(resource);
+        push(loader.requests, std::move(request));
+    }
+} // namespace Loader
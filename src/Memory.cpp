@@ -0,0 +1,579 @@
+#include "Memory.hpp"
+#include "Buffer.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+namespace Memory
+{
+    namespace
+    {
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        /// Linear and optimal resources may not share a bufferImageGranularity page
+        bool conflicts(ResourceKind a, ResourceKind b)
+        {
+            return (a == ResourceKind::Linear && b == ResourceKind::Optimal)
+                   || (a == ResourceKind::Optimal && b == ResourceKind::Linear);
+        }
+
+        bool samePage(VkDeviceSize a, VkDeviceSize b, VkDeviceSize pageSize)
+        {
+            return (a & ~(pageSize - 1)) == (b & ~(pageSize - 1));
+        }
+
+        CategoryStats &categoryStats(Allocator &allocator, Category category)
+        {
+            return allocator.categories[static_cast<std::size_t>(category)];
+        }
+
+        /// Bytes as MiB with one decimal, the unit every report line uses
+        double mebibytes(VkDeviceSize bytes)
+        {
+            return static_cast<double>(bytes) / (1024.0 * 1024.0);
+        }
+
+        Block *createBlock(
+            Allocator &allocator,
+            std::uint32_t memoryType,
+            VkDeviceSize size,
+            Strategy strategy,
+            bool dedicated
+        )
+        {
+            if (allocator.deviceAllocationCount >= allocator.maxDeviceAllocationCount)
+            {
+                throw std::runtime_error("maxMemoryAllocationCount reached!");
+            }
+
+            VkMemoryAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = size;
+            allocInfo.memoryTypeIndex = memoryType;
+
+            VkDeviceMemory memory;
+            VkResult result = vkAllocateMemory(allocator.device, &allocInfo, nullptr, &memory);
+            if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY)
+            {
+                return nullptr;
+            }
+            VK_CHECK(result, "allocate device memory block");
+            allocator.deviceAllocationCount++;
+
+            auto block = std::make_unique<Block>();
+            block->memory = memory;
+            block->size = size;
+            block->memoryType = memoryType;
+            block->strategy = strategy;
+            block->dedicated = dedicated;
+            block->ranges.push_back({0, size, ResourceKind::Free});
+
+            const VkMemoryPropertyFlags flags =
+                allocator.memoryProperties.memoryTypes[memoryType].propertyFlags;
+            if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+            {
+                void *data;
+                VK_CHECK(
+                    vkMapMemory(allocator.device, memory, 0, VK_WHOLE_SIZE, 0, &data),
+                    "map device memory block"
+                );
+                block->mapped = static_cast<std::byte *>(data);
+            }
+
+            allocator.blocks[memoryType].push_back(std::move(block));
+            return allocator.blocks[memoryType].back().get();
+        }
+
+        void destroyBlock(Allocator &allocator, Block *block)
+        {
+            if (block->mapped)
+            {
+                vkUnmapMemory(allocator.device, block->memory);
+            }
+            vkFreeMemory(allocator.device, block->memory, nullptr);
+            allocator.deviceAllocationCount--;
+
+            auto &blocks = allocator.blocks[block->memoryType];
+            std::erase_if(
+                blocks, [block](const auto &candidate) { return candidate.get() == block; }
+            );
+        }
+
+        bool allocateFromFreeList(
+            Block &block,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            VkDeviceSize granularity,
+            ResourceKind kind,
+            VkDeviceSize &offset
+        )
+        {
+            std::size_t best = block.ranges.size();
+            VkDeviceSize bestOffset = 0;
+            VkDeviceSize bestSize = std::numeric_limits<VkDeviceSize>::max();
+
+            for (std::size_t i = 0; i < block.ranges.size(); i++)
+            {
+                const Range &range = block.ranges[i];
+                if (range.kind != ResourceKind::Free || range.size < size || range.size >= bestSize)
+                {
+                    continue;
+                }
+
+                VkDeviceSize start = alignUp(range.offset, alignment);
+
+                // Neighbours are never free (free ranges are coalesced), so only they can conflict
+                if (i > 0)
+                {
+                    const Range &prev = block.ranges[i - 1];
+                    if (conflicts(prev.kind, kind)
+                        && samePage(prev.offset + prev.size - 1, start, granularity))
+                    {
+                        start = alignUp(start, granularity);
+                    }
+                }
+
+                if (start + size > range.offset + range.size)
+                {
+                    continue;
+                }
+
+                if (i + 1 < block.ranges.size())
+                {
+                    const Range &next = block.ranges[i + 1];
+                    if (conflicts(kind, next.kind)
+                        && samePage(start + size - 1, next.offset, granularity))
+                    {
+                        continue;
+                    }
+                }
+
+                best = i;
+                bestOffset = start;
+                bestSize = range.size;
+            }
+
+            if (best == block.ranges.size())
+            {
+                return false;
+            }
+
+            const Range range = block.ranges[best];
+            const VkDeviceSize end = bestOffset + size;
+            const VkDeviceSize rangeEnd = range.offset + range.size;
+
+            std::vector<Range> pieces;
+            if (bestOffset > range.offset)
+            {
+                pieces.push_back({range.offset, bestOffset - range.offset, ResourceKind::Free});
+            }
+            pieces.push_back({bestOffset, size, kind});
+            if (rangeEnd > end)
+            {
+                pieces.push_back({end, rangeEnd - end, ResourceKind::Free});
+            }
+
+            auto it = block.ranges.erase(block.ranges.begin() + best);
+            block.ranges.insert(it, pieces.begin(), pieces.end());
+
+            offset = bestOffset;
+            return true;
+        }
+
+        bool allocateFromLinear(
+            Block &block,
+            VkDeviceSize size,
+            VkDeviceSize alignment,
+            VkDeviceSize granularity,
+            ResourceKind kind,
+            VkDeviceSize &offset
+        )
+        {
+            VkDeviceSize start = alignUp(block.linearHead, alignment);
+            if (block.linearCount > 0 && conflicts(block.linearLastKind, kind)
+                && samePage(block.linearHead - 1, start, granularity))
+            {
+                start = alignUp(start, granularity);
+            }
+
+            if (start + size > block.size)
+            {
+                return false;
+            }
+
+            block.linearHead = start + size;
+            block.linearLastKind = kind;
+            block.linearCount++;
+
+            offset = start;
+            return true;
+        }
+
+        void freeFromFreeList(Block &block, VkDeviceSize offset)
+        {
+            auto it = std::lower_bound(
+                block.ranges.begin(),
+                block.ranges.end(),
+                offset,
+                [](const Range &range, VkDeviceSize value) { return range.offset < value; }
+            );
+            if (it == block.ranges.end() || it->offset != offset || it->kind == ResourceKind::Free)
+            {
+                throw std::invalid_argument("freeing an unknown allocation!");
+            }
+
+            it->kind = ResourceKind::Free;
+
+            auto next = it + 1;
+            if (next != block.ranges.end() && next->kind == ResourceKind::Free)
+            {
+                it->size += next->size;
+                block.ranges.erase(next);
+            }
+
+            if (it != block.ranges.begin())
+            {
+                auto prev = it - 1;
+                if (prev->kind == ResourceKind::Free)
+                {
+                    prev->size += it->size;
+                    block.ranges.erase(it);
+                }
+            }
+        }
+
+        bool tryAllocate(
+            Allocator &allocator,
+            std::uint32_t memoryType,
+            const VkMemoryRequirements &requirements,
+            ResourceKind kind,
+            Strategy strategy,
+            Allocation &allocation
+        )
+        {
+            const VkDeviceSize granularity = allocator.bufferImageGranularity;
+            VkDeviceSize offset = 0;
+            Block *target = nullptr;
+
+            auto subAllocate = [&](Block &block)
+            {
+                const VkDeviceSize size = requirements.size;
+                const VkDeviceSize alignment = requirements.alignment;
+
+                if (block.strategy == Strategy::Linear)
+                {
+                    return allocateFromLinear(block, size, alignment, granularity, kind, offset);
+                }
+                return allocateFromFreeList(block, size, alignment, granularity, kind, offset);
+            };
+
+            if (requirements.size > allocator.blockSize / 2)
+            {
+                target = createBlock(allocator, memoryType, requirements.size, strategy, true);
+                if (!target || !subAllocate(*target))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                for (auto &block : allocator.blocks[memoryType])
+                {
+                    if (!block->dedicated && block->strategy == strategy && subAllocate(*block))
+                    {
+                        target = block.get();
+                        break;
+                    }
+                }
+
+                // Fall back to smaller blocks when the heap cannot fit a full-size one
+                for (VkDeviceSize blockSize = allocator.blockSize;
+                     !target && blockSize >= requirements.size;
+                     blockSize /= 2)
+                {
+                    Block *block = createBlock(allocator, memoryType, blockSize, strategy, false);
+                    if (block && subAllocate(*block))
+                    {
+                        target = block;
+                    }
+                }
+
+                if (!target)
+                {
+                    return false;
+                }
+            }
+
+            target->used += requirements.size;
+
+            allocation.memory = target->memory;
+            allocation.offset = offset;
+            allocation.size = requirements.size;
+            allocation.mapped = target->mapped ? target->mapped + offset : nullptr;
+            allocation.block = target;
+            return true;
+        }
+    } // namespace
+
+    void createAllocator(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Allocator &allocator,
+        bool memoryBudget,
+        VkDeviceSize blockSize
+    )
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        allocator.device = device;
+        allocator.physicalDevice = physicalDevice;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &allocator.memoryProperties);
+        allocator.bufferImageGranularity = std::max<VkDeviceSize>(
+            properties.limits.bufferImageGranularity, 1
+        );
+        allocator.maxDeviceAllocationCount = properties.limits.maxMemoryAllocationCount;
+        allocator.blockSize = blockSize;
+        allocator.memoryBudget = memoryBudget;
+    }
+
+    void destroyAllocator(Allocator &allocator)
+    {
+        std::lock_guard<std::mutex> lock(allocator.mutex);
+        for (auto &blocks : allocator.blocks)
+        {
+            while (!blocks.empty())
+            {
+                destroyBlock(allocator, blocks.back().get());
+            }
+        }
+    }
+
+    void allocateMemory(
+        Allocator &allocator,
+        const VkMemoryRequirements &requirements,
+        VkMemoryPropertyFlags properties,
+        ResourceKind kind,
+        Allocation &allocation,
+        Category category,
+        Strategy strategy
+    )
+    {
+        std::lock_guard<std::mutex> lock(allocator.mutex);
+        std::uint32_t typeBits = requirements.memoryTypeBits;
+
+        // Try every compatible memory type in order before reporting out-of-memory
+        while (true)
+        {
+            std::uint32_t memoryType =
+                Buffer::findMemoryType(allocator.memoryProperties, typeBits, properties);
+
+            if (tryAllocate(allocator, memoryType, requirements, kind, strategy, allocation))
+            {
+                allocation.category = category;
+                CategoryStats &stats = categoryStats(allocator, category);
+                stats.bytes += allocation.size;
+                stats.highWater = std::max(stats.highWater, stats.bytes);
+                stats.count++;
+                return;
+            }
+
+            typeBits &= ~(1u << memoryType);
+            if (typeBits == 0)
+            {
+                throw std::runtime_error("failed to allocate device memory!");
+            }
+        }
+    }
+
+    void freeAllocation(Allocator &allocator, Allocation &allocation)
+    {
+        Block *block = allocation.block;
+        if (!block)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(allocator.mutex);
+        if (block->strategy == Strategy::Linear)
+        {
+            if (--block->linearCount == 0)
+            {
+                block->linearHead = 0;
+                block->linearLastKind = ResourceKind::Free;
+            }
+        }
+        else
+        {
+            freeFromFreeList(*block, allocation.offset);
+        }
+        block->used -= allocation.size;
+
+        CategoryStats &stats = categoryStats(allocator, allocation.category);
+        stats.bytes -= allocation.size;
+        stats.count--;
+
+        if (block->used == 0)
+        {
+            // Keep one empty block per memory type and strategy to avoid allocation churn
+            const auto &blocks = allocator.blocks[block->memoryType];
+            bool hasSibling = std::any_of(
+                blocks.begin(),
+                blocks.end(),
+                [block](const auto &candidate)
+                {
+                    return candidate.get() != block && !candidate->dedicated
+                           && candidate->strategy == block->strategy;
+                }
+            );
+
+            if (block->dedicated || hasSibling)
+            {
+                destroyBlock(allocator, block);
+            }
+        }
+
+        allocation = Allocation{};
+    }
+
+    std::vector<HeapStats> getHeapStats(const Allocator &allocator)
+    {
+        const VkPhysicalDeviceMemoryProperties &memProperties = allocator.memoryProperties;
+
+        std::vector<HeapStats> stats(memProperties.memoryHeapCount);
+        for (std::uint32_t i = 0; i < memProperties.memoryHeapCount; i++)
+        {
+            stats[i].heapIndex = i;
+            stats[i].heapSize = memProperties.memoryHeaps[i].size;
+        }
+
+        std::unique_lock<std::mutex> lock(allocator.mutex);
+        for (std::uint32_t type = 0; type < memProperties.memoryTypeCount; type++)
+        {
+            HeapStats &heap = stats[memProperties.memoryTypes[type].heapIndex];
+            for (const auto &block : allocator.blocks[type])
+            {
+                heap.reserved += block->size;
+                heap.used += block->used;
+                heap.blockCount++;
+            }
+        }
+
+        if (!allocator.memoryBudget)
+        {
+            for (HeapStats &heap : stats)
+            {
+                heap.budget = heap.heapSize;
+                heap.usage = heap.reserved;
+            }
+            return stats;
+        }
+        lock.unlock();
+
+        /// Budgets change with other processes' usage, so they are queried on every call
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+        budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+        VkPhysicalDeviceMemoryProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+        properties2.pNext = &budgetProperties;
+        vkGetPhysicalDeviceMemoryProperties2(allocator.physicalDevice, &properties2);
+
+        for (HeapStats &heap : stats)
+        {
+            heap.budget = budgetProperties.heapBudget[heap.heapIndex];
+            heap.usage = budgetProperties.heapUsage[heap.heapIndex];
+        }
+
+        return stats;
+    }
+
+    std::vector<HeapStats> checkBudget(Allocator &allocator, float fraction)
+    {
+        const std::vector<HeapStats> heaps = getHeapStats(allocator);
+
+        std::vector<HeapStats> crossed;
+        std::lock_guard<std::mutex> lock(allocator.mutex);
+        for (const HeapStats &heap : heaps)
+        {
+            const std::uint32_t bit = 1u << heap.heapIndex;
+            const auto limit = static_cast<VkDeviceSize>(heap.budget * fraction);
+            if (heap.usage <= limit)
+            {
+                allocator.overBudgetHeaps &= ~bit;
+                continue;
+            }
+
+            if ((allocator.overBudgetHeaps & bit) == 0)
+            {
+                allocator.overBudgetHeaps |= bit;
+                crossed.push_back(heap);
+            }
+        }
+        return crossed;
+    }
+
+    std::string_view categoryName(Category category)
+    {
+        switch (category)
+        {
+        case Category::Geometry:
+            return "geometry";
+        case Category::Uniform:
+            return "uniform";
+        case Category::Texture:
+            return "texture";
+        case Category::Staging:
+            return "staging";
+        case Category::Attachment:
+            return "attachment";
+        default:
+            return "other";
+        }
+    }
+
+    CategoryStats getCategoryStats(const Allocator &allocator, Category category)
+    {
+        std::lock_guard<std::mutex> lock(allocator.mutex);
+        return allocator.categories[static_cast<std::size_t>(category)];
+    }
+
+    std::string formatReport(const Allocator &allocator)
+    {
+        std::string report;
+        for (const HeapStats &heap : getHeapStats(allocator))
+        {
+            const bool deviceLocal =
+                allocator.memoryProperties.memoryHeaps[heap.heapIndex].flags
+                & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+            report += std::format(
+                "memory: heap {} ({}): {:.1f} of {:.1f} MiB budget, {:.1f} MiB in {} blocks\n",
+                heap.heapIndex,
+                deviceLocal ? "device" : "host",
+                mebibytes(heap.usage),
+                mebibytes(heap.budget),
+                mebibytes(heap.reserved),
+                heap.blockCount
+            );
+        }
+
+        for (std::size_t i = 0; i < CATEGORY_COUNT; i++)
+        {
+            const CategoryStats stats = getCategoryStats(allocator, static_cast<Category>(i));
+            report += std::format(
+                "memory: {:<10} {:8.1f} MiB live ({} allocations), {:8.1f} MiB peak\n",
+                categoryName(static_cast<Category>(i)),
+                mebibytes(stats.bytes),
+                stats.count,
+                mebibytes(stats.highWater)
+            );
+        }
+        return report;
+    }
+} // namespace Memory
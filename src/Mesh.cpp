@@ -0,0 +1,422 @@
+#include "Mesh.hpp"
+
+#define CGLTF_IMPLEMENTATION
+#include <cgltf.h>
+#include <meshoptimizer.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace Mesh
+{
+    namespace
+    {
+        /// Resolve a 1-based (or negative, relative to the end) OBJ index
+        std::size_t resolveIndex(long index, std::size_t count)
+        {
+            if (index > 0 && static_cast<std::size_t>(index) <= count)
+            {
+                return static_cast<std::size_t>(index) - 1;
+            }
+            if (index < 0 && static_cast<std::size_t>(-index) <= count)
+            {
+                return count - static_cast<std::size_t>(-index);
+            }
+            throw std::runtime_error("invalid OBJ face index!");
+        }
+
+        /// Read an OBJ file as a triangle soup (welded later by buildMesh)
+        void loadObj(
+            const std::filesystem::path &path,
+            std::vector<SourceVertex> &vertices,
+            std::vector<std::uint32_t> &indices
+        )
+        {
+            std::ifstream file(path);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("failed to open mesh file!");
+            }
+
+            std::vector<std::array<float, 3>> positions;
+            std::vector<std::array<float, 4>> colors;
+            std::vector<std::array<float, 2>> texCoords;
+            std::vector<SourceVertex> face;
+
+            std::string line;
+            while (std::getline(file, line))
+            {
+                std::istringstream stream(line);
+                std::string keyword;
+                stream >> keyword;
+
+                if (keyword == "v")
+                {
+                    std::array<float, 3> position{};
+                    stream >> position[0] >> position[1] >> position[2];
+
+                    /// Optional vertex color extension: v x y z r g b
+                    std::array<float, 4> color{1.0f, 1.0f, 1.0f, 1.0f};
+                    if (!(stream >> color[0] >> color[1] >> color[2]))
+                    {
+                        color = {1.0f, 1.0f, 1.0f, 1.0f};
+                    }
+
+                    positions.push_back(position);
+                    colors.push_back(color);
+                }
+                else if (keyword == "vt")
+                {
+                    std::array<float, 2> texCoord{};
+                    stream >> texCoord[0] >> texCoord[1];
+                    texCoord[1] = 1.0f - texCoord[1]; ///< OBJ UVs start bottom-left
+                    texCoords.push_back(texCoord);
+                }
+                else if (keyword == "f")
+                {
+                    face.clear();
+
+                    std::string corner;
+                    while (stream >> corner)
+                    {
+                        /// p, p/t, p//n or p/t/n; normals are not used
+                        SourceVertex vertex;
+                        const std::size_t slash = corner.find('/');
+
+                        const std::size_t p = resolveIndex(
+                            std::stol(corner.substr(0, slash)), positions.size()
+                        );
+                        std::copy_n(positions[p].data(), 3, vertex.position);
+                        std::copy_n(colors[p].data(), 4, vertex.color);
+
+                        if (slash != std::string::npos && slash + 1 < corner.size()
+                            && corner[slash + 1] != '/')
+                        {
+                            const std::size_t t = resolveIndex(
+                                std::stol(corner.substr(slash + 1)), texCoords.size()
+                            );
+                            std::copy_n(texCoords[t].data(), 2, vertex.texCoord);
+                        }
+
+                        face.push_back(vertex);
+                    }
+
+                    /// Fan triangulation (faces are assumed convex)
+                    for (std::size_t i = 1; i + 1 < face.size(); i++)
+                    {
+                        for (const SourceVertex &vertex : {face[0], face[i], face[i + 1]})
+                        {
+                            indices.push_back(static_cast<std::uint32_t>(vertices.size()));
+                            vertices.push_back(vertex);
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Read every triangle primitive of a glTF/GLB file (node transforms are ignored)
+        void loadGltf(
+            const std::filesystem::path &path,
+            std::vector<SourceVertex> &vertices,
+            std::vector<std::uint32_t> &indices
+        )
+        {
+            const std::string file = path.string();
+
+            cgltf_options options{};
+            cgltf_data *data = nullptr;
+            if (cgltf_parse_file(&options, file.c_str(), &data) != cgltf_result_success)
+            {
+                throw std::runtime_error("failed to parse glTF file!");
+            }
+            std::unique_ptr<cgltf_data, decltype(&cgltf_free)> owner(data, cgltf_free);
+
+            if (cgltf_load_buffers(&options, data, file.c_str()) != cgltf_result_success)
+            {
+                throw std::runtime_error("failed to load glTF buffers!");
+            }
+
+            /// Checks accessor ranges and index values against the loaded buffers
+            if (cgltf_validate(data) != cgltf_result_success)
+            {
+                throw std::runtime_error("invalid glTF file!");
+            }
+
+            for (cgltf_size m = 0; m < data->meshes_count; m++)
+            {
+                const cgltf_mesh &mesh = data->meshes[m];
+                for (cgltf_size p = 0; p < mesh.primitives_count; p++)
+                {
+                    const cgltf_primitive &primitive = mesh.primitives[p];
+                    if (primitive.type != cgltf_primitive_type_triangles)
+                    {
+                        continue;
+                    }
+
+                    const cgltf_accessor *position = nullptr;
+                    const cgltf_accessor *color = nullptr;
+                    const cgltf_accessor *texCoord = nullptr;
+                    for (cgltf_size a = 0; a < primitive.attributes_count; a++)
+                    {
+                        const cgltf_attribute &attribute = primitive.attributes[a];
+                        if (attribute.type == cgltf_attribute_type_position)
+                        {
+                            position = attribute.data;
+                        }
+                        else if (attribute.type == cgltf_attribute_type_color
+                                 && attribute.index == 0)
+                        {
+                            color = attribute.data;
+                        }
+                        else if (attribute.type == cgltf_attribute_type_texcoord
+                                 && attribute.index == 0)
+                        {
+                            texCoord = attribute.data;
+                        }
+                    }
+                    if (position == nullptr)
+                    {
+                        continue;
+                    }
+
+                    const auto base = static_cast<std::uint32_t>(vertices.size());
+                    for (cgltf_size i = 0; i < position->count; i++)
+                    {
+                        /// Missing attributes keep the SourceVertex defaults (white, UV 0)
+                        SourceVertex vertex;
+                        cgltf_accessor_read_float(position, i, vertex.position, 3);
+                        if (color != nullptr)
+                        {
+                            cgltf_accessor_read_float(color, i, vertex.color, 4);
+                        }
+                        if (texCoord != nullptr)
+                        {
+                            cgltf_accessor_read_float(texCoord, i, vertex.texCoord, 2);
+                        }
+                        vertices.push_back(vertex);
+                    }
+
+                    const cgltf_size indexCount =
+                        primitive.indices != nullptr ? primitive.indices->count : position->count;
+                    for (cgltf_size i = 0; i < indexCount; i++)
+                    {
+                        const cgltf_size index =
+                            primitive.indices != nullptr
+                                ? cgltf_accessor_read_index(primitive.indices, i)
+                                : i;
+                        if (index >= position->count)
+                        {
+                            throw std::runtime_error("invalid glTF index!");
+                        }
+                        indices.push_back(base + static_cast<std::uint32_t>(index));
+                    }
+                }
+            }
+        }
+
+        /// Store indices as 16-bit when every vertex is addressable, 32-bit otherwise
+        void packIndices(
+            const std::vector<std::uint32_t> &indices, std::size_t vertexCount, MeshData &mesh
+        )
+        {
+            mesh.indexCount = static_cast<std::uint32_t>(indices.size());
+
+            if (vertexCount <= std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1)
+            {
+                mesh.indexType = VK_INDEX_TYPE_UINT16;
+                mesh.indices.resize(indices.size() * sizeof(std::uint16_t));
+                for (std::size_t i = 0; i < indices.size(); i++)
+                {
+                    const auto index = static_cast<std::uint16_t>(indices[i]);
+                    std::memcpy(&mesh.indices[i * sizeof(index)], &index, sizeof(index));
+                }
+            }
+            else
+            {
+                mesh.indexType = VK_INDEX_TYPE_UINT32;
+                mesh.indices.resize(indices.size() * sizeof(std::uint32_t));
+                std::memcpy(mesh.indices.data(), indices.data(), mesh.indices.size());
+            }
+        }
+    } // namespace
+
+    MeshView view(const MeshData &mesh)
+    {
+        MeshView result;
+        result.vertices = std::as_bytes(std::span(mesh.vertices));
+        result.indices = mesh.indices;
+        result.indexType = mesh.indexType;
+        result.indexCount = mesh.indexCount;
+        result.boundingRadius = mesh.boundingRadius;
+        result.center = mesh.center;
+        result.scale = mesh.scale;
+        return result;
+    }
+
+    glm::vec4 placeInstance(const MeshView &mesh, const glm::vec4 &offsetScale)
+    {
+        /// offset + s * (center + scale * packed)
+        return glm::vec4(
+            glm::vec3(offsetScale) + offsetScale.w * mesh.center, offsetScale.w * mesh.scale
+        );
+    }
+
+    MeshData buildMesh(
+        const std::vector<SourceVertex> &vertices, const std::vector<std::uint32_t> &indices
+    )
+    {
+        if (indices.empty() || indices.size() % 3 != 0)
+        {
+            throw std::runtime_error("mesh is not a non-empty triangle list!");
+        }
+
+        /// Weld identical vertices (byte-wise) into one entry each
+        std::vector<unsigned int> remap(vertices.size());
+        const std::size_t uniqueCount = meshopt_generateVertexRemap(
+            remap.data(),
+            indices.data(),
+            indices.size(),
+            vertices.data(),
+            vertices.size(),
+            sizeof(SourceVertex)
+        );
+
+        std::vector<unsigned int> optimized(indices.size());
+        meshopt_remapIndexBuffer(optimized.data(), indices.data(), indices.size(), remap.data());
+
+        std::vector<SourceVertex> welded(uniqueCount);
+        meshopt_remapVertexBuffer(
+            welded.data(), vertices.data(), vertices.size(), sizeof(SourceVertex), remap.data()
+        );
+
+        /// Triangle order: vertex cache first, then overdraw within OVERDRAW_THRESHOLD of it
+        meshopt_optimizeVertexCache(
+            optimized.data(), optimized.data(), optimized.size(), uniqueCount
+        );
+        meshopt_optimizeOverdraw(
+            optimized.data(),
+            optimized.data(),
+            optimized.size(),
+            &welded[0].position[0],
+            uniqueCount,
+            sizeof(SourceVertex),
+            OVERDRAW_THRESHOLD
+        );
+
+        /// Vertex order: order of first use, so fetches walk the buffer forwards
+        std::vector<SourceVertex> ordered(uniqueCount);
+        const std::size_t vertexCount = meshopt_optimizeVertexFetch(
+            ordered.data(),
+            optimized.data(),
+            optimized.size(),
+            welded.data(),
+            uniqueCount,
+            sizeof(SourceVertex)
+        );
+        ordered.resize(vertexCount);
+
+        /// Positions relative to the bounds' centre in units of the largest extent; the centre
+        /// and scale are kept so the mesh is drawn at its own size and position
+        glm::vec3 minimum(std::numeric_limits<float>::max());
+        glm::vec3 maximum(std::numeric_limits<float>::lowest());
+        for (const SourceVertex &vertex : ordered)
+        {
+            const glm::vec3 position(vertex.position[0], vertex.position[1], vertex.position[2]);
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+        }
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+        const glm::vec3 size = maximum - minimum;
+        const float extent = std::max({size.x, size.y, size.z});
+        const float inverseScale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+        MeshData mesh;
+        mesh.center = center;
+        mesh.scale = extent > 0.0f ? extent : 1.0f;
+        mesh.vertices.reserve(ordered.size());
+        for (const SourceVertex &vertex : ordered)
+        {
+            const glm::vec3 position =
+                (glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]) - center)
+                * inverseScale;
+            mesh.boundingRadius = std::max(mesh.boundingRadius, glm::length(position));
+
+            PackedVertex packed{};
+            packed.position = {
+                meshopt_quantizeHalf(position.x),
+                meshopt_quantizeHalf(position.y),
+                meshopt_quantizeHalf(position.z),
+                0
+            };
+            for (std::size_t c = 0; c < 4; c++)
+            {
+                packed.color[c] =
+                    static_cast<std::uint8_t>(meshopt_quantizeUnorm(vertex.color[c], 8));
+            }
+            packed.texCoord = {
+                meshopt_quantizeHalf(vertex.texCoord[0]), meshopt_quantizeHalf(vertex.texCoord[1])
+            };
+            mesh.vertices.push_back(packed);
+        }
+
+        packIndices(optimized, mesh.vertices.size(), mesh);
+        return mesh;
+    }
+
+    MeshData fromVertices(
+        const std::vector<Buffer::Vertex> &vertices, const std::vector<std::uint16_t> &indices
+    )
+    {
+        std::vector<SourceVertex> source;
+        source.reserve(vertices.size());
+        for (const Buffer::Vertex &vertex : vertices)
+        {
+            SourceVertex converted;
+            converted.position[0] = vertex.pos.x;
+            converted.position[1] = vertex.pos.y;
+            converted.color[0] = vertex.color.r;
+            converted.color[1] = vertex.color.g;
+            converted.color[2] = vertex.color.b;
+            converted.texCoord[0] = vertex.texCoord.x;
+            converted.texCoord[1] = vertex.texCoord.y;
+            source.push_back(converted);
+        }
+
+        return buildMesh(source, std::vector<std::uint32_t>(indices.begin(), indices.end()));
+    }
+
+    MeshData loadMesh(const std::filesystem::path &path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(
+            extension.begin(),
+            extension.end(),
+            extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); }
+        );
+
+        std::vector<SourceVertex> vertices;
+        std::vector<std::uint32_t> indices;
+        if (extension == ".obj")
+        {
+            loadObj(path, vertices, indices);
+        }
+        else if (extension == ".gltf" || extension == ".glb")
+        {
+            loadGltf(path, vertices, indices);
+        }
+        else
+        {
+            throw std::runtime_error("unsupported mesh format!");
+        }
+
+        return buildMesh(vertices, indices);
+    }
+} // namespace Mesh
@@ -0,0 +1,116 @@
+#include "PipelineCache.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace PipelineCache
+{
+    namespace
+    {
+        /// Read the whole file, or return an empty blob if it is missing or unreadable
+        std::vector<std::byte> readBlob(const std::filesystem::path &path)
+        {
+            std::error_code error;
+            const auto size = std::filesystem::file_size(path, error);
+            if (error)
+            {
+                return {};
+            }
+
+            std::ifstream file(path, std::ios::binary);
+            std::vector<std::byte> blob(size);
+            if (!file.read(reinterpret_cast<char *>(blob.data()), blob.size()))
+            {
+                return {};
+            }
+            return blob;
+        }
+    } // namespace
+
+    bool isCompatible(const VkPhysicalDevice physicalDevice, const void *data, std::size_t size)
+    {
+        VkPipelineCacheHeaderVersionOne header{};
+        if (data == nullptr || size < sizeof(header))
+        {
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(header));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        return header.headerSize >= sizeof(header) && header.headerSize <= size
+               && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+               && header.vendorID == properties.vendorID
+               && header.deviceID == properties.deviceID
+               && std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE)
+                      == 0;
+    }
+
+    void createPipelineCache(
+        VkDevice &device,
+        const VkPhysicalDevice physicalDevice,
+        VkPipelineCache &pipelineCache,
+        const std::filesystem::path &path
+    )
+    {
+        std::vector<std::byte> blob = readBlob(path);
+        if (!isCompatible(physicalDevice, blob.data(), blob.size()))
+        {
+            /// Stale driver, other GPU or corrupt file: start from an empty cache
+            blob.clear();
+        }
+
+        VkPipelineCacheCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = blob.size();
+        createInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+
+        VK_CHECK(
+            vkCreatePipelineCache(device, &createInfo, nullptr, &pipelineCache),
+            "create pipeline cache"
+        );
+    }
+
+    bool savePipelineCache(
+        VkDevice &device, const VkPipelineCache pipelineCache, const std::filesystem::path &path
+    )
+    {
+        std::size_t size = 0;
+        if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) != VK_SUCCESS
+            || size == 0)
+        {
+            return false;
+        }
+
+        std::vector<std::byte> blob(size);
+        if (vkGetPipelineCacheData(device, pipelineCache, &size, blob.data()) != VK_SUCCESS)
+        {
+            return false;
+        }
+
+        std::error_code error;
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), error);
+        }
+
+        /// Write next to the target and rename, so a crash never leaves a truncated cache
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char *>(blob.data()), size))
+            {
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, path, error);
+        return !error;
+    }
+} // namespace PipelineCache
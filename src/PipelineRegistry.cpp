@@ -0,0 +1,442 @@
+#include "PipelineRegistry.hpp"
+#include "helper.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+namespace Pipelines
+{
+    namespace
+    {
+        constexpr std::uint32_t SPIRV_MAGIC = 0x07230203;
+
+        /// Build the pipeline of a variant (no registry lock held)
+        VkPipeline compile(Registry &registry, const GraphicsPipeline::PipelineState &state)
+        {
+            VkShaderModule vertShaderModule = getShaderModule(registry, state.vertexShader);
+            /// Depth-only variants have no fragment stage
+            VkShaderModule fragShaderModule = state.fragmentShader.empty()
+                                                  ? VK_NULL_HANDLE
+                                                  : getShaderModule(registry, state.fragmentShader);
+
+            return GraphicsPipeline::createGraphicsPipeline(
+                registry.device,
+                state,
+                vertShaderModule,
+                fragShaderModule,
+                registry.layout,
+                registry.cache
+            );
+        }
+
+        /// Store the outcome of a compile (lock held). A ready variant takes a rebuild as its
+        /// replacement (a failed rebuild keeps the current pipeline); other duplicates are
+        /// dropped
+        void finish(Registry &registry, Variant &variant, VkPipeline pipeline, std::string error)
+        {
+            if (variant.status == Status::Ready)
+            {
+                if (variant.pendingRebuilds == 0)
+                {
+                    vkDestroyPipeline(registry.device, pipeline, nullptr);
+                    return;
+                }
+                variant.pendingRebuilds--;
+                variant.error = std::move(error);
+                if (pipeline != VK_NULL_HANDLE)
+                {
+                    vkDestroyPipeline(registry.device, variant.replacement, nullptr);
+                    variant.replacement = pipeline;
+                }
+                return;
+            }
+
+            /// A rebuild queued while the first compile was under way, and that one failed
+            if (variant.status == Status::Failed && variant.pendingRebuilds > 0)
+            {
+                variant.pendingRebuilds--;
+            }
+            variant.pipeline = pipeline;
+            variant.status = pipeline != VK_NULL_HANDLE ? Status::Ready : Status::Failed;
+            variant.error = std::move(error);
+        }
+
+        /// Number a compile about to read the modules (lock held); it may use any module
+        /// current until it ends
+        std::uint64_t beginCompile(Registry &registry)
+        {
+            const std::uint64_t serial = ++registry.compilesStarted;
+            registry.running.push_back(serial);
+            return serial;
+        }
+
+        void compilerLoop(Registry &registry)
+        {
+            std::unique_lock<std::mutex> lock(registry.mutex);
+            while (true)
+            {
+                registry.wake.wait(
+                    lock, [&registry] { return registry.stopping || !registry.queue.empty(); }
+                );
+                if (registry.stopping)
+                {
+                    return;
+                }
+
+                const PipelineKey key = registry.queue.front();
+                registry.queue.pop_front();
+
+                /// Map nodes are stable, but copy the state so the lock can be dropped
+                const GraphicsPipeline::PipelineState state = registry.variants.at(key).state;
+                const std::uint64_t serial = beginCompile(registry);
+                lock.unlock();
+
+                VkPipeline pipeline = VK_NULL_HANDLE;
+                std::string error;
+                try
+                {
+                    pipeline = compile(registry, state);
+                }
+                catch (const std::exception &e)
+                {
+                    error = e.what();
+                }
+
+                lock.lock();
+                std::erase(registry.running, serial);
+                finish(registry, registry.variants.at(key), pipeline, std::move(error));
+            }
+        }
+
+        /// Reject anything that is not a SPIR-V binary
+        void checkSpirv(std::span<const std::byte> code)
+        {
+            if (code.empty())
+            {
+                throw std::runtime_error("failed to read shader file!");
+            }
+
+            if (code.size() % 4 != 0)
+            {
+                throw std::runtime_error("shader code size is not a multiple of 4!");
+            }
+
+            if (*reinterpret_cast<const std::uint32_t *>(code.data()) != SPIRV_MAGIC)
+            {
+                throw std::runtime_error("shader file is not SPIR-V!");
+            }
+        }
+
+        /// Find or add the variant of a state (lock held); returns true if it was added
+        bool insert(
+            Registry &registry, PipelineKey key, const GraphicsPipeline::PipelineState &state
+        )
+        {
+            auto [it, inserted] = registry.variants.try_emplace(key);
+            if (inserted)
+            {
+                it->second.state = state;
+            }
+            else if (!(it->second.state == state))
+            {
+                throw std::runtime_error("pipeline state hash collision!");
+            }
+            return inserted;
+        }
+    } // namespace
+
+    void createRegistry(
+        VkDevice &device,
+        VkPipelineLayout &layout,
+        VkPipelineCache &cache,
+        Registry &registry,
+        std::uint32_t compilerCount,
+        const AssetPack::Pack *pack
+    )
+    {
+        registry.device = device;
+        registry.layout = layout;
+        registry.cache = cache;
+        registry.pack = pack;
+
+        registry.compilers.reserve(compilerCount);
+        for (std::uint32_t i = 0; i < compilerCount; i++)
+        {
+            registry.compilers.emplace_back(compilerLoop, std::ref(registry));
+        }
+    }
+
+    void destroyRegistry(Registry &registry)
+    {
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.stopping = true;
+        }
+        registry.wake.notify_all();
+
+        /// A compile in progress finishes before its thread sees the stop flag
+        for (auto &compiler : registry.compilers)
+        {
+            compiler.join();
+        }
+        registry.compilers.clear();
+
+        for (auto &[key, variant] : registry.variants)
+        {
+            vkDestroyPipeline(registry.device, variant.pipeline, nullptr);
+            vkDestroyPipeline(registry.device, variant.replacement, nullptr);
+        }
+        registry.variants.clear();
+        registry.queue.clear();
+        registry.fallback = VK_NULL_HANDLE;
+
+        for (auto &[path, module] : registry.modules)
+        {
+            vkDestroyShaderModule(registry.device, module, nullptr);
+        }
+        registry.modules.clear();
+        for (const RetiredModule &retired : registry.retiredModules)
+        {
+            vkDestroyShaderModule(registry.device, retired.module, nullptr);
+        }
+        registry.retiredModules.clear();
+        registry.running.clear();
+    }
+
+    VkShaderModule getShaderModule(Registry &registry, const std::string &path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(registry.moduleMutex);
+            auto it = registry.modules.find(path);
+            if (it != registry.modules.end())
+            {
+                return it->second;
+            }
+        }
+
+        /// Packed SPIR-V is used in place from the mapping; otherwise read the file outside the
+        /// lock so other threads are not held up by file I/O
+        std::vector<std::byte> file;
+        std::span<const std::byte> code;
+        const AssetPack::Entry *entry = nullptr;
+        if (registry.pack != nullptr)
+        {
+            entry = AssetPack::find(*registry.pack, path, AssetPack::AssetType::Shader);
+        }
+        if (entry != nullptr)
+        {
+            code = AssetPack::payload(*registry.pack, *entry);
+        }
+        else
+        {
+            file = Helper::readFile(path);
+            code = file;
+        }
+
+        checkSpirv(code);
+        VkShaderModule module = GraphicsPipeline::createShaderModule(registry.device, code);
+
+        std::lock_guard<std::mutex> lock(registry.moduleMutex);
+        auto [it, inserted] = registry.modules.try_emplace(path, module);
+        if (!inserted)
+        {
+            /// Another thread created the same module first; keep that one
+            vkDestroyShaderModule(registry.device, module, nullptr);
+        }
+        return it->second;
+    }
+
+    std::uint32_t reloadShader(
+        Registry &registry, const std::string &path, std::span<const std::byte> code
+    )
+    {
+        checkSpirv(code);
+        VkShaderModule module = GraphicsPipeline::createShaderModule(registry.device, code);
+
+        std::uint32_t queued = 0;
+        {
+            /// Compiles numbered after the swap read the new module; the registry lock is
+            /// taken first, as nothing holding the module lock waits for it
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            {
+                std::lock_guard<std::mutex> moduleLock(registry.moduleMutex);
+                VkShaderModule &current = registry.modules[path];
+                if (current != VK_NULL_HANDLE)
+                {
+                    registry.retiredModules.push_back({current, registry.compilesStarted});
+                }
+                current = module;
+            }
+
+            for (auto &[key, variant] : registry.variants)
+            {
+                if (variant.state.vertexShader != path && variant.state.fragmentShader != path)
+                {
+                    continue;
+                }
+
+                /// Still waiting in the queue: its compile will read the new module anyway
+                const bool waiting = std::find(registry.queue.begin(), registry.queue.end(), key)
+                                     != registry.queue.end();
+                if (waiting)
+                {
+                    continue;
+                }
+
+                /// A failed variant compiles as if new; a ready one, or one whose compile is
+                /// under way with the old module, gets a replacement
+                if (variant.status == Status::Failed)
+                {
+                    variant.status = Status::Queued;
+                    variant.error.clear();
+                }
+                else
+                {
+                    variant.pendingRebuilds++;
+                }
+                registry.queue.push_back(key);
+                queued++;
+            }
+        }
+        registry.wake.notify_all();
+
+        return queued;
+    }
+
+    std::uint32_t swapReloaded(
+        Registry &registry,
+        std::vector<VkPipeline> &retired,
+        std::vector<VkShaderModule> &retiredModules
+    )
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        /// Modules replaced before the oldest running compile began are no longer read
+        const std::uint64_t oldest =
+            registry.running.empty()
+                ? registry.compilesStarted + 1
+                : *std::min_element(registry.running.begin(), registry.running.end());
+        std::erase_if(
+            registry.retiredModules,
+            [&retiredModules, oldest](const RetiredModule &module)
+            {
+                if (module.lastCompile >= oldest)
+                {
+                    return false;
+                }
+                retiredModules.push_back(module.module);
+                return true;
+            }
+        );
+
+        std::uint32_t swapped = 0;
+        for (auto &[key, variant] : registry.variants)
+        {
+            if (variant.replacement == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+
+            retired.push_back(variant.pipeline);
+            variant.pipeline = std::exchange(variant.replacement, VK_NULL_HANDLE);
+            if (key == registry.fallbackKey)
+            {
+                registry.fallback = variant.pipeline;
+            }
+            swapped++;
+        }
+        return swapped;
+    }
+
+    PipelineKey request(Registry &registry, const GraphicsPipeline::PipelineState &state)
+    {
+        const PipelineKey key = GraphicsPipeline::hashState(state);
+
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            if (!insert(registry, key, state))
+            {
+                return key;
+            }
+            registry.queue.push_back(key);
+        }
+        registry.wake.notify_one();
+
+        return key;
+    }
+
+    PipelineKey build(Registry &registry, const GraphicsPipeline::PipelineState &state)
+    {
+        const PipelineKey key = GraphicsPipeline::hashState(state);
+        std::uint64_t serial = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            insert(registry, key, state);
+
+            Variant &variant = registry.variants.at(key);
+            if (variant.status == Status::Ready)
+            {
+                return key;
+            }
+
+            /// Take it off the compile queue so no compiler builds it a second time
+            std::erase(registry.queue, key);
+            serial = beginCompile(registry);
+        }
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        std::string error;
+        try
+        {
+            pipeline = compile(registry, state);
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+        }
+
+        /// A compiler may have picked it up before it was dequeued; finish keeps one pipeline
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::erase(registry.running, serial);
+        Variant &variant = registry.variants.at(key);
+        finish(registry, variant, pipeline, error);
+        if (variant.status != Status::Ready)
+        {
+            throw std::runtime_error("failed to build pipeline variant: " + error);
+        }
+        return key;
+    }
+
+    void setFallback(Registry &registry, PipelineKey key)
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = registry.variants.find(key);
+        if (it == registry.variants.end() || it->second.status != Status::Ready)
+        {
+            throw std::runtime_error("fallback pipeline is not ready!");
+        }
+        registry.fallback = it->second.pipeline;
+        registry.fallbackKey = key;
+    }
+
+    VkPipeline resolve(Registry &registry, PipelineKey key)
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = registry.variants.find(key);
+        if (it != registry.variants.end() && it->second.status == Status::Ready)
+        {
+            return it->second.pipeline;
+        }
+        return registry.fallback;
+    }
+
+    Status status(Registry &registry, PipelineKey key)
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto it = registry.variants.find(key);
+        return it != registry.variants.end() ? it->second.status : Status::Failed;
+    }
+} // namespace Pipelines
@@ -0,0 +1,566 @@
+#include "Profiler.hpp"
+#include "Queue.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+namespace Profiler
+{
+    namespace
+    {
+        double microsecondsSince(
+            const Profiler &profiler, std::chrono::steady_clock::time_point time
+        )
+        {
+            return std::chrono::duration<double, std::micro>(time - profiler.origin).count();
+        }
+
+        void addEvent(Profiler &profiler, const TraceEvent &event)
+        {
+            if (!profiler.tracePath.empty() && profiler.events.size() < MAX_TRACE_EVENTS)
+            {
+                profiler.events.push_back(event);
+            }
+        }
+
+        void addStats(
+            std::map<std::string_view, ZoneStats> &zones, const char *name, double durationUs
+        )
+        {
+            ZoneStats &stats = zones[name];
+            stats.totalMs += durationUs / 1000.0;
+            stats.count++;
+        }
+
+        /// First timestamp query of a frame slot
+        std::uint32_t firstQuery(std::uint32_t frameIndex)
+        {
+            return frameIndex * MAX_GPU_ZONES * 2;
+        }
+
+        /// Turn the slot's previous queries into events, if the GPU has written them
+        void readBack(Profiler &profiler, std::uint32_t frameIndex)
+        {
+            GpuFrame &frame = profiler.frames[frameIndex];
+            if (!frame.submitted)
+            {
+                return;
+            }
+            frame.submitted = false;
+
+            /// No WAIT flag: the slot's timeline wait has passed, so NOT_READY only happens
+            /// if a zone was left open, and then the frame is dropped rather than waited for
+            const auto queryCount = static_cast<std::uint32_t>(frame.zones.size() * 2);
+            std::array<std::uint64_t, MAX_GPU_ZONES * 2> ticks{};
+            if (queryCount > 0
+                && vkGetQueryPoolResults(
+                       profiler.device,
+                       profiler.timestamps,
+                       firstQuery(frameIndex),
+                       queryCount,
+                       sizeof(std::uint64_t) * queryCount,
+                       ticks.data(),
+                       sizeof(std::uint64_t),
+                       VK_QUERY_RESULT_64_BIT
+                   ) == VK_SUCCESS)
+            {
+                /// GPU clocks are not calibrated against the CPU: zones are placed relative to
+                /// the frame's first timestamp, starting at the submission
+                const std::uint64_t origin = ticks[0] & profiler.timestampMask;
+                for (std::size_t i = 0; i < frame.zones.size(); i++)
+                {
+                    const std::uint64_t begin = ticks[2 * i] & profiler.timestampMask;
+                    const std::uint64_t end = ticks[2 * i + 1] & profiler.timestampMask;
+                    const double beginUs = (begin - origin) * profiler.timestampPeriod / 1000.0;
+                    const double durationUs = end >= begin
+                                                  ? (end - begin) * profiler.timestampPeriod
+                                                        / 1000.0
+                                                  : 0.0;
+
+                    addStats(profiler.gpuZones, frame.zones[i], durationUs);
+                    if (i == 0)
+                    {
+                        profiler.lastFrameMs = durationUs / 1000.0; ///< "gpu frame"
+                        if (profiler.keepFrameTimes)
+                        {
+                            profiler.frameTimesMs.push_back(profiler.lastFrameMs);
+                        }
+                    }
+                    addEvent(
+                        profiler,
+                        TraceEvent{frame.zones[i], frame.submitUs + beginUs, durationUs, true}
+                    );
+                }
+            }
+
+            std::array<std::uint64_t, STATISTICS.size()> statistics{};
+            if (frame.statistics
+                && vkGetQueryPoolResults(
+                       profiler.device,
+                       profiler.statistics,
+                       frameIndex,
+                       1,
+                       sizeof(statistics),
+                       statistics.data(),
+                       sizeof(statistics),
+                       VK_QUERY_RESULT_64_BIT
+                   ) == VK_SUCCESS)
+            {
+                for (std::size_t i = 0; i < statistics.size(); i++)
+                {
+                    profiler.statisticTotals[i] += statistics[i];
+                }
+                profiler.statisticFrames++;
+            }
+        }
+
+        void printZones(std::string_view track, const std::map<std::string_view, ZoneStats> &zones)
+        {
+            for (const auto &[name, stats] : zones)
+            {
+                std::cerr << std::format(
+                    "  {} {:<24} {:8.3f} ms avg ({} zones)\n",
+                    track,
+                    name,
+                    stats.totalMs / stats.count,
+                    stats.count
+                );
+            }
+        }
+
+        /// Print the averages since the last summary and start over
+        void printSummary(Profiler &profiler)
+        {
+            if (profiler.framesSinceSummary == 0)
+            {
+                return;
+            }
+
+            std::cerr << std::format("profile: {} frames\n", profiler.framesSinceSummary);
+            printZones("cpu", profiler.cpuZones);
+            printZones("gpu", profiler.gpuZones);
+            if (profiler.statisticFrames > 0)
+            {
+                for (std::size_t i = 0; i < STATISTICS.size(); i++)
+                {
+                    std::cerr << std::format(
+                        "  stat {:<23} {:12} per frame\n",
+                        STATISTIC_NAMES[i],
+                        profiler.statisticTotals[i] / profiler.statisticFrames
+                    );
+                }
+            }
+
+            profiler.cpuZones.clear();
+            profiler.gpuZones.clear();
+            profiler.statisticTotals.fill(0);
+            profiler.statisticFrames = 0;
+            profiler.framesSinceSummary = 0;
+        }
+
+        /// Zone names are literals, but keep the JSON valid whatever they hold
+        std::string escape(std::string_view text)
+        {
+            std::string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+
+        /// Trace thread of an event: 1 is the main thread, 2 the GPU, then one per worker
+        std::uint32_t traceThread(const TraceEvent &event)
+        {
+            return event.gpu ? 2 : (event.worker == 0 ? 1 : 2 + event.worker);
+        }
+
+        /// Chrome trace event format: complete ("X") events on a CPU and a GPU thread
+        void writeTrace(const Profiler &profiler)
+        {
+            std::ofstream file(profiler.tracePath, std::ios::trunc);
+            if (!file)
+            {
+                throw std::runtime_error("failed to open profiler trace file!");
+            }
+
+            file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+                    "\"args\":{\"name\":\"CPU\"}},\n";
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+                    "\"args\":{\"name\":\"GPU\"}}";
+            std::set<std::uint32_t> workers;
+            for (const TraceEvent &event : profiler.events)
+            {
+                if (!event.gpu && event.worker > 0 && workers.insert(event.worker).second)
+                {
+                    file << std::format(
+                        ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                        "\"args\":{{\"name\":\"worker {}\"}}}}",
+                        traceThread(event),
+                        event.worker
+                    );
+                }
+                file << std::format(
+                    ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},"
+                    "\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                    escape(event.name),
+                    event.gpu ? "gpu" : "cpu",
+                    event.beginUs,
+                    event.durationUs,
+                    traceThread(event)
+                );
+            }
+            file << "\n]}\n";
+
+            if (!file)
+            {
+                throw std::runtime_error("failed to write profiler trace file!");
+            }
+        }
+    } // namespace
+
+    Scope::Scope(Profiler &profiler, const char *name)
+        : profiler(profiler), depth(profiler.cpuStack.size())
+    {
+        beginCpuZone(profiler, name);
+    }
+
+    Scope::~Scope()
+    {
+        while (profiler.cpuStack.size() > depth)
+        {
+            endCpuZone(profiler);
+        }
+    }
+
+    void createProfiler(Profiler &profiler, bool enabled, const std::string &tracePath)
+    {
+        profiler.enabled = enabled;
+        profiler.tracePath = enabled ? tracePath : std::string{};
+        profiler.origin = std::chrono::steady_clock::now();
+    }
+
+    void createGpuQueries(
+        Profiler &profiler,
+        VkInstance instance,
+        VkDevice device,
+        VkPhysicalDevice physicalDevice,
+        VkSurfaceKHR surface,
+        std::uint32_t frameCount,
+        bool debugLabels
+    )
+    {
+        if (!profiler.enabled)
+        {
+            return;
+        }
+
+        profiler.device = device;
+        profiler.frames.resize(frameCount);
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        profiler.timestampPeriod = properties.limits.timestampPeriod;
+
+        /// Timestamps are written on the graphics queue, so its family decides the valid bits
+        const Queue::FamilyIndices indices = Queue::findQueueFamilies(physicalDevice, surface);
+        std::uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+        const std::uint32_t validBits = families[indices.graphicsFamily.value()].timestampValidBits;
+
+        if (validBits > 0)
+        {
+            profiler.timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+            VkQueryPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            poolInfo.queryCount = firstQuery(frameCount);
+            VK_CHECK(
+                vkCreateQueryPool(device, &poolInfo, nullptr, &profiler.timestamps),
+                "create timestamp query pool"
+            );
+        }
+
+        VkPhysicalDeviceFeatures features;
+        vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+        if (features.pipelineStatisticsQuery)
+        {
+            VkQueryPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+            poolInfo.queryCount = frameCount;
+            for (VkQueryPipelineStatisticFlagBits statistic : STATISTICS)
+            {
+                poolInfo.pipelineStatistics |= statistic;
+            }
+            VK_CHECK(
+                vkCreateQueryPool(device, &poolInfo, nullptr, &profiler.statistics),
+                "create pipeline statistics query pool"
+            );
+            profiler.inheritedQueries = features.inheritedQueries == VK_TRUE;
+        }
+
+        if (debugLabels)
+        {
+            profiler.beginLabel = reinterpret_cast<PFN_vkCmdBeginDebugUtilsLabelEXT>(
+                vkGetInstanceProcAddr(instance, "vkCmdBeginDebugUtilsLabelEXT")
+            );
+            profiler.endLabel = reinterpret_cast<PFN_vkCmdEndDebugUtilsLabelEXT>(
+                vkGetInstanceProcAddr(instance, "vkCmdEndDebugUtilsLabelEXT")
+            );
+        }
+    }
+
+    void destroyProfiler(Profiler &profiler)
+    {
+        if (!profiler.enabled)
+        {
+            return;
+        }
+
+        collect(profiler);
+        printSummary(profiler);
+
+        if (profiler.timestamps != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(profiler.device, profiler.timestamps, nullptr);
+            profiler.timestamps = VK_NULL_HANDLE;
+        }
+        if (profiler.statistics != VK_NULL_HANDLE)
+        {
+            vkDestroyQueryPool(profiler.device, profiler.statistics, nullptr);
+            profiler.statistics = VK_NULL_HANDLE;
+        }
+        profiler.frames.clear();
+
+        if (!profiler.tracePath.empty())
+        {
+            writeTrace(profiler);
+        }
+        profiler.events.clear();
+    }
+
+    void collect(Profiler &profiler)
+    {
+        /// The device is idle: every submitted slot can be read back
+        for (std::uint32_t i = 0; i < profiler.frames.size(); i++)
+        {
+            readBack(profiler, i);
+        }
+    }
+
+    void beginCpuZone(Profiler &profiler, const char *name)
+    {
+        if (profiler.enabled)
+        {
+            profiler.cpuStack.emplace_back(name, std::chrono::steady_clock::now());
+        }
+    }
+
+    void endCpuZone(Profiler &profiler)
+    {
+        if (!profiler.enabled || profiler.cpuStack.empty())
+        {
+            return;
+        }
+
+        const auto [name, begin] = profiler.cpuStack.back();
+        profiler.cpuStack.pop_back();
+
+        const double beginUs = microsecondsSince(profiler, begin);
+        const double durationUs =
+            microsecondsSince(profiler, std::chrono::steady_clock::now()) - beginUs;
+        addStats(profiler.cpuZones, name, durationUs);
+        addEvent(profiler, TraceEvent{name, beginUs, durationUs, false, 0});
+    }
+
+    void addCpuZone(
+        Profiler &profiler,
+        const char *name,
+        std::chrono::steady_clock::time_point begin,
+        std::chrono::steady_clock::time_point end,
+        std::uint32_t worker
+    )
+    {
+        if (!profiler.enabled)
+        {
+            return;
+        }
+
+        const double beginUs = microsecondsSince(profiler, begin);
+        const double durationUs = microsecondsSince(profiler, end) - beginUs;
+        addStats(profiler.cpuZones, name, durationUs);
+        addEvent(profiler, TraceEvent{name, beginUs, durationUs, false, worker});
+    }
+
+    void beginGpuFrame(
+        Profiler &profiler,
+        VkCommandBuffer commandBuffer,
+        std::uint32_t frameIndex,
+        bool secondaries
+    )
+    {
+        if (!profiler.enabled || profiler.frames.empty())
+        {
+            return;
+        }
+
+        readBack(profiler, frameIndex);
+
+        GpuFrame &frame = profiler.frames[frameIndex];
+        frame.zones.clear();
+        frame.openZones.clear();
+        frame.statistics = false;
+
+        if (profiler.timestamps != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(
+                commandBuffer, profiler.timestamps, firstQuery(frameIndex), MAX_GPU_ZONES * 2
+            );
+        }
+        beginGpuZone(profiler, commandBuffer, frameIndex, "gpu frame");
+
+        if (profiler.statistics != VK_NULL_HANDLE && (!secondaries || profiler.inheritedQueries))
+        {
+            vkCmdResetQueryPool(commandBuffer, profiler.statistics, frameIndex, 1);
+            vkCmdBeginQuery(commandBuffer, profiler.statistics, frameIndex, 0);
+            frame.statistics = true;
+        }
+    }
+
+    VkQueryPipelineStatisticFlags activeStatistics(
+        const Profiler &profiler, std::uint32_t frameIndex
+    )
+    {
+        if (!profiler.enabled || profiler.frames.empty() || !profiler.frames[frameIndex].statistics)
+        {
+            return 0;
+        }
+
+        VkQueryPipelineStatisticFlags flags = 0;
+        for (VkQueryPipelineStatisticFlagBits statistic : STATISTICS)
+        {
+            flags |= statistic;
+        }
+        return flags;
+    }
+
+    void endGpuFrame(Profiler &profiler, VkCommandBuffer commandBuffer, std::uint32_t frameIndex)
+    {
+        if (!profiler.enabled || profiler.frames.empty())
+        {
+            return;
+        }
+
+        if (profiler.frames[frameIndex].statistics)
+        {
+            vkCmdEndQuery(commandBuffer, profiler.statistics, frameIndex);
+        }
+        while (!profiler.frames[frameIndex].openZones.empty())
+        {
+            endGpuZone(profiler, commandBuffer, frameIndex);
+        }
+    }
+
+    void beginGpuZone(
+        Profiler &profiler,
+        VkCommandBuffer commandBuffer,
+        std::uint32_t frameIndex,
+        const char *name
+    )
+    {
+        if (!profiler.enabled || profiler.frames.empty())
+        {
+            return;
+        }
+
+        GpuFrame &frame = profiler.frames[frameIndex];
+        if (profiler.timestamps != VK_NULL_HANDLE && frame.zones.size() < MAX_GPU_ZONES)
+        {
+            const auto zone = static_cast<std::uint32_t>(frame.zones.size());
+            frame.zones.push_back(name);
+            frame.openZones.push_back(zone);
+            vkCmdWriteTimestamp(
+                commandBuffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                profiler.timestamps,
+                firstQuery(frameIndex) + 2 * zone
+            );
+        }
+        else
+        {
+            frame.openZones.push_back(UINT32_MAX); ///< Unmeasured, but the label still nests
+        }
+
+        if (profiler.beginLabel != nullptr)
+        {
+            VkDebugUtilsLabelEXT label{};
+            label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+            label.pLabelName = name;
+            profiler.beginLabel(commandBuffer, &label);
+        }
+    }
+
+    void endGpuZone(Profiler &profiler, VkCommandBuffer commandBuffer, std::uint32_t frameIndex)
+    {
+        if (!profiler.enabled || profiler.frames.empty())
+        {
+            return;
+        }
+
+        GpuFrame &frame = profiler.frames[frameIndex];
+        if (frame.openZones.empty())
+        {
+            return;
+        }
+
+        const std::uint32_t zone = frame.openZones.back();
+        frame.openZones.pop_back();
+        if (zone != UINT32_MAX)
+        {
+            vkCmdWriteTimestamp(
+                commandBuffer,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                profiler.timestamps,
+                firstQuery(frameIndex) + 2 * zone + 1
+            );
+        }
+
+        if (profiler.endLabel != nullptr)
+        {
+            profiler.endLabel(commandBuffer);
+        }
+    }
+
+    void endFrame(Profiler &profiler, std::uint32_t frameIndex)
+    {
+        if (!profiler.enabled)
+        {
+            return;
+        }
+
+        if (!profiler.frames.empty())
+        {
+            GpuFrame &frame = profiler.frames[frameIndex];
+            frame.submitted = true;
+            frame.submitUs = microsecondsSince(profiler, std::chrono::steady_clock::now());
+        }
+
+        if (++profiler.framesSinceSummary == SUMMARY_INTERVAL)
+        {
+            printSummary(profiler);
+        }
+    }
+} // namespace Profiler
@@ -21,13 +21,24 @@ namespace Queue
             if (indices.isComplete())
                 break;
 
-            if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            /// Graphics work and the compute passes feeding it share one family
+            constexpr VkQueueFlags graphicsCompute = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+            if ((queueFamily.queueFlags & graphicsCompute) == graphicsCompute)
             {
                 indices.graphicsFamily = static_cast<std::uint32_t>(i);
+                indices.computeFamily = static_cast<std::uint32_t>(i);
             }
 
+            /// Headless: nothing is presented, so the graphics family stands in
             VkBool32 presentSupport = false;
-            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            if (surface != VK_NULL_HANDLE)
+            {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+            }
+            else
+            {
+                presentSupport = (queueFamily.queueFlags & graphicsCompute) == graphicsCompute;
+            }
 
             if (presentSupport)
             {
@@ -35,6 +46,57 @@ namespace Queue
             }
         }
 
+        /// Transfer: transfer-only family first, then any non-graphics transfer family
+        std::optional<std::uint32_t> asyncTransferFamily;
+        for (const auto &[i, queueFamily] : std::views::enumerate(queueFamilies))
+        {
+            const VkQueueFlags flags = queueFamily.queueFlags;
+            if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                continue;
+            }
+
+            if (!(flags & VK_QUEUE_COMPUTE_BIT))
+            {
+                indices.transferFamily = static_cast<std::uint32_t>(i);
+                break;
+            }
+
+            if (!asyncTransferFamily.has_value())
+            {
+                asyncTransferFamily = static_cast<std::uint32_t>(i);
+            }
+        }
+
+        if (!indices.transferFamily.has_value())
+        {
+            indices.transferFamily = asyncTransferFamily.has_value() ? asyncTransferFamily
+                                                                     : indices.graphicsFamily;
+        }
+
+        /// Async compute: a family of its own, else a second queue of the transfer family, so
+        /// compute and upload submissions never share a VkQueue
+        for (const auto &[i, queueFamily] : std::views::enumerate(queueFamilies))
+        {
+            const VkQueueFlags flags = queueFamily.queueFlags;
+            if (!(flags & VK_QUEUE_COMPUTE_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT))
+            {
+                continue;
+            }
+
+            if (static_cast<std::uint32_t>(i) != indices.transferFamily)
+            {
+                indices.asyncComputeFamily = static_cast<std::uint32_t>(i);
+                indices.asyncComputeIndex = 0;
+                break;
+            }
+            if (queueFamily.queueCount >= 2 && !indices.asyncComputeFamily.has_value())
+            {
+                indices.asyncComputeFamily = static_cast<std::uint32_t>(i);
+                indices.asyncComputeIndex = 1;
+            }
+        }
+
         return indices;
     }
 } // namespace Queue
\ No newline at end of file
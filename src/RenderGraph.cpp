@@ -0,0 +1,809 @@
+#include "RenderGraph.hpp"
+#include "ImageViews.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace RenderGraph
+{
+    namespace
+    {
+        /// Accesses that must be made available before another use may touch the memory
+        constexpr VkAccessFlags2 WRITE_ACCESS =
+            VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+            | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+            | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT
+            | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+        /// Usage flags that may be combined with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+        constexpr VkImageUsageFlags ATTACHMENT_USAGE =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+            | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+
+        /**
+         * @struct UsageInfo
+         * @brief What a usage means to the synchronisation and to image creation
+         */
+        struct UsageInfo
+        {
+            VkPipelineStageFlags2 stages; ///< Stages of the use
+            VkAccessFlags2 access;        ///< Accesses of the use
+            VkImageLayout layout;         ///< Layout images must be in
+            VkImageUsageFlags imageUsage; ///< Creation flag the use requires
+            bool write;                   ///< The use writes
+        };
+
+        UsageInfo usageInfo(Usage usage)
+        {
+            switch (usage)
+            {
+            case Usage::ColorAttachment:
+                return {
+                    VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                    true
+                };
+            case Usage::DepthAttachment:
+                return {
+                    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+                        | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+                        | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                    true
+                };
+            case Usage::DepthRead:
+                return {
+                    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+                        | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                    VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                    false
+                };
+            case Usage::SampledFragment:
+                return {
+                    VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_USAGE_SAMPLED_BIT,
+                    false
+                };
+            case Usage::SampledCompute:
+                return {
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_IMAGE_USAGE_SAMPLED_BIT,
+                    false
+                };
+            case Usage::StorageRead:
+                return {
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT,
+                    false
+                };
+            case Usage::StorageWrite:
+                return {
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_GENERAL,
+                    VK_IMAGE_USAGE_STORAGE_BIT,
+                    true
+                };
+            case Usage::TransferRead:
+                return {
+                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    VK_ACCESS_2_TRANSFER_READ_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                    false
+                };
+            case Usage::TransferWrite:
+                /// TRANSFER (all transfer commands) also covers fills and updates, which
+                /// synchronization2 files under CLEAR rather than COPY
+                return {
+                    VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+                    VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                    true
+                };
+            case Usage::IndirectRead:
+                return {
+                    VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                    VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    0,
+                    false
+                };
+            case Usage::VertexRead:
+                return {
+                    VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT,
+                    VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT,
+                    VK_IMAGE_LAYOUT_UNDEFINED,
+                    0,
+                    false
+                };
+            case Usage::Present:
+                return {
+                    VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT,
+                    0,
+                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                    0,
+                    false
+                };
+            }
+            throw std::invalid_argument("unknown render graph usage!");
+        }
+
+        /// Vulkan 1.0 stages covering a synchronization2 stage mask
+        VkPipelineStageFlags legacyStages(VkPipelineStageFlags2 stages)
+        {
+            if (stages & (VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT
+                          | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT))
+            {
+                stages |= VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+            }
+            if (stages & (VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT
+                          | VK_PIPELINE_STAGE_2_RESOLVE_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT))
+            {
+                stages |= VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            }
+            /// The 1.0 bits keep their values in the low 32 bits
+            return static_cast<VkPipelineStageFlags>(stages & 0xFFFFFFFFull);
+        }
+
+        /// Vulkan 1.0 accesses covering a synchronization2 access mask
+        VkAccessFlags legacyAccess(VkAccessFlags2 access)
+        {
+            if (access
+                & (VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT))
+            {
+                access |= VK_ACCESS_2_SHADER_READ_BIT;
+            }
+            if (access & VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT)
+            {
+                access |= VK_ACCESS_2_SHADER_WRITE_BIT;
+            }
+            return static_cast<VkAccessFlags>(access & 0xFFFFFFFFull);
+        }
+
+        bool isAttachment(Usage usage)
+        {
+            return usage == Usage::ColorAttachment || usage == Usage::DepthAttachment
+                   || usage == Usage::DepthRead;
+        }
+
+        /// Every use of each resource in one pass, merged
+        using PassUses = std::vector<std::pair<ResourceId, State>>;
+
+        PassUses mergeUses(const std::vector<Access> &accesses, bool images)
+        {
+            PassUses uses;
+            for (const Access &access : accesses)
+            {
+                const UsageInfo info = usageInfo(access.usage);
+                auto found = std::find_if(
+                    uses.begin(),
+                    uses.end(),
+                    [&](const auto &use) { return use.first == access.resource; }
+                );
+                if (found == uses.end())
+                {
+                    uses.emplace_back(
+                        access.resource, State{info.stages, info.access, info.layout, info.write}
+                    );
+                    continue;
+                }
+
+                if (images && found->second.layout != info.layout)
+                {
+                    throw std::invalid_argument("render graph pass uses an image in two layouts!");
+                }
+                found->second.stages |= info.stages;
+                found->second.access |= info.access;
+                found->second.written = found->second.written || info.write;
+            }
+            return uses;
+        }
+
+        /**
+         * @brief Move a resource from its last use to the next one
+         * @param state Last use, updated to the next one
+         * @param use Next use
+         * @param image The resource is an image (layouts matter)
+         * @param id Resource id
+         * @param barrier Boundary the dependency is added to, if there is a hazard
+         * @details Reads after reads in the same layout only widen the state, so a later
+         *          write waits for all of them
+         */
+        void transition(State &state, const State &use, bool image, ResourceId id, Barrier &barrier)
+        {
+            const bool layoutChange = image && state.layout != use.layout;
+            if (!state.written && !use.written && !layoutChange)
+            {
+                state.stages |= use.stages;
+                state.access |= use.access;
+                return;
+            }
+
+            /// A buffer nothing has used yet has nothing to wait on
+            if (!image && state.stages == 0)
+            {
+                state = use;
+                return;
+            }
+
+            const VkPipelineStageFlags2 srcStages =
+                state.stages != 0 ? state.stages : VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT;
+
+            /// Write after read only needs the execution dependency
+            const VkAccessFlags2 srcAccess = state.written ? state.access & WRITE_ACCESS : 0;
+            const VkAccessFlags2 dstAccess = srcAccess != 0 ? use.access : 0;
+            if (image)
+            {
+                barrier.images.push_back(
+                    {id, srcStages, use.stages, srcAccess, dstAccess, state.layout, use.layout}
+                );
+            }
+            else
+            {
+                barrier.srcStages |= srcStages;
+                barrier.dstStages |= use.stages;
+                barrier.srcAccess |= srcAccess;
+                barrier.dstAccess |= dstAccess;
+            }
+            state = use;
+        }
+
+        /**
+         * @brief Walk the passes from the given frame-start states
+         * @param graph Graph
+         * @param imageUses Merged image uses per pass
+         * @param bufferUses Merged buffer uses per pass
+         * @param images Image states, left at their frame-end states
+         * @param buffers Buffer states, left at their frame-end states
+         * @param barriers Output boundaries (one per pass, then the exit one)
+         */
+        void walk(
+            const Graph &graph,
+            const std::vector<PassUses> &imageUses,
+            const std::vector<PassUses> &bufferUses,
+            std::vector<State> &images,
+            std::vector<State> &buffers,
+            std::vector<Barrier> &barriers
+        )
+        {
+            barriers.assign(graph.passes.size() + 1, Barrier{});
+            for (std::size_t pass = 0; pass < graph.passes.size(); pass++)
+            {
+                for (const auto &[id, use] : imageUses[pass])
+                {
+                    transition(images[id], use, true, id, barriers[pass]);
+                }
+                for (const auto &[id, use] : bufferUses[pass])
+                {
+                    transition(buffers[id], use, false, id, barriers[pass]);
+                }
+            }
+
+            /// Imported images are left in the layout their next user expects
+            for (ResourceId id = 0; id < graph.images.size(); id++)
+            {
+                const Image &image = graph.images[id];
+                if (image.exitUsage)
+                {
+                    const UsageInfo info = usageInfo(*image.exitUsage);
+                    const State exit{info.stages, info.access, info.layout, info.write};
+                    transition(images[id], exit, true, id, barriers.back());
+                }
+            }
+        }
+
+        /// A memory type of typeBits that is device-local and lazily allocated exists
+        bool hasLazyMemory(
+            const VkPhysicalDeviceMemoryProperties &properties, std::uint32_t typeBits
+        )
+        {
+            constexpr VkMemoryPropertyFlags lazy =
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+            for (std::uint32_t i = 0; i < properties.memoryTypeCount; i++)
+            {
+                if ((typeBits & (1u << i))
+                    && (properties.memoryTypes[i].propertyFlags & lazy) == lazy)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace
+
+    ResourceId createImage(
+        Graph &graph, const char *name, VkFormat format, VkImageAspectFlags aspect
+    )
+    {
+        Image image;
+        image.name = name;
+        image.format = format;
+        image.aspect = aspect;
+        image.transient = true;
+        graph.images.push_back(image);
+        graph.compiled = false;
+        return static_cast<ResourceId>(graph.images.size() - 1);
+    }
+
+    ResourceId importImage(
+        Graph &graph,
+        const char *name,
+        VkFormat format,
+        VkImageAspectFlags aspect,
+        VkPipelineStageFlags2 readyStages,
+        std::optional<Usage> exitUsage
+    )
+    {
+        Image image;
+        image.name = name;
+        image.format = format;
+        image.aspect = aspect;
+        image.ready.stages = readyStages;
+        image.exitUsage = exitUsage;
+        graph.images.push_back(image);
+        graph.compiled = false;
+        return static_cast<ResourceId>(graph.images.size() - 1);
+    }
+
+    ResourceId importBuffer(Graph &graph, const char *name, bool perFrame)
+    {
+        graph.buffers.push_back(Buffer{name, perFrame});
+        graph.compiled = false;
+        return static_cast<ResourceId>(graph.buffers.size() - 1);
+    }
+
+    PassId addPass(
+        Graph &graph, const char *name, std::vector<Access> images, std::vector<Access> buffers
+    )
+    {
+        Pass pass;
+        pass.name = name;
+        pass.images = std::move(images);
+        pass.buffers = std::move(buffers);
+        graph.passes.push_back(std::move(pass));
+        graph.compiled = false;
+        return static_cast<PassId>(graph.passes.size() - 1);
+    }
+
+    void compile(Graph &graph)
+    {
+        std::vector<PassUses> imageUses;
+        std::vector<PassUses> bufferUses;
+        for (Image &image : graph.images)
+        {
+            image.usage = image.exitUsage ? usageInfo(*image.exitUsage).imageUsage : 0;
+            image.firstPass = NO_PASS;
+            image.lastPass = NO_PASS;
+        }
+
+        for (PassId pass = 0; pass < graph.passes.size(); pass++)
+        {
+            for (const Access &access : graph.passes[pass].images)
+            {
+                if (access.resource >= graph.images.size())
+                {
+                    throw std::invalid_argument("render graph pass uses an unknown image!");
+                }
+                Image &image = graph.images[access.resource];
+                image.usage |= usageInfo(access.usage).imageUsage;
+                image.firstPass = std::min(image.firstPass, pass);
+                image.lastPass = image.lastPass == NO_PASS ? pass : std::max(image.lastPass, pass);
+            }
+            for (const Access &access : graph.passes[pass].buffers)
+            {
+                if (access.resource >= graph.buffers.size())
+                {
+                    throw std::invalid_argument("render graph pass uses an unknown buffer!");
+                }
+            }
+            imageUses.push_back(mergeUses(graph.passes[pass].images, true));
+            bufferUses.push_back(mergeUses(graph.passes[pass].buffers, false));
+        }
+
+        /// Transients are placed, in order of first use, into the first slot whose occupants
+        /// are all done by then; occupants of a slot follow each other within the frame
+        std::vector<ResourceId> transients;
+        for (ResourceId id = 0; id < graph.images.size(); id++)
+        {
+            if (graph.images[id].transient && graph.images[id].firstPass != NO_PASS)
+            {
+                transients.push_back(id);
+            }
+        }
+        std::stable_sort(
+            transients.begin(),
+            transients.end(),
+            [&](ResourceId a, ResourceId b)
+            { return graph.images[a].firstPass < graph.images[b].firstPass; }
+        );
+
+        std::vector<std::vector<ResourceId>> occupants;
+        for (ResourceId id : transients)
+        {
+            Image &image = graph.images[id];
+            auto slot = std::find_if(
+                occupants.begin(),
+                occupants.end(),
+                [&](const auto &ids) { return graph.images[ids.back()].lastPass < image.firstPass; }
+            );
+            if (slot == occupants.end())
+            {
+                slot = occupants.emplace(occupants.end());
+            }
+            image.slot = static_cast<std::uint32_t>(slot - occupants.begin());
+            slot->push_back(id);
+        }
+        graph.slotCount = static_cast<std::uint32_t>(occupants.size());
+
+        /// The walk's frame-end states do not depend on where it starts once every resource
+        /// has been written; a first walk finds them, the second starts from them
+        std::vector<State> images(graph.images.size());
+        std::vector<State> buffers(graph.buffers.size());
+        walk(graph, imageUses, bufferUses, images, buffers, graph.barriers);
+        const std::vector<State> imageEnds = images;
+
+        for (ResourceId id = 0; id < graph.images.size(); id++)
+        {
+            if (!graph.images[id].transient)
+            {
+                images[id] = graph.images[id].ready;
+            }
+        }
+
+        /// A per-frame buffer was last used by the slot's previous frame, already waited for
+        for (ResourceId id = 0; id < graph.buffers.size(); id++)
+        {
+            if (graph.buffers[id].perFrame)
+            {
+                buffers[id] = State{};
+            }
+        }
+
+        /// A transient's memory was last touched by the slot's previous occupant, or by the
+        /// slot's last occupant in the previous frame; its contents are discarded
+        for (const std::vector<ResourceId> &ids : occupants)
+        {
+            for (std::size_t i = 0; i < ids.size(); i++)
+            {
+                const State &previous = imageEnds[ids[(i + ids.size() - 1) % ids.size()]];
+                images[ids[i]] = State{
+                    previous.stages, previous.access, VK_IMAGE_LAYOUT_UNDEFINED, true
+                };
+            }
+        }
+
+        walk(graph, imageUses, bufferUses, images, buffers, graph.barriers);
+        graph.compiled = true;
+    }
+
+    VkAttachmentStoreOp storeOp(const Graph &graph, PassId pass, ResourceId image)
+    {
+        const Image &attachment = graph.images[image];
+        return !attachment.transient || attachment.lastPass > pass
+                   ? VK_ATTACHMENT_STORE_OP_STORE
+                   : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+
+    void createRenderPass(
+        VkDevice &device, const Graph &graph, PassId pass, VkRenderPass &renderPass
+    )
+    {
+        std::vector<VkAttachmentDescription> attachments;
+        std::vector<VkAttachmentReference> colorReferences;
+        VkAttachmentReference depthReference{};
+        bool hasDepth = false;
+
+        for (const Access &access : graph.passes[pass].images)
+        {
+            if (!isAttachment(access.usage))
+            {
+                continue;
+            }
+
+            const Image &image = graph.images[access.resource];
+            const VkImageLayout layout = usageInfo(access.usage).layout;
+
+            VkAttachmentDescription attachment{};
+            attachment.format = image.format;
+            attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+            attachment.loadOp = access.load;
+            attachment.storeOp = storeOp(graph, pass, access.resource);
+            attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            attachment.initialLayout = layout;
+            attachment.finalLayout = layout;
+
+            const VkAttachmentReference reference{
+                static_cast<std::uint32_t>(attachments.size()), layout
+            };
+            attachments.push_back(attachment);
+            if (access.usage == Usage::ColorAttachment)
+            {
+                colorReferences.push_back(reference);
+            }
+            else
+            {
+                depthReference = reference;
+                hasDepth = true;
+            }
+        }
+
+        VkSubpassDescription subpass{};
+        subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass.colorAttachmentCount = static_cast<std::uint32_t>(colorReferences.size());
+        subpass.pColorAttachments = colorReferences.data();
+        subpass.pDepthStencilAttachment = hasDepth ? &depthReference : nullptr;
+
+        /// No subpass dependencies: the graph's barriers before and after the pass order it
+        VkRenderPassCreateInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderPassInfo.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+        renderPassInfo.pAttachments = attachments.data();
+        renderPassInfo.subpassCount = 1;
+        renderPassInfo.pSubpasses = &subpass;
+
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render pass!");
+        }
+    }
+
+    void createTransients(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        const Graph &graph,
+        VkExtent2D extent,
+        Transients &transients
+    )
+    {
+        transients.images.assign(graph.images.size(), VK_NULL_HANDLE);
+        transients.views.assign(graph.images.size(), VK_NULL_HANDLE);
+        transients.memory.assign(graph.slotCount, Memory::Allocation{});
+        transients.lazilyAllocated = false;
+
+        /// A slot must suit every image aliased into it
+        std::vector<VkMemoryRequirements> slots(graph.slotCount, {0, 1, ~0u});
+        std::vector<bool> attachmentOnly(graph.slotCount, true);
+
+        try
+        {
+            for (ResourceId id = 0; id < graph.images.size(); id++)
+            {
+                const Image &image = graph.images[id];
+                if (!image.transient || image.firstPass == NO_PASS)
+                {
+                    continue;
+                }
+
+                const bool transientAttachment = (image.usage & ~ATTACHMENT_USAGE) == 0;
+                VkImageCreateInfo imageInfo{};
+                imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                imageInfo.imageType = VK_IMAGE_TYPE_2D;
+                imageInfo.extent = {extent.width, extent.height, 1};
+                imageInfo.mipLevels = 1;
+                imageInfo.arrayLayers = 1;
+                imageInfo.format = image.format;
+                imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                imageInfo.usage = image.usage
+                                  | (transientAttachment ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                                                         : 0);
+                imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+                imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+                if (vkCreateImage(device, &imageInfo, nullptr, &transients.images[id])
+                    != VK_SUCCESS)
+                {
+                    throw std::runtime_error("failed to create transient image!");
+                }
+
+                VkMemoryRequirements requirements;
+                vkGetImageMemoryRequirements(device, transients.images[id], &requirements);
+                VkMemoryRequirements &slot = slots[image.slot];
+                slot.size = std::max(slot.size, requirements.size);
+                slot.alignment = std::max(slot.alignment, requirements.alignment);
+                slot.memoryTypeBits &= requirements.memoryTypeBits;
+                attachmentOnly[image.slot] = attachmentOnly[image.slot] && transientAttachment;
+            }
+
+            for (std::uint32_t slot = 0; slot < graph.slotCount; slot++)
+            {
+                VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                if (attachmentOnly[slot]
+                    && hasLazyMemory(allocator.memoryProperties, slots[slot].memoryTypeBits))
+                {
+                    properties |= VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+                    transients.lazilyAllocated = true;
+                }
+                Memory::allocateMemory(
+                    allocator,
+                    slots[slot],
+                    properties,
+                    Memory::ResourceKind::Optimal,
+                    transients.memory[slot],
+                    Memory::Category::Attachment
+                );
+            }
+
+            for (ResourceId id = 0; id < graph.images.size(); id++)
+            {
+                if (transients.images[id] == VK_NULL_HANDLE)
+                {
+                    continue;
+                }
+
+                const Image &image = graph.images[id];
+                const Memory::Allocation &memory = transients.memory[image.slot];
+                vkBindImageMemory(device, transients.images[id], memory.memory, memory.offset);
+                transients.views[id] = ImageViews::createImageView(
+                    device, transients.images[id], image.format, 1, image.aspect
+                );
+            }
+        }
+        catch (...)
+        {
+            destroyTransients(device, allocator, transients);
+            throw;
+        }
+    }
+
+    void destroyTransients(VkDevice &device, Memory::Allocator &allocator, Transients &transients)
+    {
+        for (VkImageView view : transients.views)
+        {
+            vkDestroyImageView(device, view, nullptr);
+        }
+        for (VkImage image : transients.images)
+        {
+            vkDestroyImage(device, image, nullptr);
+        }
+        for (Memory::Allocation &memory : transients.memory)
+        {
+            Memory::freeAllocation(allocator, memory);
+        }
+        transients.views.clear();
+        transients.images.clear();
+        transients.memory.clear();
+        transients.lazilyAllocated = false;
+    }
+
+    void bindImage(Graph &graph, ResourceId image, VkImage handle)
+    {
+        graph.images[image].image = handle;
+    }
+
+    void execute(
+        Graph &graph,
+        const Transients &transients,
+        VkCommandBuffer commandBuffer,
+        Profiler::Profiler &profiler,
+        std::uint32_t frameIndex
+    )
+    {
+        const auto subresourceRange = [](const Image &image) -> VkImageSubresourceRange
+        { return {image.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS}; };
+        const auto handle = [&](ResourceId id)
+        { return graph.images[id].transient ? transients.images[id] : graph.images[id].image; };
+
+        const auto recordBarrier2 = [&](const Barrier &barrier)
+        {
+            graph.scratch2.clear();
+            for (const ImageBarrier &transition : barrier.images)
+            {
+                VkImageMemoryBarrier2 imageBarrier{};
+                imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                imageBarrier.srcStageMask = transition.srcStages;
+                imageBarrier.srcAccessMask = transition.srcAccess;
+                imageBarrier.dstStageMask = transition.dstStages;
+                imageBarrier.dstAccessMask = transition.dstAccess;
+                imageBarrier.oldLayout = transition.oldLayout;
+                imageBarrier.newLayout = transition.newLayout;
+                imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.image = handle(transition.image);
+                imageBarrier.subresourceRange = subresourceRange(graph.images[transition.image]);
+                graph.scratch2.push_back(imageBarrier);
+            }
+
+            VkMemoryBarrier2 memoryBarrier{};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            memoryBarrier.srcStageMask = barrier.srcStages;
+            memoryBarrier.srcAccessMask = barrier.srcAccess;
+            memoryBarrier.dstStageMask = barrier.dstStages;
+            memoryBarrier.dstAccessMask = barrier.dstAccess;
+
+            VkDependencyInfo dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.memoryBarrierCount = barrier.srcStages != 0 ? 1 : 0;
+            dependencyInfo.pMemoryBarriers = &memoryBarrier;
+            dependencyInfo.imageMemoryBarrierCount =
+                static_cast<std::uint32_t>(graph.scratch2.size());
+            dependencyInfo.pImageMemoryBarriers = graph.scratch2.data();
+            graph.pipelineBarrier2(commandBuffer, &dependencyInfo);
+        };
+
+        /// One call waits on the union of every dependency's stages
+        const auto recordBarrier = [&](const Barrier &barrier)
+        {
+            VkPipelineStageFlags srcStages = legacyStages(barrier.srcStages);
+            VkPipelineStageFlags dstStages = legacyStages(barrier.dstStages);
+
+            graph.scratch.clear();
+            for (const ImageBarrier &transition : barrier.images)
+            {
+                srcStages |= legacyStages(transition.srcStages);
+                dstStages |= legacyStages(transition.dstStages);
+
+                VkImageMemoryBarrier imageBarrier{};
+                imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                imageBarrier.srcAccessMask = legacyAccess(transition.srcAccess);
+                imageBarrier.dstAccessMask = legacyAccess(transition.dstAccess);
+                imageBarrier.oldLayout = transition.oldLayout;
+                imageBarrier.newLayout = transition.newLayout;
+                imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.image = handle(transition.image);
+                imageBarrier.subresourceRange = subresourceRange(graph.images[transition.image]);
+                graph.scratch.push_back(imageBarrier);
+            }
+
+            VkMemoryBarrier memoryBarrier{};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.srcAccessMask = legacyAccess(barrier.srcAccess);
+            memoryBarrier.dstAccessMask = legacyAccess(barrier.dstAccess);
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                srcStages,
+                dstStages,
+                0,
+                barrier.srcAccess != 0 ? 1 : 0,
+                &memoryBarrier,
+                0,
+                nullptr,
+                static_cast<std::uint32_t>(graph.scratch.size()),
+                graph.scratch.data()
+            );
+        };
+
+        const auto recordBoundary = [&](const Barrier &barrier)
+        {
+            if (barrier.srcStages == 0 && barrier.images.empty())
+            {
+                return;
+            }
+            if (graph.pipelineBarrier2)
+            {
+                recordBarrier2(barrier);
+            }
+            else
+            {
+                recordBarrier(barrier);
+            }
+        };
+
+        for (std::size_t pass = 0; pass < graph.passes.size(); pass++)
+        {
+            Profiler::beginGpuZone(profiler, commandBuffer, frameIndex, graph.passes[pass].name);
+            recordBoundary(graph.barriers[pass]);
+            graph.passes[pass].record(commandBuffer);
+            Profiler::endGpuZone(profiler, commandBuffer, frameIndex);
+        }
+        recordBoundary(graph.barriers.back());
+    }
+} // namespace RenderGraph
@@ -0,0 +1,106 @@
+#include "Resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Resolution
+{
+    namespace
+    {
+        float clampScale(float scale)
+        {
+            const float stepped = std::round(scale / SCALE_STEP) * SCALE_STEP;
+            return std::clamp(stepped, MIN_SCALE, MAX_SCALE);
+        }
+    } // namespace
+
+    void createController(Controller &controller, float scale, double targetFps)
+    {
+        controller = Controller{};
+        controller.scale = clampScale(scale);
+        controller.targetMs = targetFps > 0.0 ? 1000.0 / targetFps : 0.0;
+    }
+
+    bool update(Controller &controller, double gpuFrameMs)
+    {
+        if (controller.targetMs == 0.0 || gpuFrameMs <= 0.0)
+        {
+            return false;
+        }
+
+        /// Frames still in flight at the last change were measured at the old scale
+        if (controller.settleFrames > 0)
+        {
+            controller.settleFrames--;
+            return false;
+        }
+
+        controller.smoothedMs = controller.smoothedMs == 0.0
+                                    ? gpuFrameMs
+                                    : controller.smoothedMs
+                                          + SMOOTHING * (gpuFrameMs - controller.smoothedMs);
+
+        const double ratio = controller.smoothedMs / controller.targetMs;
+        if (ratio <= SLOWER_THRESHOLD && ratio >= FASTER_THRESHOLD)
+        {
+            return false;
+        }
+
+        const float wanted = controller.scale * static_cast<float>(std::sqrt(1.0 / ratio));
+        const float next = clampScale(
+            std::clamp(wanted, controller.scale - MAX_STEP, controller.scale + MAX_STEP)
+        );
+        if (next == controller.scale)
+        {
+            return false;
+        }
+
+        controller.scale = next;
+        controller.smoothedMs = 0.0;
+        controller.settleFrames = SETTLE_FRAMES;
+        return true;
+    }
+
+    VkExtent2D scaledExtent(const Controller &controller, VkExtent2D full)
+    {
+        const double scale = controller.scale;
+        const auto scaled = [scale](std::uint32_t size)
+        { return std::max(1u, static_cast<std::uint32_t>(std::lround(size * scale))); };
+        return {scaled(full.width), scaled(full.height)};
+    }
+
+    void recordUpscale(
+        VkCommandBuffer commandBuffer,
+        VkImage source,
+        VkExtent2D sourceExtent,
+        VkImage target,
+        VkExtent2D targetExtent
+    )
+    {
+        VkImageBlit region{};
+        region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.srcSubresource.layerCount = 1;
+        region.srcOffsets[1] = {
+            static_cast<std::int32_t>(sourceExtent.width),
+            static_cast<std::int32_t>(sourceExtent.height),
+            1
+        };
+        region.dstSubresource = region.srcSubresource;
+        region.dstOffsets[1] = {
+            static_cast<std::int32_t>(targetExtent.width),
+            static_cast<std::int32_t>(targetExtent.height),
+            1
+        };
+
+        vkCmdBlitImage(
+            commandBuffer,
+            source,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            target,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1,
+            &region,
+            VK_FILTER_LINEAR
+        );
+    }
+} // namespace Resolution
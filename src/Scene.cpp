@@ -0,0 +1,277 @@
+#include "Scene.hpp"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define SCENE_SSE 1
+#endif
+
+namespace Scene
+{
+    namespace
+    {
+        std::uint32_t levelOf(const Graph &graph, NodeId node)
+        {
+            const auto &starts = graph.levelStart;
+            const auto next = std::upper_bound(starts.begin(), starts.end(), node);
+            return static_cast<std::uint32_t>(next - starts.begin()) - 1;
+        }
+
+        void markDirty(Graph &graph, NodeId node)
+        {
+            if (graph.dirty[node] == 0)
+            {
+                graph.dirty[node] = 1;
+                graph.dirtyNodes[levelOf(graph, node)].push_back(node);
+            }
+        }
+
+        /// Translation * rotation * scale, built column by column
+        glm::mat4 localMatrix(
+            const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale
+        )
+        {
+            const glm::mat3 basis = glm::mat3_cast(rotation);
+            return glm::mat4(
+                glm::vec4(basis[0] * scale.x, 0.0f),
+                glm::vec4(basis[1] * scale.y, 0.0f),
+                glm::vec4(basis[2] * scale.z, 0.0f),
+                glm::vec4(position, 1.0f)
+            );
+        }
+
+        /// parent * local; each result column is the parent's columns weighted by a local one
+        glm::mat4 multiply(const glm::mat4 &parent, const glm::mat4 &local)
+        {
+#ifdef SCENE_SSE
+            const __m128 c0 = _mm_loadu_ps(&parent[0][0]);
+            const __m128 c1 = _mm_loadu_ps(&parent[1][0]);
+            const __m128 c2 = _mm_loadu_ps(&parent[2][0]);
+            const __m128 c3 = _mm_loadu_ps(&parent[3][0]);
+
+            glm::mat4 result;
+            for (glm::length_t column = 0; column < 4; column++)
+            {
+                const float *weights = &local[column][0];
+                __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(weights[0]));
+                sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(weights[1])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(weights[2])));
+                sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(weights[3])));
+                _mm_storeu_ps(&result[column][0], sum);
+            }
+            return result;
+#else
+            return parent * local;
+#endif
+        }
+
+        void updateNode(Graph &graph, NodeId node)
+        {
+            const NodeId parent = graph.parents[node];
+            const glm::mat4 local =
+                localMatrix(graph.positions[node], graph.rotations[node], graph.scales[node]);
+            graph.world[node] = parent == NO_PARENT ? local : multiply(graph.world[parent], local);
+            graph.changed[node] = 1;
+            graph.dirty[node] = 0;
+        }
+
+        /// Recompute the nodes of [first, last) that are dirty or whose parent changed
+        void updateNodes(Graph &graph, std::uint32_t first, std::uint32_t last)
+        {
+            for (NodeId node = first; node < last; node++)
+            {
+                const NodeId parent = graph.parents[node];
+                const bool parentChanged = parent != NO_PARENT && graph.changed[parent] != 0;
+                if (graph.dirty[node] != 0 || parentChanged)
+                {
+                    updateNode(graph, node);
+                }
+            }
+        }
+    } // namespace
+
+    NodeId createNode(
+        Graph &graph,
+        NodeId parent,
+        const glm::vec3 &position,
+        const glm::quat &rotation,
+        const glm::vec3 &scale
+    )
+    {
+        if (parent != NO_PARENT && parent >= graph.size())
+        {
+            throw std::invalid_argument("scene node parent does not exist!");
+        }
+
+        const std::uint32_t depth = parent == NO_PARENT ? 0 : levelOf(graph, parent) + 1;
+        const auto levels = static_cast<std::uint32_t>(graph.dirtyNodes.size());
+        if (levels == 0)
+        {
+            graph.levelStart = {0, 0};
+            graph.dirtyNodes.resize(1);
+        }
+        else if (depth == levels)
+        {
+            graph.levelStart.push_back(graph.levelStart.back());
+            graph.dirtyNodes.emplace_back();
+        }
+        else if (depth + 1 != levels)
+        {
+            throw std::invalid_argument("scene nodes must be added breadth first!");
+        }
+
+        const NodeId node = graph.size();
+        graph.positions.push_back(position);
+        graph.rotations.push_back(rotation);
+        graph.scales.push_back(scale);
+        graph.parents.push_back(parent);
+        graph.world.emplace_back(1.0f);
+        graph.dirty.push_back(1);
+        graph.changed.push_back(0);
+        graph.levelStart.back()++;
+        graph.dirtyNodes[depth].push_back(node);
+        return node;
+    }
+
+    void setPosition(Graph &graph, NodeId node, const glm::vec3 &position)
+    {
+        graph.positions[node] = position;
+        markDirty(graph, node);
+    }
+
+    void setRotation(Graph &graph, NodeId node, const glm::quat &rotation)
+    {
+        graph.rotations[node] = rotation;
+        markDirty(graph, node);
+    }
+
+    void setScale(Graph &graph, NodeId node, const glm::vec3 &scale)
+    {
+        graph.scales[node] = scale;
+        markDirty(graph, node);
+    }
+
+    void updateWorld(Graph &graph, Jobs::JobSystem *jobs)
+    {
+        for (NodeId node : graph.changedNodes)
+        {
+            graph.changed[node] = 0;
+        }
+        graph.changedNodes.clear();
+        graph.ranges.clear();
+
+        /// A level is visited when it holds a dirty node or a node of the level above changed
+        bool aboveChanged = false;
+        for (std::uint32_t level = 0; level < graph.dirtyNodes.size(); level++)
+        {
+            std::vector<NodeId> &dirtyNodes = graph.dirtyNodes[level];
+            if (!aboveChanged)
+            {
+                /// Only the nodes set dirty can change; their children are found below
+                std::sort(dirtyNodes.begin(), dirtyNodes.end());
+                const auto count = static_cast<std::uint32_t>(dirtyNodes.size());
+                const std::uint32_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+                if (jobs == nullptr || chunks <= 1)
+                {
+                    for (NodeId node : dirtyNodes)
+                    {
+                        updateNode(graph, node);
+                    }
+                }
+                else
+                {
+                    Jobs::dispatch(
+                        *jobs,
+                        chunks,
+                        [&graph, &dirtyNodes, count](std::uint32_t chunk, std::uint32_t)
+                        {
+                            const std::uint32_t begin = chunk * CHUNK_SIZE;
+                            const std::uint32_t end = std::min(begin + CHUNK_SIZE, count);
+                            for (std::uint32_t i = begin; i < end; i++)
+                            {
+                                updateNode(graph, dirtyNodes[i]);
+                            }
+                        }
+                    );
+                }
+                graph.changedNodes.insert(
+                    graph.changedNodes.end(), dirtyNodes.begin(), dirtyNodes.end()
+                );
+                aboveChanged = !dirtyNodes.empty();
+                dirtyNodes.clear();
+                continue;
+            }
+            dirtyNodes.clear();
+
+            /// Any node may have a changed parent, so the whole level is scanned
+            const std::uint32_t first = graph.levelStart[level];
+            const std::uint32_t last = graph.levelStart[level + 1];
+            const std::uint32_t chunks = (last - first + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            if (jobs == nullptr || chunks <= 1)
+            {
+                updateNodes(graph, first, last);
+            }
+            else
+            {
+                /// Chunks write disjoint nodes and read parents finished by the level above
+                Jobs::dispatch(
+                    *jobs,
+                    chunks,
+                    [&graph, first, last](std::uint32_t chunk, std::uint32_t)
+                    {
+                        const std::uint32_t begin = first + chunk * CHUNK_SIZE;
+                        updateNodes(graph, begin, std::min(begin + CHUNK_SIZE, last));
+                    }
+                );
+            }
+
+            const std::size_t changedBefore = graph.changedNodes.size();
+            for (NodeId node = first; node < last; node++)
+            {
+                if (graph.changed[node] != 0)
+                {
+                    graph.changedNodes.push_back(node);
+                }
+            }
+            aboveChanged = graph.changedNodes.size() != changedBefore;
+        }
+
+        /// Collapse the changed nodes into ranges for the consumers' copies
+        for (NodeId node : graph.changedNodes)
+        {
+            if (!graph.ranges.empty()
+                && graph.ranges.back().first + graph.ranges.back().count == node)
+            {
+                graph.ranges.back().count++;
+            }
+            else
+            {
+                graph.ranges.push_back({node, 1});
+            }
+        }
+    }
+
+    bool updateCamera(Camera &camera, VkExtent2D extent)
+    {
+        if (!camera.dirty && camera.extent.width == extent.width
+            && camera.extent.height == extent.height)
+        {
+            return false;
+        }
+
+        camera.view = glm::lookAt(camera.position, camera.target, camera.up);
+        camera.proj = glm::perspective(
+            glm::radians(camera.fovDegrees),
+            extent.width / static_cast<float>(extent.height),
+            camera.nearPlane,
+            camera.farPlane
+        );
+        camera.proj[1][1] *= -1; ///< Flip Y for Vulkan (GLM uses OpenGL conventions)
+        camera.extent = extent;
+        camera.dirty = false;
+        return true;
+    }
+} // namespace Scene
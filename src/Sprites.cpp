@@ -0,0 +1,327 @@
+#include "Sprites.hpp"
+#include "Buffer.hpp"
+#include "GraphicsPipeline.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Sprites
+{
+    namespace
+    {
+        /// Layer, then opaque before blended, then material
+        std::uint64_t sortKey(const Sprite &sprite)
+        {
+            return (std::uint64_t{sprite.layer} << 33) | (std::uint64_t{sprite.blended} << 32)
+                   | sprite.materialIndex;
+        }
+
+        /// Write the corners of sorted sprites [first, last) into the mapped stream
+        void writeQuads(
+            Vertex *vertices,
+            std::span<const Sprite> sprites,
+            const std::vector<std::pair<std::uint64_t, std::uint32_t>> &order,
+            std::uint32_t first,
+            std::uint32_t last
+        )
+        {
+            for (std::uint32_t quad = first; quad < last; quad++)
+            {
+                const Sprite &sprite = sprites[order[quad].second];
+                const glm::vec2 low = sprite.position - sprite.size * 0.5f;
+                const glm::vec2 high = sprite.position + sprite.size * 0.5f;
+                const glm::vec4 &uv = sprite.uvRect;
+
+                /// Top left, top right, bottom right, bottom left (Buffer::indices order)
+                Vertex *corners = vertices + std::size_t{quad} * 4;
+                corners[0] = {{low.x, low.y}, {uv.x, uv.y}, sprite.color};
+                corners[1] = {{high.x, low.y}, {uv.z, uv.y}, sprite.color};
+                corners[2] = {{high.x, high.y}, {uv.z, uv.w}, sprite.color};
+                corners[3] = {{low.x, high.y}, {uv.x, uv.w}, sprite.color};
+            }
+        }
+
+        /// Sort keys and indices, leaving the sprites in place, and cut the order into batches
+        void sortSprites(Renderer &renderer, std::span<const Sprite> sprites)
+        {
+            const auto count = static_cast<std::uint32_t>(sprites.size());
+            auto &order = renderer.order;
+            order.resize(count);
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                order[i] = {sortKey(sprites[i]), i};
+            }
+            std::sort(
+                order.begin(),
+                order.end(),
+                [](const auto &a, const auto &b) { return a.first < b.first; }
+            );
+
+            /// A batch ends where the pipeline or the material changes
+            renderer.batches.clear();
+            for (std::uint32_t quad = 0; quad < count; quad++)
+            {
+                const Sprite &sprite = sprites[order[quad].second];
+                if (quad > 0 && order[quad].first == order[quad - 1].first)
+                {
+                    renderer.batches.back().quadCount++;
+                    continue;
+                }
+
+                Batch batch;
+                batch.firstQuad = quad;
+                batch.quadCount = 1;
+                batch.materialIndex = sprite.materialIndex;
+                batch.blended = sprite.blended;
+                renderer.batches.push_back(batch);
+            }
+            renderer.orderStale = false;
+        }
+
+        void destroyStream(VkDevice &device, Memory::Allocator &allocator, Stream &stream)
+        {
+            Buffer::destroyBuffer(device, allocator, stream.buffer, stream.allocation);
+            stream.capacity = 0;
+        }
+    } // namespace
+
+    void createRenderer(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        std::uint32_t frameCount,
+        Renderer &renderer,
+        Upload::Context &uploads
+    )
+    {
+        /// Every quad's two triangles, the last quad's corners ending at index 65535
+        std::vector<std::uint16_t> indices(std::size_t{QUADS_PER_DRAW} * 6);
+        for (std::uint32_t quad = 0; quad < QUADS_PER_DRAW; quad++)
+        {
+            for (std::size_t corner = 0; corner < Buffer::indices.size(); corner++)
+            {
+                indices[quad * 6 + corner] =
+                    static_cast<std::uint16_t>(quad * 4 + Buffer::indices[corner]);
+            }
+        }
+        Buffer::createIndexBuffer(
+            device,
+            allocator,
+            indices.data(),
+            indices.size() * sizeof(std::uint16_t),
+            renderer.indexBuffer,
+            renderer.indexMemory,
+            uploads
+        );
+
+        renderer.streams.resize(frameCount);
+    }
+
+    void destroyRenderer(VkDevice &device, Memory::Allocator &allocator, Renderer &renderer)
+    {
+        for (Stream &stream : renderer.streams)
+        {
+            destroyStream(device, allocator, stream);
+        }
+        renderer.streams.clear();
+        Buffer::destroyBuffer(device, allocator, renderer.indexBuffer, renderer.indexMemory);
+        renderer.order.clear();
+        renderer.batches.clear();
+        renderer.orderStale = true;
+    }
+
+    void prepare(
+        VkDevice &device,
+        Memory::Allocator &allocator,
+        Renderer &renderer,
+        std::uint32_t frameIndex,
+        std::span<const Sprite> sprites,
+        Jobs::JobSystem *jobs
+    )
+    {
+        const auto count = static_cast<std::uint32_t>(sprites.size());
+        auto &order = renderer.order;
+        if (renderer.orderStale || order.size() != count)
+        {
+            sortSprites(renderer, sprites);
+        }
+        if (count == 0)
+        {
+            return;
+        }
+
+        Stream &stream = renderer.streams[frameIndex];
+        if (stream.capacity < count)
+        {
+            std::uint32_t capacity = std::max(stream.capacity * 2, MIN_STREAM_QUADS);
+            while (capacity < count)
+            {
+                capacity *= 2;
+            }
+            destroyStream(device, allocator, stream);
+            Buffer::createBuffer(
+                device,
+                allocator,
+                VkDeviceSize{capacity} * 4 * sizeof(Vertex),
+                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                stream.buffer,
+                stream.allocation,
+                Memory::Category::Geometry
+            );
+            stream.capacity = capacity;
+        }
+
+        /// Chunks write disjoint quads; the memory is write-combined, so it is never read back
+        auto *vertices = static_cast<Vertex *>(stream.allocation.mapped);
+        const std::uint32_t chunks = (count + WRITE_CHUNK - 1) / WRITE_CHUNK;
+        if (jobs == nullptr || chunks <= 1)
+        {
+            writeQuads(vertices, sprites, order, 0, count);
+        }
+        else
+        {
+            Jobs::dispatch(
+                *jobs,
+                chunks,
+                [vertices, sprites, &order, count](std::uint32_t chunk, std::uint32_t)
+                {
+                    const std::uint32_t first = chunk * WRITE_CHUNK;
+                    const std::uint32_t last = std::min(first + WRITE_CHUNK, count);
+                    writeQuads(vertices, sprites, order, first, last);
+                }
+            );
+        }
+
+    }
+
+    void invalidateOrder(Renderer &renderer)
+    {
+        renderer.orderStale = true;
+    }
+
+    void record(
+        VkCommandBuffer commandBuffer,
+        VkPipelineLayout pipelineLayout,
+        const Renderer &renderer,
+        std::uint32_t frameIndex,
+        const DrawPipelines &pipelines,
+        VkExtent2D space
+    )
+    {
+        if (renderer.batches.empty())
+        {
+            return;
+        }
+
+        const VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &renderer.streams[frameIndex].buffer, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, renderer.indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+        /// Pixels to clip space; Vulkan's clip Y already points down like the pixel rows
+        GraphicsPipeline::DrawConstants constants;
+        constants.model = glm::ortho(
+            0.0f, static_cast<float>(space.width), 0.0f, static_cast<float>(space.height)
+        );
+        constants.materialIndex = renderer.batches.front().materialIndex;
+        vkCmdPushConstants(
+            commandBuffer,
+            pipelineLayout,
+            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0,
+            sizeof(constants),
+            &constants
+        );
+
+        VkPipeline bound = VK_NULL_HANDLE;
+        for (const Batch &batch : renderer.batches)
+        {
+            const VkPipeline pipeline = batch.blended ? pipelines.blended : pipelines.opaque;
+            if (pipeline != bound)
+            {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                bound = pipeline;
+            }
+            if (batch.materialIndex != constants.materialIndex)
+            {
+                constants.materialIndex = batch.materialIndex;
+                vkCmdPushConstants(
+                    commandBuffer,
+                    pipelineLayout,
+                    VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                    offsetof(GraphicsPipeline::DrawConstants, materialIndex),
+                    sizeof(constants.materialIndex),
+                    &constants.materialIndex
+                );
+            }
+
+            /// The index buffer covers QUADS_PER_DRAW quads; longer batches step the vertices
+            for (std::uint32_t done = 0; done < batch.quadCount; done += QUADS_PER_DRAW)
+            {
+                const std::uint32_t quads = std::min(batch.quadCount - done, QUADS_PER_DRAW);
+                vkCmdDrawIndexed(
+                    commandBuffer,
+                    quads * 6,
+                    1,
+                    0,
+                    static_cast<std::int32_t>((batch.firstQuad + done) * 4),
+                    0
+                );
+            }
+        }
+    }
+
+    std::uint32_t drawCount(const Renderer &renderer)
+    {
+        std::uint32_t draws = 0;
+        for (const Batch &batch : renderer.batches)
+        {
+            draws += (batch.quadCount + QUADS_PER_DRAW - 1) / QUADS_PER_DRAW;
+        }
+        return draws;
+    }
+
+    std::vector<Sprite> createField(
+        std::uint32_t count,
+        VkExtent2D extent,
+        std::uint32_t firstMaterial,
+        std::uint32_t materialCount
+    )
+    {
+        std::vector<Sprite> sprites(count);
+        const auto width = static_cast<float>(extent.width);
+        const auto height = static_cast<float>(extent.height);
+
+        /// Linear congruential generator: the same field every run
+        std::uint32_t state = 0x9e3779b9u;
+        const auto next = [&state]
+        {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+        };
+
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            Sprite &sprite = sprites[i];
+            sprite.layer = static_cast<std::uint16_t>(i % FIELD_LAYERS);
+            sprite.position = {next() * width, next() * height};
+
+            /// Farther layers hold smaller sprites
+            const float side = 4.0f + 4.0f * static_cast<float>(sprite.layer) + 8.0f * next();
+            sprite.size = {side, side};
+
+            /// Quarters of the texture, as if it were a 2x2 atlas
+            const float u = (i / FIELD_LAYERS) % 2 == 0 ? 0.0f : 0.5f;
+            const float v = (i / (FIELD_LAYERS * 2)) % 2 == 0 ? 0.0f : 0.5f;
+            sprite.uvRect = {u, v, u + 0.5f, v + 0.5f};
+
+            const auto channel = [&next]
+            { return 128u + static_cast<std::uint32_t>(next() * 127.0f); };
+            sprite.color = channel() | (channel() << 8) | (channel() << 16) | (0xc0u << 24);
+            sprite.materialIndex = firstMaterial + i % std::max(materialCount, 1u);
+            sprite.blended = sprite.layer != 0;
+        }
+
+        return sprites;
+    }
+} // namespace Sprites
@@ -0,0 +1,281 @@
+#include "Submit.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace Submit
+{
+    namespace
+    {
+        /**
+         * @struct Group
+         * @brief Work merged into one submit info
+         */
+        struct Group
+        {
+            std::vector<VkCommandBufferSubmitInfo> commandBuffers;
+            std::vector<VkSemaphoreSubmitInfo> waits;
+            std::vector<VkSemaphoreSubmitInfo> signals;
+        };
+
+        /// Add a semaphore, or widen the entry already naming it (highest value, all stages)
+        void merge(std::vector<VkSemaphoreSubmitInfo> &list, const VkSemaphoreSubmitInfo &info)
+        {
+            for (VkSemaphoreSubmitInfo &existing : list)
+            {
+                if (existing.semaphore == info.semaphore)
+                {
+                    existing.value = std::max(existing.value, info.value);
+                    existing.stageMask |= info.stageMask;
+                    return;
+                }
+            }
+            list.push_back(info);
+        }
+
+        /// True when a binary wait of work[index] is signalled by earlier work pending on
+        /// another queue; timeline waits may be submitted before their signal
+        bool waitsOnOtherQueue(
+            const std::vector<Work> &work, const std::vector<bool> &submitted, std::size_t index
+        )
+        {
+            for (const VkSemaphoreSubmitInfo &wait : work[index].waits)
+            {
+                if (wait.value != 0)
+                {
+                    continue;
+                }
+                for (std::size_t i = 0; i < index; i++)
+                {
+                    if (submitted[i] || work[i].queue == work[index].queue)
+                    {
+                        continue;
+                    }
+                    for (const VkSemaphoreSubmitInfo &signal : work[i].signals)
+                    {
+                        if (signal.semaphore == wait.semaphore)
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+
+        void submit2(
+            PFN_vkQueueSubmit2 queueSubmit2,
+            VkQueue queue,
+            const std::vector<Group> &groups,
+            VkFence fence
+        )
+        {
+            std::vector<VkSubmitInfo2> infos(groups.size());
+            for (std::size_t i = 0; i < groups.size(); i++)
+            {
+                infos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+                infos[i].waitSemaphoreInfoCount =
+                    static_cast<std::uint32_t>(groups[i].waits.size());
+                infos[i].pWaitSemaphoreInfos = groups[i].waits.data();
+                infos[i].commandBufferInfoCount =
+                    static_cast<std::uint32_t>(groups[i].commandBuffers.size());
+                infos[i].pCommandBufferInfos = groups[i].commandBuffers.data();
+                infos[i].signalSemaphoreInfoCount =
+                    static_cast<std::uint32_t>(groups[i].signals.size());
+                infos[i].pSignalSemaphoreInfos = groups[i].signals.data();
+            }
+
+            VK_CHECK(
+                queueSubmit2(queue, static_cast<std::uint32_t>(infos.size()), infos.data(), fence),
+                "submit batched work"
+            );
+        }
+
+        /// Synchronization 1: the same groups, with timeline values chained per submit info
+        void submit1(VkQueue queue, const std::vector<Group> &groups, VkFence fence)
+        {
+            struct Arrays
+            {
+                std::vector<VkSemaphore> waits;
+                std::vector<std::uint64_t> waitValues;
+                std::vector<VkPipelineStageFlags> waitStages;
+                std::vector<VkCommandBuffer> commandBuffers;
+                std::vector<VkSemaphore> signals;
+                std::vector<std::uint64_t> signalValues;
+            };
+
+            std::vector<Arrays> arrays(groups.size());
+            std::vector<VkTimelineSemaphoreSubmitInfo> timelines(groups.size());
+            std::vector<VkSubmitInfo> infos(groups.size());
+            for (std::size_t i = 0; i < groups.size(); i++)
+            {
+                Arrays &a = arrays[i];
+                for (const VkSemaphoreSubmitInfo &wait : groups[i].waits)
+                {
+                    a.waits.push_back(wait.semaphore);
+                    a.waitValues.push_back(wait.value);
+
+                    /// The stages used here share their bits with VkPipelineStageFlags
+                    a.waitStages.push_back(static_cast<VkPipelineStageFlags>(wait.stageMask));
+                }
+                for (const VkCommandBufferSubmitInfo &commandBuffer : groups[i].commandBuffers)
+                {
+                    a.commandBuffers.push_back(commandBuffer.commandBuffer);
+                }
+                for (const VkSemaphoreSubmitInfo &signal : groups[i].signals)
+                {
+                    a.signals.push_back(signal.semaphore);
+                    a.signalValues.push_back(signal.value);
+                }
+
+                timelines[i].sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+                timelines[i].waitSemaphoreValueCount = static_cast<std::uint32_t>(a.waits.size());
+                timelines[i].pWaitSemaphoreValues = a.waitValues.data();
+                timelines[i].signalSemaphoreValueCount =
+                    static_cast<std::uint32_t>(a.signals.size());
+                timelines[i].pSignalSemaphoreValues = a.signalValues.data();
+
+                infos[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                infos[i].pNext = &timelines[i];
+                infos[i].waitSemaphoreCount = static_cast<std::uint32_t>(a.waits.size());
+                infos[i].pWaitSemaphores = a.waits.data();
+                infos[i].pWaitDstStageMask = a.waitStages.data();
+                infos[i].commandBufferCount = static_cast<std::uint32_t>(a.commandBuffers.size());
+                infos[i].pCommandBuffers = a.commandBuffers.data();
+                infos[i].signalSemaphoreCount = static_cast<std::uint32_t>(a.signals.size());
+                infos[i].pSignalSemaphores = a.signals.data();
+            }
+
+            VK_CHECK(
+                vkQueueSubmit(queue, static_cast<std::uint32_t>(infos.size()), infos.data(), fence),
+                "submit batched work"
+            );
+        }
+    } // namespace
+
+    VkSemaphoreSubmitInfo semaphore(
+        VkSemaphore semaphore, std::uint64_t value, VkPipelineStageFlags2 stages
+    )
+    {
+        VkSemaphoreSubmitInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        info.semaphore = semaphore;
+        info.value = value;
+        info.stageMask = stages;
+        return info;
+    }
+
+    void enqueue(Batcher &batcher, Work work)
+    {
+        std::scoped_lock lock(batcher.mutex);
+        batcher.pending.push_back(std::move(work));
+        batcher.frame.work++;
+    }
+
+    void flush(Batcher &batcher)
+    {
+        std::scoped_lock lock(batcher.mutex);
+        const std::vector<Work> &work = batcher.pending;
+        std::vector<bool> submitted(work.size(), false);
+        std::size_t remaining = work.size();
+
+        /// Each pass submits the queue of the oldest pending work, as far as it can go: the
+        /// oldest work only depends on work already submitted, so every pass makes progress
+        while (remaining > 0)
+        {
+            const std::size_t first = static_cast<std::size_t>(
+                std::find(submitted.begin(), submitted.end(), false) - submitted.begin()
+            );
+            const VkQueue queue = work[first].queue;
+
+            std::vector<Group> groups;
+            VkFence fence = VK_NULL_HANDLE;
+            for (std::size_t i = first; i < work.size(); i++)
+            {
+                if (submitted[i] || work[i].queue != queue)
+                {
+                    continue;
+                }
+                if (waitsOnOtherQueue(work, submitted, i)
+                    || (work[i].fence != VK_NULL_HANDLE && fence != VK_NULL_HANDLE))
+                {
+                    break;
+                }
+
+                /// Work with waits starts a submit info, so the waits cannot hold back earlier
+                /// command buffers
+                if (groups.empty() || !work[i].waits.empty())
+                {
+                    groups.emplace_back();
+                }
+                Group &group = groups.back();
+                for (const VkSemaphoreSubmitInfo &wait : work[i].waits)
+                {
+                    merge(group.waits, wait);
+                }
+                for (VkCommandBuffer commandBuffer : work[i].commandBuffers)
+                {
+                    VkCommandBufferSubmitInfo info{};
+                    info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+                    info.commandBuffer = commandBuffer;
+                    group.commandBuffers.push_back(info);
+                }
+                for (const VkSemaphoreSubmitInfo &signal : work[i].signals)
+                {
+                    merge(group.signals, signal);
+                }
+                if (work[i].fence != VK_NULL_HANDLE)
+                {
+                    fence = work[i].fence;
+                }
+
+                submitted[i] = true;
+                remaining--;
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            if (batcher.queueSubmit2 != nullptr)
+            {
+                submit2(batcher.queueSubmit2, queue, groups, fence);
+            }
+            else
+            {
+                submit1(queue, groups, fence);
+            }
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            batcher.frame.calls++;
+            batcher.frame.batches += static_cast<std::uint32_t>(groups.size());
+            batcher.frame.submitMs += elapsed.count();
+        }
+
+        batcher.pending.clear();
+    }
+
+    VkResult present(Batcher &batcher, VkQueue queue, const VkPresentInfoKHR &presentInfo)
+    {
+        std::scoped_lock lock(batcher.mutex);
+        return vkQueuePresentKHR(queue, &presentInfo);
+    }
+
+    void waitIdle(Batcher &batcher, VkDevice device)
+    {
+        std::scoped_lock lock(batcher.mutex);
+        vkDeviceWaitIdle(device);
+    }
+
+    void endFrame(Batcher &batcher)
+    {
+        std::scoped_lock lock(batcher.mutex);
+        batcher.last = batcher.frame;
+        batcher.total.calls += batcher.frame.calls;
+        batcher.total.batches += batcher.frame.batches;
+        batcher.total.work += batcher.frame.work;
+        batcher.total.submitMs += batcher.frame.submitMs;
+        batcher.frames++;
+        batcher.frame = Stats{};
+    }
+} // namespace Submit
@@ -54,20 +54,123 @@ namespace SwapChain
         return availableFormats[0];
     }
 
-    VkPresentModeKHR
-    chooseSwapPresentMode(const std::vector<VkPresentModeKHR> &availablePresentModes)
+    VkPresentModeKHR chooseSwapPresentMode(
+        const std::vector<VkPresentModeKHR> &availablePresentModes, LatencyMode mode
+    )
     {
-        for (const auto &availablePresentMode : availablePresentModes)
+        std::vector<VkPresentModeKHR> preferred;
+        switch (mode)
+        {
+        case LatencyMode::Benchmark:
+            preferred = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case LatencyMode::LowLatency:
+            /// FIFO never drops frames, so present_wait ids map 1:1 to displayed images
+            break;
+        case LatencyMode::Balanced:
+        case LatencyMode::Throughput:
+            preferred = {VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        }
+
+        for (const auto presentMode : preferred)
         {
-            if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+            if (std::ranges::find(availablePresentModes, presentMode)
+                != availablePresentModes.end())
             {
-                return availablePresentMode;
+                return presentMode;
             }
         }
 
         return VK_PRESENT_MODE_FIFO_KHR;
     }
 
+    std::uint32_t
+    chooseImageCount(const VkSurfaceCapabilitiesKHR &capabilities, const PresentConfig &config)
+    {
+        std::uint32_t imageCount = config.imageCount;
+        if (imageCount == 0)
+        {
+            switch (config.mode)
+            {
+            case LatencyMode::LowLatency:
+                imageCount = std::max(capabilities.minImageCount, 2u);
+                break;
+            case LatencyMode::Throughput:
+                imageCount = capabilities.minImageCount + 2;
+                break;
+            case LatencyMode::Balanced:
+            case LatencyMode::Benchmark:
+                imageCount = capabilities.minImageCount + 1;
+                break;
+            }
+        }
+
+        imageCount = std::max(imageCount, capabilities.minImageCount);
+        if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount)
+        {
+            imageCount = capabilities.maxImageCount;
+        }
+        return imageCount;
+    }
+
+    std::uint32_t chooseFramesInFlight(const PresentConfig &config)
+    {
+        std::uint32_t framesInFlight = config.framesInFlight;
+        if (framesInFlight == 0)
+        {
+            switch (config.mode)
+            {
+            case LatencyMode::LowLatency:
+                framesInFlight = 1;
+                break;
+            case LatencyMode::Throughput:
+                framesInFlight = 3;
+                break;
+            case LatencyMode::Balanced:
+            case LatencyMode::Benchmark:
+                framesInFlight = 2;
+                break;
+            }
+        }
+
+        return std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+    }
+
+    void createPresentPacer(VkDevice &device, bool enabled, PresentPacer &pacer)
+    {
+        pacer = {};
+        if (!enabled)
+        {
+            return;
+        }
+
+        pacer.waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(
+            vkGetDeviceProcAddr(device, "vkWaitForPresentKHR")
+        );
+    }
+
+    void waitForPresent(
+        VkDevice &device, VkSwapchainKHR swapChain, const PresentPacer &pacer, std::uint64_t lag
+    )
+    {
+        if (pacer.waitForPresent == nullptr || pacer.lastPresentId <= lag)
+        {
+            return;
+        }
+
+        VkResult result = pacer.waitForPresent(
+            device, swapChain, pacer.lastPresentId - lag, PRESENT_WAIT_TIMEOUT_NS
+        );
+
+        /// OUT_OF_DATE is reported again by acquire/present, which recreate the swapchain
+        if (result != VK_SUCCESS && result != VK_TIMEOUT && result != VK_ERROR_OUT_OF_DATE_KHR
+            && result != VK_SUBOPTIMAL_KHR)
+        {
+            throw std::runtime_error("failed to wait for present!");
+        }
+    }
+
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities)
     {
         if (capabilities.currentExtent.width != std::numeric_limits<std::uint32_t>::max())
@@ -98,21 +201,18 @@ namespace SwapChain
         VkSurfaceKHR &surface,
         VkSwapchainKHR &swapChain,
         std::vector<VkImage> &swapChainImages,
-        VkExtent2D &swapChainExtent
+        VkExtent2D &swapChainExtent,
+        const PresentConfig &config,
+        VkSwapchainKHR oldSwapChain
     )
     {
         SwapChainSupportDetails details = querySwapChainSupport(physicalDevice, surface);
 
         VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(details.formats);
-        VkPresentModeKHR presentMode = chooseSwapPresentMode(details.presentModes);
+        VkPresentModeKHR presentMode = chooseSwapPresentMode(details.presentModes, config.mode);
         swapChainExtent = chooseSwapExtent(details.capabilities);
 
-        std::uint32_t imageCount = details.capabilities.minImageCount + 1;
-        if (details.capabilities.maxImageCount > 0
-            && imageCount > details.capabilities.maxImageCount)
-        {
-            imageCount = details.capabilities.maxImageCount;
-        }
+        std::uint32_t imageCount = chooseImageCount(details.capabilities, config);
 
         VkSwapchainCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -123,6 +223,14 @@ namespace SwapChain
         createInfo.imageExtent = swapChainExtent;
         createInfo.imageArrayLayers = 1;
         createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (config.blitTarget)
+        {
+            if ((details.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) == 0)
+            {
+                throw std::runtime_error("failed to create swap chain: no blit destination use!");
+            }
+            createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
 
         Queue::FamilyIndices indices = Queue::findQueueFamilies(physicalDevice, surface);
         std::uint32_t queueFamilyIndices[] =
@@ -145,12 +253,15 @@ namespace SwapChain
         createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         createInfo.presentMode = presentMode;
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = oldSwapChain;
 
-        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &swapChain) != VK_SUCCESS)
+        /// Write to a local first: swapChain may be the same handle as oldSwapChain
+        VkSwapchainKHR newSwapChain = VK_NULL_HANDLE;
+        if (vkCreateSwapchainKHR(device, &createInfo, nullptr, &newSwapChain) != VK_SUCCESS)
         {
             throw std::runtime_error("failed to create swap chain!");
         }
+        swapChain = newSwapChain;
 
         vkGetSwapchainImagesKHR(device, swapChain, &imageCount, nullptr);
         swapChainImages.resize(imageCount);
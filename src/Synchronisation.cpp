@@ -4,36 +4,16 @@
 
 void Synchronization::createSyncObjects(
     VkDevice &device,
-    std::vector<VkSemaphore> &imageAvailableSemaphores,
     std::vector<VkSemaphore> &renderFinishedSemaphores,
-    std::vector<VkFence> &inFlightFences,
-    std::size_t swapChainImageCount,
-    std::size_t maxFramesInFlight
+    std::size_t swapChainImageCount
 )
 {
-    // imageAvailableSemaphores: one per frame in flight (cycled through for acquire)
     // renderFinishedSemaphores: one per swapchain image (indexed by imageIndex)
-    imageAvailableSemaphores.resize(maxFramesInFlight);
     renderFinishedSemaphores.resize(swapChainImageCount);
-    inFlightFences.resize(maxFramesInFlight);
 
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    VkFenceCreateInfo fenceInfo{};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    // Create acquire semaphores (one per frame in flight)
-    for (size_t i = 0; i < maxFramesInFlight; i++)
-    {
-        if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphores[i])
-            != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create imageAvailable semaphore!");
-        }
-    }
-
     // Create renderFinished semaphores (one per swapchain image)
     for (size_t i = 0; i < swapChainImageCount; i++)
     {
@@ -43,13 +23,69 @@ void Synchronization::createSyncObjects(
             throw std::runtime_error("failed to create renderFinished semaphore!");
         }
     }
+}
+
+void Synchronization::createFrameSyncObjects(VkDevice &device, VkSemaphore &imageAvailableSemaphore)
+{
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    // Create fences for each frame in flight
-    for (size_t i = 0; i < maxFramesInFlight; i++)
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &imageAvailableSemaphore) != VK_SUCCESS)
     {
-        if (vkCreateFence(device, &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create fence!");
-        }
+        throw std::runtime_error("failed to create imageAvailable semaphore!");
+    }
+}
+
+void Synchronization::createTimeline(VkDevice &device, Timeline &timeline)
+{
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &timeline.semaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create timeline semaphore!");
+    }
+    timeline.lastSubmitted = 0;
+}
+
+void Synchronization::destroyTimeline(VkDevice &device, Timeline &timeline)
+{
+    vkDestroySemaphore(device, timeline.semaphore, nullptr);
+    timeline.semaphore = VK_NULL_HANDLE;
+    timeline.lastSubmitted = 0;
+}
+
+std::uint64_t Synchronization::completedValue(VkDevice &device, const Timeline &timeline)
+{
+    std::uint64_t value = 0;
+    if (vkGetSemaphoreCounterValue(device, timeline.semaphore, &value) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to query timeline semaphore!");
+    }
+    return value;
+}
+
+void Synchronization::waitForValue(VkDevice &device, const Timeline &timeline, std::uint64_t value)
+{
+    if (value == 0)
+    {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &timeline.semaphore;
+    waitInfo.pValues = &value;
+
+    if (vkWaitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to wait for timeline semaphore!");
     }
 }
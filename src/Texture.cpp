@@ -5,7 +5,10 @@
 namespace Image
 {
     void createTextureSampler(
-        VkDevice &device, VkPhysicalDevice &physicalDevice, VkSampler &textureSampler
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSampler &textureSampler,
+        std::uint32_t mipLevels
     )
     {
         VkPhysicalDeviceProperties properties{};
@@ -27,7 +30,7 @@ namespace Image
         samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
         samplerInfo.mipLodBias = 0.0f;
         samplerInfo.minLod = 0.0f;
-        samplerInfo.maxLod = 0.0f;
+        samplerInfo.maxLod = static_cast<float>(mipLevels);
 
         VK_CHECK(vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler),
                  "create texture sampler");
@@ -0,0 +1,406 @@
+#include "TextureStreamer.hpp"
+#include "Image.hpp"
+#include "ImageViews.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+namespace Streaming
+{
+    namespace
+    {
+        /// Read and transcode queued files until the streamer is destroyed
+        void loaderLoop(Streamer &streamer)
+        {
+            std::unique_lock<std::mutex> lock(streamer.mutex);
+            while (true)
+            {
+                streamer.wake.wait(
+                    lock, [&streamer] { return streamer.stopping || !streamer.loadQueue.empty(); }
+                );
+                if (streamer.stopping)
+                {
+                    return;
+                }
+
+                auto [handle, path] = std::move(streamer.loadQueue.front());
+                streamer.loadQueue.pop_front();
+
+                lock.unlock();
+                Ktx::TextureData data;
+                std::exception_ptr error;
+                try
+                {
+                    data = Ktx::loadKtx2(streamer.physicalDevice, path);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                lock.lock();
+
+                if (error)
+                {
+                    if (!streamer.error)
+                    {
+                        streamer.error = error;
+                    }
+                    continue;
+                }
+                streamer.loadedTextures.emplace_back(handle, std::move(data));
+            }
+        }
+
+        /// Bytes of the chain starting at level
+        VkDeviceSize chainBytes(const StreamedTexture &texture, std::uint32_t level)
+        {
+            const auto &levels = texture.source.levels;
+            return std::accumulate(
+                levels.begin() + level,
+                levels.end(),
+                VkDeviceSize{0},
+                [](VkDeviceSize sum, const Upload::ImageLevel &l) { return sum + l.size; }
+            );
+        }
+
+        /// Bytes streamed images may occupy: the process's device-local budget minus other use
+        VkDeviceSize availableBytes(const Streamer &streamer)
+        {
+            const VkPhysicalDeviceMemoryProperties &memProperties =
+                streamer.allocator->memoryProperties;
+
+            VkDeviceSize available = 0;
+            for (const Memory::HeapStats &heap : Memory::getHeapStats(*streamer.allocator))
+            {
+                if ((memProperties.memoryHeaps[heap.heapIndex].flags
+                     & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                    == 0)
+                {
+                    continue;
+                }
+
+                const auto limit = static_cast<VkDeviceSize>(heap.budget * BUDGET_FRACTION);
+                const VkDeviceSize otherUsage = heap.usage > streamer.residentBytes
+                                                    ? heap.usage - streamer.residentBytes
+                                                    : 0;
+                available = std::max(available, limit > otherUsage ? limit - otherUsage : 0);
+            }
+
+            if (streamer.budgetLimit != 0)
+            {
+                available = std::min(available, streamer.budgetLimit);
+            }
+            return available;
+        }
+
+        /// Coarsest level that still covers the requested on-screen size
+        std::uint32_t wantedLevel(const Streamer &streamer, const StreamedTexture &texture)
+        {
+            if (texture.requestedExtent == 0)
+            {
+                /// Not drawn this update: keep what is resident for a while, then drop to the tail
+                return streamer.updateIndex - texture.lastRequested > EVICT_AFTER_UPDATES
+                           ? texture.tailLevel
+                           : texture.residentLevel;
+            }
+
+            for (std::uint32_t level = texture.tailLevel; level > 0; level--)
+            {
+                const Upload::ImageLevel &l = texture.source.levels[level];
+                if (std::max(l.width, l.height) >= texture.requestedExtent)
+                {
+                    return level;
+                }
+            }
+            return 0;
+        }
+
+        /// Replace the texture's image by one holding levels [level, levelCount)
+        void rebuild(
+            Streamer &streamer,
+            StreamedTexture &texture,
+            std::uint32_t level,
+            std::uint64_t retireValue
+        )
+        {
+            const std::span<const Upload::ImageLevel> levels =
+                std::span(texture.source.levels).subspan(level);
+
+            VkImage image = VK_NULL_HANDLE;
+            Memory::Allocation memory;
+            Image::createImage(
+                streamer.device,
+                *streamer.allocator,
+                levels.front().width,
+                levels.front().height,
+                texture.source.format,
+                VK_IMAGE_TILING_OPTIMAL,
+                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                image,
+                memory,
+                static_cast<std::uint32_t>(levels.size()),
+                Memory::Category::Texture
+            );
+
+            /// Every resident level is copied again from the host chain; no GPU-side copy needed
+            Upload::uploadImage(
+                *streamer.uploads, texture.source.data.data(), image, texture.source.format, levels
+            );
+
+            VkImageView view = ImageViews::createImageView(
+                streamer.device,
+                image,
+                texture.source.format,
+                static_cast<std::uint32_t>(levels.size())
+            );
+
+            /// Frames submitted so far may still sample the old image
+            if (texture.image != VK_NULL_HANDLE)
+            {
+                Deletion::defer(
+                    *streamer.deletion,
+                    retireValue,
+                    [device = streamer.device,
+                     allocator = streamer.allocator,
+                     oldImage = texture.image,
+                     oldView = texture.view,
+                     oldMemory = texture.memory]() mutable
+                    {
+                        vkDestroyImageView(device, oldView, nullptr);
+                        Image::destroyImage(device, *allocator, oldImage, oldMemory);
+                    }
+                );
+            }
+
+            streamer.residentBytes = streamer.residentBytes - texture.residentBytes + memory.size;
+            texture.image = image;
+            texture.memory = memory;
+            texture.view = view;
+            texture.residentBytes = memory.size;
+            texture.residentLevel = level;
+        }
+
+        /// Move textures finished by the loader in and make their tail levels resident
+        bool acceptLoaded(Streamer &streamer, std::uint64_t retireValue)
+        {
+            std::vector<std::pair<TextureHandle, Ktx::TextureData>> loaded;
+            {
+                std::lock_guard<std::mutex> lock(streamer.mutex);
+                if (streamer.error)
+                {
+                    std::rethrow_exception(std::exchange(streamer.error, nullptr));
+                }
+                loaded.swap(streamer.loadedTextures);
+            }
+
+            for (auto &[handle, data] : loaded)
+            {
+                StreamedTexture &texture = *streamer.textures[handle];
+                if (data.levels.empty())
+                {
+                    throw std::runtime_error("failed to stream texture without mip levels!");
+                }
+
+                texture.source = std::move(data);
+                texture.loaded = true;
+                texture.levelCount = static_cast<std::uint32_t>(texture.source.levels.size());
+                texture.residentLevel = texture.levelCount;
+                texture.lastRequested = streamer.updateIndex;
+
+                texture.tailLevel = texture.levelCount - 1;
+                for (std::uint32_t level = 0; level < texture.levelCount; level++)
+                {
+                    const Upload::ImageLevel &l = texture.source.levels[level];
+                    if (std::max(l.width, l.height) <= MIN_RESIDENT_EXTENT)
+                    {
+                        texture.tailLevel = level;
+                        break;
+                    }
+                }
+
+                rebuild(streamer, texture, texture.tailLevel, retireValue);
+            }
+            return !loaded.empty();
+        }
+    } // namespace
+
+    void createStreamer(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        Memory::Allocator &allocator,
+        Upload::Context &uploads,
+        Deletion::Queue &deletion,
+        Streamer &streamer,
+        VkDeviceSize budgetLimit
+    )
+    {
+        streamer.device = device;
+        streamer.physicalDevice = physicalDevice;
+        streamer.allocator = &allocator;
+        streamer.uploads = &uploads;
+        streamer.deletion = &deletion;
+        streamer.budgetLimit = budgetLimit;
+
+        /// Views start at the finest resident level, so one sampler serves every residency
+        Image::createTextureSampler(device, physicalDevice, streamer.sampler, MAX_LEVELS);
+
+        streamer.loader = std::thread(loaderLoop, std::ref(streamer));
+    }
+
+    void destroyStreamer(Streamer &streamer)
+    {
+        {
+            std::lock_guard<std::mutex> lock(streamer.mutex);
+            streamer.stopping = true;
+        }
+        streamer.wake.notify_all();
+
+        if (streamer.loader.joinable())
+        {
+            streamer.loader.join();
+        }
+
+        for (auto &texture : streamer.textures)
+        {
+            if (texture->image != VK_NULL_HANDLE)
+            {
+                vkDestroyImageView(streamer.device, texture->view, nullptr);
+                Image::destroyImage(
+                    streamer.device, *streamer.allocator, texture->image, texture->memory
+                );
+            }
+        }
+        streamer.textures.clear();
+        streamer.residentBytes = 0;
+
+        vkDestroySampler(streamer.device, streamer.sampler, nullptr);
+        streamer.sampler = VK_NULL_HANDLE;
+    }
+
+    TextureHandle addTexture(Streamer &streamer, const std::filesystem::path &path)
+    {
+        const auto handle = static_cast<TextureHandle>(streamer.textures.size());
+        streamer.textures.push_back(std::make_unique<StreamedTexture>());
+        streamer.textures.back()->path = path;
+
+        {
+            std::lock_guard<std::mutex> lock(streamer.mutex);
+            streamer.loadQueue.emplace_back(handle, path);
+        }
+        streamer.wake.notify_one();
+        return handle;
+    }
+
+    void requestResolution(Streamer &streamer, TextureHandle handle, std::uint32_t screenExtent)
+    {
+        StreamedTexture &texture = *streamer.textures.at(handle);
+        texture.requestedExtent = std::max(texture.requestedExtent, screenExtent);
+    }
+
+    bool update(Streamer &streamer, std::uint64_t retireValue)
+    {
+        bool changed = acceptLoaded(streamer, retireValue);
+
+        std::vector<StreamedTexture *> resident;
+        for (auto &texture : streamer.textures)
+        {
+            if (texture->loaded)
+            {
+                if (texture->requestedExtent != 0)
+                {
+                    texture->lastRequested = streamer.updateIndex;
+                }
+                resident.push_back(texture.get());
+            }
+        }
+
+        /// Coarsen first: what is no longer needed frees budget for what is
+        for (StreamedTexture *texture : resident)
+        {
+            const std::uint32_t wanted = wantedLevel(streamer, *texture);
+            if (texture->residentLevel < wanted)
+            {
+                rebuild(streamer, *texture, wanted, retireValue);
+                changed = true;
+            }
+        }
+
+        /// Over budget (other allocations grew or the budget shrank): drop a level from the
+        /// least recently requested textures until back under it, never below their tails
+        const VkDeviceSize available = availableBytes(streamer);
+        std::sort(
+            resident.begin(),
+            resident.end(),
+            [](const StreamedTexture *a, const StreamedTexture *b)
+            {
+                return a->lastRequested < b->lastRequested;
+            }
+        );
+        for (StreamedTexture *texture : resident)
+        {
+            while (streamer.residentBytes > available
+                   && texture->residentLevel < texture->tailLevel)
+            {
+                rebuild(streamer, *texture, texture->residentLevel + 1, retireValue);
+                changed = true;
+            }
+        }
+
+        /// Refine one level at a time, largest shortfall first, within budget and the per-update
+        /// upload cap (the first refinement always goes through so large levels still arrive)
+        std::stable_sort(
+            resident.begin(),
+            resident.end(),
+            [&streamer](const StreamedTexture *a, const StreamedTexture *b)
+            {
+                return a->residentLevel - wantedLevel(streamer, *a)
+                       > b->residentLevel - wantedLevel(streamer, *b);
+            }
+        );
+
+        VkDeviceSize uploaded = 0;
+        for (StreamedTexture *texture : resident)
+        {
+            const std::uint32_t wanted = wantedLevel(streamer, *texture);
+            if (texture->residentLevel <= wanted)
+            {
+                continue;
+            }
+
+            const std::uint32_t level = texture->residentLevel - 1;
+            const VkDeviceSize bytes = chainBytes(*texture, level);
+            const VkDeviceSize growth =
+                bytes > texture->residentBytes ? bytes - texture->residentBytes : 0;
+            if (streamer.residentBytes + growth > available
+                || (uploaded != 0 && uploaded + bytes > MAX_UPDATE_BYTES))
+            {
+                continue;
+            }
+
+            rebuild(streamer, *texture, level, retireValue);
+            uploaded += bytes;
+            changed = true;
+        }
+
+        for (StreamedTexture *texture : resident)
+        {
+            texture->requestedExtent = 0;
+        }
+        streamer.updateIndex++;
+
+        if (changed)
+        {
+            Upload::submit(*streamer.uploads);
+        }
+        return changed;
+    }
+
+    VkImageView view(const Streamer &streamer, TextureHandle handle)
+    {
+        return streamer.textures.at(handle)->view;
+    }
+} // namespace Streaming
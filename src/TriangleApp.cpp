@@ -4,6 +4,7 @@
  */
 
 #include "TriangleApp.hpp"
+#include "Benchmark.hpp"
 #include "Image.hpp"
 #include "RenderConstants.hpp"
 #include "VulkanHelpers.hpp"
@@ -18,30 +19,123 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <utility>
 #include <chrono>
+#include <cmath>
 #include <cstddef>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <vulkan/vulkan_core.h>
 
 #include "Buffer.hpp"
 #include "Command.hpp"
+#include "Deletion.hpp"
 #include "Device.hpp"
 #include "Framebuffer.hpp"
 #include "GraphicsPipeline.hpp"
 #include "ImageViews.hpp"
 #include "Instance.hpp"
+#include "Mesh.hpp"
+#include "PipelineCache.hpp"
+#include "PipelineRegistry.hpp"
+#include "Profiler.hpp"
+#include "Scene.hpp"
+#include "Sprites.hpp"
 #include "SwapChain.hpp"
 #include "Synchronisation.hpp"
 
+/// Scene node whose world matrix is the model matrix of every draw; the instance nodes follow
+static constexpr Scene::NodeId MESH_NODE = 0;
+
+/**
+ * @brief Store the presentation and scene settings and resolve the frames-in-flight count
+ * @param presentConfig Latency mode, swapchain image count and frames in flight
+ * @param sceneConfig Instance count and draw path
+ */
+TriangleApp::TriangleApp(
+    const SwapChain::PresentConfig &presentConfig, const SceneConfig &sceneConfig
+)
+    : presentConfig(presentConfig),
+      sceneConfig(sceneConfig),
+      framesInFlight(SwapChain::chooseFramesInFlight(presentConfig))
+{
+}
+
 /**
  * @brief Main application entry point
- * @details Initializes window, Vulkan resources, runs the rendering loop, and cleans up
+ * @details Initializes window, Vulkan resources, runs the rendering loop, and cleans up.
+ *          Benchmarks open no window and run a fixed number of frames instead.
  */
 void TriangleApp::run()
 {
-    initWindow();
+    launchTime = std::chrono::steady_clock::now();
+    Profiler::createProfiler(profiler, sceneConfig.profile, sceneConfig.tracePath);
+    profiler.keepFrameTimes = sceneConfig.benchmark;
+    Resolution::createController(
+        resolution, sceneConfig.renderScalePercent / 100.0f, sceneConfig.targetFps
+    );
+    camera.position = RenderConstants::CAMERA_POSITION;
+    camera.target = RenderConstants::CAMERA_TARGET;
+    camera.up = RenderConstants::CAMERA_UP;
+    camera.fovDegrees = RenderConstants::CAMERA_FOV_DEGREES;
+    camera.nearPlane = RenderConstants::CAMERA_NEAR_PLANE;
+    camera.farPlane = RenderConstants::CAMERA_FAR_PLANE;
+    if (!sceneConfig.benchmark)
+    {
+        initWindow();
+    }
     initVulkan();
-    mainLoop();
+
+    /// The watcher polls the sources of the shaders in use and the scene texture
+    if (sceneConfig.hotReload)
+    {
+        HotReload::watchShader(watcher, std::string(GraphicsPipeline::vertShaderPath));
+        HotReload::watchShader(
+            watcher,
+            std::string(
+                sceneConfig.bindless ? GraphicsPipeline::bindlessFragShaderPath
+                                     : GraphicsPipeline::fragShaderPath
+            )
+        );
+        if (sceneConfig.spriteCount > 0)
+        {
+            HotReload::watchShader(watcher, std::string(Sprites::spriteVertShaderPath));
+            HotReload::watchShader(
+                watcher,
+                std::string(
+                    sceneConfig.bindless ? Sprites::spriteBindlessFragShaderPath
+                                         : Sprites::spriteFragShaderPath
+                )
+            );
+        }
+        HotReload::watchTexture(watcher, sceneTexturePath());
+        HotReload::start(watcher, vulkan.physicalDevice);
+
+        Loader::createLoader(
+            vulkan.device,
+            vulkan.physicalDevice,
+            vulkan.surface,
+            vulkan.graphicsQueue,
+            vulkan.transferQueue,
+            submits,
+            allocator,
+            loader
+        );
+    }
+
+    if (sceneConfig.benchmark)
+    {
+        runBenchmark();
+    }
+    else
+    {
+        mainLoop();
+    }
     cleanup();
 }
 
@@ -76,147 +170,676 @@ static void frameBufferResizeCallback(GLFWwindow *window, int width, int height)
 }
 
 /**
- * @brief Initialize all Vulkan resources in the correct order
+ * @brief Initialize all Vulkan resources as a dependency graph on the job system
  * @details Creates instance, devices, swapchain, graphics pipeline, buffers, textures, and synchronization primitives
- * @note Order is critical - dependencies must be created before dependent resources
+ * @note Each task names what it needs; independent work overlaps on the worker threads. The
+ *       texture decode and mesh import run during device creation, and the base pipeline
+ *       compiles while the swapchain, textures and buffers are created and uploaded. The
+ *       upload context and descriptor caches are not thread-safe, so the tasks using them
+ *       form a chain. Task timings become CPU zones on per-worker trace threads.
  */
 void TriangleApp::initVulkan()
 {
-    // Core Vulkan instance and device setup
-    Instance::createInstance(vulkan.instance); ///< Create Vulkan instance with validation layers
-
-    Instance::createSurface(
-        vulkan.instance, window, &vulkan.surface
-    ); ///< Platform-specific window surface
-
-    Device::
-        pickPhysicalDevice(vulkan.instance, vulkan.physicalDevice, vulkan.surface); ///< Select GPU
-    Device::checkDeviceExtensionSupport(vulkan.physicalDevice); ///< Verify swapchain support
-    Device::createLogicalDevice(
-        vulkan.physicalDevice,
-        vulkan.device,
-        vulkan.graphicsQueue,
-        vulkan.presentQueue,
-        vulkan.surface
+    Profiler::Scope initScope(profiler, "initVulkan");
+
+    // Worker threads: the startup tasks first, then recording large draw lists in parallel
+    Jobs::createJobSystem(jobs);
+
+    const bool debugLabels = sceneConfig.profile && Instance::supportsDebugUtils();
+    const std::string texturePath = sceneTexturePath();
+    const std::uint32_t instanceCount = std::max(sceneConfig.instanceCount, 1u);
+    const std::uint32_t drawCount = std::clamp(sceneConfig.drawCount, 1u, instanceCount);
+    Ktx::TextureData texels;
+    Mesh::MeshData meshData;
+    Mesh::MeshView mesh;
+    std::vector<Buffer::Instance> instanceGrid;
+
+    Jobs::TaskGraph graph;
+
+    // Core Vulkan instance and device setup (debug labels only matter when profiling)
+    const Jobs::TaskId device = Jobs::addTask(
+        graph,
+        "instance and device",
+        {},
+        [this, debugLabels]
+        {
+            Instance::createInstance(
+                vulkan.instance, debugLabels, !sceneConfig.benchmark
+            ); ///< Instance with validation layers
+
+            /// Headless runs have no surface; queue selection then treats graphics as present
+            if (!sceneConfig.benchmark)
+            {
+                Instance::createSurface(
+                    vulkan.instance, window, &vulkan.surface
+                ); ///< Platform-specific window surface
+            }
+
+            Device::pickPhysicalDevice(
+                vulkan.instance, vulkan.physicalDevice, vulkan.surface, sceneConfig.device
+            ); ///< Select GPU (best rated, or the one --device or VULKAN_TUTO_DEVICE names)
+
+            /// Low-latency pacing needs present_wait; without it the single frame slot still
+            /// bounds lag
+            const bool presentWait = !sceneConfig.benchmark
+                                     && presentConfig.mode == SwapChain::LatencyMode::LowLatency
+                                     && Device::supportsPresentWait(vulkan.physicalDevice);
+
+            /// Vulkan 1.3 devices render without render pass objects or framebuffers, and the
+            /// frame graph's barriers keep their per-image stage masks
+            const bool dynamicRendering =
+                !sceneConfig.renderPass && Device::supportsDynamicRendering(vulkan.physicalDevice);
+
+            /// Culling moves to a compute-only queue when the device has one, overlapping the
+            /// frames still drawing
+            const bool asyncCompute = sceneConfig.gpuCulling && !sceneConfig.singleQueue;
+            Device::createLogicalDevice(
+                vulkan.physicalDevice,
+                vulkan.device,
+                vulkan.graphicsQueue,
+                vulkan.presentQueue,
+                vulkan.transferQueue,
+                vulkan.computeQueue,
+                vulkan.asyncComputeQueue,
+                vulkan.surface,
+                presentWait,
+                dynamicRendering,
+                asyncCompute
+            );
+            SwapChain::createPresentPacer(vulkan.device, presentWait, presentPacer);
+            if (dynamicRendering)
+            {
+                Device::loadDynamicRendering(vulkan.device, vulkan.dynamicRendering);
+            }
+            submits.queueSubmit2 = vulkan.dynamicRendering.queueSubmit2; ///< Null = sync1
+
+            // Device memory sub-allocator (caches memory properties, owns large blocks)
+            Memory::createAllocator(
+                vulkan.device,
+                vulkan.physicalDevice,
+                allocator,
+                Device::supportsMemoryBudget(vulkan.physicalDevice)
+            );
+
+            // Upload batches (copies run on the dedicated transfer family when available)
+            Upload::createContext(
+                vulkan.device,
+                vulkan.physicalDevice,
+                vulkan.surface,
+                allocator,
+                vulkan.graphicsQueue,
+                vulkan.transferQueue,
+                submits,
+                uploads
+            );
+
+            // Descriptor layouts are shared through the cache; long-lived sets come from a
+            // pool chain
+            Descriptors::createLayoutCache(vulkan.device, layouts);
+            Descriptors::createAllocator(
+                vulkan.device, 8, Descriptors::DEFAULT_RATIOS, descriptors
+            );
+        }
     );
 
-    // Swapchain creation (presentation engine)
-    SwapChain::createSwapChain(
-        vulkan.physicalDevice,
-        vulkan.device,
-        vulkan.surface,
-        swapchain.swapChain,
-        swapchain.images,
-        swapchain.extent
+    // Asset pack: shaders, texels and mesh buffers baked offline
+    const Jobs::TaskId pack = Jobs::addTask(
+        graph,
+        "asset pack",
+        {},
+        [this]
+        {
+            if (!sceneConfig.assetPack.empty())
+            {
+                AssetPack::openPack(sceneConfig.assetPack, assets);
+            }
+        }
     );
 
-    // Create image views for each swapchain image
-    ImageViews::createImageViews(
-        vulkan.device, swapchain.images, VK_FORMAT_B8G8R8A8_SRGB, swapchain.imageViews
+    // Texture decode, once for every copy; KTX2 transcoding picks a format of the device
+    const bool decodeNeedsDevice = Image::decodeNeedsDevice(texturePath);
+    std::vector<Jobs::TaskId> decodeDependencies = {pack};
+    if (decodeNeedsDevice)
+    {
+        decodeDependencies.push_back(device);
+    }
+    const Jobs::TaskId decode = Jobs::addTask(
+        graph,
+        "decode texture",
+        decodeDependencies,
+        [this, &texturePath, &texels, decodeNeedsDevice]
+        {
+            if (AssetPack::find(assets, texturePath, AssetPack::AssetType::Texture) == nullptr)
+            {
+                texels = Image::decodeTexture(
+                    texturePath, decodeNeedsDevice ? vulkan.physicalDevice : VK_NULL_HANDLE
+                );
+            }
+        }
     );
 
-    // Graphics pipeline setup
-    GraphicsPipeline::
-        createRenderPass(vulkan.device, pipeline.renderPass); ///< Define rendering attachments
-
-    Buffer::createDescriptorSetLayout(
-        vulkan.device, pipeline.descriptorSetLayout
-    ); ///< Shader resource layout
-
-    GraphicsPipeline::createGraphicsPipeline(
-        vulkan.device,
-        swapchain.extent,
-        pipeline.layout,
-        pipeline.pipeline,
-        pipeline.renderPass,
-        pipeline.descriptorSetLayout
+    // Geometry: baked in the pack, else the imported mesh or the built-in quad (packed either way)
+    const Jobs::TaskId meshImport = Jobs::addTask(
+        graph,
+        "load mesh",
+        {pack},
+        [this, &meshData, &mesh]
+        {
+            if (!AssetPack::findMesh(assets, mesh))
+            {
+                meshData = sceneConfig.meshPath.empty()
+                               ? Mesh::fromVertices(Buffer::vertices, Buffer::indices)
+                               : Mesh::loadMesh(sceneConfig.meshPath);
+                mesh = Mesh::view(meshData);
+            }
+        }
     );
 
-    // Create framebuffers (one per swapchain image)
-    Framebuffer::createFramebuffers(
-        vulkan.device,
-        pipeline.renderPass,
-        swapchain.imageViews,
-        swapchain.extent,
-        swapchain.framebuffers
+    // Graphics pipeline cache, seeded from the previous run when compatible
+    const Jobs::TaskId cache = Jobs::addTask(
+        graph,
+        "pipeline cache",
+        {device},
+        [this]
+        {
+            PipelineCache::createPipelineCache(
+                vulkan.device, vulkan.physicalDevice, pipeline.cache
+            );
+        }
     );
 
-    // Command buffer infrastructure
-    Command::createCommandPool(vulkan.device, vulkan.physicalDevice, vulkan.surface, commandPool);
-
-    // Texture loading and setup
-    Image::createTextureImage(
-        vulkan.device,
-        vulkan.physicalDevice,
-        texture.image,
-        texture.memory,
-        commandPool,
-        vulkan.graphicsQueue
+    // Render pass, shader resource layouts and the pipeline layout
+    const Jobs::TaskId layout = Jobs::addTask(
+        graph,
+        "pipeline layout",
+        {device},
+        [this]
+        {
+            pipeline.depthFormat = GraphicsPipeline::findDepthFormat(vulkan.physicalDevice);
+            createFrameGraph(); ///< Passes, their barriers and the render pass
+
+            Buffer::createDescriptorSetLayout(
+                layouts, pipeline.descriptorSetLayout
+            ); ///< Shader resource layout
+
+            // Bindless: one texture and material table as set 1, bound once per frame
+            std::vector<VkDescriptorSetLayout> setLayouts = {pipeline.descriptorSetLayout};
+            if (sceneConfig.bindless)
+            {
+                if (!Device::supportsBindless(vulkan.physicalDevice))
+                {
+                    throw std::runtime_error(
+                        "failed to enable bindless, no descriptor indexing support!"
+                    );
+                }
+                Bindless::createTable(
+                    vulkan.device, vulkan.physicalDevice, allocator, framesInFlight, bindless
+                );
+                setLayouts.push_back(bindless.layout);
+            }
+
+            GraphicsPipeline::createPipelineLayout(vulkan.device, setLayouts, pipeline.layout);
+        }
     );
 
-    ImageViews::createTextureImageView(vulkan.device, texture.image, texture.view);
-
-    Image::createTextureSampler(
-        vulkan.device, vulkan.physicalDevice, texture.sampler
-    ); ///< Texture filtering
+    /**
+     * Only the fallback, the opaque variant without a pre-pass, is built here, while the
+     * swapchain, textures and buffers are created and uploaded. Every other variant is queued
+     * for the compiler thread and picked up by drawFrame once it is ready.
+     */
+    const Jobs::TaskId basePipeline = Jobs::addTask(
+        graph,
+        "pipeline",
+        {layout, cache, pack},
+        [this]
+        {
+            Pipelines::createRegistry(
+                vulkan.device,
+                pipeline.layout,
+                pipeline.cache,
+                pipelines,
+                1,
+                AssetPack::isOpen(assets) ? &assets : nullptr
+            );
+
+            /// Without a render pass object the pipelines name their attachment formats
+            GraphicsPipeline::PipelineState baseState;
+            baseState.renderPass = pipeline.renderPass;
+            baseState.colorFormat = VK_FORMAT_B8G8R8A8_SRGB;
+            baseState.depthFormat = pipeline.depthFormat;
+            if (sceneConfig.bindless)
+            {
+                baseState.fragmentShader = std::string(GraphicsPipeline::bindlessFragShaderPath);
+            }
+            pipeline.fallbackKey = Pipelines::build(pipelines, baseState);
+            Pipelines::setFallback(pipelines, pipeline.fallbackKey);
+            pipeline.key = pipeline.fallbackKey;
+
+            /// After a depth pre-pass the opaque draws only shade the surfaces it kept
+            if (sceneConfig.depthPrepass)
+            {
+                GraphicsPipeline::PipelineState prepassState = baseState;
+                prepassState.fragmentShader.clear();
+                prepassState.colorWrite = false;
+                pipeline.prepassKey = Pipelines::request(pipelines, prepassState);
+
+                baseState.depthWrite = false;
+                baseState.depthCompare = VK_COMPARE_OP_LESS_OR_EQUAL;
+                pipeline.key = Pipelines::request(pipelines, baseState);
+            }
+
+            /// Blended draws are tested against the opaque depth but leave it untouched
+            GraphicsPipeline::PipelineState blendedState = baseState;
+            blendedState.blendEnable = true;
+            blendedState.depthWrite = false;
+            blendedState.depthCompare = VK_COMPARE_OP_LESS_OR_EQUAL;
+            pipeline.blendedKey = Pipelines::request(pipelines, blendedState);
+
+            /// Sprites are screen space: drawn last, over the scene and without its depth
+            if (sceneConfig.spriteCount > 0)
+            {
+                GraphicsPipeline::PipelineState spriteState;
+                spriteState.renderPass = pipeline.renderPass;
+                spriteState.colorFormat = VK_FORMAT_B8G8R8A8_SRGB;
+                spriteState.depthFormat = pipeline.depthFormat;
+                spriteState.vertexShader = std::string(Sprites::spriteVertShaderPath);
+                spriteState.fragmentShader = std::string(
+                    sceneConfig.bindless ? Sprites::spriteBindlessFragShaderPath
+                                         : Sprites::spriteFragShaderPath
+                );
+                spriteState.vertexLayout = GraphicsPipeline::VertexLayout::Sprite;
+                spriteState.cullMode = VK_CULL_MODE_NONE;
+                spriteState.depthTest = false;
+                spriteState.depthWrite = false;
+                pipeline.spriteKey = Pipelines::request(pipelines, spriteState);
+
+                spriteState.blendEnable = true;
+                pipeline.spriteBlendKey = Pipelines::request(pipelines, spriteState);
+            }
+
+            /// The cull shader module is created here too, off the resource chain
+            if (sceneConfig.gpuCulling)
+            {
+                Pipelines::getShaderModule(pipelines, std::string(Culling::cullShaderPath));
+            }
+        }
+    );
 
-    // Vertex and index buffer creation
-    Buffer::createVertexBuffer(
-        vulkan.device,
-        vulkan.physicalDevice,
-        buffers.vertexBuffer,
-        buffers.vertexMemory,
-        commandPool,
-        vulkan.graphicsQueue
+    // Swapchain creation (presentation engine), or offscreen images when headless, with one
+    // view per image and the depth attachment they share (and framebuffers for render passes)
+    const Jobs::TaskId targets = Jobs::addTask(
+        graph,
+        "swapchain",
+        {layout},
+        [this]
+        {
+            /// Upscaled frames blit into the swapchain images
+            presentConfig.blitTarget = sceneConfig.upscaled();
+            if (sceneConfig.benchmark)
+            {
+                createOffscreenTargets();
+            }
+            else
+            {
+                SwapChain::createSwapChain(
+                    vulkan.physicalDevice,
+                    vulkan.device,
+                    vulkan.surface,
+                    swapchain.swapChain,
+                    swapchain.images,
+                    swapchain.extent,
+                    presentConfig
+                );
+            }
+
+            ImageViews::createImageViews(
+                vulkan.device, swapchain.images, VK_FORMAT_B8G8R8A8_SRGB, swapchain.imageViews
+            );
+
+            RenderGraph::createTransients(
+                vulkan.device,
+                allocator,
+                frameGraph.graph,
+                swapchain.extent,
+                swapchain.transients
+            );
+            createFramebuffers();
+        }
     );
 
-    Buffer::createIndexBuffer(
-        vulkan.device,
-        vulkan.physicalDevice,
-        buffers.indexBuffer,
-        buffers.indexMemory,
-        commandPool,
-        vulkan.graphicsQueue
+    // Texture images from the decoded texels (benchmarks may load further copies to sample
+    // from), their bindless materials and the streamer
+    const Jobs::TaskId textures = Jobs::addTask(
+        graph,
+        "textures",
+        {targets, decode},
+        [this, &texturePath, &texels]
+        {
+            loadTexture(texture, texturePath, texels);
+            extraTextures.resize(std::max(sceneConfig.textureCount, 1u) - 1);
+            for (TextureResources &extra : extraTextures)
+            {
+                loadTexture(extra, texturePath, texels);
+            }
+
+            if (!bindless.sets.empty())
+            {
+                textureSlot = Bindless::addTexture(bindless, texture.view, texture.sampler);
+                Bindless::Material material;
+                material.textureIndex = textureSlot;
+                materialIndex = Bindless::addMaterial(bindless, material);
+
+                /// One material per extra texture, right after the first, cycled over the draws
+                for (const TextureResources &extra : extraTextures)
+                {
+                    material.textureIndex =
+                        Bindless::addTexture(bindless, extra.view, extra.sampler);
+                    Bindless::addMaterial(bindless, material);
+                }
+            }
+
+            // Streamed texture: loaded in the background, drawn instead once its tail levels
+            // are in
+            if (!sceneConfig.streamPath.empty())
+            {
+                Streaming::createStreamer(
+                    vulkan.device,
+                    vulkan.physicalDevice,
+                    allocator,
+                    uploads,
+                    deletionQueue,
+                    streamer,
+                    VkDeviceSize{sceneConfig.streamBudgetMiB} * 1024 * 1024
+                );
+                streamedTexture = Streaming::addTexture(streamer, sceneConfig.streamPath);
+            }
+        }
     );
 
-    // Uniform buffer setup (per frame in flight for dynamic updates)
-    Buffer::createUniformBuffers(
-        vulkan.device,
-        vulkan.physicalDevice,
-        buffers.uniformBuffers,
-        buffers.uniformMemory,
-        buffers.uniformMapped
+    // Draw records: one covers every instance unless the instances are split into drawCount
+    // consecutive ranges
+    const auto drawRange = [instanceCount, drawCount](std::uint32_t draw)
+    {
+        const auto first = static_cast<std::uint64_t>(instanceCount) * draw / drawCount;
+        const auto last = static_cast<std::uint64_t>(instanceCount) * (draw + 1) / drawCount;
+        return std::pair(
+            static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last - first)
+        );
+    };
+
+    // Vertex, index, instance and indirect buffers, uploaded in one batch with the textures
+    const Jobs::TaskId geometry = Jobs::addTask(
+        graph,
+        "geometry",
+        {textures, meshImport},
+        [this, &mesh, &instanceGrid, instanceCount, drawCount, &drawRange]
+        {
+            buffers.indexType = mesh.indexType;
+            buffers.boundingRadius = mesh.boundingRadius * mesh.scale;
+
+            Buffer::createVertexBuffer(
+                vulkan.device,
+                allocator,
+                mesh.vertices.data(),
+                mesh.vertices.size(),
+                buffers.vertexBuffer,
+                buffers.vertexMemory,
+                uploads
+            );
+
+            Buffer::createIndexBuffer(
+                vulkan.device,
+                allocator,
+                mesh.indices.data(),
+                mesh.indices.size(),
+                buffers.indexBuffer,
+                buffers.indexMemory,
+                uploads
+            );
+
+            // Per-instance data: a grid of copies (a single centred one by default), placed as
+            // scene nodes in the mesh's space. Their world matrices give the uploaded offsets
+            // and scales, with the mesh's own centre and scale folded in; nothing moves them
+            // afterwards, so no later update writes a range
+            instanceGrid = Buffer::createInstanceGrid(instanceCount);
+            Scene::createNode(scene, Scene::NO_PARENT);
+            for (const Buffer::Instance &instance : instanceGrid)
+            {
+                Scene::createNode(
+                    scene,
+                    Scene::NO_PARENT,
+                    glm::vec3(instance.offsetScale),
+                    glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                    glm::vec3(instance.offsetScale.w)
+                );
+            }
+            Scene::updateWorld(scene, nullptr); ///< Inside the task graph: no dispatch
+            for (const Scene::Range &range : scene.ranges)
+            {
+                for (Scene::NodeId node = range.first; node < range.first + range.count; node++)
+                {
+                    if (node == MESH_NODE)
+                    {
+                        continue;
+                    }
+                    const glm::mat4 &world = scene.world[node];
+                    instanceGrid[node - 1].offsetScale = Mesh::placeInstance(
+                        mesh, glm::vec4(glm::vec3(world[3]), glm::length(glm::vec3(world[0])))
+                    );
+                }
+            }
+            Buffer::createInstanceBuffer(
+                vulkan.device,
+                allocator,
+                instanceGrid,
+                buffers.instanceBuffer,
+                buffers.instanceMemory,
+                uploads
+            );
+
+            VkPhysicalDeviceFeatures features;
+            vkGetPhysicalDeviceFeatures(vulkan.physicalDevice, &features);
+            if (sceneConfig.indirect && !sceneConfig.gpuCulling && drawCount > 1
+                && !features.drawIndirectFirstInstance)
+            {
+                throw std::runtime_error(
+                    "failed to split indirect draws, no drawIndirectFirstInstance!"
+                );
+            }
+
+            // Indirect arguments: the draw ranges as VkDrawIndexedIndirectCommand records
+            std::vector<VkDrawIndexedIndirectCommand> meshCommands;
+            for (std::uint32_t draw = 0; draw < drawCount; draw++)
+            {
+                const auto [firstInstance, count] = drawRange(draw);
+                meshCommands.push_back({mesh.indexCount, count, 0, 0, firstInstance});
+            }
+            Buffer::createIndirectBuffer(
+                vulkan.device,
+                allocator,
+                meshCommands,
+                buffers.indirectBuffer,
+                buffers.indirectMemory,
+                uploads
+            );
+
+            // Sprites: the shared quad indices, and a field covering the window drawn with the
+            // scene's materials
+            if (sceneConfig.spriteCount > 0)
+            {
+                Sprites::createRenderer(
+                    vulkan.device, allocator, framesInFlight, spriteRenderer, uploads
+                );
+                const bool tableMaterials = !bindless.sets.empty();
+                sprites = Sprites::createField(
+                    sceneConfig.spriteCount,
+                    swapchain.extent,
+                    tableMaterials ? materialIndex : 0,
+                    tableMaterials ? static_cast<std::uint32_t>(extraTextures.size()) + 1 : 1
+                );
+            }
+
+            // Texture, geometry and indirect uploads go out in one batch; nothing waits on it
+            Upload::submit(uploads);
+        }
     );
 
-    // Descriptor pool and sets (links shaders to resources)
-    Buffer::createDescriptorPool(vulkan.device, descriptorPool);
-    Buffer::createDescriptorSets(
-        vulkan.device,
-        descriptorPool,
-        descriptorSets,
-        pipeline.descriptorSetLayout,
-        buffers.uniformBuffers,
-        texture.view,
-        texture.sampler
+    // Per-frame resources: command pool, sync objects, uniform ring region, descriptors,
+    // staging, queries, worker pools, the cull pass and the draw list
+    Jobs::addTask(
+        graph,
+        "frame resources",
+        {geometry, basePipeline},
+        [this, &mesh, &instanceGrid, instanceCount, drawCount, &drawRange, debugLabels]
+        {
+            Frame::createFrameContexts(
+                vulkan.device,
+                vulkan.physicalDevice,
+                vulkan.surface,
+                allocator,
+                framesInFlight,
+                frames,
+                uniforms
+            );
+
+            // Timestamp and statistics queries, one range per frame slot (profiling only)
+            Profiler::createGpuQueries(
+                profiler,
+                vulkan.instance,
+                vulkan.device,
+                vulkan.physicalDevice,
+                vulkan.surface,
+                framesInFlight,
+                debugLabels
+            );
+
+            // Per-thread, per-frame pools for recording large draw lists in parallel
+            Command::createParallelRecorder(
+                vulkan.device,
+                vulkan.physicalDevice,
+                vulkan.surface,
+                framesInFlight,
+                Jobs::threadCount(jobs),
+                recorder
+            );
+
+            // GPU culling: a compute pass compacts the visible instances and writes the draw
+            // arguments, into one output set per frame slot (on the async compute queue if any)
+            if (sceneConfig.gpuCulling)
+            {
+                const bool async = vulkan.asyncComputeQueue != VK_NULL_HANDLE;
+                Culling::createCullPass(
+                    vulkan.device,
+                    allocator,
+                    layouts,
+                    descriptors,
+                    Pipelines::getShaderModule(pipelines, std::string(Culling::cullShaderPath)),
+                    pipeline.cache,
+                    buffers.instanceBuffer,
+                    instanceCount,
+                    mesh.indexCount,
+                    mesh.boundingRadius,
+                    framesInFlight,
+                    culling
+                );
+                if (async)
+                {
+                    AsyncCompute::createContext(
+                        vulkan.device,
+                        vulkan.physicalDevice,
+                        vulkan.surface,
+                        vulkan.asyncComputeQueue,
+                        submits,
+                        framesInFlight,
+                        asyncCompute
+                    );
+                }
+            }
+
+            // Draw list: the instanced mesh, as CPU draws or as GPU-sourced records (the cull
+            // pass writes a single record for all instances; drawFrame points the draw at the
+            // frame's output set)
+            if (sceneConfig.gpuCulling)
+            {
+                Command::IndirectDraw draw;
+                draw.vertexBuffer = buffers.vertexBuffer;
+                draw.indexBuffer = buffers.indexBuffer;
+                draw.indexType = buffers.indexType;
+                draw.instanceBuffer = culling.outputs.front().visibleBuffer;
+                draw.argumentBuffer = culling.outputs.front().argumentBuffer;
+                draw.drawCount = 1;
+                draw.materialIndex = materialIndex;
+                indirectDraws.push_back(draw);
+            }
+            else if (sceneConfig.indirect)
+            {
+                Command::IndirectDraw draw;
+                draw.vertexBuffer = buffers.vertexBuffer;
+                draw.indexBuffer = buffers.indexBuffer;
+                draw.indexType = buffers.indexType;
+                draw.instanceBuffer = buffers.instanceBuffer;
+                draw.argumentBuffer = buffers.indirectBuffer;
+                draw.drawCount = drawCount;
+                draw.materialIndex = materialIndex;
+                draw.multiDraw = Device::supportsMultiDrawIndirect(vulkan.physicalDevice);
+                indirectDraws.push_back(draw);
+            }
+            else
+            {
+                /// Each draw is sorted by the centre of its instances; the last blendedDraws
+                /// records are drawn blended
+                const auto materialCount = static_cast<std::uint32_t>(extraTextures.size()) + 1;
+                const std::uint32_t firstBlended =
+                    drawCount - std::min(sceneConfig.blendedDraws, drawCount);
+                for (std::uint32_t i = 0; i < drawCount; i++)
+                {
+                    const auto [firstInstance, count] = drawRange(i);
+
+                    glm::vec3 center(0.0f);
+                    for (std::uint32_t j = firstInstance; j < firstInstance + count; j++)
+                    {
+                        center += glm::vec3(instanceGrid[j].offsetScale);
+                    }
+
+                    Command::DrawItem draw;
+                    draw.vertexBuffer = buffers.vertexBuffer;
+                    draw.indexBuffer = buffers.indexBuffer;
+                    draw.indexType = buffers.indexType;
+                    draw.indexCount = mesh.indexCount;
+                    draw.instanceBuffer = buffers.instanceBuffer;
+                    draw.instanceCount = count;
+                    draw.firstInstance = firstInstance;
+                    draw.materialIndex = materialIndex + i % materialCount;
+                    draw.center = center / static_cast<float>(count);
+                    draw.blended = i >= firstBlended;
+                    drawItems.push_back(draw);
+                }
+            }
+
+            /**
+             * Synchronization primitives:
+             * - renderFinishedSemaphores: One per swapchain image (prevents reuse before present)
+             * - timeline: GPU progress, signalled by every frame submission
+             * - imageAvailable semaphores live in the frame contexts
+             * Headless frames are never presented and only signal the timeline
+             */
+            if (!sceneConfig.benchmark)
+            {
+                Synchronization::createSyncObjects(
+                    vulkan.device, sync.renderFinished, swapchain.images.size()
+                );
+            }
+            Synchronization::createTimeline(vulkan.device, sync.timeline);
+        }
     );
 
-    // Command buffers for recording draw commands
-    Command::createCommandBuffers(vulkan.device, commandPool, commandBuffers, MAX_FRAMES_IN_FLIGHT);
+    Jobs::runGraph(jobs, graph);
 
-    /**
-     * Synchronization primitives:
-     * - imageAvailableSemaphores: One per frame in flight (used for acquire)
-     * - renderFinishedSemaphores: One per swapchain image (prevents reuse before present)
-     * - inFlightFences: CPU-GPU sync for frame pacing
-     */
-    Synchronization::createSyncObjects(
-        vulkan.device,
-        sync.imageAvailable,
-        sync.renderFinished,
-        sync.inFlight,
-        swapchain.images.size(),
-        MAX_FRAMES_IN_FLIGHT
-    );
+    /// The profiler is main-thread only: the tasks are recorded once they have all finished
+    for (const Jobs::Task &task : graph.tasks)
+    {
+        Profiler::addCpuZone(profiler, task.name, task.begin, task.end, task.workerIndex);
+    }
 }
 
 /**
@@ -232,13 +855,90 @@ void TriangleApp::mainLoop()
         drawFrame();      ///< Render a single frame
     }
 
-    vkDeviceWaitIdle(vulkan.device); ///< Wait for all GPU operations to complete
+    Submit::waitIdle(submits, vulkan.device); ///< Wait for all GPU operations to complete
+}
+
+/**
+ * @brief Headless benchmark loop
+ * @details Draws Benchmark::WARMUP_FRAMES frames, then the measured ones. CPU time is the wall
+ *          time of drawFrame, timeline wait included, so a GPU-bound run shows up on both
+ *          tracks. GPU times are read back once the device is idle and arrive in submission
+ *          order, so the warm-up frames are the first ones.
+ */
+void TriangleApp::runBenchmark()
+{
+    const std::uint32_t totalFrames = Benchmark::WARMUP_FRAMES + sceneConfig.benchmarkFrames;
+    std::vector<double> cpuFrameMs;
+    cpuFrameMs.reserve(sceneConfig.benchmarkFrames);
+
+    for (std::uint32_t i = 0; i < totalFrames; i++)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        drawFrame();
+        const auto end = std::chrono::steady_clock::now();
+
+        if (i >= Benchmark::WARMUP_FRAMES)
+        {
+            cpuFrameMs.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+    }
+
+    Submit::waitIdle(submits, vulkan.device);
+    Profiler::collect(profiler);
+
+    std::vector<double> gpuFrameMs = profiler.frameTimesMs;
+    gpuFrameMs.erase(
+        gpuFrameMs.begin(),
+        gpuFrameMs.begin() + std::min<std::size_t>(Benchmark::WARMUP_FRAMES, gpuFrameMs.size())
+    );
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(vulkan.physicalDevice, &properties);
+
+    Benchmark::Report report;
+    report.deviceName = properties.deviceName;
+    report.driverVersion = properties.driverVersion;
+    report.deviceUuid = Device::formatUuid(Device::queryIdentity(vulkan.physicalDevice).uuid);
+    report.width = swapchain.extent.width;
+    report.height = swapchain.extent.height;
+    report.frames = sceneConfig.benchmarkFrames;
+    report.instances = std::max(sceneConfig.instanceCount, 1u);
+    report.draws = drawItems.empty() ? indirectDraws.front().drawCount
+                                     : static_cast<std::uint32_t>(drawItems.size());
+    report.textures = static_cast<std::uint32_t>(extraTextures.size()) + 1;
+    report.drawPath = sceneConfig.gpuCulling ? "gpu-cull"
+                      : sceneConfig.indirect ? "indirect"
+                                             : "direct";
+    report.blendedDraws = static_cast<std::uint32_t>(
+        std::ranges::count(drawItems, true, &Command::DrawItem::blended)
+    );
+    report.depthPrepass = sceneConfig.depthPrepass;
+    report.renderPath =
+        vulkan.dynamicRendering.beginRendering ? "dynamic-rendering" : "render-pass";
+    report.asyncCompute = asyncCompute.enabled();
+    report.renderScale = sceneConfig.upscaled() ? resolution.scale : 1.0f;
+    report.sprites = static_cast<std::uint32_t>(sprites.size());
+    report.spriteDraws = Sprites::drawCount(spriteRenderer);
+    report.submitsPerFrame = static_cast<double>(submits.total.calls) / submits.frames;
+    report.submitMs = submits.total.submitMs / submits.frames;
+    report.startupMs = startupMs;
+    for (std::size_t i = 0; i < Memory::CATEGORY_COUNT; i++)
+    {
+        const auto category = static_cast<Memory::Category>(i);
+        report.memory.push_back(
+            {std::string(Memory::categoryName(category)),
+             Memory::getCategoryStats(allocator, category).highWater}
+        );
+    }
+    report.cpu = Benchmark::summarize(cpuFrameMs);
+    report.gpu = Benchmark::summarize(gpuFrameMs);
+    Benchmark::writeReport(report, sceneConfig.benchmarkPath);
 }
 
 /**
  * @brief Render a single frame
  * @details Implements frame-in-flight rendering with proper synchronization:
- *          1. Wait for previous frame using this slot to finish
+ *          1. Wait for previous frame using this slot to finish and reset its FrameContext
  *          2. Acquire next swapchain image
  *          3. Update uniform buffers (animation)
  *          4. Record command buffer
@@ -248,82 +948,444 @@ void TriangleApp::mainLoop()
  */
 void TriangleApp::drawFrame()
 {
-    /// Wait for the previous frame using this slot to finish rendering
-    vkWaitForFences(vulkan.device, 1, &sync.inFlight[currentFrame], VK_TRUE, UINT64_MAX);
+    Frame::FrameContext &frame = frames[currentFrame];
+    Profiler::Scope frameScope(profiler, "drawFrame");
 
-    /// Acquire the next available swapchain image
-    std::uint32_t imageIndex;
-    VkResult resAcquire = vkAcquireNextImageKHR(
-        vulkan.device,
-        swapchain.swapChain,
-        UINT64_MAX,
-        sync.imageAvailable[currentFrame], ///< Signaled when image is available
-        VK_NULL_HANDLE,
-        &imageIndex
+    /// Wait for the previous frame using this slot, then recycle its pools in bulk
+    Profiler::beginCpuZone(profiler, "timeline wait");
+    Frame::waitAndReset(vulkan.device, sync.timeline, frame);
+
+    /// Destroy objects whose last use the GPU has finished
+    Deletion::flush(deletionQueue, Synchronization::completedValue(vulkan.device, sync.timeline));
+
+    /// Low latency: hold the CPU until the previous frame reached the display, so input and
+    /// animation are sampled as close to the next present as possible
+    SwapChain::waitForPresent(vulkan.device, swapchain.swapChain, presentPacer, framesInFlight - 1);
+
+    /// Release staging memory of upload batches that have finished
+    Upload::collect(uploads);
+
+    /// Warn before the driver starts paging: a heap nearing its budget is reported once
+    if (frameNumber % RenderConstants::MEMORY_CHECK_FRAMES == 0)
+    {
+        for (const Memory::HeapStats &heap : Memory::checkBudget(allocator))
+        {
+            std::cerr << std::format(
+                "memory: heap {} uses {} of its {} byte budget\n",
+                heap.heapIndex,
+                heap.usage,
+                heap.budget
+            );
+        }
+    }
+
+    /// Edited shaders and textures are swapped in between frames, before anything is bound
+    if (sceneConfig.hotReload)
+    {
+        applyReloads();
+    }
+
+    /// Steer the render scale by the GPU frame time read back with this slot's queries; the
+    /// images keep their size, so only the render area changes
+    Resolution::update(resolution, std::exchange(profiler.lastFrameMs, 0.0));
+    Profiler::endCpuZone(profiler);
+
+    /// Acquire the next available swapchain image (headless: the slot's own offscreen image,
+    /// released by the timeline wait above)
+    Profiler::beginCpuZone(profiler, "acquire");
+    const bool headless = swapchain.swapChain == VK_NULL_HANDLE;
+    std::uint32_t imageIndex = currentFrame;
+    if (!headless)
+    {
+        VkResult resAcquire = vkAcquireNextImageKHR(
+            vulkan.device,
+            swapchain.swapChain,
+            UINT64_MAX,
+            frame.imageAvailable, ///< Signaled when image is available
+            VK_NULL_HANDLE,
+            &imageIndex
+        );
+
+        /// Handle swapchain out of date (window resize)
+        if (resAcquire == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            recreateSwapChain();
+            return;
+        }
+        VK_CHECK(
+            (resAcquire == VK_SUCCESS || resAcquire == VK_SUBOPTIMAL_KHR) ? VK_SUCCESS
+                                                                          : resAcquire,
+            "acquire swap chain image"
+        );
+    }
+    Profiler::endCpuZone(profiler);
+
+    /// Camera matrices go to the uniform ring; the animated transform is pushed with each draw
+    Profiler::beginCpuZone(profiler, "update");
+    std::uint32_t uniformOffset = 0;
+    const Buffer::Vertex::UniformBufferObject ubo = updateUniformBuffer(frame, uniformOffset);
+    Scene::setRotation(scene, MESH_NODE, sceneRotation());
+    Scene::updateWorld(scene, &jobs);
+    const glm::mat4 model = scene.world[MESH_NODE];
+    for (Command::DrawItem &draw : drawItems)
+    {
+        draw.model = model;
+    }
+    for (Command::IndirectDraw &draw : indirectDraws)
+    {
+        draw.model = model;
+    }
+
+    /// Opaque draws front to back for the early depth test, blended ones back to front
+    Command::sortDraws(drawItems, ubo.view);
+    if (!sprites.empty())
+    {
+        updateSprites();
+    }
+
+    /// Stream the mip level matching the mesh's projected size; until something is resident
+    /// the regular texture is bound. Replaced images retire with the frames already submitted
+    VkImageView textureView = texture.view;
+    VkSampler textureSampler = texture.sampler;
+    if (streamer.sampler != VK_NULL_HANDLE)
+    {
+        const float distance = glm::length(camera.position - camera.target);
+        const float halfHeight = distance * std::tan(glm::radians(camera.fovDegrees) * 0.5f);
+        const auto screenExtent = static_cast<std::uint32_t>(
+            swapchain.extent.height * buffers.boundingRadius / halfHeight
+        );
+
+        Streaming::requestResolution(streamer, streamedTexture, screenExtent);
+        const bool changed = Streaming::update(streamer, sync.timeline.lastSubmitted);
+
+        if (VkImageView streamed = Streaming::view(streamer, streamedTexture);
+            streamed != VK_NULL_HANDLE)
+        {
+            textureView = streamed;
+            textureSampler = streamer.sampler;
+
+            /// Bindless: point the material at a new slot; the old one is freed once unused
+            if (changed && !bindless.sets.empty())
+            {
+                const std::uint32_t oldSlot = textureSlot;
+                textureSlot = Bindless::addTexture(bindless, streamed, streamer.sampler);
+
+                Bindless::Material material;
+                material.textureIndex = textureSlot;
+                Bindless::setMaterial(bindless, materialIndex, material);
+
+                Deletion::defer(
+                    deletionQueue,
+                    sync.timeline.lastSubmitted,
+                    [this, oldSlot]() { Bindless::removeTexture(bindless, oldSlot); }
+                );
+            }
+        }
+    }
+
+    /// Transient descriptor set, released with the frame's descriptor pool
+    frame.descriptorSet =
+        Frame::allocateDescriptorSet(vulkan.device, frame, pipeline.descriptorSetLayout);
+    Buffer::writeDescriptorSet(
+        vulkan.device, frame.descriptorSet, uniforms.buffer, textureView, textureSampler
     );
 
-    /// Handle swapchain out of date (window resize)
-    if (resAcquire == VK_ERROR_OUT_OF_DATE_KHR)
+    /// Bind the variant if it finished compiling, the fallback otherwise
+    pipeline.bound.blended = Pipelines::resolve(pipelines, pipeline.blendedKey);
+
+    /// The fallback writes its own depth, so the pre-pass waits for both of its variants
+    const bool prepassReady =
+        sceneConfig.depthPrepass
+        && Pipelines::status(pipelines, pipeline.prepassKey) == Pipelines::Status::Ready
+        && Pipelines::status(pipelines, pipeline.key) == Pipelines::Status::Ready;
+    pipeline.bound.opaque = Pipelines::resolve(
+        pipelines, prepassReady || !sceneConfig.depthPrepass ? pipeline.key : pipeline.fallbackKey
+    );
+    pipeline.bound.depthPrepass =
+        prepassReady ? Pipelines::resolve(pipelines, pipeline.prepassKey) : VK_NULL_HANDLE;
+
+    /// The fallback has the mesh's vertex layout, so sprites wait for their own pipelines
+    pipeline.boundSprites = {};
+    if (!sprites.empty()
+        && Pipelines::status(pipelines, pipeline.spriteKey) == Pipelines::Status::Ready
+        && Pipelines::status(pipelines, pipeline.spriteBlendKey) == Pipelines::Status::Ready)
     {
-        recreateSwapChain();
-        return;
+        pipeline.boundSprites.opaque = Pipelines::resolve(pipelines, pipeline.spriteKey);
+        pipeline.boundSprites.blended = Pipelines::resolve(pipelines, pipeline.spriteBlendKey);
+    }
+    Profiler::endCpuZone(profiler);
+
+    /// The frame's set, then the slot's bindless table (bound once for every draw)
+    const std::array<VkDescriptorSet, 2> descriptorSets = {
+        frame.descriptorSet,
+        !bindless.sets.empty() ? Bindless::beginFrame(bindless, currentFrame) : VK_NULL_HANDLE
+    };
+    const std::size_t descriptorSetCount = !bindless.sets.empty() ? 2 : 1;
+
+    /// Pass bodies for this frame; the graph records the barriers between them and wraps each
+    /// in a GPU zone, since timestamps cannot go between secondaries of the render pass
+    RenderGraph::Graph &graph = frameGraph.graph;
+    RenderGraph::bindImage(graph, frameGraph.color, swapchain.images[imageIndex]);
+    if (frameGraph.cull != RenderGraph::NO_PASS)
+    {
+        graph.passes[frameGraph.cull].record = [this, &ubo, &model](VkCommandBuffer commandBuffer)
+        {
+            Culling::recordCullPass(
+                commandBuffer, culling, culling.outputs[currentFrame], ubo.proj * ubo.view * model
+            );
+        };
+    }
+
+    /// The frame draws from its slot's cull outputs, last read by the frame waited on above
+    if (culling.pipeline != VK_NULL_HANDLE)
+    {
+        const Culling::Output &output = culling.outputs[currentFrame];
+        indirectDraws.front().instanceBuffer = output.visibleBuffer;
+        indirectDraws.front().argumentBuffer = output.argumentBuffer;
+    }
+
+    /// Async compute: cull into the slot's outputs on the compute queue, released to graphics
+    std::uint64_t cullValue = 0;
+    std::array<VkBuffer, 2> cullOutputs{};
+    if (asyncCompute.enabled())
+    {
+        const Culling::Output &output = culling.outputs[currentFrame];
+        cullOutputs = {output.visibleBuffer, output.argumentBuffer};
+
+        /// The source instances change family once, before the first dispatch
+        if (asyncCompute.handOver == VK_NULL_HANDLE)
+        {
+            const std::array<VkBuffer, 1> source = {culling.sourceBuffer};
+            AsyncCompute::handOverBuffers(
+                asyncCompute, vulkan.graphicsQueue, sync.timeline, source
+            );
+        }
+
+        VkCommandBuffer computeCommands = AsyncCompute::begin(asyncCompute, currentFrame);
+        Culling::recordCullPass(computeCommands, culling, output, ubo.proj * ubo.view * model);
+        AsyncCompute::releaseBuffers(
+            computeCommands,
+            cullOutputs,
+            asyncCompute.family,
+            asyncCompute.graphicsFamily,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT
+        );
+        cullValue = AsyncCompute::submit(
+            asyncCompute, currentFrame, sync.timeline.semaphore, frame.timelineValue
+        );
     }
-    VK_CHECK(
-        (resAcquire == VK_SUCCESS || resAcquire == VK_SUBOPTIMAL_KHR) ? VK_SUCCESS : resAcquire,
-        "acquire swap chain image"
+
+    Command::RenderTarget target;
+    target.renderPass = pipeline.renderPass;
+    target.framebuffer =
+        swapchain.framebuffers.empty() ? VK_NULL_HANDLE : swapchain.framebuffers[imageIndex];
+    const bool upscaled = frameGraph.upscale != RenderGraph::NO_PASS;
+    const VkExtent2D renderExtent =
+        upscaled ? Resolution::scaledExtent(resolution, swapchain.extent) : swapchain.extent;
+    target.colorView = upscaled ? swapchain.transients.views[frameGraph.scene]
+                                : swapchain.imageViews[imageIndex];
+    target.depthView = swapchain.transients.views[frameGraph.depth];
+    target.colorFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    target.depthFormat = pipeline.depthFormat;
+    target.colorStore = RenderGraph::storeOp(
+        graph, frameGraph.forward, upscaled ? frameGraph.scene : frameGraph.color
     );
+    target.depthStore = RenderGraph::storeOp(graph, frameGraph.forward, frameGraph.depth);
+    target.extent = renderExtent;
+    target.beginRendering = vulkan.dynamicRendering.beginRendering;
+    target.endRendering = vulkan.dynamicRendering.endRendering;
+
+    /// Sprites cover the swapchain extent, whatever the scale the scene is drawn at
+    std::function<void(VkCommandBuffer)> overlay;
+    if (pipeline.boundSprites.blended != VK_NULL_HANDLE)
+    {
+        overlay = [this](VkCommandBuffer commandBuffer)
+        {
+            Sprites::record(
+                commandBuffer,
+                pipeline.layout,
+                spriteRenderer,
+                currentFrame,
+                pipeline.boundSprites,
+                swapchain.extent
+            );
+        };
+    }
 
-    /// Reset fence only after successfully acquiring image
-    vkResetFences(vulkan.device, 1, &sync.inFlight[currentFrame]);
+    /// Upscaled: the overlay has a pass of its own on the swapchain image, after the blit
+    const bool overlayPass = frameGraph.overlay != RenderGraph::NO_PASS;
+    graph.passes[frameGraph.forward].record =
+        [this, &target, &descriptorSets, descriptorSetCount, &uniformOffset, &overlay, overlayPass](
+            VkCommandBuffer commandBuffer
+        )
+    {
+        Command::recordRenderPass(
+            commandBuffer,
+            target,
+            pipeline.bound,
+            pipeline.layout,
+            std::span(descriptorSets.data(), descriptorSetCount),
+            std::span(&uniformOffset, 1),
+            currentFrame,
+            drawItems,
+            indirectDraws,
+            jobs,
+            recorder,
+            Profiler::activeStatistics(profiler, currentFrame),
+            overlayPass ? std::function<void(VkCommandBuffer)>{} : overlay
+        );
+    };
 
-    /// Update transformation matrices for animation
-    updateUniformBuffer(currentFrame);
+    Command::RenderTarget overlayTarget = target;
+    if (overlayPass)
+    {
+        overlayTarget.renderPass = pipeline.overlayRenderPass;
+        overlayTarget.framebuffer = swapchain.overlayFramebuffers.empty()
+                                        ? VK_NULL_HANDLE
+                                        : swapchain.overlayFramebuffers[imageIndex];
+        overlayTarget.colorView = swapchain.imageViews[imageIndex];
+        overlayTarget.depthView = swapchain.transients.views[frameGraph.overlayDepth];
+        overlayTarget.colorLoad = VK_ATTACHMENT_LOAD_OP_LOAD;
+        overlayTarget.depthLoad = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        overlayTarget.colorStore =
+            RenderGraph::storeOp(graph, frameGraph.overlay, frameGraph.color);
+        overlayTarget.depthStore =
+            RenderGraph::storeOp(graph, frameGraph.overlay, frameGraph.overlayDepth);
+        overlayTarget.extent = swapchain.extent;
+
+        /// No draws of its own: the pass only wraps the overlay
+        graph.passes[frameGraph.overlay].record =
+            [this, &overlayTarget, &descriptorSets, descriptorSetCount, &uniformOffset, &overlay](
+                VkCommandBuffer commandBuffer
+            )
+        {
+            Command::recordRenderPass(
+                commandBuffer,
+                overlayTarget,
+                pipeline.bound,
+                pipeline.layout,
+                std::span(descriptorSets.data(), descriptorSetCount),
+                std::span(&uniformOffset, 1),
+                currentFrame,
+                {},
+                {},
+                jobs,
+                recorder,
+                0,
+                overlay
+            );
+        };
+    }
+    if (upscaled)
+    {
+        graph.passes[frameGraph.upscale].record =
+            [this, renderExtent, imageIndex](VkCommandBuffer commandBuffer)
+        {
+            Resolution::recordUpscale(
+                commandBuffer,
+                swapchain.transients.images[frameGraph.scene],
+                renderExtent,
+                swapchain.images[imageIndex],
+                swapchain.extent
+            );
+        };
+    }
 
-    /// Record rendering commands into command buffer
-    vkResetCommandBuffer(commandBuffers[currentFrame], 0);
+    /// Record rendering commands (the command pool was reset after the timeline wait)
+    Profiler::beginCpuZone(profiler, "record");
     Command::recordCommandBuffer(
-        commandBuffers[currentFrame],
-        pipeline.renderPass,
-        swapchain.framebuffers[imageIndex],
-        swapchain.extent,
-        pipeline.pipeline,
-        pipeline.layout,
-        buffers.vertexBuffer,
-        buffers.indexBuffer,
-        descriptorSets,
-        currentFrame
+        frame.commandBuffer,
+        [this, &cullOutputs](VkCommandBuffer commandBuffer)
+        {
+            Profiler::beginGpuFrame(
+                profiler,
+                commandBuffer,
+                currentFrame,
+                drawItems.size() >= Command::PARALLEL_RECORD_THRESHOLD
+            );
+            if (asyncCompute.enabled())
+            {
+                AsyncCompute::acquireBuffers(
+                    commandBuffer,
+                    cullOutputs,
+                    asyncCompute.family,
+                    asyncCompute.graphicsFamily,
+                    VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                    VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT
+                );
+            }
+            RenderGraph::execute(
+                frameGraph.graph, swapchain.transients, commandBuffer, profiler, currentFrame
+            );
+            Profiler::endGpuFrame(profiler, commandBuffer, currentFrame);
+        }
     );
+    Profiler::endCpuZone(profiler);
 
-    /// Submit command buffer to GPU
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    /// Submit command buffer to GPU, together with the uploads and compute work of the frame
+    Profiler::beginCpuZone(profiler, "submit");
+    Submit::Work work;
+    work.queue = vulkan.graphicsQueue;
+    work.commandBuffers = {frame.commandBuffer};
 
-    /// Wait for image to be available before writing colors
-    std::array<VkSemaphore, 1> waitSemaphores = {sync.imageAvailable[currentFrame]};
-    std::array<VkPipelineStageFlags, 1> waitStages = {
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
-    };
-    submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
-    submitInfo.pWaitSemaphores = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages.data();
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
-
-    /// Signal per-image semaphore when rendering is done (critical for preventing reuse)
-    std::array<VkSemaphore, 1> signalSemaphores = {sync.renderFinished[imageIndex]};
-    submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
-    submitInfo.pSignalSemaphores = signalSemaphores.data();
-
-    VK_CHECK(
-        vkQueueSubmit(vulkan.graphicsQueue, 1, &submitInfo, sync.inFlight[currentFrame]),
-        "submit draw command buffer"
-    );
+    /// Wait for image to be available before writing colors (offscreen images need no wait),
+    /// and for the culling results before the indirect draw reads them
+    if (!headless)
+    {
+        work.waits.push_back(Submit::semaphore(frame.imageAvailable, 0, frameGraph.colorReady));
+    }
+    if (cullValue != 0)
+    {
+        work.waits.push_back(Submit::semaphore(
+            asyncCompute.timeline.semaphore,
+            cullValue,
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT
+        ));
+    }
+
+    /**
+     * Signal the per-image semaphore for present (critical for preventing reuse) and the next
+     * timeline value, which replaces the per-frame fence. Headless frames signal the timeline
+     * only.
+     */
+    frame.timelineValue = ++sync.timeline.lastSubmitted;
+    if (!headless)
+    {
+        work.signals.push_back(Submit::semaphore(sync.renderFinished[imageIndex]));
+    }
+    work.signals.push_back(Submit::semaphore(sync.timeline.semaphore, frame.timelineValue));
+
+    /// Present waits on renderFinished, so everything goes out before it
+    Submit::enqueue(submits, std::move(work));
+    Submit::flush(submits);
+    Submit::endFrame(submits);
+    Profiler::endCpuZone(profiler);
+    Profiler::endFrame(profiler, currentFrame);
+
+    /// Time to first frame: window, device, pipeline and uploads up to the first submission
+    if (frameNumber == 0)
+    {
+        const std::chrono::duration<double, std::milli> startup =
+            std::chrono::steady_clock::now() - launchTime;
+        startupMs = startup.count();
+        std::cerr << std::format("startup: first frame submitted after {:.1f} ms\n", startupMs);
+    }
+    frameNumber++;
+
+    /// Nothing to present offscreen
+    if (headless)
+    {
+        currentFrame = (currentFrame + 1) % framesInFlight;
+        return;
+    }
 
     /// Present the rendered image to the screen
+    Profiler::beginCpuZone(profiler, "present");
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-    presentInfo.waitSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
-    presentInfo.pWaitSemaphores = signalSemaphores.data(); ///< Wait for rendering to finish
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &sync.renderFinished[imageIndex]; ///< Rendering finished
 
     std::array<VkSwapchainKHR, 1> swapChains = {swapchain.swapChain};
     presentInfo.swapchainCount = static_cast<uint32_t>(swapChains.size());
@@ -331,7 +1393,20 @@ void TriangleApp::drawFrame()
     presentInfo.pImageIndices = &imageIndex;
     presentInfo.pResults = nullptr;
 
-    VkResult resPresent = vkQueuePresentKHR(vulkan.presentQueue, &presentInfo);
+    /// Tag the present so waitForPresent can find it (ids are per swapchain, strictly increasing)
+    VkPresentIdKHR presentId{};
+    std::uint64_t presentIdValue = presentPacer.lastPresentId + 1;
+    if (presentPacer.waitForPresent != nullptr)
+    {
+        presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentId.swapchainCount = 1;
+        presentId.pPresentIds = &presentIdValue;
+        presentInfo.pNext = &presentId;
+        presentPacer.lastPresentId = presentIdValue;
+    }
+
+    VkResult resPresent = Submit::present(submits, vulkan.presentQueue, presentInfo);
+    Profiler::endCpuZone(profiler);
 
     /// Handle window resize or suboptimal swapchain
     if (resPresent == VK_ERROR_OUT_OF_DATE_KHR || resPresent == VK_SUBOPTIMAL_KHR
@@ -346,58 +1421,510 @@ void TriangleApp::drawFrame()
     }
 
     /// Advance to next frame slot (wraps around)
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    currentFrame = (currentFrame + 1) % framesInFlight;
+}
+
+/**
+ * @brief Animated rotation of the scene's mesh node
+ * @return Local rotation of MESH_NODE, whose world matrix is pushed with every draw
+ * @details Rotates around RenderConstants::ROTATION_AXIS based on elapsed time, real or
+ *          simulated
+ */
+glm::quat TriangleApp::sceneRotation() const
+{
+    /// Rotate using configured speed
+    return glm::angleAxis(
+        sceneTime() * glm::radians(RenderConstants::ROTATION_SPEED_DEG_PER_SEC),
+        RenderConstants::ROTATION_AXIS
+    );
 }
 
 /**
- * @brief Update uniform buffer with current transformation matrices
- * @param currentImage Index of the frame's uniform buffer to update
- * @details Creates animated rotation by updating model matrix based on elapsed time.
- *          Uses persistently mapped memory for efficient updates every frame.
- *          View and projection matrices remain static.
- * @note proj[1][1] is negated to flip Y-axis for Vulkan's coordinate system
+ * @brief Seconds of animation so far
+ * @return Elapsed time since the first call, or simulated time in benchmarks
  */
-void TriangleApp::updateUniformBuffer(std::uint32_t currentImage)
+float TriangleApp::sceneTime() const
 {
     static auto startTime = std::chrono::high_resolution_clock::now();
 
-    /// Calculate elapsed time since app started
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime)
-                     .count();
+    /// Calculate elapsed time since app started (benchmarks: a fixed step per frame, so every
+    /// run draws the same sequence of frames)
+    float time = static_cast<float>(frameNumber) * Benchmark::SIMULATED_FRAME_SECONDS;
+    if (!sceneConfig.benchmark)
+    {
+        auto currentTime = std::chrono::high_resolution_clock::now();
+        time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime)
+                   .count();
+    }
+    return time;
+}
 
-    /// Build transformation matrices
+/**
+ * @brief Scroll the sprite layers and hand the sprites to the frame slot's stream
+ * @details Nearer layers move faster; a sprite leaving the right edge comes back on the left
+ */
+void TriangleApp::updateSprites()
+{
+    const float time = sceneTime();
+    const float step = time - spriteClock;
+    spriteClock = time;
+
+    const auto width = static_cast<float>(std::max(swapchain.extent.width, 1u));
+    for (Sprites::Sprite &sprite : sprites)
+    {
+        const float speed = RenderConstants::SPRITE_SPEED * static_cast<float>(sprite.layer + 1);
+        sprite.position.x = std::fmod(sprite.position.x + speed * step, width);
+    }
+
+    Sprites::prepare(vulkan.device, allocator, spriteRenderer, currentFrame, sprites, &jobs);
+}
+
+/**
+ * @brief Write the camera matrices into the frame's region of the uniform ring
+ * @param frame Frame context whose ring region is used
+ * @param dynamicOffset Output dynamic offset of the matrices, passed when binding set 0
+ * @return Matrices written, reused by the cull pass
+ * @details The ring is persistently mapped, so the write is a plain copy: no descriptor update
+ *          and no allocation per frame. The camera's matrices are only rebuilt when the
+ *          swapchain extent or a camera parameter changed.
+ */
+Buffer::Vertex::UniformBufferObject TriangleApp::updateUniformBuffer(
+    Frame::FrameContext &frame, std::uint32_t &dynamicOffset
+)
+{
+    Scene::updateCamera(camera, swapchain.extent);
     Buffer::Vertex::UniformBufferObject ubo{};
+    ubo.view = camera.view;
+    ubo.proj = camera.proj;
 
-    /// Model matrix: rotate using configured speed around Z-axis
-    ubo.model = glm::rotate(
-        glm::mat4(1.0f),
-        time * glm::radians(RenderConstants::ROTATION_SPEED_DEG_PER_SEC),
-        RenderConstants::ROTATION_AXIS
+    /// Copy to mapped GPU memory (no need to map/unmap each frame)
+    std::byte *mapped = Frame::allocateUniform(uniforms, frame, sizeof(ubo), dynamicOffset);
+    if (mapped == nullptr)
+    {
+        throw std::runtime_error("failed to allocate frame uniform data!");
+    }
+    memcpy(mapped, &ubo, sizeof(ubo));
+    return ubo;
+}
+
+/**
+ * @brief Declare the frame's passes, compile their barriers and create the render pass
+ * @details Culling resets and writes the indirect arguments and the compacted instances the
+ *          render pass reads. The colour target is ready once the acquire wait at
+ *          COLOR_ATTACHMENT_OUTPUT has passed and is left in PRESENT_SRC_KHR; depth is
+ *          transient, cleared on load and never stored. Upscaled frames draw into a scene
+ *          transient instead, which a pass blits over the colour target (then ready at
+ *          TRANSFER); sprites follow in an overlay pass on the colour target. With dynamic
+ *          rendering there is no render pass object, and the barriers are recorded with
+ *          vkCmdPipelineBarrier2.
+ */
+void TriangleApp::createFrameGraph()
+{
+    using RenderGraph::Usage;
+    RenderGraph::Graph &graph = frameGraph.graph;
+
+    /// Upscaled: the swapchain image is first written by the blit, the scene goes offscreen
+    const bool upscaled = sceneConfig.upscaled();
+    frameGraph.colorReady = upscaled ? VK_PIPELINE_STAGE_2_TRANSFER_BIT
+                                     : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    frameGraph.color = RenderGraph::importImage(
+        graph,
+        "color",
+        VK_FORMAT_B8G8R8A8_SRGB,
+        VK_IMAGE_ASPECT_COLOR_BIT,
+        frameGraph.colorReady,
+        Usage::Present
     );
+    frameGraph.depth =
+        RenderGraph::createImage(graph, "depth", pipeline.depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+    const RenderGraph::ResourceId target =
+        upscaled ? RenderGraph::createImage(
+                       graph, "scene", VK_FORMAT_B8G8R8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT
+                   )
+                 : frameGraph.color;
+
+    std::vector<RenderGraph::Access> drawBuffers;
+    if (sceneConfig.gpuCulling)
+    {
+        frameGraph.visible = RenderGraph::importBuffer(graph, "visible instances", true);
+        frameGraph.arguments = RenderGraph::importBuffer(graph, "indirect arguments", true);
+
+        /// Async compute: the outputs arrive through an acquire recorded ahead of the graph
+        if (vulkan.asyncComputeQueue == VK_NULL_HANDLE)
+        {
+            frameGraph.cull = RenderGraph::addPass(
+                graph,
+                "cull",
+                {},
+                {{frameGraph.arguments, Usage::TransferWrite},
+                 {frameGraph.arguments, Usage::StorageWrite},
+                 {frameGraph.visible, Usage::StorageWrite}}
+            );
+        }
+        drawBuffers = {
+            {frameGraph.arguments, Usage::IndirectRead}, {frameGraph.visible, Usage::VertexRead}
+        };
+    }
+
+    frameGraph.forward = RenderGraph::addPass(
+        graph,
+        "render pass",
+        {{target, Usage::ColorAttachment, VK_ATTACHMENT_LOAD_OP_CLEAR},
+         {frameGraph.depth, Usage::DepthAttachment, VK_ATTACHMENT_LOAD_OP_CLEAR}},
+        std::move(drawBuffers)
+    );
+    if (upscaled)
+    {
+        frameGraph.scene = target;
+        frameGraph.upscale = RenderGraph::addPass(
+            graph,
+            "upscale",
+            {{frameGraph.scene, Usage::TransferRead}, {frameGraph.color, Usage::TransferWrite}},
+            {}
+        );
+
+        /// Sprites are drawn over the blit at full resolution instead of scaled with the
+        /// scene; the depth only matches the sprite pipelines' attachment formats
+        if (sceneConfig.spriteCount > 0)
+        {
+            frameGraph.overlayDepth = RenderGraph::createImage(
+                graph, "overlay depth", pipeline.depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT
+            );
+            frameGraph.overlay = RenderGraph::addPass(
+                graph,
+                "overlay",
+                {{frameGraph.color, Usage::ColorAttachment, VK_ATTACHMENT_LOAD_OP_LOAD},
+                 {frameGraph.overlayDepth,
+                  Usage::DepthAttachment,
+                  VK_ATTACHMENT_LOAD_OP_DONT_CARE}},
+                {}
+            );
+        }
+    }
+
+    RenderGraph::compile(graph);
+    graph.pipelineBarrier2 = vulkan.dynamicRendering.pipelineBarrier2;
+    if (!vulkan.dynamicRendering.beginRendering)
+    {
+        RenderGraph::createRenderPass(
+            vulkan.device, graph, frameGraph.forward, pipeline.renderPass
+        );
+
+        /// Same formats as the main pass, so the sprite pipelines are compatible with both
+        if (frameGraph.overlay != RenderGraph::NO_PASS)
+        {
+            RenderGraph::createRenderPass(
+                vulkan.device, graph, frameGraph.overlay, pipeline.overlayRenderPass
+            );
+        }
+    }
+}
+
+/**
+ * @brief Create the headless colour targets used instead of swapchain images
+ * @details Device-local images in the swapchain format, one per frame slot: a slot's image is
+ *          free again once its timeline wait has passed, so no acquire is needed. The frame
+ *          graph still leaves it in PRESENT_SRC_KHR, which is valid for any image while
+ *          VK_KHR_swapchain is enabled, so it is shared with the windowed path unchanged.
+ */
+void TriangleApp::createOffscreenTargets()
+{
+    swapchain.extent = {Benchmark::WIDTH, Benchmark::HEIGHT};
+    swapchain.images.resize(framesInFlight);
+    swapchain.memory.resize(framesInFlight);
+
+    for (std::uint32_t i = 0; i < framesInFlight; i++)
+    {
+        Image::createImage(
+            vulkan.device,
+            allocator,
+            swapchain.extent.width,
+            swapchain.extent.height,
+            VK_FORMAT_B8G8R8A8_SRGB,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            swapchain.images[i],
+            swapchain.memory[i],
+            1,
+            Memory::Category::Attachment
+        );
+    }
+}
+
+/**
+ * @brief Create a framebuffer per swapchain image around the graph's attachments
+ * @details Only the render pass path has framebuffers; upscaled frames render into the scene
+ *          transient instead of the swapchain image, at most at the full extent
+ */
+void TriangleApp::createFramebuffers()
+{
+    if (pipeline.renderPass == VK_NULL_HANDLE)
+    {
+        return;
+    }
 
-    /// View matrix: camera positioned using configured parameters
-    ubo.view = glm::lookAt(
-        RenderConstants::CAMERA_POSITION, RenderConstants::CAMERA_TARGET, RenderConstants::CAMERA_UP
+    std::vector<VkImageView> colorViews = swapchain.imageViews;
+    if (frameGraph.upscale != RenderGraph::NO_PASS)
+    {
+        std::ranges::fill(colorViews, swapchain.transients.views[frameGraph.scene]);
+    }
+
+    Framebuffer::createFramebuffers(
+        vulkan.device,
+        pipeline.renderPass,
+        colorViews,
+        swapchain.transients.views[frameGraph.depth],
+        swapchain.extent,
+        swapchain.framebuffers
     );
 
-    /// Projection matrix: perspective with configured FOV and clipping planes
-    ubo.proj = glm::perspective(
-        glm::radians(RenderConstants::CAMERA_FOV_DEGREES),
-        swapchain.extent.width / (float)swapchain.extent.height,
-        RenderConstants::CAMERA_NEAR_PLANE,
-        RenderConstants::CAMERA_FAR_PLANE
+    if (pipeline.overlayRenderPass != VK_NULL_HANDLE)
+    {
+        Framebuffer::createFramebuffers(
+            vulkan.device,
+            pipeline.overlayRenderPass,
+            swapchain.imageViews,
+            swapchain.transients.views[frameGraph.overlayDepth],
+            swapchain.extent,
+            swapchain.overlayFramebuffers
+        );
+    }
+}
+
+/**
+ * @brief Path of the scene texture, as looked up in the asset pack
+ * @return sceneConfig.texturePath, or the default texture
+ */
+std::string TriangleApp::sceneTexturePath() const
+{
+    return sceneConfig.texturePath.empty() ? std::string(Image::texturePath)
+                                           : sceneConfig.texturePath;
+}
+
+/**
+ * @brief Create the scene texture with its view and sampler
+ * @param target Output texture
+ * @param texturePath Path of the texture, as looked up in the asset pack
+ * @param texels Texels decoded from texturePath (unused when the pack holds them)
+ * @details Pre-decoded texels are staged straight from the pack mapping; missing mip levels
+ *          are blitted in the same upload batch
+ */
+void TriangleApp::loadTexture(
+    TextureResources &target,
+    const std::string &texturePath,
+    const Ktx::TextureData &texels
+)
+{
+    const AssetPack::Entry *packed =
+        AssetPack::find(assets, texturePath, AssetPack::AssetType::Texture);
+    if (packed != nullptr)
+    {
+        target.format = static_cast<VkFormat>(packed->params[2]);
+        target.mipLevels = Image::canGenerateMipmaps(vulkan.physicalDevice, target.format)
+                                ? Image::mipLevelCount(packed->params[0], packed->params[1])
+                                : 1;
+        Image::createTextureImage(
+            vulkan.device,
+            allocator,
+            AssetPack::payload(assets, *packed).data(),
+            packed->params[0],
+            packed->params[1],
+            target.format,
+            target.mipLevels,
+            target.image,
+            target.memory,
+            uploads
+        );
+    }
+    else
+    {
+        Image::createTextureImage(
+            vulkan.device,
+            vulkan.physicalDevice,
+            allocator,
+            texels,
+            target.image,
+            target.memory,
+            target.format,
+            target.mipLevels,
+            uploads
+        );
+    }
+
+    ImageViews::createTextureImageView(
+        vulkan.device, target.image, target.view, target.format, target.mipLevels
     );
-    ubo.proj[1][1] *= -1; ///< Flip Y for Vulkan (GLM uses OpenGL conventions)
 
-    /// Copy to mapped GPU memory (no need to map/unmap each frame)
-    memcpy(buffers.uniformMapped[currentImage], &ubo, sizeof(ubo));
+    Image::createTextureSampler(
+        vulkan.device, vulkan.physicalDevice, target.sampler, target.mipLevels
+    ); ///< Texture filtering over the whole mip chain
+}
+
+/**
+ * @brief Destroy a texture's sampler, view and image
+ * @param target Texture (reset on return)
+ * @details Images the loader made are queued back to it and destroyed on its thread
+ */
+void TriangleApp::destroyTexture(TextureResources &target)
+{
+    vkDestroySampler(vulkan.device, target.sampler, nullptr);
+    vkDestroyImageView(vulkan.device, target.view, nullptr);
+    if (target.loaded)
+    {
+        Loader::Resource resource;
+        resource.image = target.image;
+        resource.allocation = target.memory;
+        Loader::release(loader, std::move(resource));
+    }
+    else
+    {
+        Image::destroyImage(vulkan.device, allocator, target.image, target.memory);
+    }
+    target = TextureResources{};
+}
+
+/**
+ * @brief Install the shaders and textures rebuilt by the watcher
+ * @details Rebuild failures are printed and leave the current shader or texture in place.
+ *          Retired pipelines and images may still be used by the frames already submitted, so
+ *          they are destroyed once the timeline passes sync.timeline.lastSubmitted. With
+ *          bindless, the material moves to a new slot and the old one is freed the same way.
+ */
+void TriangleApp::applyReloads()
+{
+    for (HotReload::Change &change : HotReload::takeChanges(watcher))
+    {
+        if (!change.error.empty())
+        {
+            std::cerr << std::format("hot reload: {}: {}\n", change.path.string(), change.error);
+            continue;
+        }
+
+        if (change.kind == HotReload::AssetKind::Shader)
+        {
+            try
+            {
+                const std::uint32_t queued =
+                    Pipelines::reloadShader(pipelines, change.key, change.spirv);
+                std::cerr << std::format(
+                    "hot reload: {}: rebuilding {} pipelines\n", change.path.string(), queued
+                );
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << std::format("hot reload: {}: {}\n", change.path.string(), e.what());
+            }
+            continue;
+        }
+
+        /// The loader thread creates the image and uploads it; nothing here waits for it
+        reloadLoads.push_back(Loader::loadTexture(loader, std::move(change.texels)));
+        std::cerr << std::format("hot reload: {}: uploading\n", change.path.string());
+    }
+
+    /// Rebuilt pipelines take over from this frame on
+    std::vector<VkPipeline> retired;
+    std::vector<VkShaderModule> retiredModules;
+    Pipelines::swapReloaded(pipelines, retired, retiredModules);
+    for (VkPipeline old : retired)
+    {
+        Deletion::defer(
+            deletionQueue,
+            sync.timeline.lastSubmitted,
+            [this, old]() { vkDestroyPipeline(vulkan.device, old, nullptr); }
+        );
+    }
+    for (VkShaderModule old : retiredModules)
+    {
+        Deletion::defer(
+            deletionQueue,
+            sync.timeline.lastSubmitted,
+            [this, old]() { vkDestroyShaderModule(vulkan.device, old, nullptr); }
+        );
+    }
+
+    /// Of the edits uploaded by now only the newest is drawn; older ones were never bound
+    std::optional<Loader::Resource> uploaded;
+    while (!reloadLoads.empty()
+           && reloadLoads.front().wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        try
+        {
+            Loader::Resource resource = reloadLoads.front().get();
+            if (uploaded.has_value())
+            {
+                Loader::release(loader, std::move(*uploaded));
+            }
+            uploaded = std::move(resource);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << std::format("hot reload: texture: {}\n", e.what());
+        }
+        reloadLoads.pop_front();
+    }
+    if (!uploaded.has_value())
+    {
+        return;
+    }
+
+    Deletion::defer(
+        deletionQueue,
+        sync.timeline.lastSubmitted,
+        [this,
+         image = texture.image,
+         memory = texture.memory,
+         view = texture.view,
+         sampler = texture.sampler,
+         loaded = texture.loaded]()
+        {
+            TextureResources retired;
+            retired.image = image;
+            retired.memory = memory;
+            retired.view = view;
+            retired.sampler = sampler;
+            retired.loaded = loaded;
+            destroyTexture(retired);
+        }
+    );
+
+    texture = TextureResources{};
+    texture.image = uploaded->image;
+    texture.memory = uploaded->allocation;
+    texture.format = uploaded->format;
+    texture.mipLevels = uploaded->mipLevels;
+    texture.loaded = true;
+    ImageViews::createTextureImageView(
+        vulkan.device, texture.image, texture.view, texture.format, texture.mipLevels
+    );
+    Image::createTextureSampler(
+        vulkan.device, vulkan.physicalDevice, texture.sampler, texture.mipLevels
+    );
+
+    /// Bindless: point the material at a new slot (a resident streamed texture stays drawn)
+    if (!bindless.sets.empty() && streamer.sampler == VK_NULL_HANDLE)
+    {
+        const std::uint32_t oldSlot = textureSlot;
+        textureSlot = Bindless::addTexture(bindless, texture.view, texture.sampler);
+
+        Bindless::Material material;
+        material.textureIndex = textureSlot;
+        Bindless::setMaterial(bindless, materialIndex, material);
+
+        Deletion::defer(
+            deletionQueue,
+            sync.timeline.lastSubmitted,
+            [this, oldSlot]() { Bindless::removeTexture(bindless, oldSlot); }
+        );
+    }
 }
 
 /**
  * @brief Recreate swapchain after window resize or invalidation
- * @details Handles window minimization, waits for valid size, destroys old resources,
- *          and creates new swapchain with updated dimensions
+ * @details Handles window minimization, waits for valid size, retires old resources,
+ *          and creates new swapchain with updated dimensions from the old one
  * @note Must recreate renderFinished semaphores as swapchain image count may change
  */
 void TriangleApp::recreateSwapChain()
@@ -411,50 +1938,94 @@ void TriangleApp::recreateSwapChain()
         glfwWaitEvents();
     }
 
-    /// Wait for all GPU operations to complete before destroying resources
-    vkDeviceWaitIdle(vulkan.device);
-
-    /// Clean up old swapchain and dependent resources
-    cleanupSwapChain();
-
-    /// Reset handles to ensure clean state
-    swapchain.swapChain = VK_NULL_HANDLE;
-    swapchain.images.clear();
-    swapchain.imageViews.clear();
-    swapchain.framebuffers.clear();
+    /// Old resources stay alive until the GPU has moved past them (no device drain)
+    VkSwapchainKHR oldSwapChain = VK_NULL_HANDLE;
+    retireSwapChain(oldSwapChain);
 
-    /// Recreate swapchain with new dimensions
+    /// Recreate swapchain with new dimensions, handing over the retiring one
     SwapChain::createSwapChain(
         vulkan.physicalDevice,
         vulkan.device,
         vulkan.surface,
         swapchain.swapChain,
         swapchain.images,
-        swapchain.extent
+        swapchain.extent,
+        presentConfig,
+        oldSwapChain
     );
     ImageViews::createImageViews(
         vulkan.device, swapchain.images, VK_FORMAT_B8G8R8A8_SRGB, swapchain.imageViews
     );
-    Framebuffer::createFramebuffers(
+    RenderGraph::createTransients(
         vulkan.device,
-        pipeline.renderPass,
-        swapchain.imageViews,
+        allocator,
+        frameGraph.graph,
         swapchain.extent,
-        swapchain.framebuffers
+        swapchain.transients
     );
+    createFramebuffers();
 
     /**
      * Recreate renderFinished semaphores since swapchain image count may have changed
-     * imageAvailable semaphores and fences don't need recreation (frame-based, not image-based)
+     * imageAvailable semaphores and the timeline don't need recreation (not per image)
      */
-    Synchronization::createSyncObjects(
-        vulkan.device,
-        sync.imageAvailable,
-        sync.renderFinished,
-        sync.inFlight,
-        swapchain.images.size(),
-        MAX_FRAMES_IN_FLIGHT
+    Synchronization::createSyncObjects(vulkan.device, sync.renderFinished, swapchain.images.size());
+}
+
+/**
+ * @brief Move the current swapchain resources onto the deletion queue
+ * @param oldSwapChain Output retired swapchain, passed as oldSwapchain to its replacement
+ * @details Framebuffers and views are last used by the most recent submission. The presents
+ *          queued behind it have no completion signal of their own, so everything is kept for
+ *          another framesInFlight submissions, by which point the present queue has
+ *          consumed the old renderFinished semaphores and released the old images.
+ */
+void TriangleApp::retireSwapChain(VkSwapchainKHR &oldSwapChain)
+{
+    oldSwapChain = swapchain.swapChain;
+
+    const std::uint64_t retireValue = sync.timeline.lastSubmitted + framesInFlight;
+    Deletion::defer(
+        deletionQueue,
+        retireValue,
+        [this,
+         device = vulkan.device,
+         swapChain = swapchain.swapChain,
+         imageViews = std::move(swapchain.imageViews),
+         framebuffers = std::move(swapchain.framebuffers),
+         overlayFramebuffers = std::move(swapchain.overlayFramebuffers),
+         transients = std::move(swapchain.transients),
+         semaphores = std::move(sync.renderFinished)]() mutable
+        {
+            for (auto framebuffer : framebuffers)
+            {
+                vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+            for (auto framebuffer : overlayFramebuffers)
+            {
+                vkDestroyFramebuffer(device, framebuffer, nullptr);
+            }
+            for (auto imageView : imageViews)
+            {
+                vkDestroyImageView(device, imageView, nullptr);
+            }
+            RenderGraph::destroyTransients(device, allocator, transients);
+            vkDestroySwapchainKHR(device, swapChain, nullptr);
+            for (auto semaphore : semaphores)
+            {
+                vkDestroySemaphore(device, semaphore, nullptr);
+            }
+        }
     );
+
+    /// Reset handles to ensure clean state (present ids restart with the new swapchain)
+    swapchain.swapChain = VK_NULL_HANDLE;
+    swapchain.images.clear();
+    swapchain.imageViews.clear();
+    swapchain.framebuffers.clear();
+    swapchain.overlayFramebuffers.clear();
+    sync.renderFinished.clear();
+    presentPacer.lastPresentId = 0;
 }
 
 /**
@@ -470,6 +2041,10 @@ void TriangleApp::cleanupSwapChain()
     {
         vkDestroyFramebuffer(vulkan.device, framebuffer, nullptr);
     }
+    for (auto framebuffer : swapchain.overlayFramebuffers)
+    {
+        vkDestroyFramebuffer(vulkan.device, framebuffer, nullptr);
+    }
 
     /// Destroy image views (we don't own the images themselves)
     for (auto imageView : swapchain.imageViews)
@@ -477,8 +2052,16 @@ void TriangleApp::cleanupSwapChain()
         vkDestroyImageView(vulkan.device, imageView, nullptr);
     }
 
-    /// Destroy the swapchain itself
+    /// Transient attachments are ours, recreated with every swapchain
+    RenderGraph::destroyTransients(vulkan.device, allocator, swapchain.transients);
+
+    /// Destroy the swapchain itself, or the offscreen images standing in for it
     vkDestroySwapchainKHR(vulkan.device, swapchain.swapChain, nullptr);
+    for (std::size_t i = 0; i < swapchain.memory.size(); i++)
+    {
+        Image::destroyImage(vulkan.device, allocator, swapchain.images[i], swapchain.memory[i]);
+    }
+    swapchain.memory.clear();
 
     /// Destroy renderFinished semaphores (indexed by swapchain image, may change on resize)
     for (auto semaphore : sync.renderFinished)
@@ -496,59 +2079,123 @@ void TriangleApp::cleanupSwapChain()
  */
 void TriangleApp::cleanup()
 {
+    HotReload::stop(watcher);
+
+    /// Heaps and categories as the frames left them, with the peaks of the whole run
+    if (sceneConfig.profile)
+    {
+        std::cerr << Memory::formatReport(allocator);
+    }
+
+    /// Everything still queued for deferred destruction (the device is idle here)
+    Deletion::flushAll(deletionQueue);
+
     /// Clean up swapchain and per-image resources first
     cleanupSwapChain();
 
-    /// Texture resources
-    vkDestroySampler(vulkan.device, texture.sampler, nullptr);
-    vkDestroyImageView(vulkan.device, texture.view, nullptr);
-    vkDestroyImage(vulkan.device, texture.image, nullptr);
-    vkFreeMemory(vulkan.device, texture.memory, nullptr);
+    /// Upload batches (frees remaining staging buffers)
+    Upload::destroyContext(uploads);
 
-    /// Uniform buffers (unmap before destroying to prevent memory leak)
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    /// Streamed textures (replaced images were released with the deletion queue above)
+    if (streamer.sampler != VK_NULL_HANDLE)
     {
-        vkUnmapMemory(
-            vulkan.device, buffers.uniformMemory[i]
-        ); ///< CRITICAL: unmap persistently mapped memory
-        vkDestroyBuffer(vulkan.device, buffers.uniformBuffers[i], nullptr);
-        vkFreeMemory(vulkan.device, buffers.uniformMemory[i], nullptr);
+        Streaming::destroyStreamer(streamer);
     }
 
-    /// Descriptor pool (automatically frees descriptor sets)
-    vkDestroyDescriptorPool(vulkan.device, descriptorPool, nullptr);
-    vkDestroyDescriptorSetLayout(vulkan.device, pipeline.descriptorSetLayout, nullptr);
-
-    /// Vertex and index buffers
-    vkDestroyBuffer(vulkan.device, buffers.indexBuffer, nullptr);
-    vkFreeMemory(vulkan.device, buffers.indexMemory, nullptr);
-    vkDestroyBuffer(vulkan.device, buffers.vertexBuffer, nullptr);
-    vkFreeMemory(vulkan.device, buffers.vertexMemory, nullptr);
+    /// Texture resources
+    for (TextureResources &extra : extraTextures)
+    {
+        destroyTexture(extra);
+    }
+    extraTextures.clear();
+    destroyTexture(texture);
 
-    /// Graphics pipeline and layout
-    vkDestroyPipeline(vulkan.device, pipeline.pipeline, nullptr);
-    vkDestroyPipelineLayout(vulkan.device, pipeline.layout, nullptr);
-    vkDestroyRenderPass(vulkan.device, pipeline.renderPass, nullptr);
+    /// Edits still uploading are released unbound, then the loader finishes its queue
+    if (sceneConfig.hotReload)
+    {
+        for (std::future<Loader::Resource> &load : reloadLoads)
+        {
+            try
+            {
+                Loader::release(loader, load.get());
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        reloadLoads.clear();
+        Loader::destroyLoader(loader);
+    }
 
-    /// Synchronization primitives (frame-based)
-    for (auto semaphore : sync.imageAvailable)
+    /// Cull pass (its shader module belongs to the pipeline registry) and its compute queue
+    AsyncCompute::destroyContext(asyncCompute);
+    if (culling.pipeline != VK_NULL_HANDLE)
     {
-        vkDestroySemaphore(vulkan.device, semaphore, nullptr);
+        Culling::destroyCullPass(vulkan.device, allocator, culling);
     }
-    for (auto fence : sync.inFlight)
+
+    /// Descriptor sets and layouts (frame descriptor pools go with the frame contexts)
+    if (!bindless.sets.empty())
     {
-        vkDestroyFence(vulkan.device, fence, nullptr);
+        Bindless::destroyTable(bindless);
     }
+    Descriptors::destroyAllocator(descriptors);
+    Descriptors::destroyLayoutCache(layouts);
+    pipeline.descriptorSetLayout = VK_NULL_HANDLE;
+
+    /// Vertex, index, instance and indirect buffers
+    Buffer::destroyBuffer(vulkan.device, allocator, buffers.indirectBuffer, buffers.indirectMemory);
+    Buffer::destroyBuffer(vulkan.device, allocator, buffers.instanceBuffer, buffers.instanceMemory);
+    Buffer::destroyBuffer(vulkan.device, allocator, buffers.indexBuffer, buffers.indexMemory);
+    Buffer::destroyBuffer(vulkan.device, allocator, buffers.vertexBuffer, buffers.vertexMemory);
+    Sprites::destroyRenderer(vulkan.device, allocator, spriteRenderer);
+
+    /// Pipeline variants and shader modules, then the cache (written back for the next launch)
+    Pipelines::destroyRegistry(pipelines);
+    AssetPack::closePack(assets);
+    PipelineCache::savePipelineCache(vulkan.device, pipeline.cache);
+    vkDestroyPipelineCache(vulkan.device, pipeline.cache, nullptr);
+    vkDestroyPipelineLayout(vulkan.device, pipeline.layout, nullptr);
+    vkDestroyRenderPass(vulkan.device, pipeline.renderPass, nullptr);
+    vkDestroyRenderPass(vulkan.device, pipeline.overlayRenderPass, nullptr);
+
+    /// Profiler queries (the summary and trace are written here)
+    Profiler::destroyProfiler(profiler);
+
+    /// Frame contexts (command pools, sync objects, staging buffers) and the uniform ring
+    Frame::destroyFrameContexts(vulkan.device, allocator, frames, uniforms);
+    Synchronization::destroyTimeline(vulkan.device, sync.timeline);
 
-    /// Command pool (automatically frees command buffers)
-    vkDestroyCommandPool(vulkan.device, commandPool, nullptr);
+    /// Worker command pools and threads
+    Command::destroyParallelRecorder(recorder);
+    Jobs::destroyJobSystem(jobs);
+
+    /// Device memory blocks (every buffer and image is destroyed by now; what is not leaked)
+    for (std::size_t i = 0; i < Memory::CATEGORY_COUNT; i++)
+    {
+        const Memory::CategoryStats stats =
+            Memory::getCategoryStats(allocator, static_cast<Memory::Category>(i));
+        if (stats.count > 0)
+        {
+            std::cerr << std::format(
+                "memory: {} leaked: {} allocations, {} bytes\n",
+                Memory::categoryName(static_cast<Memory::Category>(i)),
+                stats.count,
+                stats.bytes
+            );
+        }
+    }
+    Memory::destroyAllocator(allocator);
 
     /// Device and instance
     vkDestroyDevice(vulkan.device, nullptr);
     vkDestroySurfaceKHR(vulkan.instance, vulkan.surface, nullptr);
     vkDestroyInstance(vulkan.instance, nullptr);
 
-    /// GLFW cleanup
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    /// GLFW cleanup (headless runs never initialised it)
+    if (window != nullptr)
+    {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
 }
\ No newline at end of file
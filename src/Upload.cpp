@@ -0,0 +1,670 @@
+#include "Upload.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "Queue.hpp"
+#include "VulkanHelpers.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Upload
+{
+    namespace
+    {
+        /// Largest single copy; keeps a chunk placeable once the ring has drained
+        VkDeviceSize maxChunkSize(const StagingRing &ring)
+        {
+            return ring.size / 2;
+        }
+
+        VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        /**
+         * @struct Slice
+         * @brief Region of the staging ring reserved for one copy
+         */
+        struct Slice
+        {
+            VkDeviceSize offset = 0;     ///< Offset into StagingRing::buffer
+            VkDeviceSize size = 0;       ///< Slice size in bytes
+            std::byte *mapped = nullptr; ///< Host pointer to the slice
+        };
+
+        VkCommandPool createPool(VkDevice device, std::uint32_t queueFamily)
+        {
+            VkCommandPoolCreateInfo poolInfo{};
+            poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+                             | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = queueFamily;
+
+            VkCommandPool pool;
+            VK_CHECK(vkCreateCommandPool(device, &poolInfo, nullptr, &pool), "create upload pool");
+            return pool;
+        }
+
+        VkCommandBuffer allocateCommands(VkDevice device, VkCommandPool pool)
+        {
+            VkCommandBufferAllocateInfo allocInfo{};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = pool;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            VK_CHECK(
+                vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer),
+                "allocate upload command buffer"
+            );
+            return commandBuffer;
+        }
+
+        void beginCommands(VkCommandBuffer commandBuffer)
+        {
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            VK_CHECK(vkBeginCommandBuffer(commandBuffer, &beginInfo), "begin upload batch");
+        }
+
+        /// Return the batch being recorded, opening a free (or new) slot if needed
+        Batch &currentBatch(Context &context)
+        {
+            if (context.recording.has_value())
+            {
+                return context.batches[*context.recording];
+            }
+
+            std::size_t slot = context.batches.size();
+            for (std::size_t i = 0; i < context.batches.size(); i++)
+            {
+                if (context.batches[i].id == 0)
+                {
+                    slot = i;
+                    break;
+                }
+            }
+
+            if (slot == context.batches.size())
+            {
+                Batch batch{};
+                batch.transferCommands = allocateCommands(context.device, context.transferPool);
+
+                VkFenceCreateInfo fenceInfo{};
+                fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                VK_CHECK(
+                    vkCreateFence(context.device, &fenceInfo, nullptr, &batch.fence),
+                    "create upload fence"
+                );
+
+                if (context.dedicatedTransfer())
+                {
+                    batch.graphicsCommands = allocateCommands(context.device, context.graphicsPool);
+
+                    VkSemaphoreCreateInfo semaphoreInfo{};
+                    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                    VK_CHECK(
+                        vkCreateSemaphore(
+                            context.device, &semaphoreInfo, nullptr, &batch.transferDone
+                        ),
+                        "create upload semaphore"
+                    );
+                }
+
+                context.batches.push_back(std::move(batch));
+            }
+
+            Batch &batch = context.batches[slot];
+            batch.id = context.nextBatchId++;
+            batch.graphicsWaitStages = 0;
+
+            beginCommands(batch.transferCommands);
+            if (batch.graphicsCommands != VK_NULL_HANDLE)
+            {
+                beginCommands(batch.graphicsCommands);
+            }
+
+            context.recording = slot;
+            return batch;
+        }
+
+        /**
+         * Reserve a slice of the staging ring, or return false if the free space is too
+         * small. Wrapped slices must end strictly before the tail so head == tail always
+         * means an empty ring.
+         */
+        bool allocateSlice(StagingRing &ring, VkDeviceSize size, Slice &slice)
+        {
+            if (ring.head == ring.tail)
+            {
+                ring.head = 0;
+                ring.tail = 0;
+            }
+
+            VkDeviceSize offset = alignUp(ring.head, ring.alignment);
+
+            if (ring.head >= ring.tail)
+            {
+                if (offset + size > ring.size)
+                {
+                    offset = 0;
+                    if (size >= ring.tail)
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if (offset + size >= ring.tail)
+            {
+                return false;
+            }
+
+            ring.head = offset + size;
+
+            slice.offset = offset;
+            slice.size = size;
+            slice.mapped = static_cast<std::byte *>(ring.allocation.mapped) + offset;
+            return true;
+        }
+
+        /// Move the tail past every retired batch that has no older batch still in flight
+        void releaseSlices(StagingRing &ring)
+        {
+            while (!ring.pending.empty() && ring.pending.front().done)
+            {
+                ring.tail = ring.pending.front().end;
+                ring.pending.pop_front();
+            }
+        }
+
+        /// Wait for the oldest submitted batch so its slices can be reused
+        void waitOldest(Context &context);
+
+        /**
+         * Copy size bytes into the ring, flushing and waiting on older batches when it is
+         * full. Returns the batch to record into (the recording slot may have changed).
+         */
+        Batch &stage(Context &context, const void *data, VkDeviceSize size, Slice &slice)
+        {
+            while (!allocateSlice(context.ring, size, slice))
+            {
+                if (context.recording.has_value())
+                {
+                    submit(context);
+                }
+                if (context.ring.pending.empty())
+                {
+                    throw std::runtime_error("upload does not fit in the staging ring!");
+                }
+                waitOldest(context);
+            }
+
+            memcpy(slice.mapped, data, static_cast<size_t>(size));
+            return currentBatch(context);
+        }
+
+        void retire(Context &context, Batch &batch)
+        {
+            for (auto &retirement : context.ring.pending)
+            {
+                if (retirement.batchId == batch.id)
+                {
+                    retirement.done = true;
+                    break;
+                }
+            }
+            releaseSlices(context.ring);
+
+            vkResetFences(context.device, 1, &batch.fence);
+            batch.submitted = false;
+            batch.id = 0;
+        }
+
+        void waitOldest(Context &context)
+        {
+            const std::uint64_t oldest = context.ring.pending.front().batchId;
+            wait(context, oldest);
+        }
+    } // namespace
+
+    void createContext(
+        VkDevice &device,
+        VkPhysicalDevice &physicalDevice,
+        VkSurfaceKHR &surface,
+        Memory::Allocator &allocator,
+        VkQueue &graphicsQueue,
+        VkQueue &transferQueue,
+        Submit::Batcher &batcher,
+        Context &context,
+        VkDeviceSize stagingSize
+    )
+    {
+        Queue::FamilyIndices indices = Queue::findQueueFamilies(physicalDevice, surface);
+
+        context.device = device;
+        context.allocator = &allocator;
+        context.graphicsQueue = graphicsQueue;
+        context.transferQueue = transferQueue;
+        context.batcher = &batcher;
+        context.graphicsFamily = indices.graphicsFamily.value();
+        context.transferFamily = indices.transferFamily.value();
+
+        context.transferPool = createPool(device, context.transferFamily);
+        if (context.dedicatedTransfer())
+        {
+            context.graphicsPool = createPool(device, context.graphicsFamily);
+        }
+
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+        /// Slice offsets double as bufferOffset of image copies (multiple of 4 and texel size)
+        context.ring.alignment = std::max<VkDeviceSize>(
+            properties.limits.optimalBufferCopyOffsetAlignment, 16
+        );
+        context.ring.size = stagingSize;
+
+        Buffer::createBuffer(
+            device,
+            allocator,
+            stagingSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            context.ring.buffer,
+            context.ring.allocation,
+            Memory::Category::Staging
+        );
+    }
+
+    void destroyContext(Context &context)
+    {
+        if (context.recording.has_value())
+        {
+            submit(context);
+        }
+
+        /// Batches may still sit in the batcher; their fences only signal once flushed
+        Submit::flush(*context.batcher);
+        for (auto &batch : context.batches)
+        {
+            if (batch.submitted)
+            {
+                vkWaitForFences(context.device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+                retire(context, batch);
+            }
+
+            vkDestroyFence(context.device, batch.fence, nullptr);
+            if (batch.transferDone != VK_NULL_HANDLE)
+            {
+                vkDestroySemaphore(context.device, batch.transferDone, nullptr);
+            }
+        }
+        context.batches.clear();
+
+        Buffer::destroyBuffer(
+            context.device, *context.allocator, context.ring.buffer, context.ring.allocation
+        );
+
+        /// Destroying the pools also frees their command buffers
+        vkDestroyCommandPool(context.device, context.transferPool, nullptr);
+        if (context.graphicsPool != VK_NULL_HANDLE)
+        {
+            vkDestroyCommandPool(context.device, context.graphicsPool, nullptr);
+        }
+    }
+
+    void uploadBuffer(
+        Context &context,
+        const void *data,
+        VkDeviceSize size,
+        VkBuffer dstBuffer,
+        VkDeviceSize dstOffset,
+        VkPipelineStageFlags dstStage,
+        VkAccessFlags dstAccess
+    )
+    {
+        const auto *bytes = static_cast<const std::byte *>(data);
+        const VkDeviceSize chunkSize = maxChunkSize(context.ring);
+
+        for (VkDeviceSize copied = 0; copied < size;)
+        {
+            const VkDeviceSize chunk = std::min(size - copied, chunkSize);
+
+            Slice slice;
+            Batch &batch = stage(context, bytes + copied, chunk, slice);
+
+            VkBufferCopy copyRegion{};
+            copyRegion.srcOffset = slice.offset;
+            copyRegion.dstOffset = dstOffset + copied;
+            copyRegion.size = chunk;
+            vkCmdCopyBuffer(batch.transferCommands, context.ring.buffer, dstBuffer, 1, &copyRegion);
+
+            copied += chunk;
+        }
+
+        Batch &batch = currentBatch(context);
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = dstAccess;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = dstBuffer;
+        barrier.offset = dstOffset;
+        barrier.size = size;
+
+        if (!context.dedicatedTransfer())
+        {
+            vkCmdPipelineBarrier(
+                batch.transferCommands,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                dstStage,
+                0,
+                0,
+                nullptr,
+                1,
+                &barrier,
+                0,
+                nullptr
+            );
+            return;
+        }
+
+        /// Release on the transfer family, acquire on graphics (same barrier on both sides)
+        barrier.srcQueueFamilyIndex = context.transferFamily;
+        barrier.dstQueueFamilyIndex = context.graphicsFamily;
+
+        VkBufferMemoryBarrier release = barrier;
+        release.dstAccessMask = 0;
+        vkCmdPipelineBarrier(
+            batch.transferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            nullptr,
+            1,
+            &release,
+            0,
+            nullptr
+        );
+
+        VkBufferMemoryBarrier acquire = barrier;
+        acquire.srcAccessMask = 0;
+        vkCmdPipelineBarrier(
+            batch.graphicsCommands, dstStage, dstStage, 0, 0, nullptr, 1, &acquire, 0, nullptr
+        );
+        batch.graphicsWaitStages |= dstStage;
+    }
+
+    void uploadImage(
+        Context &context,
+        const void *data,
+        VkDeviceSize size,
+        VkImage image,
+        VkFormat format,
+        std::uint32_t width,
+        std::uint32_t height
+    )
+    {
+        const ImageLevel level{0, size, width, height};
+        uploadImage(context, data, image, format, std::span(&level, 1));
+    }
+
+    void uploadImage(
+        Context &context,
+        const void *data,
+        VkImage image,
+        VkFormat format,
+        std::span<const ImageLevel> levels,
+        std::uint32_t mipLevels
+    )
+    {
+        const auto *bytes = static_cast<const std::byte *>(data);
+        const auto levelCount = static_cast<std::uint32_t>(levels.size());
+        const std::uint32_t imageLevels = std::max(mipLevels, levelCount);
+        const bool generate = imageLevels > levelCount;
+        const VkExtent2D block = Image::blockExtent(format);
+        const VkDeviceSize chunkSize = maxChunkSize(context.ring);
+
+        Image::transitionImageLayout(
+            currentBatch(context).transferCommands,
+            image,
+            format,
+            VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            imageLevels
+        );
+
+        for (std::uint32_t mip = 0; mip < levelCount; mip++)
+        {
+            const ImageLevel &level = levels[mip];
+            const std::uint32_t blockRows = (level.height + block.height - 1) / block.height;
+            const VkDeviceSize rowPitch = level.size / blockRows;
+            if (rowPitch > chunkSize)
+            {
+                throw std::runtime_error("image row does not fit in the staging ring!");
+            }
+            const auto bandRows = static_cast<std::uint32_t>(chunkSize / rowPitch);
+
+            /// Copy in bands of whole block rows so large images stream through the ring
+            for (std::uint32_t row = 0; row < blockRows;)
+            {
+                const std::uint32_t rows = std::min(blockRows - row, bandRows);
+                const std::uint32_t y = row * block.height;
+
+                Slice slice;
+                Batch &batch =
+                    stage(context, bytes + level.offset + row * rowPitch, rows * rowPitch, slice);
+
+                VkBufferImageCopy region{};
+                region.bufferOffset = slice.offset;
+                region.bufferRowLength = 0;
+                region.bufferImageHeight = 0;
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.mipLevel = mip;
+                region.imageSubresource.baseArrayLayer = 0;
+                region.imageSubresource.layerCount = 1;
+                region.imageOffset = {0, static_cast<std::int32_t>(y), 0};
+                region.imageExtent = {
+                    level.width, std::min(rows * block.height, level.height - y), 1
+                };
+
+                vkCmdCopyBufferToImage(
+                    batch.transferCommands,
+                    context.ring.buffer,
+                    image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    1,
+                    &region
+                );
+
+                row += rows;
+            }
+        }
+
+        Batch &batch = currentBatch(context);
+        const ImageLevel &last = levels.back();
+
+        if (!context.dedicatedTransfer())
+        {
+            if (generate)
+            {
+                Image::generateMipmaps(
+                    batch.transferCommands,
+                    image,
+                    format,
+                    last.width,
+                    last.height,
+                    levelCount - 1,
+                    imageLevels
+                );
+                return;
+            }
+            Image::transitionImageLayout(
+                batch.transferCommands,
+                image,
+                format,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                levelCount
+            );
+            return;
+        }
+
+        /**
+         * The layout change is part of the release/acquire pair and runs once. Blits need a
+         * graphics queue, so an image with levels left to generate is handed over still in
+         * TRANSFER_DST and its mip chain is built on the graphics side.
+         */
+        const VkPipelineStageFlags dstStage = generate ? VK_PIPELINE_STAGE_TRANSFER_BIT
+                                                       : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = generate ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                     : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = context.transferFamily;
+        barrier.dstQueueFamilyIndex = context.graphicsFamily;
+        barrier.image = image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.levelCount = imageLevels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        VkImageMemoryBarrier release = barrier;
+        release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        release.dstAccessMask = 0;
+        vkCmdPipelineBarrier(
+            batch.transferCommands,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            1,
+            &release
+        );
+
+        VkImageMemoryBarrier acquire = barrier;
+        acquire.srcAccessMask = 0;
+        acquire.dstAccessMask = generate
+                                    ? VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT
+                                    : VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(
+            batch.graphicsCommands, dstStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &acquire
+        );
+        batch.graphicsWaitStages |= dstStage;
+
+        if (generate)
+        {
+            Image::generateMipmaps(
+                batch.graphicsCommands,
+                image,
+                format,
+                last.width,
+                last.height,
+                levelCount - 1,
+                imageLevels
+            );
+        }
+    }
+
+    std::uint64_t submit(Context &context)
+    {
+        if (!context.recording.has_value())
+        {
+            return 0;
+        }
+
+        Batch &batch = context.batches[*context.recording];
+        context.recording.reset();
+
+        VK_CHECK(vkEndCommandBuffer(batch.transferCommands), "end upload batch");
+
+        /// Handed to the batcher; the copies go out with the next flush
+        Submit::Work transferWork;
+        transferWork.queue = context.transferQueue;
+        transferWork.commandBuffers = {batch.transferCommands};
+
+        if (!context.dedicatedTransfer())
+        {
+            transferWork.fence = batch.fence;
+            Submit::enqueue(*context.batcher, std::move(transferWork));
+        }
+        else
+        {
+            VK_CHECK(vkEndCommandBuffer(batch.graphicsCommands), "end upload acquire");
+
+            transferWork.signals = {Submit::semaphore(batch.transferDone)};
+            Submit::enqueue(*context.batcher, std::move(transferWork));
+
+            /// Buffers-only batches wait before any stage (TOP_OF_PIPE would mean none in a
+            /// synchronization2 wait)
+            const VkPipelineStageFlags2 waitStage = batch.graphicsWaitStages != 0
+                                                        ? batch.graphicsWaitStages
+                                                        : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+            Submit::Work acquireWork;
+            acquireWork.queue = context.graphicsQueue;
+            acquireWork.commandBuffers = {batch.graphicsCommands};
+            acquireWork.waits = {Submit::semaphore(batch.transferDone, 0, waitStage)};
+            acquireWork.fence = batch.fence;
+            Submit::enqueue(*context.batcher, std::move(acquireWork));
+        }
+
+        context.ring.pending.push_back({batch.id, context.ring.head, false});
+
+        batch.submitted = true;
+        return batch.id;
+    }
+
+    void collect(Context &context)
+    {
+        for (auto &batch : context.batches)
+        {
+            if (batch.submitted && vkGetFenceStatus(context.device, batch.fence) == VK_SUCCESS)
+            {
+                retire(context, batch);
+            }
+        }
+    }
+
+    bool isComplete(Context &context, std::uint64_t ticket)
+    {
+        collect(context);
+
+        for (const auto &batch : context.batches)
+        {
+            if (batch.id == ticket)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void wait(Context &context, std::uint64_t ticket)
+    {
+        for (auto &batch : context.batches)
+        {
+            if (batch.id == ticket && batch.submitted)
+            {
+                Submit::flush(*context.batcher);
+                vkWaitForFences(context.device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+                retire(context, batch);
+                return;
+            }
+        }
+    }
+} // namespace Upload
@@ -1,21 +1,267 @@
+#include <charconv>
 #include <format>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
+#include "AssetPack.hpp"
 #include "TriangleApp.hpp"
 
-int main()
+namespace
 {
-    TriangleApp app;
+    /// Parse an unsigned count option value
+    std::uint32_t parseCount(std::string_view option, std::string_view value)
+    {
+        std::uint32_t count = 0;
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+        if (error != std::errc{} || end != value.data() + value.size())
+        {
+            throw std::invalid_argument(std::format("invalid value for {}: {}", option, value));
+        }
+        return count;
+    }
+
+    /**
+     * @brief Build the presentation and scene settings from the command line
+     * @details --latency=balanced|benchmark|low-latency|throughput, --images=N, --frames=N,
+     *          --device=uuid|pci:address, --mesh=path, --texture=path, --instances=N,
+     *          --indirect, --gpu-cull, --pack=path,
+     *          --bake-pack=path (write the startup assets into a pack and exit),
+     *          --stream=path.ktx2, --stream-budget=MiB, --bindless, --profile,
+     *          --trace=path.json (implies --profile), --benchmark[=path.json] (headless,
+     *          report to the file or standard output), --bench-frames=N, --draws=N,
+     *          --textures=N (needs --bindless), --blended=N (CPU draws only), --depth-prepass,
+     *          --render-pass (render pass objects even where dynamic rendering is supported),
+     *          --single-queue (GPU culling on the graphics queue, not the async compute one),
+     *          --render-scale=PERCENT (scene resolution, upscaled to the window),
+     *          --target-fps=N (adjust the render scale to hold N frames per second),
+     *          --hot-reload (swap in edited shaders and the texture while running),
+     *          --sprites=N (screen-space sprites batched over the scene)
+     */
+    void parseOptions(
+        int argc,
+        char *argv[],
+        SwapChain::PresentConfig &config,
+        SceneConfig &scene,
+        std::string &bakePath
+    )
+    {
+
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string_view arg = argv[i];
+            const auto separator = arg.find('=');
+            const std::string_view option = arg.substr(0, separator);
+            const std::string_view value = separator == std::string_view::npos
+                                               ? std::string_view{}
+                                               : arg.substr(separator + 1);
+
+            if (option == "--latency")
+            {
+                if (value == "balanced")
+                {
+                    config.mode = SwapChain::LatencyMode::Balanced;
+                }
+                else if (value == "benchmark")
+                {
+                    config.mode = SwapChain::LatencyMode::Benchmark;
+                }
+                else if (value == "low-latency")
+                {
+                    config.mode = SwapChain::LatencyMode::LowLatency;
+                }
+                else if (value == "throughput")
+                {
+                    config.mode = SwapChain::LatencyMode::Throughput;
+                }
+                else
+                {
+                    throw std::invalid_argument(std::format("unknown latency mode: {}", value));
+                }
+            }
+            else if (option == "--images")
+            {
+                config.imageCount = parseCount(option, value);
+            }
+            else if (option == "--frames")
+            {
+                config.framesInFlight = parseCount(option, value);
+            }
+            else if (option == "--mesh")
+            {
+                scene.meshPath = value;
+            }
+            else if (option == "--texture")
+            {
+                scene.texturePath = value;
+            }
+            else if (option == "--instances")
+            {
+                scene.instanceCount = parseCount(option, value);
+            }
+            else if (option == "--device")
+            {
+                scene.device = value;
+            }
+            else if (option == "--pack")
+            {
+                scene.assetPack = value;
+            }
+            else if (option == "--stream")
+            {
+                scene.streamPath = value;
+            }
+            else if (option == "--stream-budget")
+            {
+                scene.streamBudgetMiB = parseCount(option, value);
+            }
+            else if (option == "--render-scale")
+            {
+                scene.renderScalePercent = parseCount(option, value);
+            }
+            else if (option == "--target-fps")
+            {
+                scene.targetFps = parseCount(option, value);
+            }
+            else if (option == "--bake-pack")
+            {
+                bakePath = value;
+            }
+            else if (option == "--trace")
+            {
+                scene.tracePath = value;
+                scene.profile = true;
+            }
+            else if (option == "--benchmark")
+            {
+                scene.benchmark = true;
+                scene.benchmarkPath = value;
+            }
+            else if (option == "--bench-frames")
+            {
+                scene.benchmarkFrames = parseCount(option, value);
+            }
+            else if (option == "--draws")
+            {
+                scene.drawCount = parseCount(option, value);
+            }
+            else if (option == "--textures")
+            {
+                scene.textureCount = parseCount(option, value);
+            }
+            else if (option == "--blended")
+            {
+                scene.blendedDraws = parseCount(option, value);
+            }
+            else if (option == "--sprites")
+            {
+                scene.spriteCount = parseCount(option, value);
+            }
+            else if (arg == "--depth-prepass")
+            {
+                scene.depthPrepass = true;
+            }
+            else if (arg == "--render-pass")
+            {
+                scene.renderPass = true;
+            }
+            else if (arg == "--single-queue")
+            {
+                scene.singleQueue = true;
+            }
+            else if (arg == "--hot-reload")
+            {
+                scene.hotReload = true;
+            }
+            else if (arg == "--profile")
+            {
+                scene.profile = true;
+            }
+            else if (arg == "--bindless")
+            {
+                scene.bindless = true;
+            }
+            else if (arg == "--indirect")
+            {
+                scene.indirect = true;
+            }
+            else if (arg == "--gpu-cull")
+            {
+                scene.gpuCulling = true;
+                scene.indirect = true;
+            }
+            else
+            {
+                throw std::invalid_argument(std::format("unknown option: {}", arg));
+            }
+        }
+
+        /// Extra textures are only sampled through per-draw bindless materials
+        if (scene.textureCount > 1 && !scene.bindless)
+        {
+            throw std::invalid_argument("--textures needs --bindless");
+        }
+
+        /// Indirect records are all drawn opaque; only CPU draws pick the blended pipeline
+        if (scene.blendedDraws > 0 && scene.indirect)
+        {
+            throw std::invalid_argument("--blended cannot be combined with --indirect");
+        }
 
+        /// Benchmarks replay a fixed sequence of frames; nothing may change under them
+        if (scene.hotReload && scene.benchmark)
+        {
+            throw std::invalid_argument("--hot-reload cannot be combined with --benchmark");
+        }
+
+        const auto minPercent = static_cast<std::uint32_t>(Resolution::MIN_SCALE * 100.0f);
+        const auto maxPercent = static_cast<std::uint32_t>(Resolution::MAX_SCALE * 100.0f);
+        if (scene.renderScalePercent < minPercent || scene.renderScalePercent > maxPercent)
+        {
+            throw std::invalid_argument(
+                std::format("--render-scale must be between {} and {}", minPercent, maxPercent)
+            );
+        }
+
+        /// GPU frame times come from the profiler's timestamp queries (dynamic resolution
+        /// steers by them too)
+        if (scene.benchmark || scene.targetFps > 0)
+        {
+            scene.profile = true;
+        }
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
     try
     {
+        SwapChain::PresentConfig presentConfig;
+        SceneConfig sceneConfig;
+        std::string bakePath;
+
+        /// The benchmark executable runs headless without being asked
+#ifdef HEADLESS_BENCHMARK
+        sceneConfig.benchmark = true;
+#endif
+        parseOptions(argc, argv, presentConfig, sceneConfig, bakePath);
+
+        /// Offline step: no window or device is created
+        if (!bakePath.empty())
+        {
+            AssetPack::bakeSceneAssets(bakePath, sceneConfig.meshPath);
+            return EXIT_SUCCESS;
+        }
+
+        TriangleApp app(presentConfig, sceneConfig);
         app.run();
     }
     catch (const std::exception &e)
     {
-        std::cout << std::format("{}", e.what()) << std::endl;
+        std::cerr << std::format("{}", e.what()) << std::endl;
         return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}